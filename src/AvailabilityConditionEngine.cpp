@@ -0,0 +1,225 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AvailabilityConditionEngine.h"
+#include "CityStatsSnapshot.h"
+#include "CpuFeatureUtil.h"
+#include <algorithm>
+#include <immintrin.h>
+#include <limits>
+
+namespace
+{
+	constexpr size_t BitsPerWord = 64;
+
+	// The kernels set the bit of each row where every metric is greater than or
+	// equal to its threshold.
+
+	template <size_t RowWidth>
+	void EvaluateThresholdsScalar(
+		const std::vector<std::array<double, RowWidth>>& thresholds,
+		const std::array<double, RowWidth>& metrics,
+		std::vector<uint64_t>& availableRows)
+	{
+		for (size_t row = 0; row < thresholds.size(); row++)
+		{
+			const std::array<double, RowWidth>& rowThresholds = thresholds[row];
+
+			bool available = true;
+
+			for (size_t i = 0; i < RowWidth; i++)
+			{
+				available &= metrics[i] >= rowThresholds[i];
+			}
+
+			if (available)
+			{
+				availableRows[row / BitsPerWord] |= 1ULL << (row % BitsPerWord);
+			}
+		}
+	}
+
+	template <size_t RowWidth>
+	CPU_FEATURE_TARGET_AVX void EvaluateThresholdsAvx(
+		const std::vector<std::array<double, RowWidth>>& thresholds,
+		const std::array<double, RowWidth>& metrics,
+		std::vector<uint64_t>& availableRows)
+	{
+		static_assert((RowWidth % 4) == 0);
+		constexpr size_t VectorCount = RowWidth / 4;
+
+		__m256d metricVectors[VectorCount];
+
+		for (size_t i = 0; i < VectorCount; i++)
+		{
+			metricVectors[i] = _mm256_loadu_pd(metrics.data() + (i * 4));
+		}
+
+		for (size_t row = 0; row < thresholds.size(); row++)
+		{
+			const double* pThresholds = thresholds[row].data();
+
+			__m256d available = _mm256_cmp_pd(metricVectors[0], _mm256_loadu_pd(pThresholds), _CMP_GE_OQ);
+
+			for (size_t i = 1; i < VectorCount; i++)
+			{
+				available = _mm256_and_pd(
+					available,
+					_mm256_cmp_pd(metricVectors[i], _mm256_loadu_pd(pThresholds + (i * 4)), _CMP_GE_OQ));
+			}
+
+			if (_mm256_movemask_pd(available) == 0xF)
+			{
+				availableRows[row / BitsPerWord] |= 1ULL << (row % BitsPerWord);
+			}
+		}
+	}
+
+	// Checks that the conditions can be compiled into a threshold row.
+	bool IsThresholdCompatible(const OrdinanceProgram& program)
+	{
+		const OrdinanceProgram::Instruction* pInstructions = program.GetConditionInstructions();
+		const size_t conditionCount = program.GetConditionCount();
+
+		for (size_t i = 0; i < conditionCount; i++)
+		{
+			if (pInstructions[i].opcode != OrdinanceProgram::Opcode::RequireMetricAtLeast
+				|| pInstructions[i].metric >= CityMetric::Count)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+AvailabilityConditionEngine::AvailabilityConditionEngine()
+	: AvailabilityConditionEngine(CpuFeatureUtil::IsAvxSupported())
+{
+}
+
+AvailabilityConditionEngine::AvailabilityConditionEngine(bool useAvx)
+	: definitions(),
+	  slots(),
+	  thresholds(),
+	  availableRows(),
+	  evaluatedEpoch(0),
+	  evaluated(false),
+	  useAvx(useAvx)
+{
+}
+
+void AvailabilityConditionEngine::Compile(const std::vector<std::shared_ptr<const OrdinanceDefinition>>& newDefinitions)
+{
+	Clear();
+
+	definitions = newDefinitions;
+	slots.resize(definitions.size(), Slot{ nullptr, NoRow });
+
+	for (size_t slot = 0; slot < definitions.size(); slot++)
+	{
+		const OrdinanceDefinition* pDefinition = definitions[slot].get();
+
+		if (pDefinition && IsThresholdCompatible(pDefinition->GetProgram()))
+		{
+			const OrdinanceProgram& program = pDefinition->GetProgram();
+			const OrdinanceProgram::Instruction* pInstructions = program.GetConditionInstructions();
+			const size_t conditionCount = program.GetConditionCount();
+
+			ThresholdRow row;
+			row.fill(-std::numeric_limits<double>::infinity());
+
+			for (size_t i = 0; i < conditionCount; i++)
+			{
+				// A metric that has more than one condition must pass the largest threshold.
+				double& threshold = row[static_cast<size_t>(pInstructions[i].metric)];
+
+				if (pInstructions[i].value > threshold)
+				{
+					threshold = pInstructions[i].value;
+				}
+			}
+
+			slots[slot] = Slot{ pDefinition, static_cast<uint32_t>(thresholds.size()) };
+			thresholds.push_back(row);
+		}
+	}
+
+	availableRows.resize((thresholds.size() + (BitsPerWord - 1)) / BitsPerWord);
+}
+
+void AvailabilityConditionEngine::Clear()
+{
+	definitions.clear();
+	slots.clear();
+	thresholds.clear();
+	availableRows.clear();
+	evaluated = false;
+}
+
+bool AvailabilityConditionEngine::TryCheckConditions(
+	size_t slot,
+	const OrdinanceDefinition* definition,
+	bool& conditionsMet)
+{
+	if (slot >= slots.size() || !definition || slots[slot].definition != definition)
+	{
+		return false;
+	}
+
+	CityStatsSnapshot& snapshot = CityStatsSnapshot::GetInstance();
+
+	if (!snapshot.Update())
+	{
+		return false;
+	}
+
+	if (!evaluated || snapshot.GetEpoch() != evaluatedEpoch)
+	{
+		Evaluate(snapshot.GetMetricValues());
+		evaluatedEpoch = snapshot.GetEpoch();
+		evaluated = true;
+	}
+
+	const uint32_t row = slots[slot].row;
+
+	conditionsMet = (availableRows[row / BitsPerWord] & (1ULL << (row % BitsPerWord))) != 0;
+	return true;
+}
+
+void AvailabilityConditionEngine::Evaluate(const std::array<double, CityMetricUtil::MetricCount>& metrics)
+{
+	// The padding metrics are compared with a masked threshold.
+	ThresholdRow paddedMetrics{};
+	std::copy(metrics.begin(), metrics.end(), paddedMetrics.begin());
+
+	std::fill(availableRows.begin(), availableRows.end(), 0);
+
+	if (useAvx)
+	{
+		EvaluateThresholdsAvx(thresholds, paddedMetrics, availableRows);
+	}
+	else
+	{
+		EvaluateThresholdsScalar(thresholds, paddedMetrics, availableRows);
+	}
+}
@@ -0,0 +1,96 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "CityMetric.h"
+#include "OrdinanceDefinition.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Evaluates the availability conditions of all of the custom ordinances in one pass.
+// The metric conditions of each ordinance are compiled into a fixed-width threshold
+// row with an element for each city metric. The metrics that an ordinance does not
+// test are masked by a threshold of negative infinity, which every value passes.
+// The availability of every compiled ordinance is computed from the CityStatsSnapshot
+// when the first ordinance checks its conditions after the snapshot has changed, by
+// comparing each row with the metric values using AVX when the CPU supports it. The
+// results are stored in a bitset.
+// The ordinances that have a Lua condition are not compiled, their program calls the
+// Lua functions in the same order as the other conditions.
+class AvailabilityConditionEngine
+{
+public:
+	AvailabilityConditionEngine();
+	// Selects the kernel, this allows the tests and benchmarks to compare the AVX
+	// kernel with the scalar kernel.
+	// The AVX kernel must only be selected if CpuFeatureUtil::IsAvxSupported
+	// returns true.
+	explicit AvailabilityConditionEngine(bool useAvx);
+
+	AvailabilityConditionEngine(const AvailabilityConditionEngine& other) = delete;
+	AvailabilityConditionEngine(AvailabilityConditionEngine&& other) = delete;
+
+	AvailabilityConditionEngine& operator=(const AvailabilityConditionEngine& other) = delete;
+	AvailabilityConditionEngine& operator=(AvailabilityConditionEngine&& other) = delete;
+
+	// Compiles the availability conditions of the ordinance definitions.
+	// The slot of a definition is its index in the list, a null definition leaves
+	// its slot empty.
+	void Compile(const std::vector<std::shared_ptr<const OrdinanceDefinition>>& definitions);
+	void Clear();
+
+	// Gets a value indicating whether the conditions of the ordinance in the specified
+	// slot are met for the current city statistics snapshot.
+	// Returns false if the slot was not compiled from the specified definition, the
+	// caller must check the conditions itself.
+	bool TryCheckConditions(size_t slot, const OrdinanceDefinition* definition, bool& conditionsMet);
+
+private:
+	static constexpr uint32_t NoRow = UINT32_MAX;
+	// The metric count rounded up to a multiple of 4, the kernel compares
+	// 4 metrics at a time.
+	static constexpr size_t RowWidth = (CityMetricUtil::MetricCount + 3) & ~static_cast<size_t>(3);
+
+	using ThresholdRow = std::array<double, RowWidth>;
+
+	struct Slot
+	{
+		// The definition is only used to check that the ordinance still uses the
+		// definition that the slot was compiled from, a loaded city can replace it
+		// with the values from the save game.
+		const OrdinanceDefinition* definition;
+		uint32_t row;
+	};
+
+	void Evaluate(const std::array<double, CityMetricUtil::MetricCount>& metrics);
+
+	std::vector<std::shared_ptr<const OrdinanceDefinition>> definitions;
+	std::vector<Slot> slots;
+	std::vector<ThresholdRow> thresholds;
+	// A bit for each threshold row, the bit is set if the ordinance is available.
+	std::vector<uint64_t> availableRows;
+	// The epoch of the CityStatsSnapshot that the availability was computed from.
+	uint32_t evaluatedEpoch;
+	bool evaluated;
+	bool useAvx;
+};
@@ -0,0 +1,189 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Decodes a list of items on a background thread while the game is idle.
+// The game thread takes the decoded items when it needs them, it only waits
+// for the item that is currently being decoded.
+// The items are decoded in index order, an item that the game thread takes
+// before the background thread reaches it is skipped.
+template <typename T> class BackgroundDecoder
+{
+public:
+	// Decodes the item at the specified index, or returns null if the item must
+	// be created on the game thread.
+	using DecodeFunction = std::function<std::unique_ptr<T>(size_t)>;
+
+	BackgroundDecoder();
+	~BackgroundDecoder();
+
+	BackgroundDecoder(const BackgroundDecoder& other) = delete;
+	BackgroundDecoder(BackgroundDecoder&& other) = delete;
+
+	BackgroundDecoder& operator=(const BackgroundDecoder& other) = delete;
+	BackgroundDecoder& operator=(BackgroundDecoder&& other) = delete;
+
+	// Starts decoding the items in the range [0, count).
+	// The data that the decode function reads must not be modified until the
+	// item has been taken or the decoder has been stopped.
+	void Start(size_t count, DecodeFunction&& decodeFunction);
+
+	// Stops the background thread and discards the items that have not been taken.
+	// The owner should call this before the DLL is unloaded, the destructor also
+	// waits for the background thread but joining a thread during static
+	// destruction can deadlock on the loader lock.
+	void Stop();
+
+	// Takes the decoded item at the specified index.
+	// Returns null if the item could not be decoded, or if the background
+	// thread has not reached it yet, in which case it will be skipped.
+	std::unique_ptr<T> Take(size_t index);
+
+private:
+	enum class ItemState : uint8_t
+	{
+		Pending,
+		Decoding,
+		Ready,
+		Taken
+	};
+
+	void DecodeItems();
+
+	std::mutex mutex;
+	std::condition_variable itemDecoded;
+	std::vector<ItemState> states;
+	std::vector<std::unique_ptr<T>> items;
+	DecodeFunction decodeFunction;
+	std::thread thread;
+	size_t nextIndex;
+	bool stopRequested;
+};
+
+template <typename T> BackgroundDecoder<T>::BackgroundDecoder()
+	: mutex(),
+	  itemDecoded(),
+	  states(),
+	  items(),
+	  decodeFunction(),
+	  thread(),
+	  nextIndex(0),
+	  stopRequested(false)
+{
+}
+
+template <typename T> BackgroundDecoder<T>::~BackgroundDecoder()
+{
+	// The background thread uses this object, so it is always joined before the
+	// object is destroyed. The owner stops the decoder in its shutdown handlers
+	// so that the thread has already exited before the DLL is unloaded.
+	Stop();
+}
+
+template <typename T> void BackgroundDecoder<T>::Start(size_t count, DecodeFunction&& decodeFunction)
+{
+	Stop();
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	states.assign(count, ItemState::Pending);
+	items.resize(count);
+	this->decodeFunction = std::move(decodeFunction);
+	nextIndex = 0;
+	stopRequested = false;
+
+	thread = std::thread(&BackgroundDecoder::DecodeItems, this);
+}
+
+template <typename T> void BackgroundDecoder<T>::Stop()
+{
+	if (thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopRequested = true;
+		}
+
+		thread.join();
+	}
+
+	states.clear();
+	items.clear();
+	decodeFunction = nullptr;
+}
+
+template <typename T> std::unique_ptr<T> BackgroundDecoder<T>::Take(size_t index)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	if (index >= states.size())
+	{
+		return nullptr;
+	}
+
+	itemDecoded.wait(lock, [&] { return states[index] != ItemState::Decoding; });
+
+	states[index] = ItemState::Taken;
+
+	return std::move(items[index]);
+}
+
+template <typename T> void BackgroundDecoder<T>::DecodeItems()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (!stopRequested)
+	{
+		// Skip the items that the game thread took before they were decoded.
+		while (nextIndex < states.size() && states[nextIndex] != ItemState::Pending)
+		{
+			nextIndex++;
+		}
+
+		if (nextIndex >= states.size())
+		{
+			break;
+		}
+
+		const size_t index = nextIndex++;
+		states[index] = ItemState::Decoding;
+
+		lock.unlock();
+		std::unique_ptr<T> item = decodeFunction(index);
+		lock.lock();
+
+		items[index] = std::move(item);
+		states[index] = ItemState::Ready;
+		itemDecoded.notify_all();
+	}
+}
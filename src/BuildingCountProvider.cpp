@@ -20,12 +20,20 @@
  */
 
 #include "BuildingCountProvider.h"
+#include "CityStatsSnapshot.h"
 #include "GlobalPointers.h"
 #include "cISC4FireProtectionSimulator.h"
 #include "cISC4PoliceSimulator.h"
 #include "cISC4ResidentialSimulator.h"
 
 uint32_t BuildingCountProvider::GetBuildingCount(BuildingType type)
+{
+	CityStatsSnapshot& snapshot = CityStatsSnapshot::GetInstance();
+
+	return snapshot.Update() ? snapshot.GetBuildingCount(type) : QueryBuildingCount(type);
+}
+
+uint32_t BuildingCountProvider::QueryBuildingCount(BuildingType type)
 {
 	switch (type)
 	{
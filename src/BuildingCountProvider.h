@@ -24,6 +24,9 @@
 
 namespace BuildingCountProvider
 {
+	// Gets the building count from the CityStatsSnapshot.
 	uint32_t GetBuildingCount(BuildingType type);
+	// Reads the building count from the game's simulators.
+	uint32_t QueryBuildingCount(BuildingType type);
 }
 
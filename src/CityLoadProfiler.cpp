@@ -0,0 +1,235 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CityLoadProfiler.h"
+#include "Logger.h"
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+	constexpr size_t SlowestOrdinanceCount = 10;
+
+	// The histogram buckets are powers of 2 in microseconds, the last bucket
+	// contains everything that is slower.
+	constexpr size_t HistogramBucketCount = 16;
+	constexpr size_t HistogramBarWidth = 40;
+
+	constexpr std::array<const char*, static_cast<size_t>(CityLoadProfiler::Phase::Count)> PhaseNames =
+	{
+		"GetOrdinanceByID",
+		"CustomOrdinance creation and Init",
+		"AddOrdinance",
+		"CustomOrdinance::Read",
+		"ExemplarPropertyHolder::Read",
+		"LoadLocalizedStringResources",
+	};
+
+	double ToMilliseconds(CityLoadProfiler::Clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	size_t GetHistogramBucket(CityLoadProfiler::Clock::duration duration)
+	{
+		const int64_t microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+
+		size_t bucket = 0;
+
+		while (bucket < (HistogramBucketCount - 1) && microseconds >= (int64_t(1) << bucket))
+		{
+			bucket++;
+		}
+
+		return bucket;
+	}
+}
+
+CityLoadProfiler::ScopedTimer::ScopedTimer(Phase phase, uint32_t ordinanceID)
+	: phase(phase),
+	  ordinanceID(ordinanceID),
+	  start(),
+	  enabled(CityLoadProfiler::GetInstance().IsEnabled())
+{
+	if (enabled)
+	{
+		start = Clock::now();
+	}
+}
+
+CityLoadProfiler::ScopedTimer::~ScopedTimer()
+{
+	if (enabled)
+	{
+		CityLoadProfiler::GetInstance().AddSample(phase, ordinanceID, Clock::now() - start);
+	}
+}
+
+CityLoadProfiler& CityLoadProfiler::GetInstance()
+{
+	static CityLoadProfiler instance;
+
+	return instance;
+}
+
+CityLoadProfiler::CityLoadProfiler()
+	: phases(),
+	  enabled(false)
+{
+}
+
+bool CityLoadProfiler::IsEnabled() const
+{
+	return enabled;
+}
+
+void CityLoadProfiler::SetEnabled(bool enabled)
+{
+	this->enabled = enabled;
+
+	if (!enabled)
+	{
+		Reset();
+	}
+}
+
+void CityLoadProfiler::AddSample(Phase phase, uint32_t ordinanceID, Clock::duration elapsed)
+{
+	phases[static_cast<size_t>(phase)].push_back(Sample{ ordinanceID, elapsed });
+}
+
+void CityLoadProfiler::WriteSummary(Logger& logger, Clock::duration postCityInitTime)
+{
+	logger.WriteLineFormatted(
+		LogLevel::Debug,
+		"City load timing, PostCityInit: %.3f ms",
+		ToMilliseconds(postCityInitTime));
+
+	// The per-ordinance totals only include the outer phases, CustomOrdinance::Read
+	// already contains the property holder and localized string times.
+	std::unordered_map<uint32_t, Clock::duration> ordinanceTotals;
+
+	for (size_t i = 0; i < phases.size(); i++)
+	{
+		const std::vector<Sample>& samples = phases[i];
+
+		if (samples.empty())
+		{
+			continue;
+		}
+
+		const Phase phase = static_cast<Phase>(i);
+		const bool nestedPhase = phase == Phase::PropertyHolderRead || phase == Phase::LoadLocalizedStrings;
+
+		Clock::duration total{};
+		Clock::duration maximum{};
+		std::array<uint32_t, HistogramBucketCount> histogram{};
+
+		for (const Sample& sample : samples)
+		{
+			total += sample.elapsed;
+			maximum = std::max(maximum, sample.elapsed);
+			histogram[GetHistogramBucket(sample.elapsed)]++;
+
+			if (!nestedPhase)
+			{
+				ordinanceTotals[sample.ordinanceID] += sample.elapsed;
+			}
+		}
+
+		logger.WriteLineFormatted(
+			LogLevel::Debug,
+			"  %s: %.3f ms, %zu calls, mean %.3f ms, max %.3f ms",
+			PhaseNames[i],
+			ToMilliseconds(total),
+			samples.size(),
+			ToMilliseconds(total) / static_cast<double>(samples.size()),
+			ToMilliseconds(maximum));
+
+		const uint32_t largestBucket = *std::max_element(histogram.begin(), histogram.end());
+
+		for (size_t bucket = 0; bucket < histogram.size(); bucket++)
+		{
+			const uint32_t count = histogram[bucket];
+
+			if (count == 0)
+			{
+				continue;
+			}
+
+			const size_t barLength = std::max<size_t>(1, (static_cast<size_t>(count) * HistogramBarWidth) / largestBucket);
+
+			if (bucket < (HistogramBucketCount - 1))
+			{
+				logger.WriteLineFormatted(
+					LogLevel::Debug,
+					"    < %6llu us: %6u %s",
+					1ULL << bucket,
+					count,
+					std::string(barLength, '#').c_str());
+			}
+			else
+			{
+				logger.WriteLineFormatted(
+					LogLevel::Debug,
+					"    >= %5llu us: %6u %s",
+					1ULL << (bucket - 1),
+					count,
+					std::string(barLength, '#').c_str());
+			}
+		}
+	}
+
+	if (!ordinanceTotals.empty())
+	{
+		std::vector<std::pair<uint32_t, Clock::duration>> slowestOrdinances(ordinanceTotals.begin(), ordinanceTotals.end());
+
+		const size_t count = std::min(slowestOrdinances.size(), SlowestOrdinanceCount);
+
+		std::partial_sort(
+			slowestOrdinances.begin(),
+			slowestOrdinances.begin() + count,
+			slowestOrdinances.end(),
+			[](const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; });
+
+		logger.WriteLine(LogLevel::Debug, "  Slowest ordinances:");
+
+		for (size_t i = 0; i < count; i++)
+		{
+			logger.WriteLineFormatted(
+				LogLevel::Debug,
+				"    0x%08x: %.3f ms",
+				slowestOrdinances[i].first,
+				ToMilliseconds(slowestOrdinances[i].second));
+		}
+	}
+
+	Reset();
+}
+
+void CityLoadProfiler::Reset()
+{
+	for (std::vector<Sample>& samples : phases)
+	{
+		samples.clear();
+	}
+}
@@ -0,0 +1,94 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+class Logger;
+
+// Collects the per-ordinance timing information for the plugin's part of a city load.
+// The profiler is disabled unless the Debug log level is enabled, the scoped
+// timers only check a flag when it is disabled.
+//
+// The samples are collected between the city shutdown and the next city's PostCityInit
+// message, this covers the game's deserialization of the saved ordinances.
+class CityLoadProfiler
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	enum class Phase : uint32_t
+	{
+		GetOrdinanceByID = 0,
+		CreateOrdinance,
+		AddOrdinance,
+		Deserialize,
+		PropertyHolderRead,
+		LoadLocalizedStrings,
+		Count
+	};
+
+	// Adds the time between the constructor and destructor to a phase.
+	class ScopedTimer
+	{
+	public:
+		ScopedTimer(Phase phase, uint32_t ordinanceID);
+		~ScopedTimer();
+
+		ScopedTimer(const ScopedTimer& other) = delete;
+		ScopedTimer& operator=(const ScopedTimer& other) = delete;
+
+	private:
+		Phase phase;
+		uint32_t ordinanceID;
+		Clock::time_point start;
+		bool enabled;
+	};
+
+	static CityLoadProfiler& GetInstance();
+
+	bool IsEnabled() const;
+	void SetEnabled(bool enabled);
+
+	void AddSample(Phase phase, uint32_t ordinanceID, Clock::duration elapsed);
+
+	// Writes the phase statistics, histograms and the slowest ordinances to
+	// the log and removes the samples.
+	// The total time is the time that PostCityInit spent in the plugin.
+	void WriteSummary(Logger& logger, Clock::duration postCityInitTime);
+
+	void Reset();
+
+private:
+	CityLoadProfiler();
+
+	struct Sample
+	{
+		uint32_t ordinanceID;
+		Clock::duration elapsed;
+	};
+
+	std::array<std::vector<Sample>, static_cast<size_t>(Phase::Count)> phases;
+	bool enabled;
+};
@@ -0,0 +1,47 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CityMetric.h"
+
+bool CityMetricUtil::TryGetRCIGroupMetric(uint32_t demandID, CityMetric& metric)
+{
+	for (size_t i = 0; i < RCIGroups.size(); i++)
+	{
+		if (static_cast<uint32_t>(RCIGroups[i]) == demandID)
+		{
+			metric = static_cast<CityMetric>(FirstRCIGroupMetric + i);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool CityMetricUtil::TryGetBuildingCountMetric(BuildingType type, CityMetric& metric)
+{
+	if (static_cast<size_t>(type) >= BuildingTypeCount)
+	{
+		return false;
+	}
+
+	metric = static_cast<CityMetric>(FirstBuildingCountMetric + static_cast<size_t>(type));
+	return true;
+}
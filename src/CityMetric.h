@@ -0,0 +1,91 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "BuildingType.h"
+#include "RCIGroup.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// The city statistics that the availability conditions and monthly income
+// factors use.
+enum class CityMetric : uint8_t
+{
+	TotalResidentialPopulation = 0,
+	Res1Population,
+	Res2Population,
+	Res3Population,
+	Cs1Population,
+	Cs2Population,
+	Cs3Population,
+	Co2Population,
+	Co3Population,
+	IRPopulation,
+	IDPopulation,
+	IMPopulation,
+	IHTPopulation,
+	FireStationCount,
+	HospitalCount,
+	JailCount,
+	PoliceStationCount,
+	SchoolCount,
+	SimYear,
+	Count
+};
+
+namespace CityMetricUtil
+{
+	static constexpr size_t MetricCount = static_cast<size_t>(CityMetric::Count);
+
+	static constexpr size_t FirstRCIGroupMetric = static_cast<size_t>(CityMetric::Res1Population);
+	static constexpr size_t FirstBuildingCountMetric = static_cast<size_t>(CityMetric::FireStationCount);
+
+	// The RCI groups in the same order as the population metrics.
+	static constexpr std::array<RCIGroup, 12> RCIGroups =
+	{
+		RCIGroup::Res1,
+		RCIGroup::Res2,
+		RCIGroup::Res3,
+		RCIGroup::Cs1,
+		RCIGroup::Cs2,
+		RCIGroup::Cs3,
+		RCIGroup::Co2,
+		RCIGroup::Co3,
+		RCIGroup::IR,
+		RCIGroup::ID,
+		RCIGroup::IM,
+		RCIGroup::IHT,
+	};
+
+	static constexpr size_t BuildingTypeCount = static_cast<size_t>(BuildingType::School) + 1;
+
+	static_assert(FirstRCIGroupMetric + RCIGroups.size() == FirstBuildingCountMetric);
+	static_assert(FirstBuildingCountMetric + BuildingTypeCount == static_cast<size_t>(CityMetric::SimYear));
+
+	// Gets the population metric for a demand id.
+	// Returns false if the demand id is not one of the RCIGroup values.
+	bool TryGetRCIGroupMetric(uint32_t demandID, CityMetric& metric);
+
+	// Gets the count metric for a building type.
+	// Returns false if the type is not one of the BuildingType values.
+	bool TryGetBuildingCountMetric(BuildingType type, CityMetric& metric);
+}
@@ -0,0 +1,147 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CityStatsSnapshot.h"
+
+CityStatsSnapshot& CityStatsSnapshot::GetInstance()
+{
+	static CityStatsSnapshot instance;
+
+	return instance;
+}
+
+CityStatsSnapshot::CityStatsSnapshot()
+	: source(nullptr),
+	  simDate(),
+	  totalResidentialPopulation(0),
+	  rciGroupPopulations(),
+	  buildingCounts(),
+	  metricValues(),
+	  tick(0),
+	  filledTick(0),
+	  epoch(0),
+	  valid(false)
+{
+}
+
+void CityStatsSnapshot::SetSource(const ICityStatsSource* newSource)
+{
+	source = newSource;
+	Invalidate();
+}
+
+bool CityStatsSnapshot::Update()
+{
+	SimDate date{};
+
+	if (!source || !source->GetSimDate(date.year, date.month, date.day))
+	{
+		return false;
+	}
+
+	if (!valid || filledTick != tick || date != simDate)
+	{
+		Fill(date);
+	}
+
+	return true;
+}
+
+void CityStatsSnapshot::AdvanceTick()
+{
+	tick++;
+}
+
+void CityStatsSnapshot::Invalidate()
+{
+	// The values are reset so that a snapshot without a city reports zero.
+	simDate = SimDate();
+	totalResidentialPopulation = 0;
+	rciGroupPopulations.fill(0);
+	buildingCounts.fill(0);
+	metricValues.fill(0.0);
+	valid = false;
+}
+
+uint32_t CityStatsSnapshot::GetEpoch() const
+{
+	return epoch;
+}
+
+uint32_t CityStatsSnapshot::GetSimYear() const
+{
+	return simDate.year;
+}
+
+int32_t CityStatsSnapshot::GetTotalResidentialPopulation() const
+{
+	return totalResidentialPopulation;
+}
+
+bool CityStatsSnapshot::TryGetRCIGroupPopulation(uint32_t demandID, int32_t& population) const
+{
+	CityMetric metric{};
+
+	if (!CityMetricUtil::TryGetRCIGroupMetric(demandID, metric))
+	{
+		return false;
+	}
+
+	population = rciGroupPopulations[static_cast<size_t>(metric) - CityMetricUtil::FirstRCIGroupMetric];
+	return true;
+}
+
+uint32_t CityStatsSnapshot::GetBuildingCount(BuildingType type) const
+{
+	const size_t index = static_cast<size_t>(type);
+
+	return index < buildingCounts.size() ? buildingCounts[index] : 0;
+}
+
+const std::array<double, CityMetricUtil::MetricCount>& CityStatsSnapshot::GetMetricValues() const
+{
+	return metricValues;
+}
+
+void CityStatsSnapshot::Fill(const SimDate& date)
+{
+	simDate = date;
+	metricValues[static_cast<size_t>(CityMetric::SimYear)] = static_cast<double>(date.year);
+
+	totalResidentialPopulation = source->GetTotalResidentialPopulation();
+	metricValues[static_cast<size_t>(CityMetric::TotalResidentialPopulation)] = static_cast<double>(totalResidentialPopulation);
+
+	for (size_t i = 0; i < rciGroupPopulations.size(); i++)
+	{
+		rciGroupPopulations[i] = source->GetRCIGroupPopulation(static_cast<uint32_t>(CityMetricUtil::RCIGroups[i]));
+		metricValues[CityMetricUtil::FirstRCIGroupMetric + i] = static_cast<double>(rciGroupPopulations[i]);
+	}
+
+	for (size_t i = 0; i < buildingCounts.size(); i++)
+	{
+		buildingCounts[i] = source->GetBuildingCount(static_cast<BuildingType>(i));
+		metricValues[CityMetricUtil::FirstBuildingCountMetric + i] = static_cast<double>(buildingCounts[i]);
+	}
+
+	filledTick = tick;
+	epoch++;
+	valid = true;
+}
@@ -0,0 +1,93 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "BuildingType.h"
+#include "CityMetric.h"
+#include "CityStatsSource.h"
+#include <array>
+#include <cstdint>
+
+// A copy of the city statistics that the ordinances use.
+// The game queries every ordinance once per pass of its ordinance simulator,
+// the statistics are read from the game's simulators once per tick of the
+// game's framework instead of once per ordinance. The snapshot is filled when
+// it is first read after a new tick has started or the simulation date has
+// changed, see CityStatsTickService.
+// The epoch is incremented every time the snapshot is filled, this allows the
+// users of the snapshot to detect that the values have changed.
+// The snapshot is invalidated when a city is loaded or unloaded, and is only
+// used on the game thread.
+class CityStatsSnapshot
+{
+public:
+	static CityStatsSnapshot& GetInstance();
+
+	// Sets the source of the statistics, the snapshot is invalidated.
+	// The source must remain valid until it is replaced.
+	void SetSource(const ICityStatsSource* source);
+
+	// Fills the snapshot if it is not valid, a new tick has started or the
+	// simulation date has changed.
+	// Returns false if a city is not loaded or the source has not been set, the
+	// values are zero in that case.
+	bool Update();
+	// Starts a new tick, the snapshot is filled again when it is next updated.
+	void AdvanceTick();
+	void Invalidate();
+
+	uint32_t GetEpoch() const;
+
+	uint32_t GetSimYear() const;
+	int32_t GetTotalResidentialPopulation() const;
+	// Returns false if the demand id is not one of the RCIGroup values.
+	bool TryGetRCIGroupPopulation(uint32_t demandID, int32_t& population) const;
+	uint32_t GetBuildingCount(BuildingType type) const;
+
+	// Gets the metric values in the CityMetric order.
+	const std::array<double, CityMetricUtil::MetricCount>& GetMetricValues() const;
+
+private:
+	struct SimDate
+	{
+		uint32_t year;
+		uint32_t month;
+		uint32_t day;
+
+		bool operator==(const SimDate& other) const = default;
+	};
+
+	CityStatsSnapshot();
+
+	void Fill(const SimDate& date);
+
+	const ICityStatsSource* source;
+	SimDate simDate;
+	int32_t totalResidentialPopulation;
+	std::array<int32_t, CityMetricUtil::RCIGroups.size()> rciGroupPopulations;
+	std::array<uint32_t, CityMetricUtil::BuildingTypeCount> buildingCounts;
+	std::array<double, CityMetricUtil::MetricCount> metricValues;
+	uint32_t tick;
+	// The tick that the snapshot was filled in.
+	uint32_t filledTick;
+	uint32_t epoch;
+	bool valid;
+};
@@ -0,0 +1,59 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CityStatsSource.h"
+#include "BuildingCountProvider.h"
+#include "cISC4Simulator.h"
+#include "GlobalPointers.h"
+#include "PopulationProvider.h"
+
+const GameCityStatsSource& GameCityStatsSource::GetInstance()
+{
+	static const GameCityStatsSource instance;
+
+	return instance;
+}
+
+bool GameCityStatsSource::GetSimDate(uint32_t& year, uint32_t& month, uint32_t& day) const
+{
+	if (!spSimulator)
+	{
+		return false;
+	}
+
+	spSimulator->GetSimDate(&year, &month, &day, nullptr, nullptr);
+	return true;
+}
+
+int32_t GameCityStatsSource::GetTotalResidentialPopulation() const
+{
+	return PopulationProvider::QueryTotalResidentialPopulation();
+}
+
+int32_t GameCityStatsSource::GetRCIGroupPopulation(uint32_t demandID) const
+{
+	return PopulationProvider::QueryRCIGroupPopulation(demandID);
+}
+
+uint32_t GameCityStatsSource::GetBuildingCount(BuildingType type) const
+{
+	return BuildingCountProvider::QueryBuildingCount(type);
+}
@@ -0,0 +1,52 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "BuildingType.h"
+#include <cstdint>
+
+// The city statistics that are copied into the CityStatsSnapshot.
+// This allows the snapshot to be tested without the game's simulators.
+class ICityStatsSource
+{
+public:
+	virtual ~ICityStatsSource() = default;
+
+	// Returns false if a city is not loaded.
+	virtual bool GetSimDate(uint32_t& year, uint32_t& month, uint32_t& day) const = 0;
+
+	virtual int32_t GetTotalResidentialPopulation() const = 0;
+	virtual int32_t GetRCIGroupPopulation(uint32_t demandID) const = 0;
+	virtual uint32_t GetBuildingCount(BuildingType type) const = 0;
+};
+
+// The ICityStatsSource implementation that reads the values from the game's simulators.
+class GameCityStatsSource final : public ICityStatsSource
+{
+public:
+	static const GameCityStatsSource& GetInstance();
+
+	bool GetSimDate(uint32_t& year, uint32_t& month, uint32_t& day) const override;
+
+	int32_t GetTotalResidentialPopulation() const override;
+	int32_t GetRCIGroupPopulation(uint32_t demandID) const override;
+	uint32_t GetBuildingCount(BuildingType type) const override;
+};
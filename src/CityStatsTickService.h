@@ -20,20 +20,15 @@
  */
 
 #pragma once
-#include "cRZBaseUnknown.h"
-#include "cIGZPersistResourceKeyFilter.h"
+#include "cRZBaseSystemService.h"
 
-class PersistResourceKeyFilterByType : public cRZBaseUnknown, public cIGZPersistResourceKeyFilter
+// Starts a new CityStatsSnapshot tick on every tick of the game's framework.
+// The game simulates the city on the same thread as the framework ticks, the
+// ordinances read the snapshot that was filled in the current tick.
+class CityStatsTickService final : public cRZBaseSystemService
 {
 public:
-	PersistResourceKeyFilterByType(uint32_t type);
+	CityStatsTickService();
 
-	bool QueryInterface(uint32_t riid, void** ppvObj) override;
-	uint32_t AddRef() override;
-	uint32_t Release() override;
-	bool IsKeyIncluded(cGZPersistResourceKey const& key) override;
-
-private:
-	uint32_t type;
+	bool OnTick(uint32_t unknown1) override;
 };
-
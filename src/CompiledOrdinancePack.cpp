@@ -0,0 +1,310 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CompiledOrdinancePack.h"
+#include "HashUtil.h"
+#include "frozen/unordered_map.h"
+#include <cstring>
+#include <utility>
+
+using namespace CompiledOrdinancePackFormat;
+
+namespace
+{
+	uint32_t ReadUint32(const uint8_t* data)
+	{
+		return static_cast<uint32_t>(data[0])
+			| (static_cast<uint32_t>(data[1]) << 8)
+			| (static_cast<uint32_t>(data[2]) << 16)
+			| (static_cast<uint32_t>(data[3]) << 24);
+	}
+
+	uint64_t ReadUint64(const uint8_t* data)
+	{
+		return static_cast<uint64_t>(ReadUint32(data))
+			| (static_cast<uint64_t>(ReadUint32(data + 4)) << 32);
+	}
+
+	bool IsInRange(size_t fileSize, uint64_t offset, uint64_t length)
+	{
+		return offset <= fileSize && length <= fileSize - offset;
+	}
+
+	constexpr auto MakePropertySlotItems()
+	{
+		std::array<std::pair<uint32_t, uint8_t>, PropertySchema.size()> items{};
+
+		for (size_t i = 0; i < PropertySchema.size(); i++)
+		{
+			items[i] = std::pair(PropertySchema[i].id, static_cast<uint8_t>(i));
+		}
+
+		return items;
+	}
+
+	static constexpr auto PropertySlots = frozen::make_unordered_map(MakePropertySlotItems());
+}
+
+CompiledOrdinancePack::CompiledOrdinancePack()
+	: records(),
+	  stringPool(),
+	  recordCount(0)
+{
+}
+
+uint64_t CompiledOrdinancePack::GetSchemaHash()
+{
+	uint64_t hash = HashUtil::Fnv1a64OffsetBasis;
+
+	for (const PropertySchemaItem& item : PropertySchema)
+	{
+		const uint32_t kind = static_cast<uint32_t>(item.kind);
+
+		hash = HashUtil::Fnv1a64(&item.id, sizeof(item.id), hash);
+		hash = HashUtil::Fnv1a64(&kind, sizeof(kind), hash);
+	}
+
+	return hash;
+}
+
+bool CompiledOrdinancePack::Open(const std::filesystem::path& path)
+{
+	Close();
+
+	if (!file.Open(path))
+	{
+		return false;
+	}
+
+	const std::span<const uint8_t> data = file.GetData();
+
+	if (data.size() < HeaderSize)
+	{
+		Close();
+		return false;
+	}
+
+	const uint8_t* header = data.data();
+
+	const uint32_t signature = ReadUint32(header);
+	const uint32_t version = ReadUint32(header + 4);
+	const uint64_t schemaHash = ReadUint64(header + 8);
+	const uint32_t count = ReadUint32(header + 16);
+	const uint32_t recordSize = ReadUint32(header + 20);
+	const uint32_t recordOffset = ReadUint32(header + 24);
+	const uint32_t stringPoolOffset = ReadUint32(header + 28);
+	const uint32_t stringPoolSize = ReadUint32(header + 32);
+
+	if (signature != Signature
+		|| version != Version
+		|| schemaHash != GetSchemaHash()
+		|| recordSize != RecordSize
+		|| !IsInRange(data.size(), recordOffset, static_cast<uint64_t>(count) * RecordSize)
+		|| !IsInRange(data.size(), stringPoolOffset, stringPoolSize))
+	{
+		Close();
+		return false;
+	}
+
+	records = data.subspan(recordOffset, static_cast<size_t>(count) * RecordSize);
+	stringPool = data.subspan(stringPoolOffset, stringPoolSize);
+	recordCount = count;
+
+	// The string values are validated when the pack is opened, so that the
+	// property reads do not have to check the string pool bounds.
+	for (uint32_t i = 0; i < recordCount; i++)
+	{
+		const uint8_t* record = records.data() + (static_cast<size_t>(i) * RecordSize);
+		const uint64_t presentFlags = ReadUint64(record + 16);
+
+		for (size_t slot = 0; slot < PropertySchema.size(); slot++)
+		{
+			if ((presentFlags & (1ULL << slot)) != 0 && PropertySchema[slot].kind == ValueKind::String)
+			{
+				const uint8_t* value = record + RecordHeaderSize + (slot * RecordValueSize);
+
+				if (!IsInRange(stringPool.size(), ReadUint32(value), ReadUint32(value + 4)))
+				{
+					Close();
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+void CompiledOrdinancePack::Close()
+{
+	file.Close();
+	records = std::span<const uint8_t>();
+	stringPool = std::span<const uint8_t>();
+	recordCount = 0;
+}
+
+bool CompiledOrdinancePack::IsOpen() const
+{
+	return file.IsOpen();
+}
+
+uint32_t CompiledOrdinancePack::GetRecordCount() const
+{
+	return recordCount;
+}
+
+CompiledOrdinancePack::Key CompiledOrdinancePack::GetKey(uint32_t index) const
+{
+	const uint8_t* record = records.data() + (static_cast<size_t>(index) * RecordSize);
+
+	Key key{};
+	key.type = ReadUint32(record);
+	key.group = ReadUint32(record + 4);
+	key.instance = ReadUint32(record + 8);
+
+	return key;
+}
+
+bool CompiledOrdinancePack::GetPropertyValue(uint32_t index, uint32_t id, uint32_t& value) const
+{
+	int64_t temp = 0;
+
+	if (GetPropertyValue(index, id, temp))
+	{
+		value = static_cast<uint32_t>(temp);
+		return true;
+	}
+
+	return false;
+}
+
+bool CompiledOrdinancePack::GetPropertyValue(uint32_t index, uint32_t id, int64_t& value) const
+{
+	ValueKind kind{};
+	const uint8_t* data = FindValue(index, id, kind);
+
+	if (data)
+	{
+		if (kind == ValueKind::Int64)
+		{
+			value = static_cast<int64_t>(ReadUint64(data));
+			return true;
+		}
+		else if (kind == ValueKind::Uint32)
+		{
+			value = ReadUint32(data);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool CompiledOrdinancePack::GetPropertyValue(uint32_t index, uint32_t id, float& value) const
+{
+	ValueKind kind{};
+	const uint8_t* data = FindValue(index, id, kind);
+
+	if (data && kind == ValueKind::Float32)
+	{
+		const uint32_t bits = ReadUint32(data);
+		std::memcpy(&value, &bits, sizeof(value));
+		return true;
+	}
+
+	return false;
+}
+
+bool CompiledOrdinancePack::GetPropertyValue(uint32_t index, uint32_t id, bool& value) const
+{
+	ValueKind kind{};
+	const uint8_t* data = FindValue(index, id, kind);
+
+	if (data && kind == ValueKind::Bool)
+	{
+		value = ReadUint32(data) != 0;
+		return true;
+	}
+
+	return false;
+}
+
+bool CompiledOrdinancePack::GetPropertyValue(uint32_t index, uint32_t id, std::string_view& value) const
+{
+	ValueKind kind{};
+	const uint8_t* data = FindValue(index, id, kind);
+
+	if (data && kind == ValueKind::String)
+	{
+		const uint32_t offset = ReadUint32(data);
+		const uint32_t length = ReadUint32(data + 4);
+
+		value = std::string_view(reinterpret_cast<const char*>(stringPool.data() + offset), length);
+		return true;
+	}
+
+	return false;
+}
+
+bool CompiledOrdinancePack::GetStringResourceKey(
+	uint32_t index,
+	uint32_t id,
+	uint32_t& group,
+	uint32_t& instance) const
+{
+	ValueKind kind{};
+	const uint8_t* data = FindValue(index, id, kind);
+
+	if (data && kind == ValueKind::StringResourceKey)
+	{
+		group = ReadUint32(data);
+		instance = ReadUint32(data + 4);
+		return true;
+	}
+
+	return false;
+}
+
+const uint8_t* CompiledOrdinancePack::FindValue(uint32_t index, uint32_t id, ValueKind& kind) const
+{
+	if (index >= recordCount)
+	{
+		return nullptr;
+	}
+
+	const auto it = PropertySlots.find(id);
+
+	if (it == PropertySlots.end())
+	{
+		return nullptr;
+	}
+
+	const size_t slot = it->second;
+	const uint8_t* record = records.data() + (static_cast<size_t>(index) * RecordSize);
+
+	if ((ReadUint64(record + 16) & (1ULL << slot)) == 0)
+	{
+		return nullptr;
+	}
+
+	kind = PropertySchema[slot].kind;
+	return record + RecordHeaderSize + (slot * RecordValueSize);
+}
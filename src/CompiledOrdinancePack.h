@@ -0,0 +1,85 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "CompiledOrdinancePackFormat.h"
+#include "MemoryMappedFile.h"
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+// A read-only compiled ordinance pack.
+// The pack stores the decoded values of the properties that are used by the
+// ordinance definitions, one fixed-size record for each ordinance exemplar with
+// the strings in an offset-indexed string pool.
+// The file is memory mapped and the values are read in place, so the ordinance
+// definitions can be created without loading or parsing the exemplars.
+// See CompiledOrdinancePackFormat.h for the file layout.
+class CompiledOrdinancePack
+{
+public:
+	struct Key
+	{
+		uint32_t type;
+		uint32_t group;
+		uint32_t instance;
+	};
+
+	CompiledOrdinancePack();
+
+	// Gets the hash of the property schema that is stored in the pack header.
+	static uint64_t GetSchemaHash();
+
+	// Opens the pack and validates the header, record table and string pool.
+	// Returns false if the file is not a valid pack, a pack that was written with
+	// a different format version or property schema is also rejected.
+	bool Open(const std::filesystem::path& path);
+	void Close();
+
+	bool IsOpen() const;
+
+	uint32_t GetRecordCount() const;
+	Key GetKey(uint32_t index) const;
+
+	// Returns false if the record does not have a value for the property.
+	// Int64 and Uint32 values are converted to the requested integer type, the
+	// other values must have the requested type.
+	bool GetPropertyValue(uint32_t index, uint32_t id, uint32_t& value) const;
+	bool GetPropertyValue(uint32_t index, uint32_t id, int64_t& value) const;
+	bool GetPropertyValue(uint32_t index, uint32_t id, float& value) const;
+	bool GetPropertyValue(uint32_t index, uint32_t id, bool& value) const;
+	bool GetPropertyValue(uint32_t index, uint32_t id, std::string_view& value) const;
+	bool GetStringResourceKey(uint32_t index, uint32_t id, uint32_t& group, uint32_t& instance) const;
+
+private:
+	// Gets the value of the property, or nullptr if the record does not have a
+	// value for the property.
+	const uint8_t* FindValue(
+		uint32_t index,
+		uint32_t id,
+		CompiledOrdinancePackFormat::ValueKind& kind) const;
+
+	MemoryMappedFile file;
+	std::span<const uint8_t> records;
+	std::span<const uint8_t> stringPool;
+	uint32_t recordCount;
+};
@@ -0,0 +1,136 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "OrdiancePropertyIDs.h"
+#include <array>
+#include <cstdint>
+
+// The file layout of a compiled ordinance pack, see CompiledOrdinancePack.h.
+// All of the values are little-endian.
+namespace CompiledOrdinancePackFormat
+{
+	static constexpr uint32_t Signature = 0x4B43504F; // OPCK
+	static constexpr uint32_t Version = 1;
+
+	// The type of the value that is stored for a property.
+	// The value type is the type that the ordinance definition reads.
+	enum class ValueKind : uint32_t
+	{
+		// These values must not be renumbered because
+		// they are stored in the pack files.
+
+		Int64 = 0,
+		Uint32 = 1,
+		Float32 = 2,
+		Bool = 3,
+		// A string pool offset and length.
+		String = 4,
+		// The group and instance ids of a string resource key.
+		StringResourceKey = 5,
+	};
+
+	struct PropertySchemaItem
+	{
+		uint32_t id;
+		ValueKind kind;
+	};
+
+	// The properties that are stored in a pack record, each property uses the
+	// value slot at its index in the schema.
+	// A hash of the schema is stored in the pack header, so that packs which
+	// were written with a different schema are rejected.
+	static constexpr std::array<PropertySchemaItem, 46> PropertySchema =
+	{
+		PropertySchemaItem{ kOrdinanceNameKey, ValueKind::StringResourceKey },
+		PropertySchemaItem{ kOrdinanceName, ValueKind::String },
+		PropertySchemaItem{ kOrdinanceDescriptionKey, ValueKind::StringResourceKey },
+		PropertySchemaItem{ kOrdinanceDescription, ValueKind::String },
+		PropertySchemaItem{ kOrdinanceEnactmentIncome, ValueKind::Int64 },
+		PropertySchemaItem{ kOrdinanceRetracmentIncome, ValueKind::Int64 },
+		PropertySchemaItem{ kOrdinancemMonthlyConstantIncome, ValueKind::Int64 },
+		PropertySchemaItem{ kOrdinanceIsIncome, ValueKind::Bool },
+		PropertySchemaItem{ kOrdinanceAvailabilityLuaFunction, ValueKind::String },
+		PropertySchemaItem{ kOrdinanceAvailabilityGameYear, ValueKind::Uint32 },
+		PropertySchemaItem{ kOrdinanceAvailabilityMinFireStationCount, ValueKind::Uint32 },
+		PropertySchemaItem{ kOrdinanceAvailabilityMinHospitalCount, ValueKind::Uint32 },
+		PropertySchemaItem{ kOrdinanceAvailabilityMinJailCount, ValueKind::Uint32 },
+		PropertySchemaItem{ kOrdinanceAvailabilityMinPoliceStationCount, ValueKind::Uint32 },
+		PropertySchemaItem{ kOrdinanceAvailabilityMinSchoolBuildingCount, ValueKind::Uint32 },
+		PropertySchemaItem{ kOrdinanceAvailabilityMinPopulationResLowWealth, ValueKind::Uint32 },
+		PropertySchemaItem{ kOrdinanceAvailabilityMinPopulationResMediumWealth, ValueKind::Uint32 },
+		PropertySchemaItem{ kOrdinanceAvailabilityMinPopulationResHighWealth, ValueKind::Uint32 },
+		PropertySchemaItem{ kOrdinanceAvailabilityMinPopulationCsLowWealth, ValueKind::Uint32 },
+		PropertySchemaItem{ kOrdinanceAvailabilityMinPopulationCsMediumWealth, ValueKind::Uint32 },
+		PropertySchemaItem{ kOrdinanceAvailabilityMinPopulationCsHighWealth, ValueKind::Uint32 },
+		PropertySchemaItem{ kOrdinanceAvailabilityMinPopulationCoMediumWealth, ValueKind::Uint32 },
+		PropertySchemaItem{ kOrdinanceAvailabilityMinPopulationCoHighWealth, ValueKind::Uint32 },
+		PropertySchemaItem{ kOrdinanceAvailabilityMinPopulationIR, ValueKind::Uint32 },
+		PropertySchemaItem{ kOrdinanceAvailabilityMinPopulationID, ValueKind::Uint32 },
+		PropertySchemaItem{ kOrdinanceAvailabilityMinPopulationIM, ValueKind::Uint32 },
+		PropertySchemaItem{ kOrdinanceAvailabilityMinPopulationIHT, ValueKind::Uint32 },
+		PropertySchemaItem{ kOrdinanceMonthlyIncomeFactorLuaFunction, ValueKind::String },
+		PropertySchemaItem{ kOrdinanceMonthlyIncomeFactorResTotalPopulation, ValueKind::Float32 },
+		PropertySchemaItem{ kOrdinanceMonthlyIncomeFactorResLowWealthPopulation, ValueKind::Float32 },
+		PropertySchemaItem{ kOrdinanceMonthlyIncomeFactorResMediumWealthPopulation, ValueKind::Float32 },
+		PropertySchemaItem{ kOrdinanceMonthlyIncomeFactorResHighWealthPopulation, ValueKind::Float32 },
+		PropertySchemaItem{ kOrdinanceMonthlyIncomeFactorCsLowWealthPopulation, ValueKind::Float32 },
+		PropertySchemaItem{ kOrdinanceMonthlyIncomeFactorCsMediumWealthPopulation, ValueKind::Float32 },
+		PropertySchemaItem{ kOrdinanceMonthlyIncomeFactorCsHighWealthPopulation, ValueKind::Float32 },
+		PropertySchemaItem{ kOrdinanceMonthlyIncomeFactorCoMediumWealthPopulation, ValueKind::Float32 },
+		PropertySchemaItem{ kOrdinanceMonthlyIncomeFactorCoHighWealthPopulation, ValueKind::Float32 },
+		PropertySchemaItem{ kOrdinanceMonthlyIncomeFactorIRPopulation, ValueKind::Float32 },
+		PropertySchemaItem{ kOrdinanceMonthlyIncomeFactorIDPopulation, ValueKind::Float32 },
+		PropertySchemaItem{ kOrdinanceMonthlyIncomeFactorIMPopulation, ValueKind::Float32 },
+		PropertySchemaItem{ kOrdinanceMonthlyIncomeFactorIHTPopulation, ValueKind::Float32 },
+		PropertySchemaItem{ kOrdinanceMonthlyIncomeFactorFireStationCount, ValueKind::Float32 },
+		PropertySchemaItem{ kOrdinanceMonthlyIncomeFactorHospitalCount, ValueKind::Float32 },
+		PropertySchemaItem{ kOrdinanceMonthlyIncomeFactorJailCount, ValueKind::Float32 },
+		PropertySchemaItem{ kOrdinanceMonthlyIncomeFactorPoliceStationCount, ValueKind::Float32 },
+		PropertySchemaItem{ kOrdinanceMonthlyIncomeFactorSchoolBuildingCount, ValueKind::Float32 },
+	};
+
+	// The present flags of a record are stored in a 64-bit mask.
+	static_assert(PropertySchema.size() <= 64);
+
+	// The header layout:
+	// 0  - signature
+	// 4  - version
+	// 8  - schema hash (64-bit)
+	// 16 - record count
+	// 20 - record size
+	// 24 - record table offset
+	// 28 - string pool offset
+	// 32 - string pool size
+	// 36 - reserved
+	static constexpr uint32_t HeaderSize = 40;
+
+	// The record layout:
+	// 0  - exemplar type id
+	// 4  - exemplar group id
+	// 8  - exemplar instance id
+	// 12 - reserved
+	// 16 - present flags, bit N is set when schema property N has a value (64-bit)
+	// 24 - the property values, 8 bytes for each schema property
+	static constexpr uint32_t RecordHeaderSize = 24;
+	static constexpr uint32_t RecordValueSize = 8;
+	static constexpr uint32_t RecordSize = RecordHeaderSize + (RecordValueSize * PropertySchema.size());
+}
@@ -0,0 +1,229 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CompiledOrdinancePackWriter.h"
+#include "CompiledOrdinancePack.h"
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+using namespace CompiledOrdinancePackFormat;
+
+namespace
+{
+	void WriteUint32(uint8_t* data, uint32_t value)
+	{
+		data[0] = static_cast<uint8_t>(value);
+		data[1] = static_cast<uint8_t>(value >> 8);
+		data[2] = static_cast<uint8_t>(value >> 16);
+		data[3] = static_cast<uint8_t>(value >> 24);
+	}
+
+	void WriteUint64(uint8_t* data, uint64_t value)
+	{
+		WriteUint32(data, static_cast<uint32_t>(value));
+		WriteUint32(data + 4, static_cast<uint32_t>(value >> 32));
+	}
+}
+
+CompiledOrdinancePackWriter::CompiledOrdinancePackWriter()
+	: records(),
+	  stringPool(),
+	  stringOffsets(),
+	  recordCount(0)
+{
+}
+
+bool CompiledOrdinancePackWriter::Add(
+	uint32_t type,
+	uint32_t group,
+	uint32_t instance,
+	const ExemplarPropertyTable& properties)
+{
+	if (properties.IsEmpty() || properties.HasParentCohort())
+	{
+		return false;
+	}
+
+	std::array<uint8_t, RecordSize> record{};
+	uint64_t presentFlags = 0;
+
+	WriteUint32(record.data(), type);
+	WriteUint32(record.data() + 4, group);
+	WriteUint32(record.data() + 8, instance);
+
+	for (size_t slot = 0; slot < PropertySchema.size(); slot++)
+	{
+		const PropertySchemaItem& item = PropertySchema[slot];
+		uint8_t* value = record.data() + RecordHeaderSize + (slot * RecordValueSize);
+		bool present = false;
+
+		switch (item.kind)
+		{
+		case ValueKind::Int64:
+		{
+			int64_t temp = 0;
+			present = properties.GetPropertyValue(item.id, temp);
+			WriteUint64(value, static_cast<uint64_t>(temp));
+			break;
+		}
+		case ValueKind::Uint32:
+		{
+			uint32_t temp = 0;
+			present = properties.GetPropertyValue(item.id, temp);
+			WriteUint32(value, temp);
+			break;
+		}
+		case ValueKind::Float32:
+		{
+			float temp = 0.0f;
+			present = properties.GetPropertyValue(item.id, temp);
+
+			uint32_t bits = 0;
+			std::memcpy(&bits, &temp, sizeof(bits));
+			WriteUint32(value, bits);
+			break;
+		}
+		case ValueKind::Bool:
+		{
+			bool temp = false;
+			present = properties.GetPropertyValue(item.id, temp);
+			WriteUint32(value, temp ? 1 : 0);
+			break;
+		}
+		case ValueKind::String:
+		{
+			std::string_view temp;
+			present = properties.GetPropertyValue(item.id, temp);
+
+			if (present)
+			{
+				WriteUint32(value, AddString(temp));
+				WriteUint32(value + 4, static_cast<uint32_t>(temp.size()));
+			}
+			break;
+		}
+		case ValueKind::StringResourceKey:
+		{
+			// The string resource key is a TGI, the type is not used.
+			std::array<uint32_t, 3> tgi{};
+			present = properties.GetPropertyValues(item.id, tgi);
+			WriteUint32(value, tgi[1]);
+			WriteUint32(value + 4, tgi[2]);
+			break;
+		}
+		}
+
+		if (present)
+		{
+			presentFlags |= 1ULL << slot;
+		}
+	}
+
+	WriteUint64(record.data() + 16, presentFlags);
+
+	records.insert(records.end(), record.begin(), record.end());
+	recordCount++;
+
+	return true;
+}
+
+void CompiledOrdinancePackWriter::Clear()
+{
+	records.clear();
+	stringPool.clear();
+	stringOffsets.clear();
+	recordCount = 0;
+}
+
+uint32_t CompiledOrdinancePackWriter::GetRecordCount() const
+{
+	return recordCount;
+}
+
+bool CompiledOrdinancePackWriter::Save(const std::filesystem::path& path) const
+{
+	const uint64_t stringPoolOffset = static_cast<uint64_t>(HeaderSize) + records.size();
+
+	if (stringPoolOffset + stringPool.size() > std::numeric_limits<uint32_t>::max())
+	{
+		return false;
+	}
+
+	std::array<uint8_t, HeaderSize> header{};
+
+	WriteUint32(header.data(), Signature);
+	WriteUint32(header.data() + 4, Version);
+	WriteUint64(header.data() + 8, CompiledOrdinancePack::GetSchemaHash());
+	WriteUint32(header.data() + 16, recordCount);
+	WriteUint32(header.data() + 20, RecordSize);
+	WriteUint32(header.data() + 24, HeaderSize);
+	WriteUint32(header.data() + 28, static_cast<uint32_t>(stringPoolOffset));
+	WriteUint32(header.data() + 32, static_cast<uint32_t>(stringPool.size()));
+
+	// The pack is written to a temporary file that replaces the existing pack,
+	// this prevents a partially written pack from being used if the game crashes.
+
+	std::filesystem::path tempFilePath = path;
+	tempFilePath += ".tmp";
+
+	{
+		std::ofstream stream(tempFilePath, std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+
+		if (!stream)
+		{
+			return false;
+		}
+
+		stream.write(reinterpret_cast<const char*>(header.data()), header.size());
+		stream.write(reinterpret_cast<const char*>(records.data()), records.size());
+		stream.write(stringPool.data(), stringPool.size());
+		stream.flush();
+
+		if (!stream)
+		{
+			return false;
+		}
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(tempFilePath, path, ec);
+
+	return !ec;
+}
+
+uint32_t CompiledOrdinancePackWriter::AddString(std::string_view value)
+{
+	const auto it = stringOffsets.find(std::string(value));
+
+	if (it != stringOffsets.end())
+	{
+		return it->second;
+	}
+
+	const uint32_t offset = static_cast<uint32_t>(stringPool.size());
+
+	stringPool.append(value);
+	stringOffsets.emplace(std::string(value), offset);
+
+	return offset;
+}
@@ -0,0 +1,58 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "ExemplarPropertyTable.h"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Builds a compiled ordinance pack from the decoded ordinance exemplars.
+// See CompiledOrdinancePack.h.
+class CompiledOrdinancePackWriter
+{
+public:
+	CompiledOrdinancePackWriter();
+
+	// Adds a record with the values of the pack schema properties.
+	// Returns false if the property table is empty or the exemplar has a parent
+	// cohort, the table does not have the properties that the exemplar inherits
+	// from its parent cohort.
+	bool Add(uint32_t type, uint32_t group, uint32_t instance, const ExemplarPropertyTable& properties);
+	void Clear();
+
+	uint32_t GetRecordCount() const;
+
+	bool Save(const std::filesystem::path& path) const;
+
+private:
+	uint32_t AddString(std::string_view value);
+
+	std::vector<uint8_t> records;
+	std::string stringPool;
+	// The string pool offsets of the strings that were already added, duplicate
+	// strings such as Lua function names are stored once.
+	std::unordered_map<std::string, uint32_t> stringOffsets;
+	uint32_t recordCount;
+};
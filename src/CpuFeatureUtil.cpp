@@ -19,38 +19,40 @@
  * If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "PersistResourceKeyFilterByType.h"
-#include "cGZPersistResourceKey.h"
+#include "CpuFeatureUtil.h"
+#if defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
 
-PersistResourceKeyFilterByType::PersistResourceKeyFilterByType(uint32_t type)
-	: type(type)
+namespace
 {
-}
-
-bool PersistResourceKeyFilterByType::QueryInterface(uint32_t riid, void** ppvObj)
-{
-	if (riid == GZIID_cIGZPersistResourceKeyFilter)
+	bool DetectAvxSupport()
 	{
-		*ppvObj = static_cast<cIGZPersistResourceKeyFilter*>(this);
-		AddRef();
-
-		return true;
+#if defined(_MSC_VER)
+		int cpuInfo[4] = {};
+		__cpuid(cpuInfo, 1);
+
+		constexpr int OSXSAVE = 1 << 27;
+		constexpr int AVX = 1 << 28;
+
+		if ((cpuInfo[2] & (OSXSAVE | AVX)) == (OSXSAVE | AVX))
+		{
+			// The OS must save the YMM registers on a context switch.
+			return (_xgetbv(0) & 0x6) == 0x6;
+		}
+
+		return false;
+#else
+		// The builtin also checks that the OS saves the YMM registers.
+		return __builtin_cpu_supports("avx");
+#endif
 	}
-
-	return cRZBaseUnknown::QueryInterface(riid, ppvObj);
 }
 
-uint32_t PersistResourceKeyFilterByType::AddRef()
+bool CpuFeatureUtil::IsAvxSupported()
 {
-	return cRZBaseUnknown::AddRef();
-}
+	static const bool isAvxSupported = DetectAvxSupport();
 
-uint32_t PersistResourceKeyFilterByType::Release()
-{
-	return cRZBaseUnknown::Release();
-}
-
-bool PersistResourceKeyFilterByType::IsKeyIncluded(cGZPersistResourceKey const& key)
-{
-	return key.type == type;
+	return isAvxSupported;
 }
@@ -0,0 +1,39 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Marks a function that uses the AVX intrinsics, the function must only be
+// called if IsAvxSupported returns true.
+// MSVC allows the intrinsics in any function, GCC and Clang require the
+// target attribute when the file is not compiled for AVX.
+#if defined(_MSC_VER)
+#define CPU_FEATURE_TARGET_AVX
+#else
+#define CPU_FEATURE_TARGET_AVX __attribute__((target("avx")))
+#endif
+
+namespace CpuFeatureUtil
+{
+	// Gets a value indicating whether the CPU and OS support the AVX instructions.
+	// The result is detected on the first call.
+	bool IsAvxSupported();
+}
@@ -20,23 +20,15 @@
  */
 
 #include "CustomOrdinance.h"
+#include "CityLoadProfiler.h"
+#include "CityStatsSnapshot.h"
 #include "cIGZIStream.h"
 #include "cIGZOStream.h"
-#include "cIGZPersistResourceManager.h"
-#include "cIGZVariant.h"
-#include "cISCResExemplar.h"
-#include "cISCProperty.h"
-#include "cRZAutoRefCount.h"
-#include "GlobalPointers.h"
 #include "GZStreamUtil.h"
 #include "Logger.h"
-#include "OrdiancePropertyIDs.h"
-#include "SCPropertyUtil.h"
 #include "SC4Percentage.h"
 #include "SafeInt.hpp"
-#include "StringResourceManager.h"
-#include <algorithm>
-#include <array>
+#include "StringResourceKey.h"
 #include <cassert>
 #include <utility>
 
@@ -50,68 +42,6 @@
 #include "RCIGroupPopulationIncomeFactor.h"
 #include "TotalResidentialPopulationIncomeFactor.h"
 
-static constexpr std::array<std::pair<uint32_t, BuildingType>, 5> BuildingCountAvailabilityConditions =
-{
-	std::pair(kOrdinanceAvailabilityMinFireStationCount, BuildingType::FireStation),
-	std::pair(kOrdinanceAvailabilityMinHospitalCount, BuildingType::Hospital),
-	std::pair(kOrdinanceAvailabilityMinJailCount, BuildingType::Jail),
-	std::pair(kOrdinanceAvailabilityMinPoliceStationCount, BuildingType::PoliceStation),
-	std::pair(kOrdinanceAvailabilityMinSchoolBuildingCount, BuildingType::School),
-};
-
-static constexpr std::array<std::pair<uint32_t, RCIGroup>, 12> RCIGroupMinPopulationAvailabilityConditions =
-{
-	std::pair(kOrdinanceAvailabilityMinPopulationResLowWealth, RCIGroup::Res1),
-	std::pair(kOrdinanceAvailabilityMinPopulationResMediumWealth, RCIGroup::Res2),
-	std::pair(kOrdinanceAvailabilityMinPopulationResHighWealth, RCIGroup::Res3),
-	std::pair(kOrdinanceAvailabilityMinPopulationCsLowWealth, RCIGroup::Cs1),
-	std::pair(kOrdinanceAvailabilityMinPopulationCsMediumWealth, RCIGroup::Cs2),
-	std::pair(kOrdinanceAvailabilityMinPopulationCsHighWealth, RCIGroup::Cs3),
-	std::pair(kOrdinanceAvailabilityMinPopulationCoMediumWealth, RCIGroup::Co2),
-	std::pair(kOrdinanceAvailabilityMinPopulationCoHighWealth, RCIGroup::Co3),
-	std::pair(kOrdinanceAvailabilityMinPopulationIR, RCIGroup::IR),
-	std::pair(kOrdinanceAvailabilityMinPopulationID, RCIGroup::ID),
-	std::pair(kOrdinanceAvailabilityMinPopulationIM, RCIGroup::IM),
-	std::pair(kOrdinanceAvailabilityMinPopulationIHT, RCIGroup::IHT),
-};
-
-static constexpr std::array<std::pair<uint32_t, RCIGroup>, 3> ResWealthGroupMonthlyIncomeFactors =
-{
-	std::pair(kOrdinanceMonthlyIncomeFactorResLowWealthPopulation, RCIGroup::Res1),
-	std::pair(kOrdinanceMonthlyIncomeFactorResMediumWealthPopulation, RCIGroup::Res2),
-	std::pair(kOrdinanceMonthlyIncomeFactorResHighWealthPopulation, RCIGroup::Res3),
-};
-
-static constexpr std::array<std::pair<uint32_t, RCIGroup>, 3> CsWealthGroupMonthlyIncomeFactors =
-{
-	std::pair(kOrdinanceMonthlyIncomeFactorCsLowWealthPopulation, RCIGroup::Cs1),
-	std::pair(kOrdinanceMonthlyIncomeFactorCsMediumWealthPopulation, RCIGroup::Cs2),
-	std::pair(kOrdinanceMonthlyIncomeFactorCsHighWealthPopulation, RCIGroup::Cs3),
-};
-
-static constexpr std::array<std::pair<uint32_t, RCIGroup>, 2> CoWealthGroupMonthlyIncomeFactors =
-{
-	std::pair(kOrdinanceMonthlyIncomeFactorCoMediumWealthPopulation, RCIGroup::Co2),
-	std::pair(kOrdinanceMonthlyIncomeFactorCoHighWealthPopulation, RCIGroup::Co3),
-};
-
-static constexpr std::array<std::pair<uint32_t, RCIGroup>, 4> IndustrialMonthlyIncomeFactors =
-{
-	std::pair(kOrdinanceMonthlyIncomeFactorIRPopulation, RCIGroup::IR),
-	std::pair(kOrdinanceMonthlyIncomeFactorIDPopulation, RCIGroup::ID),
-	std::pair(kOrdinanceMonthlyIncomeFactorIMPopulation, RCIGroup::IM),
-	std::pair(kOrdinanceMonthlyIncomeFactorIHTPopulation, RCIGroup::IHT),
-};
-
-static constexpr std::array<std::pair<uint32_t, BuildingType>, 5> BuildingCountMonthlyIncomeFactors =
-{
-	std::pair(kOrdinanceMonthlyIncomeFactorFireStationCount, BuildingType::FireStation),
-	std::pair(kOrdinanceMonthlyIncomeFactorHospitalCount, BuildingType::Hospital),
-	std::pair(kOrdinanceMonthlyIncomeFactorJailCount, BuildingType::Jail),
-	std::pair(kOrdinanceMonthlyIncomeFactorPoliceStationCount, BuildingType::PoliceStation),
-	std::pair(kOrdinanceMonthlyIncomeFactorSchoolBuildingCount, BuildingType::School),
-};
-
 namespace
 {
 	bool ReadAvailabilityConditions(cIGZIStream& stream, std::vector<std::unique_ptr<IAvailabilityCondition>>& vector)
@@ -305,25 +235,25 @@ namespace
 	}
 }
 
-CustomOrdinance::CustomOrdinance(const cGZPersistResourceKey& exemplarKey)
-	: ordinanceExemplarKey(exemplarKey),
-	  availabilityConditions(),
-	  monthlyIncomeFactors(),
-	  name(),
-	  nameKey(),
-	  description(),
-	  descriptionKey(),
-	  enactmentIncome(0),
-	  retracmentIncome(0),
-	  monthlyConstantIncome(0),
-	  isIncomeOrdinance(false),
-	  monthlyAdjustedIncome(0),
+CustomOrdinance::CustomOrdinance(
+	const std::shared_ptr<const OrdinanceDefinition>& definition,
+	MonthlyIncomeEngine* pIncomeEngine,
+	AvailabilityConditionEngine* pAvailabilityEngine,
+	size_t engineSlot)
+	: monthlyAdjustedIncome(0),
+	  definition(definition),
+	  incomeEngine(pIncomeEngine),
+	  availabilityEngine(pAvailabilityEngine),
+	  engineSlot(engineSlot),
+	  name(definition->GetName()),
+	  description(definition->GetDescription()),
+	  miscProperties(),
 	  available(false),
 	  on(false),
 	  enabled(false),
-	  haveDeserialized(false),
-	  miscProperties()
+	  haveDeserialized(false)
 {
+	assert(definition);
 }
 
 bool CustomOrdinance::QueryInterface(uint32_t riid, void** ppvObj)
@@ -368,7 +298,7 @@ bool CustomOrdinance::Init(void)
 	if (!haveDeserialized)
 	{
 		enabled = true;
-		InitFromExemplarData();
+		miscProperties.SetDefaultExemplar(definition->GetExemplar(), definition->GetKey());
 	}
 
 	return true;
@@ -387,24 +317,38 @@ bool CustomOrdinance::Shutdown(void)
 
 int64_t CustomOrdinance::GetCurrentMonthlyIncome(void)
 {
-	double monthlyIncome = static_cast<double>(monthlyConstantIncome);
+	// The metric values are zero when a city is not loaded.
+	CityStatsSnapshot::GetInstance().Update();
 
-	for (const auto& factor : monthlyIncomeFactors)
-	{
-		monthlyIncome = factor->Calculate(monthlyIncome);
-	}
+	return CalculateMonthlyIncome();
+}
+
+int64_t CustomOrdinance::CalculateMonthlyIncome() const
+{
+	const CityStatsSnapshot& snapshot = CityStatsSnapshot::GetInstance();
+
+	const double monthlyIncome = definition->GetProgram().CalculateMonthlyIncome(
+		static_cast<double>(definition->GetMonthlyConstantIncome()),
+		snapshot.GetMetricValues());
+
+	return ToMonthlyIncomeInteger(monthlyIncome);
+}
 
+int64_t CustomOrdinance::ToMonthlyIncomeInteger(double monthlyIncome) const
+{
 	int64_t monthlyIncomeInteger = 0;
 
 	if (!SafeCast(monthlyIncome, monthlyIncomeInteger))
 	{
-		monthlyIncomeInteger = monthlyConstantIncome;
+		monthlyIncomeInteger = definition->GetMonthlyConstantIncome();
+
+		const cGZPersistResourceKey& ordinanceExemplarKey = definition->GetKey();
 
 		Logger::GetInstance().WriteLineFormatted(
 			LogLevel::Error,
 			"Error when calculating the monthly income for '%s' (TGI 0x%08x, 0x%08x, 0x%08x), "
 			"%f cannot be represented as a signed 64-bit integer. Returning the monthly constant income.",
-			name.ToChar(),
+			definition->GetName().ToChar(),
 			ordinanceExemplarKey.type,
 			ordinanceExemplarKey.group,
 			ordinanceExemplarKey.instance,
@@ -416,7 +360,7 @@ int64_t CustomOrdinance::GetCurrentMonthlyIncome(void)
 
 uint32_t CustomOrdinance::GetID(void) const
 {
-	return ordinanceExemplarKey.instance;
+	return definition->GetKey().instance;
 }
 
 cIGZString* CustomOrdinance::GetName(void)
@@ -446,17 +390,17 @@ SC4Percentage CustomOrdinance::GetChanceAvailability(void)
 
 int64_t CustomOrdinance::GetEnactmentIncome(void)
 {
-	return enactmentIncome;
+	return definition->GetEnactmentIncome();
 }
 
 int64_t CustomOrdinance::GetRetracmentIncome(void)
 {
-	return retracmentIncome;
+	return definition->GetRetracmentIncome();
 }
 
 int64_t CustomOrdinance::GetMonthlyConstantIncome(void)
 {
-	return monthlyConstantIncome;
+	return definition->GetMonthlyConstantIncome();
 }
 
 float CustomOrdinance::GetMonthlyIncomeFactor(void)
@@ -503,15 +447,14 @@ bool CustomOrdinance::CheckConditions(void)
 
 	if (enabled)
 	{
-		result = true;
+		CityStatsSnapshot& snapshot = CityStatsSnapshot::GetInstance();
+
+		// The metric values are zero when a city is not loaded.
+		snapshot.Update();
 
-		for (const auto& item : availabilityConditions)
+		if (!availabilityEngine || !availabilityEngine->TryCheckConditions(engineSlot, definition.get(), result))
 		{
-			if (!item->CheckCondition())
-			{
-				result = false;
-				break;
-			}
+			result = definition->GetProgram().CheckConditions(snapshot.GetMetricValues());
 		}
 	}
 
@@ -520,12 +463,28 @@ bool CustomOrdinance::CheckConditions(void)
 
 bool CustomOrdinance::IsIncomeOrdinance(void)
 {
-	return isIncomeOrdinance;
+	return definition->IsIncomeOrdinance();
 }
 
 bool CustomOrdinance::Simulate(void)
 {
-	monthlyAdjustedIncome = GetCurrentMonthlyIncome();
+	double monthlyIncome = 0.0;
+	bool inRange = false;
+
+	// The metric values are zero when a city is not loaded.
+	CityStatsSnapshot::GetInstance().Update();
+
+	if (incomeEngine && incomeEngine->TryGetMonthlyIncome(engineSlot, definition.get(), monthlyIncome, inRange))
+	{
+		// The engine checks the range of all of the incomes, SafeCast is only
+		// used to handle and report the out of range values.
+		monthlyAdjustedIncome = inRange ? static_cast<int64_t>(monthlyIncome) : ToMonthlyIncomeInteger(monthlyIncome);
+	}
+	else
+	{
+		monthlyAdjustedIncome = CalculateMonthlyIncome();
+	}
+
 	return true;
 }
 
@@ -576,8 +535,8 @@ bool CustomOrdinance::SetKey(const cGZPersistResourceKey& key)
 	// performs when starting a new city.
 	// That saves us a call to cISC4OrdinanceSimulator::AddOrdinance.
 	//
-	// The method is a no-op because we set the ordinance exemplar resource key
-	// in the class constructor, which is required for the game's deserialization
+	// The method is a no-op because we set the ordinance definition in the
+	// class constructor, which is required for the game's deserialization
 	// code to work.
 	// This class uses the instance id member of exemplar resource key as the
 	// class id for GZCOM serialization (see GetGZCLSID).
@@ -592,63 +551,68 @@ bool CustomOrdinance::Write(cIGZOStream& stream)
 		return false;
 	}
 
-	const uint32_t version = 1;
+	const uint32_t version = 2;
 	if (!stream.SetUint32(version))
 	{
 		return false;
 	}
 
-	if (!GZStreamUtil::WriteResKey(stream, ordinanceExemplarKey))
+	if (!GZStreamUtil::WriteResKey(stream, definition->GetKey()))
+	{
+		return false;
+	}
+
+	if (!stream.SetSint64(static_cast<int64_t>(definition->GetContentHash())))
 	{
 		return false;
 	}
 
-	if (!WriteAvailabilityConditions(stream, availabilityConditions))
+	if (!WriteAvailabilityConditions(stream, definition->GetAvailabilityConditions()))
 	{
 		return false;
 	}
 
-	if (!WriteMonthlyIncomeFactors(stream, monthlyIncomeFactors))
+	if (!WriteMonthlyIncomeFactors(stream, definition->GetMonthlyIncomeFactors()))
 	{
 		return false;
 	}
 
-	if (!stream.SetGZStr(name))
+	if (!stream.SetGZStr(definition->GetName()))
 	{
 		return false;
 	}
 
-	if (!GZStreamUtil::WriteStringResourceKey(stream, nameKey))
+	if (!GZStreamUtil::WriteStringResourceKey(stream, definition->GetNameKey()))
 	{
 		return false;
 	}
 
-	if (!stream.SetGZStr(description))
+	if (!stream.SetGZStr(definition->GetDescription()))
 	{
 		return false;
 	}
 
-	if (!GZStreamUtil::WriteStringResourceKey(stream, descriptionKey))
+	if (!GZStreamUtil::WriteStringResourceKey(stream, definition->GetDescriptionKey()))
 	{
 		return false;
 	}
 
-	if (!stream.SetSint64(enactmentIncome))
+	if (!stream.SetSint64(definition->GetEnactmentIncome()))
 	{
 		return false;
 	}
 
-	if (!stream.SetSint64(retracmentIncome))
+	if (!stream.SetSint64(definition->GetRetracmentIncome()))
 	{
 		return false;
 	}
 
-	if (!stream.SetSint64(retracmentIncome))
+	if (!stream.SetSint64(definition->GetRetracmentIncome()))
 	{
 		return false;
 	}
 
-	if (!stream.SetSint64(monthlyConstantIncome))
+	if (!stream.SetSint64(definition->GetMonthlyConstantIncome()))
 	{
 		return false;
 	}
@@ -658,7 +622,7 @@ bool CustomOrdinance::Write(cIGZOStream& stream)
 		return false;
 	}
 
-	if (!GZStreamUtil::WriteBool(stream, isIncomeOrdinance))
+	if (!GZStreamUtil::WriteBool(stream, definition->IsIncomeOrdinance()))
 	{
 		return false;
 	}
@@ -688,22 +652,65 @@ bool CustomOrdinance::Write(cIGZOStream& stream)
 
 bool CustomOrdinance::Read(cIGZIStream& stream)
 {
+	CityLoadProfiler::ScopedTimer timer(CityLoadProfiler::Phase::Deserialize, definition->GetKey().instance);
+
 	if (stream.GetError() != 0)
 	{
 		return false;
 	}
 
 	uint32_t version = 0;
-	if (!stream.GetUint32(version) || version != 1)
+	if (!stream.GetUint32(version) || version < 1 || version > 2)
 	{
 		return false;
 	}
 
+	// The definition values in the save game are used instead of the current
+	// exemplar values, they are placed in a new definition that is private to
+	// this instance.
+	// Version 2 added the content hash of the definition, if it matches the
+	// definition of the installed exemplar the saved values are the same and
+	// the shared definition is used.
+
+	cGZPersistResourceKey ordinanceExemplarKey;
+	OrdinanceDefinition::AvailabilityConditionList availabilityConditions;
+	OrdinanceDefinition::MonthlyIncomeFactorList monthlyIncomeFactors;
+	cRZBaseString savedName;
+	StringResourceKey nameKey;
+	cRZBaseString savedDescription;
+	StringResourceKey descriptionKey;
+	int64_t enactmentIncome = 0;
+	int64_t retracmentIncome = 0;
+	int64_t monthlyConstantIncome = 0;
+	bool isIncomeOrdinance = false;
+
 	if (!GZStreamUtil::ReadResKey(stream, ordinanceExemplarKey))
 	{
 		return false;
 	}
 
+	uint64_t contentHash = 0;
+
+	if (version >= 2)
+	{
+		int64_t value = 0;
+
+		if (!stream.GetSint64(value))
+		{
+			return false;
+		}
+
+		contentHash = static_cast<uint64_t>(value);
+	}
+
+	const cGZPersistResourceKey& installedKey = definition->GetKey();
+
+	const bool useInstalledDefinition = contentHash != 0
+		&& contentHash == definition->GetContentHash()
+		&& ordinanceExemplarKey.type == installedKey.type
+		&& ordinanceExemplarKey.group == installedKey.group
+		&& ordinanceExemplarKey.instance == installedKey.instance;
+
 	if (!ReadAvailabilityConditions(stream, availabilityConditions))
 	{
 		return false;
@@ -714,7 +721,7 @@ bool CustomOrdinance::Read(cIGZIStream& stream)
 		return false;
 	}
 
-	if (!stream.GetGZStr(name))
+	if (!stream.GetGZStr(savedName))
 	{
 		return false;
 	}
@@ -724,7 +731,7 @@ bool CustomOrdinance::Read(cIGZIStream& stream)
 		return false;
 	}
 
-	if (!stream.GetGZStr(description))
+	if (!stream.GetGZStr(savedDescription))
 	{
 		return false;
 	}
@@ -764,9 +771,15 @@ bool CustomOrdinance::Read(cIGZIStream& stream)
 		return false;
 	}
 
-	if (!miscProperties.Read(stream))
 	{
-		return false;
+		CityLoadProfiler::ScopedTimer propertyHolderTimer(
+			CityLoadProfiler::Phase::PropertyHolderRead,
+			definition->GetKey().instance);
+
+		if (!miscProperties.Read(stream))
+		{
+			return false;
+		}
 	}
 
 	if (!GZStreamUtil::ReadBool(stream, available))
@@ -784,236 +797,40 @@ bool CustomOrdinance::Read(cIGZIStream& stream)
 		return false;
 	}
 
-	haveDeserialized = true;
-	LoadLocalizedStringResources();
-
-	return true;
-}
-
-uint32_t CustomOrdinance::GetGZCLSID()
-{
-	return ordinanceExemplarKey.instance;
-}
-
-void CustomOrdinance::InitFromExemplarData()
-{
-	cRZAutoRefCount<cISCResExemplar> exemplar;
-
-	if (spRM->GetResource(
-		ordinanceExemplarKey,
-		GZIID_cISCResExemplar,
-		exemplar.AsPPVoid(),
-		0,
-		nullptr))
-	{
-		miscProperties.SetDefaultExemplar(exemplar);
-
-		const cISCPropertyHolder* pPropertyHolder = exemplar->AsISCPropertyHolder();
-
-		ReadCommonOrdinanceProperties(pPropertyHolder);
-		ReadAvailabilityConditionProperties(pPropertyHolder);
-		ReadMonthlyIncomeFactorProperties(pPropertyHolder);
-		LoadLocalizedStringResources();
-	}
-}
-
-void CustomOrdinance::LoadLocalizedStringResources()
-{
-	cRZAutoRefCount<cIGZString> localizedName;
-	cRZAutoRefCount<cIGZString> localizedDescription;
-
-	if (StringResourceManager::GetLocalizedString(nameKey, localizedName.AsPPObj()))
+	if (useInstalledDefinition)
 	{
-		if (StringResourceManager::GetLocalizedString(descriptionKey, localizedDescription.AsPPObj()))
-		{
-			if (localizedName->Strlen() > 0 && !localizedName->IsEqual(this->name, false))
-			{
-				name.Copy(*localizedName);
-			}
-
-			if (localizedDescription->Strlen() > 0 && !localizedDescription->IsEqual(this->description, false))
-			{
-				description.Copy(*localizedDescription);
-			}
-		}
-	}
-}
-
-void CustomOrdinance::ReadCommonOrdinanceProperties(const cISCPropertyHolder* pPropertyHolder)
-{
-	if (!SCPropertyUtil::GetPropertyValue(pPropertyHolder, kOrdinanceNameKey, nameKey))
-	{
-		if (!SCPropertyUtil::GetPropertyValue(pPropertyHolder, kOrdinanceName, name))
-		{
-			name.Sprintf("0x%08x", ordinanceExemplarKey.instance);
-		}
-	}
-
-	if (!SCPropertyUtil::GetPropertyValue(pPropertyHolder, kOrdinanceDescriptionKey, descriptionKey))
-	{
-		if (!SCPropertyUtil::GetPropertyValue(pPropertyHolder, kOrdinanceDescription, description))
-		{
-			description.Sprintf("0x%08x", ordinanceExemplarKey.instance);
-		}
-	}
-
-	SCPropertyUtil::GetPropertyValue(pPropertyHolder, kOrdinanceEnactmentIncome, enactmentIncome);
-	SCPropertyUtil::GetPropertyValue(pPropertyHolder, kOrdinanceRetracmentIncome, retracmentIncome);
-	SCPropertyUtil::GetPropertyValue(pPropertyHolder, kOrdinancemMonthlyConstantIncome, monthlyConstantIncome);
-	SCPropertyUtil::GetPropertyValue(pPropertyHolder, kOrdinanceIsIncome, isIncomeOrdinance);
-}
-
-void CustomOrdinance::ReadAvailabilityConditionProperties(const cISCPropertyHolder* pPropertyHolder)
-{
-	cRZBaseString luaFunctionName;
-
-	// The Lua function property takes precedence over all other availability condition properties.
-	if (SCPropertyUtil::GetPropertyValue(pPropertyHolder, kOrdinanceAvailabilityLuaFunction, luaFunctionName)
-		&& luaFunctionName.Strlen() > 0)
-	{
-		availabilityConditions.push_back(std::make_unique<LuaFunctionAvailabilityCondition>(luaFunctionName));
-	}
-	else
-	{
-		uint32_t yearAvailable = 0;
-
-		if (SCPropertyUtil::GetPropertyValue(pPropertyHolder, kOrdinanceAvailabilityGameYear, yearAvailable))
-		{
-			constexpr uint32_t kSC4StartYear = 2000;
-
-			if (yearAvailable > kSC4StartYear)
-			{
-				availabilityConditions.push_back(std::make_unique<GameYearAvailabilityCondition>(yearAvailable));
-			}
-		}
-
-		for (const auto& item : BuildingCountAvailabilityConditions)
-		{
-			ReadMinBuildingCountAvailabilityCondition(pPropertyHolder, item.first, item.second);
-		}
-
-		for (const auto& item : RCIGroupMinPopulationAvailabilityConditions)
-		{
-			ReadRCIGroupMinPopulationAvailabilityCondition(pPropertyHolder, item.first, item.second);
-		}
-	}
-}
-
-void CustomOrdinance::ReadMonthlyIncomeFactorProperties(const cISCPropertyHolder* pPropertyHolder)
-{
-	cRZBaseString luaFunctionName;
-
-	// The Lua function property takes precedence over all other monthly income factor properties.
-	if (SCPropertyUtil::GetPropertyValue(pPropertyHolder, kOrdinanceMonthlyIncomeFactorLuaFunction, luaFunctionName)
-		&& luaFunctionName.Strlen() > 0)
-	{
-		monthlyIncomeFactors.push_back(std::make_unique<LuaFunctionIncomeFactor>(luaFunctionName));
-	}
-	else
-	{
-		float resTotalPopulationIncomeFactor = 0.0f;
-
-		if (SCPropertyUtil::GetPropertyValue(
-			pPropertyHolder,
-			kOrdinanceMonthlyIncomeFactorResTotalPopulation,
-			resTotalPopulationIncomeFactor))
-		{
-			monthlyIncomeFactors.push_back(std::make_unique<TotalResidentialPopulationIncomeFactor>(resTotalPopulationIncomeFactor));
-		}
-		else
-		{
-			// The total residential population property takes precedence over the residential wealth group properties.
-			for (const auto& item : ResWealthGroupMonthlyIncomeFactors)
-			{
-				ReadRCIGroupPopulationMonthlyIncomeFactor(
-					pPropertyHolder,
-					item.first,
-					item.second);
-			}
-		}
-
-		for (const auto& item : CsWealthGroupMonthlyIncomeFactors)
-		{
-			ReadRCIGroupPopulationMonthlyIncomeFactor(
-				pPropertyHolder,
-				item.first,
-				item.second);
-		}
-
-		for (const auto& item : CoWealthGroupMonthlyIncomeFactors)
-		{
-			ReadRCIGroupPopulationMonthlyIncomeFactor(
-				pPropertyHolder,
-				item.first,
-				item.second);
-		}
-
-		for (const auto& item : IndustrialMonthlyIncomeFactors)
-		{
-			ReadRCIGroupPopulationMonthlyIncomeFactor(
-				pPropertyHolder,
-				item.first,
-				item.second);
-		}
-
-		for (const auto& item : BuildingCountMonthlyIncomeFactors)
-		{
-			ReadBuildingCountMonthlyIncomeFactor(
-				pPropertyHolder,
-				item.first,
-				item.second);
-		}
-	}
-}
-
-void CustomOrdinance::ReadMinBuildingCountAvailabilityCondition(
-	const cISCPropertyHolder* pPropertyHolder,
-	uint32_t id,
-	BuildingType type)
-{
-	uint32_t count = 0;
-
-	if (SCPropertyUtil::GetPropertyValue(pPropertyHolder, id, count) && count > 0)
-	{
-		availabilityConditions.push_back(std::make_unique<BuildingCountAvailabilityCondition>(type, count));
+		haveDeserialized = true;
+		return true;
 	}
-}
-
-void CustomOrdinance::ReadRCIGroupMinPopulationAvailabilityCondition(
-	const cISCPropertyHolder* pPropertyHolder,
-	uint32_t id,
-	RCIGroup type)
-{
-	uint32_t minPopulation = 0;
 
-	if (SCPropertyUtil::GetPropertyValue(pPropertyHolder, id, minPopulation) && minPopulation > 0)
+	if (contentHash != 0)
 	{
-		availabilityConditions.push_back(std::make_unique<RCIGroupPopulationAvailabilityCondition>(type, minPopulation));
+		Logger::GetInstance().WriteLineFormatted(
+			LogLevel::Info,
+			"The installed exemplar for ordinance 0x%08x has changed since the city was saved, using the saved values.",
+			ordinanceExemplarKey.instance);
 	}
-}
 
-void CustomOrdinance::ReadBuildingCountMonthlyIncomeFactor(
-	const cISCPropertyHolder* pPropertyHolder,
-	uint32_t id,
-	BuildingType type)
-{
-	float factor = 0.0f;
+	definition = OrdinanceDefinition::Create(
+		ordinanceExemplarKey,
+		std::move(availabilityConditions),
+		std::move(monthlyIncomeFactors),
+		savedName,
+		nameKey,
+		savedDescription,
+		descriptionKey,
+		enactmentIncome,
+		retracmentIncome,
+		monthlyConstantIncome,
+		isIncomeOrdinance);
+	name = definition->GetName();
+	description = definition->GetDescription();
+	haveDeserialized = true;
 
-	if (SCPropertyUtil::GetPropertyValue(pPropertyHolder, id, factor))
-	{
-		monthlyIncomeFactors.push_back(std::make_unique<BuildingCountIncomeFactor>(type, factor));
-	}
+	return true;
 }
 
-void CustomOrdinance::ReadRCIGroupPopulationMonthlyIncomeFactor(
-	const cISCPropertyHolder* pPropertyHolder,
-	uint32_t id,
-	RCIGroup type)
+uint32_t CustomOrdinance::GetGZCLSID()
 {
-	float factor = 0.0f;
-
-	if (SCPropertyUtil::GetPropertyValue(pPropertyHolder, id, factor))
-	{
-		monthlyIncomeFactors.push_back(std::make_unique<RCIGroupPopulationIncomeFactor>(type, factor));
-	}
+	return definition->GetKey().instance;
 }
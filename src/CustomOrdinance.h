@@ -20,19 +20,16 @@
  */
 
 #pragma once
+#include "cRZBaseString.h"
 #include "cRZBaseUnknown.h"
-#include "BuildingType.h"
 #include "cGZPersistResourceKey.h"
 #include "cISC4OrdinanceSimple.h"
 #include "cIGZSerializable.h"
-#include "cRZBaseString.h"
+#include "AvailabilityConditionEngine.h"
 #include "ExemplarPropertyHolder.h"
-#include "IAvailabilityCondition.h"
-#include "IMonthlyIncomeFactor.h"
-#include "RCIGroup.h"
-#include "StringResourceKey.h"
+#include "MonthlyIncomeEngine.h"
+#include "OrdinanceDefinition.h"
 #include <memory>
-#include <vector>
 
 class CustomOrdinance final
 	: public cRZBaseUnknown,
@@ -40,12 +37,25 @@ class CustomOrdinance final
 	  private cIGZSerializable
 {
 public:
-	// Setting the ordinance exemplar resource key in the class constructor is
-	// required for the game's deserialization code to work.
-	// This class uses the instance id member of exemplar resource key as the
-	// class id for GZCOM serialization (see GetGZCLSID).
-
-	CustomOrdinance(const cGZPersistResourceKey& exemplarKey);
+	// Setting the ordinance definition in the class constructor is required
+	// for the game's deserialization code to work.
+	// This class uses the instance id member of definition's exemplar resource
+	// key as the class id for GZCOM serialization (see GetGZCLSID).
+	//
+	// The definition is shared with the other instances of the ordinance, this
+	// class only stores the per-city state.
+	//
+	// The income engine computes the monthly income of all of the ordinances when
+	// the first ordinance is simulated, and the availability engine checks the
+	// conditions of all of the ordinances when the first ordinance checks its
+	// conditions. The slot is the ordinance's index in the engines.
+	// The engines are optional.
+
+	CustomOrdinance(
+		const std::shared_ptr<const OrdinanceDefinition>& definition,
+		MonthlyIncomeEngine* pIncomeEngine,
+		AvailabilityConditionEngine* pAvailabilityEngine,
+		size_t engineSlot);
 
 	CustomOrdinance(const CustomOrdinance& other) = delete;
 	CustomOrdinance(CustomOrdinance&& other) = delete;
@@ -205,52 +215,21 @@ private:
 	bool Read(cIGZIStream& stream);
 	uint32_t GetGZCLSID();
 
-	// Private members
-
-	void InitFromExemplarData();
-
-	void LoadLocalizedStringResources();
+	int64_t CalculateMonthlyIncome() const;
+	int64_t ToMonthlyIncomeInteger(double monthlyIncome) const;
 
-	void ReadCommonOrdinanceProperties(const cISCPropertyHolder* pPropertyHolder);
-	void ReadAvailabilityConditionProperties(const cISCPropertyHolder* pPropertyHolder);
-	void ReadMonthlyIncomeFactorProperties(const cISCPropertyHolder* pPropertyHolder);
-
-	void ReadMinBuildingCountAvailabilityCondition(
-		const cISCPropertyHolder* pPropertyHolder,
-		uint32_t id,
-		BuildingType type);
-	void ReadRCIGroupMinPopulationAvailabilityCondition(
-		const cISCPropertyHolder* pPropertyHolder,
-		uint32_t id,
-		RCIGroup type);
-
-	void ReadBuildingCountMonthlyIncomeFactor(
-		const cISCPropertyHolder* pPropertyHolder,
-		uint32_t id,
-		BuildingType type);
-	void ReadRCIGroupPopulationMonthlyIncomeFactor(
-		const cISCPropertyHolder* pPropertyHolder,
-		uint32_t id,
-		RCIGroup type);
-
-	// The int64_t fields are first to eliminate 8 bytes of alignment padding.
-
-	int64_t enactmentIncome;
-	int64_t retracmentIncome;
-	int64_t monthlyConstantIncome;
 	int64_t monthlyAdjustedIncome;
-	cGZPersistResourceKey ordinanceExemplarKey;
-	std::vector<std::unique_ptr<IAvailabilityCondition>> availabilityConditions;
-	std::vector<std::unique_ptr<IMonthlyIncomeFactor>> monthlyIncomeFactors;
+	std::shared_ptr<const OrdinanceDefinition> definition;
+	MonthlyIncomeEngine* incomeEngine;
+	AvailabilityConditionEngine* availabilityEngine;
+	size_t engineSlot;
+	// The game receives a pointer to these strings, each instance has its own copy
+	// so that a caller cannot modify the shared definition.
 	cRZBaseString name;
-	StringResourceKey nameKey;
 	cRZBaseString description;
-	StringResourceKey descriptionKey;
 	ExemplarPropertyHolder miscProperties;
-	bool isIncomeOrdinance;
 	bool available;
 	bool on;
 	bool enabled;
 	bool haveDeserialized;
 };
-
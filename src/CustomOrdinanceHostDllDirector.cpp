@@ -48,18 +48,40 @@
 #include "cRZAutoRefCount.h"
 #include "cRZBaseString.h"
 #include "cRZMessage2COMDirector.h"
+#include "AvailabilityConditionEngine.h"
+#include "CityLoadProfiler.h"
+#include "CityStatsSnapshot.h"
+#include "CityStatsSource.h"
+#include "CityStatsTickService.h"
+#include "CompiledOrdinancePack.h"
+#include "CompiledOrdinancePackWriter.h"
 #include "CustomOrdinance.h"
 #include "DebugUtil.h"
+#include "DiscoveryProfiler.h"
+#include "ExemplarPropertyTable.h"
+#include "ExemplarTypeClassifier.h"
+#include "FileSystem.h"
 #include "GlobalPointers.h"
 #include "GZServPtrs.h"
-#include "PersistResourceKeyFilterByType.h"
+#include "MaxisOrdinanceIDs.h"
+#include "MonthlyIncomeEngine.h"
+#include "OrdinanceDefinitionRegistry.h"
+#include "OrdinanceDiscoveryIndex.h"
+#include "OrdinanceDiscoveryPipeline.h"
+#include "PersistResourceKeyFilterPipeline.h"
+#include "PluginFileEnumerator.h"
 #include "SCPropertyUtil.h"
+#include "SessionResourceCache.h"
 
-#include "frozen/unordered_set.h"
-
+#include <algorithm>
 #include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cwctype>
+#include <memory>
 #include <string>
-#include <unordered_set>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <Windows.h>
@@ -79,6 +101,9 @@ static constexpr std::array<uint32_t, 2> RequiredNotifications =
 static constexpr uint32_t kCustomOrdinanceHostDllDirector = 0xEED7366B;
 
 static constexpr std::string_view PluginLogFileName = "SC4CustomOrdinanceHost.log";
+static constexpr std::string_view PluginConfigFileName = "SC4CustomOrdinanceHost.ini";
+static constexpr std::string_view DiscoveryIndexFileName = "SC4CustomOrdinanceHost.index";
+static constexpr std::string_view CompiledPackFileName = "SC4CustomOrdinanceHost.pack";
 
 namespace
 {
@@ -91,45 +116,291 @@ namespace
 		return temp.parent_path();
 	}
 
-	void PathCombine(cRZBaseString& path, const std::string_view& segment)
+	// Gets the Plugins folder in the game's installation directory.
+	// The game executable is in the Apps sub-folder of the installation directory.
+	std::filesystem::path GetInstallPluginFolderPath()
+	{
+		wil::unique_cotaskmem_string modulePath = wil::GetModuleFileNameW(nullptr);
+
+		std::filesystem::path temp(modulePath.get());
+
+		return temp.parent_path().parent_path() / L"Plugins";
+	}
+
+	// Checks if the folder is the root folder or one of its sub-folders.
+	// The paths must be normalized, the comparison is not case-sensitive.
+	bool IsSameOrSubFolder(const std::filesystem::path& folder, const std::filesystem::path& root)
 	{
-		uint32_t length = path.Strlen();
+		auto folderIt = folder.begin();
 
-		if (length > 0 && segment.size() > 0)
+		for (const std::filesystem::path& rootElement : root)
 		{
-			if (path.ToChar()[length - 1] != '\\')
+			// A trailing directory separator is an empty element.
+			if (rootElement.empty())
 			{
-				// Append a backslash if necessary.
-				path.Append("\\", 1);
+				break;
 			}
 
-			path.Append(segment.data(), segment.size());
+			if (folderIt == folder.end() || _wcsicmp(folderIt->c_str(), rootElement.c_str()) != 0)
+			{
+				return false;
+			}
+
+			++folderIt;
 		}
+
+		return true;
 	}
 
-	static constexpr frozen::unordered_set<uint32_t, 20> MaxisOrdinanceCLSIDs =
+	std::filesystem::path ToFileSystemPath(const cIGZString& path)
 	{
-		0xA2BF1DDC, // Carpool Incentive
-		0xA2BF1E43, // Clean Air
-		0x00D0723D, // CPR Training
-		0x40D07236, // Free Clinics
-		0x815B4CEF, // Junior Sports League
-		0x22F6E80C, // Landfill Gas Recovery
-		0xA0D07129, // Legalize Gambling
-		0x62BF1DAA, // Mandatory Smoke Detectors
-		0x62BF1DB9, // Neighborhood Watch
-		0xE0D0722E, // Nuclear Free Zone
-		0x22F6E81B, // Paper Reduction Act
-		0x82B9999B, // Power Conservation
-		0xE0D07233, // Pro Reading Campaign
-		0xA2BF1DE5, // Shuttle Service
-		0xC2F6E81F, // Tire Recycling
-		0x62F6E7CF, // Tourist Promotion
-		0x42BF1E18, // Trash Presort
-		0xC2BF1E04, // Vehicle Emission Standard
-		0x02BF1DFA, // Water Conservation
-		0xC2BF1DC5, // Youth Curfew
-	};
+		// SC4 uses UTF-8 for its strings.
+		return std::filesystem::path(std::u8string_view(
+			reinterpret_cast<const char8_t*>(path.ToChar()),
+			path.Strlen()));
+	}
+
+	cRZBaseString ToRZBaseString(const std::filesystem::path& path)
+	{
+		const std::u8string utf8 = path.u8string();
+
+		return cRZBaseString(reinterpret_cast<const char*>(utf8.data()), static_cast<uint32_t>(utf8.size()));
+	}
+
+	// Reads the log level from the [Logging] section of the configuration file.
+	// The configuration file is optional, the default log level is Error.
+	LogLevel GetConfiguredLogLevel(const std::filesystem::path& configFilePath)
+	{
+		wchar_t value[16]{};
+
+		GetPrivateProfileStringW(
+			L"Logging",
+			L"LogLevel",
+			L"Error",
+			value,
+			static_cast<DWORD>(std::size(value)),
+			configFilePath.c_str());
+
+		if (_wcsicmp(value, L"Info") == 0)
+		{
+			return LogLevel::Info;
+		}
+		else if (_wcsicmp(value, L"Debug") == 0)
+		{
+			return LogLevel::Debug;
+		}
+		else if (_wcsicmp(value, L"Trace") == 0)
+		{
+			return LogLevel::Trace;
+		}
+
+		return LogLevel::Error;
+	}
+
+	// Reads a list of values that are separated by semicolons from the [Discovery]
+	// section of the configuration file.
+	std::vector<std::wstring> GetConfiguredDiscoveryList(
+		const std::filesystem::path& configFilePath,
+		const wchar_t* keyName,
+		const wchar_t* defaultValue)
+	{
+		std::vector<wchar_t> buffer(32768);
+
+		const DWORD length = GetPrivateProfileStringW(
+			L"Discovery",
+			keyName,
+			defaultValue,
+			buffer.data(),
+			static_cast<DWORD>(buffer.size()),
+			configFilePath.c_str());
+
+		std::vector<std::wstring> values;
+		const std::wstring_view text(buffer.data(), length);
+
+		size_t start = 0;
+
+		while (start <= text.size())
+		{
+			size_t end = text.find(L';', start);
+
+			if (end == std::wstring_view::npos)
+			{
+				end = text.size();
+			}
+
+			std::wstring_view value = text.substr(start, end - start);
+
+			while (!value.empty() && iswspace(value.front()))
+			{
+				value.remove_prefix(1);
+			}
+
+			while (!value.empty() && iswspace(value.back()))
+			{
+				value.remove_suffix(1);
+			}
+
+			if (!value.empty())
+			{
+				values.emplace_back(value);
+			}
+
+			start = end + 1;
+		}
+
+		return values;
+	}
+
+	// Gets the folders that are searched for the custom ordinances, in precedence order.
+	// Relative paths are resolved against the user plugins folder, the default is the
+	// 140-ordinances folder.
+	// The folders must be inside one of the game's plugin folders, the ordinance
+	// exemplars are loaded from the game's resource manager when a city is loaded.
+	std::vector<std::filesystem::path> GetConfiguredOrdinanceFolders(
+		const std::filesystem::path& configFilePath,
+		const std::filesystem::path& userPluginFolderPath,
+		const std::filesystem::path& installPluginFolderPath)
+	{
+		const std::filesystem::path userPluginRoot = userPluginFolderPath.lexically_normal();
+		const std::filesystem::path installPluginRoot = installPluginFolderPath.lexically_normal();
+
+		std::vector<std::filesystem::path> folders;
+
+		for (const std::wstring& value : GetConfiguredDiscoveryList(configFilePath, L"OrdinanceFolders", L"140-ordinances"))
+		{
+			std::filesystem::path folder(value);
+
+			if (folder.is_relative())
+			{
+				folder = userPluginFolderPath / folder;
+			}
+
+			folder = folder.lexically_normal();
+
+			if (!IsSameOrSubFolder(folder, userPluginRoot) && !IsSameOrSubFolder(folder, installPluginRoot))
+			{
+				Logger::GetInstance().WriteLineFormatted(
+					LogLevel::Error,
+					"Ignored the ordinance folder %s, it is not inside one of the game's Plugins folders.",
+					ToRZBaseString(folder).ToChar());
+				continue;
+			}
+
+			if (std::find(folders.begin(), folders.end(), folder) == folders.end())
+			{
+				folders.push_back(std::move(folder));
+			}
+		}
+
+		return folders;
+	}
+
+	std::vector<std::string> GetConfiguredFileExtensions(const std::filesystem::path& configFilePath)
+	{
+		std::vector<std::string> extensions;
+
+		for (const std::wstring& value : GetConfiguredDiscoveryList(configFilePath, L"FileExtensions", L""))
+		{
+			const std::u8string utf8 = std::filesystem::path(value).u8string();
+
+			extensions.emplace_back(utf8.begin(), utf8.end());
+		}
+
+		if (extensions.empty())
+		{
+			extensions = PluginFileEnumerator::GetDefaultFileExtensions();
+		}
+
+		return extensions;
+	}
+
+	// Parses a group or instance id, the value can be decimal or hexadecimal with a 0x prefix.
+	bool TryParseResourceId(std::wstring_view text, uint32_t& value)
+	{
+		const std::wstring str(text);
+		wchar_t* end = nullptr;
+
+		errno = 0;
+		const unsigned long result = wcstoul(str.c_str(), &end, 0);
+
+		if (end == str.c_str() || *end != L'\0' || errno == ERANGE || result > UINT32_MAX)
+		{
+			return false;
+		}
+
+		value = static_cast<uint32_t>(result);
+		return true;
+	}
+
+	// Adds the user-configured key exclusions from the [Discovery] section of the
+	// configuration file.
+	// ExcludedGroups is a list of group ids or group id ranges, e.g. 0x1000-0x1FFF,
+	// and ExcludedInstances is a list of instance ids.
+	void AddConfiguredKeyExclusions(
+		PersistResourceKeyFilterPipeline& filter,
+		const std::filesystem::path& configFilePath)
+	{
+		Logger& logger = Logger::GetInstance();
+
+		for (const std::wstring& value : GetConfiguredDiscoveryList(configFilePath, L"ExcludedGroups", L""))
+		{
+			const size_t separator = value.find(L'-');
+			const std::wstring_view text(value);
+
+			uint32_t firstGroup = 0;
+			uint32_t lastGroup = 0;
+
+			bool valid = false;
+
+			if (separator == std::wstring::npos)
+			{
+				valid = TryParseResourceId(text, firstGroup);
+				lastGroup = firstGroup;
+			}
+			else
+			{
+				valid = TryParseResourceId(text.substr(0, separator), firstGroup)
+					 && TryParseResourceId(text.substr(separator + 1), lastGroup)
+					 && firstGroup <= lastGroup;
+			}
+
+			if (valid)
+			{
+				filter.ExcludeGroupRange("Configured group exclusion", firstGroup, lastGroup);
+			}
+			else
+			{
+				logger.WriteLineFormatted(
+					LogLevel::Error,
+					"Ignoring the invalid ExcludedGroups entry: %s",
+					ToRZBaseString(std::filesystem::path(value)).ToChar());
+			}
+		}
+
+		std::vector<uint32_t> instances;
+
+		for (const std::wstring& value : GetConfiguredDiscoveryList(configFilePath, L"ExcludedInstances", L""))
+		{
+			uint32_t instance = 0;
+
+			if (TryParseResourceId(value, instance))
+			{
+				instances.push_back(instance);
+			}
+			else
+			{
+				logger.WriteLineFormatted(
+					LogLevel::Error,
+					"Ignoring the invalid ExcludedInstances entry: %s",
+					ToRZBaseString(std::filesystem::path(value)).ToChar());
+			}
+		}
+
+		if (!instances.empty())
+		{
+			filter.ExcludeInstances("Configured instance exclusion", std::move(instances));
+		}
+	}
 
 	struct PersistResourceKeyInstanceHash
 	{
@@ -147,106 +418,325 @@ namespace
 		}
 	};
 
+	struct OrdinanceExemplar
+	{
+		cRZAutoRefCount<cISCResExemplar> exemplar;
+		ExemplarPropertyTable properties;
+	};
+
+	using OrdinanceExemplarMap = std::unordered_map<
+		cGZPersistResourceKey,
+		OrdinanceExemplar,
+		PersistResourceKeyInstanceHash,
+		PersistResourceKeyInstanceEqual>;
+
 	struct EnumResourceKeyContext
 	{
 		cIGZPersistDBSegmentMultiPackedFiles* pMultiPackedFile;
 		cIGZPersistResourceFactory* pExemplarResourceFactory;
-		std::unordered_set<
-			cGZPersistResourceKey,
-			PersistResourceKeyInstanceHash,
-			PersistResourceKeyInstanceEqual> ordinanceKeys;
+		// The parsed exemplars are kept so that the ordinances can be initialized
+		// without asking the resource manager to load and parse them a second time.
+		// The map is shared by all of the ordinance folders, the first folder that
+		// has an instance id takes precedence.
+		OrdinanceExemplarMap& ordinanceExemplars;
+		// A reusable buffer for the record data.
+		std::vector<uint8_t> recordData;
+		// The profiler is null when the discovery timing is disabled.
+		DiscoveryProfiler* pProfiler;
 
 		EnumResourceKeyContext(
 			cIGZPersistDBSegmentMultiPackedFiles* pMultiPackedFile,
-			cIGZPersistResourceFactory* pFactory)
+			cIGZPersistResourceFactory* pFactory,
+			OrdinanceExemplarMap& ordinanceExemplars,
+			DiscoveryProfiler* pProfiler)
 			: pMultiPackedFile(pMultiPackedFile),
 			  pExemplarResourceFactory(pFactory),
-			  ordinanceKeys()
+			  ordinanceExemplars(ordinanceExemplars),
+			  recordData(),
+			  pProfiler(pProfiler)
 		{
 		}
 	};
 
-	void EnumCustomOrdinanceResourceKeys(cGZPersistResourceKey const& key, void* pContext)
+	// Checks if any of the exemplars can only be read correctly by the game's exemplar parser.
+	// The pipeline cannot read the exemplars that use an unsupported format or inherit their
+	// ExemplarType, nor the properties of text exemplars and parent cohorts.
+	// An ordinance key that is in more than one file must also use the game's parser, the
+	// resource manager picks the game's override winner which may not be the first file.
+	bool RequiresGameExemplarParser(const std::vector<OrdinanceDiscoveryPipeline::DiscoveredExemplar>& exemplars)
+	{
+		using ExemplarStatus = OrdinanceDiscoveryPipeline::ExemplarStatus;
+
+		std::unordered_map<uint32_t, const OrdinanceDiscoveryPipeline::DiscoveredExemplar*> ordinances;
+
+		for (const OrdinanceDiscoveryPipeline::DiscoveredExemplar& item : exemplars)
+		{
+			switch (item.status)
+			{
+			case ExemplarStatus::UnsupportedFormat:
+			case ExemplarStatus::InheritedExemplarType:
+				return true;
+			case ExemplarStatus::Ordinance:
+				if (item.properties.IsEmpty() || item.properties.HasParentCohort())
+				{
+					return true;
+				}
+				else
+				{
+					const auto [it, inserted] = ordinances.try_emplace(item.key.instance, &item);
+
+					if (!inserted
+						&& it->second->key.type == item.key.type
+						&& it->second->key.group == item.key.group)
+					{
+						return true;
+					}
+				}
+				break;
+			default:
+				break;
+			}
+		}
+
+		return false;
+	}
+
+	// Checks that the compiled pack was written for the specified ordinance keys.
+	bool CompiledPackMatchesKeys(
+		const CompiledOrdinancePack& compiledPack,
+		const std::vector<cGZPersistResourceKey>& ordinanceKeys)
+	{
+		if (compiledPack.GetRecordCount() != ordinanceKeys.size())
+		{
+			return false;
+		}
+
+		for (uint32_t i = 0; i < compiledPack.GetRecordCount(); i++)
+		{
+			const CompiledOrdinancePack::Key packKey = compiledPack.GetKey(i);
+			const cGZPersistResourceKey& key = ordinanceKeys[i];
+
+			if (packKey.type != key.type || packKey.group != key.group || packKey.instance != key.instance)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Checks the exemplar status and logs an error if the exemplar can't be used
+	// as a custom ordinance.
+	// The caller is responsible for skipping overrides of the Maxis ordinances
+	// and duplicate instance ids.
+	bool ValidateOrdinanceExemplar(
+		const cGZPersistResourceKey& key,
+		OrdinanceDiscoveryPipeline::ExemplarStatus status)
+	{
+		using ExemplarStatus = OrdinanceDiscoveryPipeline::ExemplarStatus;
+
+		bool result = false;
+
+		switch (status)
+		{
+		case ExemplarStatus::Ordinance:
+			// Prevent the Maxis key CLSID values from being reused.
+			// The CLSID values must be unique.
+			if (MaxisOrdinanceCLSIDs.contains(key.instance))
+			{
+				Logger::GetInstance().WriteLineFormatted(
+					LogLevel::Error,
+					"Exemplar instance id 0x%08x is the same as a Maxis ordinance id.",
+					key.instance);
+			}
+			else
+			{
+				result = true;
+			}
+			break;
+		case ExemplarStatus::NotOrdinance:
+			Logger::GetInstance().WriteLineFormatted(
+				LogLevel::Error,
+				"Exemplar 0x%08x, 0x%08x, 0x%08x does not have an ExemplarType of Ordinance.",
+				key.type,
+				key.group,
+				key.instance);
+			break;
+		case ExemplarStatus::MissingExemplarType:
+			Logger::GetInstance().WriteLineFormatted(
+				LogLevel::Error,
+				"Exemplar 0x%08x, 0x%08x, 0x%08x does not have an ExemplarType property.",
+				key.type,
+				key.group,
+				key.instance);
+			break;
+		case ExemplarStatus::InvalidData:
+		case ExemplarStatus::UnsupportedFormat:
+		case ExemplarStatus::InheritedExemplarType:
+		default:
+			Logger::GetInstance().WriteLineFormatted(
+				LogLevel::Error,
+				"Failed to parse 0x%08x, 0x%08x, 0x%08x.",
+				key.type,
+				key.group,
+				key.instance);
+			break;
+		}
+
+		return result;
+	}
+
+	OrdinanceDiscoveryPipeline::ExemplarStatus GetExemplarStatus(cISCResExemplar* pExemplar)
 	{
 		constexpr uint32_t kExemplarType = 0x10;
 		constexpr uint32_t kExemplarType_Ordinance = 14;
-		constexpr uint32_t kMaxisOrdinanceGroupID = 0xA9C2C209;
 
-		if (MaxisOrdinanceCLSIDs.contains(key.instance) && key.group == kMaxisOrdinanceGroupID)
+		using ExemplarStatus = OrdinanceDiscoveryPipeline::ExemplarStatus;
+
+		const cISCPropertyHolder* pPropertyHolder = pExemplar->AsISCPropertyHolder();
+
+		uint32_t exemplarType = 0;
+
+		if (SCPropertyUtil::GetPropertyValue(pPropertyHolder, kExemplarType, exemplarType))
+		{
+			return exemplarType == kExemplarType_Ordinance ? ExemplarStatus::Ordinance : ExemplarStatus::NotOrdinance;
+		}
+
+		return ExemplarStatus::MissingExemplarType;
+	}
+
+	// Reads the ExemplarType from the record data, without creating the exemplar.
+	// Returns false if the record could not be classified, the caller should use the
+	// game's exemplar parser in that case.
+	bool PeekExemplarStatus(
+		cIGZPersistDBRecord* pRecord,
+		std::vector<uint8_t>& buffer,
+		OrdinanceDiscoveryPipeline::ExemplarStatus& status)
+	{
+		constexpr uint32_t kExemplarType_Ordinance = 14;
+
+		using ExemplarStatus = OrdinanceDiscoveryPipeline::ExemplarStatus;
+
+		bool result = false;
+
+		buffer.resize(pRecord->GetSize());
+
+		if (!buffer.empty() && pRecord->GetFieldVoid(buffer.data(), static_cast<uint32_t>(buffer.size())))
 		{
-			// Overrides of the Maxis ordinances are silently ignored.
-			return;
+			uint32_t exemplarType = 0;
+
+			switch (ExemplarTypeClassifier::GetExemplarType(buffer, exemplarType))
+			{
+			case ExemplarTypeClassifier::Result::Found:
+				status = exemplarType == kExemplarType_Ordinance ? ExemplarStatus::Ordinance : ExemplarStatus::NotOrdinance;
+				result = true;
+				break;
+			case ExemplarTypeClassifier::Result::NotFound:
+				status = ExemplarStatus::MissingExemplarType;
+				result = true;
+				break;
+			case ExemplarTypeClassifier::Result::Inherited:
+				// The game's exemplar parser resolves the parent cohort.
+			case ExemplarTypeClassifier::Result::InvalidData:
+			case ExemplarTypeClassifier::Result::UnsupportedFormat:
+			default:
+				break;
+			}
 		}
 
+		// Rewind the record for the exemplar parser.
+		pRecord->SeekAbsolute(0);
+
+		return result;
+	}
+
+	void EnumCustomOrdinanceResourceKeys(cGZPersistResourceKey const& key, void* pContext)
+	{
 		EnumResourceKeyContext* pState = static_cast<EnumResourceKeyContext*>(pContext);
+		DiscoveryProfiler* pProfiler = pState->pProfiler;
+
+		const DiscoveryProfiler::Clock::time_point recordStart = pProfiler ? DiscoveryProfiler::Clock::now() : DiscoveryProfiler::Clock::time_point();
 
 		cRZAutoRefCount<cIGZPersistDBSegment> segment;
 
 		if (pState->pMultiPackedFile->FindDBSegment(key, segment.AsPPObj()))
 		{
 			cRZAutoRefCount<cIGZPersistDBRecord> record;
+			bool recordOpened = false;
+
+			{
+				DiscoveryProfiler::ScopedTimer timer(pProfiler, DiscoveryProfiler::Phase::OpenRecord);
+				recordOpened = segment->OpenRecord(key, record.AsPPObj(), cIGZFile::AccessMode::Read);
+			}
 
-			if (segment->OpenRecord(key, record.AsPPObj(), cIGZFile::AccessMode::Read))
+			if (recordOpened)
 			{
 				cRZAutoRefCount<cISCResExemplar> exemplar;
 
-				if (pState->pExemplarResourceFactory->CreateInstance(
-					*record,
-					GZIID_cISCResExemplar,
-					exemplar.AsPPVoid(),
-					0,
-					nullptr))
+				OrdinanceDiscoveryPipeline::ExemplarStatus status = OrdinanceDiscoveryPipeline::ExemplarStatus::InvalidData;
+				bool peeked = false;
+
 				{
-					const cISCPropertyHolder* pPropertyHolder = exemplar->AsISCPropertyHolder();
+					// Most of the exemplars in a mixed pack are not ordinances, the full
+					// exemplar is only created for the ones that are.
+					DiscoveryProfiler::ScopedTimer timer(pProfiler, DiscoveryProfiler::Phase::TypeValidation);
+					peeked = PeekExemplarStatus(record, pState->recordData, status);
+				}
 
-					uint32_t exemplarType = 0;
+				if (!peeked || status == OrdinanceDiscoveryPipeline::ExemplarStatus::Ordinance)
+				{
+					bool created = false;
 
-					if (SCPropertyUtil::GetPropertyValue(pPropertyHolder, kExemplarType, exemplarType))
 					{
-						if (exemplarType == kExemplarType_Ordinance)
-						{
-							// Prevent the Maxis key CLSID values from being reused.
-							// The CLSID values must be unique.
-							if (MaxisOrdinanceCLSIDs.contains(key.instance))
-							{
-								Logger::GetInstance().WriteLineFormatted(
-									LogLevel::Error,
-									"Exemplar instance id 0x%08x is the same as a Maxis ordinance id.",
-									key.instance);
-							}
-							else
-							{
-								pState->ordinanceKeys.emplace(key);
-							}
-						}
-						else
-						{
-							Logger::GetInstance().WriteLineFormatted(
-								LogLevel::Error,
-								"Exemplar 0x%08x, 0x%08x, 0x%08x does not have an ExemplarType of Ordinance.",
-								key.type,
-								key.group,
-								key.instance);
-						}
+						DiscoveryProfiler::ScopedTimer timer(pProfiler, DiscoveryProfiler::Phase::CreateInstance);
+						created = pState->pExemplarResourceFactory->CreateInstance(
+							*record,
+							GZIID_cISCResExemplar,
+							exemplar.AsPPVoid(),
+							0,
+							nullptr);
+					}
+
+					if (created)
+					{
+						DiscoveryProfiler::ScopedTimer timer(pProfiler, DiscoveryProfiler::Phase::TypeValidation);
+						status = GetExemplarStatus(exemplar);
 					}
 					else
 					{
-						Logger::GetInstance().WriteLineFormatted(
-							LogLevel::Error,
-							"Exemplar 0x%08x, 0x%08x, 0x%08x does not have an ExemplarType property.",
-							key.type,
-							key.group,
-							key.instance);
+						status = OrdinanceDiscoveryPipeline::ExemplarStatus::InvalidData;
 					}
 				}
-				else
+
+				if (ValidateOrdinanceExemplar(key, status))
 				{
-					Logger::GetInstance().WriteLineFormatted(
-						LogLevel::Error,
-						"Failed to parse 0x%08x, 0x%08x, 0x%08x.",
-						key.type,
-						key.group,
-						key.instance);
+					DiscoveryProfiler::ScopedTimer timer(pProfiler, DiscoveryProfiler::Phase::KeySetInsertion);
+
+					auto [it, inserted] = pState->ordinanceExemplars.try_emplace(key);
+
+					if (inserted)
+					{
+						it->second.exemplar = exemplar;
+
+						if (peeked)
+						{
+							// The table is left empty for text exemplars, their properties
+							// are read from the exemplar.
+							it->second.properties.Parse(pState->recordData);
+						}
+					}
+				}
+
+				if (pProfiler)
+				{
+					cRZBaseString segmentPath;
+					segment->GetPath(segmentPath);
+
+					pProfiler->AddRecord(
+						key,
+						std::string(segmentPath.ToChar(), segmentPath.Strlen()),
+						DiscoveryProfiler::Clock::now() - recordStart,
+						record->GetSize());
 				}
 
 				segment->CloseRecord(record);
@@ -292,7 +782,7 @@ public:
 		logFilePath /= PluginLogFileName;
 
 		Logger& logger = Logger::GetInstance();
-		logger.Init(logFilePath, LogLevel::Error);
+		logger.Init(logFilePath, GetConfiguredLogLevel(dllFolderPath / PluginConfigFileName));
 		logger.WriteLogFileHeader("SC4CustomOrdinanceHost v" PLUGIN_VERSION_STR);
 	}
 
@@ -303,7 +793,7 @@ public:
 
 	bool OnStart(cIGZCOM* pCOM) override
 	{
-		if (!customOrdinanceResourceKeys.empty())
+		if (!ordinanceRegistry.IsEmpty())
 		{
 			mpFrameWork->AddHook(this);
 		}
@@ -316,14 +806,11 @@ public:
 		// To retrieve an instance of a registered class the framework will call the
 		// GetClassObject method whenever it needs the director to provide one.
 
-		const auto it = std::ranges::find(
-			customOrdinanceResourceKeys,
-			rclsid,
-			&cGZPersistResourceKey::instance);
+		const size_t index = ordinanceRegistry.Find(rclsid);
 
-		if (it != customOrdinanceResourceKeys.end())
+		if (index != OrdinanceDefinitionRegistry::npos)
 		{
-			auto ordinance = new CustomOrdinance(*it);
+			auto ordinance = new CustomOrdinance(ordinanceRegistry.GetDefinition(index), &monthlyIncomeEngine, &availabilityConditionEngine, index);
 
 			if (ordinance->QueryInterface(riid, ppvObj))
 			{
@@ -346,12 +833,11 @@ public:
 
 		LoadCustomOrdinances();
 
-		if (!customOrdinanceResourceKeys.empty())
+		const size_t count = ordinanceRegistry.GetCount();
+
+		for (size_t i = 0; i < count; i++)
 		{
-			for (const auto& key : customOrdinanceResourceKeys)
-			{
-				pCallback(key.instance, 0, pContext);
-			}
+			pCallback(ordinanceRegistry.GetKey(i).instance, 0, pContext);
 		}
 	}
 
@@ -375,6 +861,8 @@ private:
 	{
 		cISC4City* pCity = static_cast<cISC4City*>(pStandardMsg->GetVoid1());
 
+		CityStatsSnapshot::GetInstance().Invalidate();
+
 		if (pCity)
 		{
 			spDemandSim = pCity->GetDemandSimulator();
@@ -388,26 +876,86 @@ private:
 
 			if (pOrdinanceSim)
 			{
-				for (const auto& key : customOrdinanceResourceKeys)
+				using Phase = CityLoadProfiler::Phase;
+
+				CityLoadProfiler& profiler = CityLoadProfiler::GetInstance();
+				const CityLoadProfiler::Clock::time_point start = profiler.IsEnabled() ? CityLoadProfiler::Clock::now() : CityLoadProfiler::Clock::time_point();
+
+				const size_t count = ordinanceRegistry.GetCount();
+
+				for (size_t i = 0; i < count; i++)
 				{
-					cISC4Ordinance* pOrdinance = pOrdinanceSim->GetOrdinanceByID(key.instance);
+					const uint32_t ordinanceID = ordinanceRegistry.GetKey(i).instance;
+					cISC4Ordinance* pOrdinance = nullptr;
+
+					{
+						CityLoadProfiler::ScopedTimer timer(Phase::GetOrdinanceByID, ordinanceID);
+						pOrdinance = pOrdinanceSim->GetOrdinanceByID(ordinanceID);
+					}
 
 					if (!pOrdinance)
 					{
+						CustomOrdinance* pNewOrdinance = nullptr;
+
+						{
+							CityLoadProfiler::ScopedTimer timer(Phase::CreateOrdinance, ordinanceID);
+
+							pNewOrdinance = new CustomOrdinance(ordinanceRegistry.GetDefinition(i), &monthlyIncomeEngine, &availabilityConditionEngine, i);
+							pNewOrdinance->Init();
+						}
+
 						auto ordinance = cRZAutoRefCount<CustomOrdinance>(
-							new CustomOrdinance(key),
+							pNewOrdinance,
 							cRZAutoRefCount<CustomOrdinance>::kAddRef);
-						ordinance->Init();
 
+						CityLoadProfiler::ScopedTimer timer(Phase::AddOrdinance, ordinanceID);
 						pOrdinanceSim->AddOrdinance(*ordinance);
 					}
 				}
+
+				CompileOrdinanceEngines();
+
+				if (profiler.IsEnabled())
+				{
+					profiler.WriteSummary(Logger::GetInstance(), CityLoadProfiler::Clock::now() - start);
+					SessionResourceCache::GetInstance().WriteCityLoadStatistics(Logger::GetInstance());
+				}
 			}
 		}
 	}
 
+	void CompileOrdinanceEngines()
+	{
+		// The definitions of all of the ordinances have been created when the city
+		// ordinances were loaded or added.
+		const size_t count = ordinanceRegistry.GetCount();
+
+		std::vector<std::shared_ptr<const OrdinanceDefinition>> definitions;
+		definitions.reserve(count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			definitions.push_back(ordinanceRegistry.GetDefinition(i));
+		}
+
+		monthlyIncomeEngine.Compile(definitions);
+		availabilityConditionEngine.Compile(definitions);
+	}
+
 	void PostCityShutdown()
 	{
+		// The definitions that the first city did not use are created on demand, the
+		// background thread is stopped so that it is never running when the game exits.
+		ordinanceRegistry.StopPrefetch();
+
+		// The samples for the next city load start with the deserialization of its ordinances.
+		CityLoadProfiler::GetInstance().Reset();
+		SessionResourceCache::GetInstance().ResetCityLoadStatistics();
+		SessionResourceCache::GetInstance().Clear();
+		monthlyIncomeEngine.Clear();
+		availabilityConditionEngine.Clear();
+		CityStatsSnapshot::GetInstance().Invalidate();
+
 		spDemandSim = nullptr;
 		spFireProtectionSim = nullptr;
 		spPoliceSim = nullptr;
@@ -435,11 +983,42 @@ private:
 			}
 		}
 
+		// The profiler is enabled after the ordinance discovery, its samples are limited
+		// to the city loads.
+		CityLoadProfiler::GetInstance().SetEnabled(logger.IsEnabled(LogLevel::Debug));
+
+		CityStatsSnapshot::GetInstance().SetSource(&GameCityStatsSource::GetInstance());
+
+		// The snapshot is filled again on the first read in each framework tick.
+		tickService = cRZAutoRefCount<CityStatsTickService>(
+			new CityStatsTickService(),
+			cRZAutoRefCount<CityStatsTickService>::kAddRef);
+
+		if (!mpFrameWork->AddSystemService(tickService) || !mpFrameWork->AddToTick(tickService))
+		{
+			logger.WriteLine(LogLevel::Error, "Failed to register the city statistics tick service.");
+		}
+
+		// The player is usually in the region view for a while before the first city
+		// is loaded, the ordinance definitions are decoded in the background.
+		ordinanceRegistry.StartPrefetch();
+
 		return true;
 	}
 
 	bool PreAppShutdown() override
 	{
+		ordinanceRegistry.StopPrefetch();
+
+		if (tickService)
+		{
+			mpFrameWork->RemoveFromTick(tickService);
+			mpFrameWork->RemoveSystemService(tickService);
+			tickService.Reset();
+		}
+
+		SessionResourceCache::GetInstance().Clear();
+
 		cIGZPersistResourceManager* localRM = spRM;
 		spRM = nullptr;
 
@@ -451,9 +1030,9 @@ private:
 		return true;
 	}
 
-	cRZBaseString GetCustomOrdinanceDirectoryPath()
+	std::filesystem::path GetUserPluginFolderPath()
 	{
-		cRZBaseString path;
+		std::filesystem::path path;
 
 		if (mpFrameWork)
 		{
@@ -471,8 +1050,7 @@ private:
 
 					if (tempPath.Strlen() > 0)
 					{
-						PathCombine(tempPath, "140-ordinances\\");
-						path = std::move(tempPath);
+						path = ToFileSystemPath(tempPath);
 					}
 				}
 			}
@@ -486,90 +1064,114 @@ private:
 	{
 		Logger& logger = Logger::GetInstance();
 
-		customOrdinanceResourceKeys.clear();
+		ordinanceRegistry.Clear();
 
-		const cRZBaseString customOrdinanceDir = GetCustomOrdinanceDirectoryPath();
+		const std::filesystem::path userPluginFolderPath = GetUserPluginFolderPath();
 
-		if (customOrdinanceDir.Strlen() > 0)
+		if (!userPluginFolderPath.empty())
 		{
-			logger.WriteLineFormatted(LogLevel::Info, "Ordinance folder path=%s", customOrdinanceDir.ToChar());
+			const std::filesystem::path dllFolderPath = GetDllFolderPath();
+			const std::filesystem::path configFilePath = dllFolderPath / PluginConfigFileName;
+			const std::filesystem::path discoveryIndexPath = dllFolderPath / DiscoveryIndexFileName;
+			const std::filesystem::path compiledPackPath = dllFolderPath / CompiledPackFileName;
+
+			// The earlier folders take precedence when an ordinance is in more than one folder.
+			const std::vector<std::filesystem::path> ordinanceFolders = GetConfiguredOrdinanceFolders(
+				configFilePath,
+				userPluginFolderPath,
+				GetInstallPluginFolderPath());
+
+			for (const std::filesystem::path& folder : ordinanceFolders)
+			{
+				logger.WriteLineFormatted(LogLevel::Info, "Ordinance folder path=%s", ToRZBaseString(folder).ToChar());
+			}
 
-			cRZAutoRefCount<cIGZPersistDBSegment> customOrdinanceFiles;
+			// The discovery phases are only timed when the Debug log level is enabled.
+			std::unique_ptr<DiscoveryProfiler> profiler;
 
-			if (mpCOM->GetClassObject(
-				GZCLSID_cGZPersistDBSegmentMultiPackedFiles,
-				GZIID_cIGZPersistDBSegment,
-				customOrdinanceFiles.AsPPVoid()))
+			if (logger.IsEnabled(LogLevel::Debug))
 			{
-				if (customOrdinanceFiles->Init())
-				{
-					if (customOrdinanceFiles->SetPath(customOrdinanceDir))
-					{
-						if (customOrdinanceFiles->Open(true, false))
-						{
-							cRZAutoRefCount<cIGZPersistResourceKeyList> list;
+				profiler = std::make_unique<DiscoveryProfiler>();
+			}
 
-							if (mpCOM->GetClassObject(
-								GZCLSID_cIGZPersistResourceKeyList,
-								GZIID_cIGZPersistResourceKeyList,
-								list.AsPPVoid()))
-							{
-								constexpr uint32_t kExemplarType = 0x6534284A;
+			// The key filter rejects the resources that can never be a custom ordinance
+			// before they are read. Overrides of the Maxis ordinances are silently ignored.
+			constexpr uint32_t kExemplarType = 0x6534284A;
 
-								cRZAutoRefCount<cIGZPersistResourceKeyFilter> filter(
-									new PersistResourceKeyFilterByType(kExemplarType),
-									cRZAutoRefCount<cIGZPersistResourceKeyFilter>::kAddRef);
+			cRZAutoRefCount<PersistResourceKeyFilterPipeline> keyFilter(
+				new PersistResourceKeyFilterPipeline(),
+				cRZAutoRefCount<PersistResourceKeyFilterPipeline>::kAddRef);
 
-								uint32_t matchCount = customOrdinanceFiles->GetResourceKeyList(list, filter);
+			keyFilter->RequireType("Exemplar type", kExemplarType);
+			keyFilter->ExcludeInstances(
+				"Maxis ordinance override",
+				std::vector<uint32_t>(MaxisOrdinanceCLSIDs.begin(), MaxisOrdinanceCLSIDs.end()),
+				kMaxisOrdinanceGroupID);
+			AddConfiguredKeyExclusions(*keyFilter, configFilePath);
 
-								if (matchCount > 0)
-								{
-									constexpr uint32_t kExemplarResourceFactoryCLSID = 0x453429B3;
-									cRZAutoRefCount<cIGZPersistResourceFactory> exemplarResourceFactory;
+			std::vector<FileInfo> ordinanceFiles;
+			bool enumeratedFiles = false;
 
-									if (mpCOM->GetClassObject(
-										kExemplarResourceFactoryCLSID,
-										GZIID_cIGZPersistResourceFactory,
-										exemplarResourceFactory.AsPPVoid()))
-									{
-										cRZAutoRefCount<cIGZPersistDBSegmentMultiPackedFiles> multiPackedFile;
+			{
+				DiscoveryProfiler::ScopedTimer timer(profiler.get(), DiscoveryProfiler::Phase::DirectoryEnumeration);
 
-										if (customOrdinanceFiles->QueryInterface(
-											GZIID_cIGZPersistDBSegmentMultiPackedFiles,
-											multiPackedFile.AsPPVoid()))
-										{
-											EnumResourceKeyContext context(multiPackedFile, exemplarResourceFactory);
+				const PluginFileEnumerator enumerator(
+					NativeFileSystem::GetInstance(),
+					GetConfiguredFileExtensions(configFilePath));
 
-											list->EnumKeys(EnumCustomOrdinanceResourceKeys, &context);
+				enumeratedFiles = enumerator.Enumerate(ordinanceFolders, ordinanceFiles);
+			}
 
-											const auto& ordinanceKeys = context.ordinanceKeys;
+			if (!enumeratedFiles)
+			{
+				logger.WriteLine(LogLevel::Error, "Failed to enumerate one or more of the ordinance folders.");
+			}
 
-											if (!ordinanceKeys.empty())
-											{
-												customOrdinanceResourceKeys.reserve(ordinanceKeys.size());
+			OrdinanceDiscoveryIndex discoveryIndex;
+			discoveryIndex.Load(discoveryIndexPath);
 
-												for (const auto& key : ordinanceKeys)
-												{
-													customOrdinanceResourceKeys.emplace_back(key);
-												}
-											}
-										}
-									}
-								}
-							}
+			bool filesUnchanged = false;
 
-							customOrdinanceFiles->Close();
-						}
-					}
+			{
+				DiscoveryProfiler::ScopedTimer timer(profiler.get(), DiscoveryProfiler::Phase::DiscoveryIndexRefresh);
+				filesUnchanged = discoveryIndex.Refresh(
+					ordinanceFolders,
+					ordinanceFiles,
+					keyFilter->GetConfigurationHash()) && enumeratedFiles;
+			}
 
-					customOrdinanceFiles->Shutdown();
-				}
+			if (!filesUnchanged)
+			{
+				// The compiled pack is out of date, it is written again when the
+				// ordinance folder can be read without the game's exemplar parser.
+				std::error_code ec;
+				std::filesystem::remove(compiledPackPath, ec);
+			}
+
+			if (!enumeratedFiles
+				|| !ReadCustomOrdinanceFiles(ordinanceFiles, discoveryIndex, filesUnchanged, compiledPackPath, *keyFilter, profiler.get()))
+			{
+				ScanCustomOrdinanceFolders(ordinanceFolders, keyFilter, profiler.get());
+			}
+
+			ordinanceRegistry.BuildLookupTable();
+
+			if (enumeratedFiles && discoveryIndex.IsModified() && !discoveryIndex.Save(discoveryIndexPath))
+			{
+				logger.WriteLine(LogLevel::Error, "Failed to save the ordinance discovery index.");
 			}
 
 			logger.WriteLineFormatted(
 				LogLevel::Info,
 				"Found %u ordinance exemplars.",
-				customOrdinanceResourceKeys.size());
+				ordinanceRegistry.GetCount());
+
+			if (profiler)
+			{
+				profiler->WriteSummary(logger);
+			}
+
+			keyFilter->WriteRejectionCounts(logger);
 		}
 		else
 		{
@@ -577,7 +1179,293 @@ private:
 		}
 	}
 
-	std::vector<cGZPersistResourceKey> customOrdinanceResourceKeys;
+	bool ReadCustomOrdinanceFiles(
+		const std::vector<FileInfo>& ordinanceFiles,
+		OrdinanceDiscoveryIndex& discoveryIndex,
+		bool filesUnchanged,
+		const std::filesystem::path& compiledPackPath,
+		PersistResourceKeyFilterPipeline& keyFilter,
+		DiscoveryProfiler* pProfiler)
+	{
+		using ExemplarStatus = OrdinanceDiscoveryPipeline::ExemplarStatus;
+
+		// Only the files that were added or changed since the discovery index was
+		// saved are read, the exemplars of the other files are in the index.
+		const std::vector<uint32_t> filesToDecode = discoveryIndex.GetFilesToDecode();
+
+		if (!filesToDecode.empty())
+		{
+			DiscoveryProfiler::ScopedTimer timer(pProfiler, DiscoveryProfiler::Phase::DirectoryRead);
+
+			std::vector<std::filesystem::path> paths;
+			paths.reserve(filesToDecode.size());
+
+			for (uint32_t fileIndex : filesToDecode)
+			{
+				paths.push_back(ordinanceFiles[fileIndex].path);
+			}
+
+			OrdinanceDiscoveryPipeline pipeline;
+			std::vector<OrdinanceDiscoveryPipeline::DiscoveredExemplar> decodedExemplars;
+
+			pipeline.Run(
+				paths,
+				decodedExemplars,
+				[&keyFilter](const cGZPersistResourceKey& key) { return keyFilter.IsKeyIncluded(key); });
+
+			// The file index of the pipeline results is the position in the path list.
+			std::vector<std::vector<OrdinanceDiscoveryPipeline::DiscoveredExemplar>> fileExemplars(paths.size());
+
+			for (OrdinanceDiscoveryPipeline::DiscoveredExemplar& item : decodedExemplars)
+			{
+				fileExemplars[item.fileIndex].push_back(std::move(item));
+			}
+
+			for (size_t i = 0; i < filesToDecode.size(); i++)
+			{
+				discoveryIndex.SetFileExemplars(filesToDecode[i], std::move(fileExemplars[i]));
+			}
+		}
+
+		std::vector<OrdinanceDiscoveryPipeline::DiscoveredExemplar> exemplars;
+		discoveryIndex.GetExemplars(exemplars);
+
+		if (RequiresGameExemplarParser(exemplars))
+		{
+			// The game's resource system is used for all of the folders, this ensures
+			// that the errors are only logged once.
+			Logger::GetInstance().WriteLine(
+				LogLevel::Info,
+				"The ordinance folders have exemplars that require the game's exemplar parser.");
+			return false;
+		}
+
+		const size_t ordinanceCount = static_cast<size_t>(std::count_if(
+			exemplars.begin(),
+			exemplars.end(),
+			[](const OrdinanceDiscoveryPipeline::DiscoveredExemplar& item) { return item.status == ExemplarStatus::Ordinance; }));
+
+		ordinanceRegistry.Reserve(ordinanceCount);
+
+		// The exemplars are in the folder precedence order and then in path order,
+		// the first exemplar that uses an instance id is kept.
+		std::unordered_map<uint32_t, OrdinanceDiscoveryPipeline::DiscoveredExemplar*> ordinances;
+		ordinances.reserve(ordinanceCount);
+
+		for (OrdinanceDiscoveryPipeline::DiscoveredExemplar& item : exemplars)
+		{
+			if (ValidateOrdinanceExemplar(item.key, item.status))
+			{
+				const auto [it, inserted] = ordinances.try_emplace(item.key.instance, &item);
+
+				if (!inserted)
+				{
+					const cGZPersistResourceKey& keptKey = it->second->key;
+
+					Logger::GetInstance().WriteLineFormatted(
+						LogLevel::Error,
+						"Ignored exemplar 0x%08x, 0x%08x, 0x%08x in %s, the instance id is already used by 0x%08x, 0x%08x, 0x%08x in %s.",
+						item.key.type,
+						item.key.group,
+						item.key.instance,
+						ToRZBaseString(ordinanceFiles[item.fileIndex].path).ToChar(),
+						keptKey.type,
+						keptKey.group,
+						keptKey.instance,
+						ToRZBaseString(ordinanceFiles[it->second->fileIndex].path).ToChar());
+				}
+			}
+		}
+
+		// The kept ordinances, in the file order.
+		std::vector<OrdinanceDiscoveryPipeline::DiscoveredExemplar*> keptOrdinances;
+		keptOrdinances.reserve(ordinances.size());
+
+		for (OrdinanceDiscoveryPipeline::DiscoveredExemplar& item : exemplars)
+		{
+			const auto it = ordinances.find(item.key.instance);
+
+			if (it != ordinances.end() && it->second == &item)
+			{
+				keptOrdinances.push_back(&item);
+			}
+		}
+
+		if (filesUnchanged)
+		{
+			std::vector<cGZPersistResourceKey> ordinanceKeys;
+			ordinanceKeys.reserve(keptOrdinances.size());
+
+			for (const OrdinanceDiscoveryPipeline::DiscoveredExemplar* item : keptOrdinances)
+			{
+				ordinanceKeys.push_back(item->key);
+			}
+
+			CompiledOrdinancePack compiledPack;
+
+			if (compiledPack.Open(compiledPackPath) && CompiledPackMatchesKeys(compiledPack, ordinanceKeys))
+			{
+				// The ordinance definitions will be created from the compiled pack.
+				ordinanceRegistry.AddCompiledPack(std::move(compiledPack));
+
+				Logger::GetInstance().WriteLine(LogLevel::Info, "Using the compiled ordinance pack.");
+				return true;
+			}
+		}
+
+		// The compiled pack is only written when it has all of the ordinances.
+		CompiledOrdinancePackWriter compiledPackWriter;
+		bool compiledPackComplete = true;
+
+		for (OrdinanceDiscoveryPipeline::DiscoveredExemplar* pItem : keptOrdinances)
+		{
+			OrdinanceDiscoveryPipeline::DiscoveredExemplar& item = *pItem;
+
+			if (compiledPackComplete)
+			{
+				compiledPackComplete = compiledPackWriter.Add(
+					item.key.type,
+					item.key.group,
+					item.key.instance,
+					item.properties);
+			}
+
+			// The definition is created from the decoded properties, the game's
+			// exemplar is only loaded if the game reads the ordinance's properties.
+			ordinanceRegistry.Add(item.key, nullptr, std::move(item.properties));
+		}
+
+		if (compiledPackComplete && !compiledPackWriter.Save(compiledPackPath))
+		{
+			Logger::GetInstance().WriteLine(LogLevel::Error, "Failed to save the compiled ordinance pack.");
+		}
+
+		return true;
+	}
+
+	bool ScanCustomOrdinanceFolders(
+		const std::vector<std::filesystem::path>& ordinanceFolders,
+		cIGZPersistResourceKeyFilter* pKeyFilter,
+		DiscoveryProfiler* pProfiler)
+	{
+		OrdinanceExemplarMap ordinanceExemplars;
+
+		for (const std::filesystem::path& folder : ordinanceFolders)
+		{
+			if (NativeFileSystem::GetInstance().DirectoryExists(folder))
+			{
+				// The segment path must end with a directory separator.
+				if (!ScanCustomOrdinanceDirectory(ToRZBaseString(folder / ""), ordinanceExemplars, pKeyFilter, pProfiler))
+				{
+					return false;
+				}
+			}
+		}
+
+		if (!ordinanceExemplars.empty())
+		{
+			ordinanceRegistry.Reserve(ordinanceExemplars.size());
+
+			for (auto& [key, item] : ordinanceExemplars)
+			{
+				ordinanceRegistry.Add(key, item.exemplar, std::move(item.properties));
+			}
+		}
+
+		return true;
+	}
+
+	bool ScanCustomOrdinanceDirectory(
+		const cRZBaseString& customOrdinanceDir,
+		OrdinanceExemplarMap& ordinanceExemplars,
+		cIGZPersistResourceKeyFilter* pKeyFilter,
+		DiscoveryProfiler* pProfiler)
+	{
+		bool result = false;
+
+		cRZAutoRefCount<cIGZPersistDBSegment> customOrdinanceFiles;
+
+		if (mpCOM->GetClassObject(
+			GZCLSID_cGZPersistDBSegmentMultiPackedFiles,
+			GZIID_cIGZPersistDBSegment,
+			customOrdinanceFiles.AsPPVoid()))
+		{
+			if (customOrdinanceFiles->Init())
+			{
+				if (customOrdinanceFiles->SetPath(customOrdinanceDir))
+				{
+					bool segmentOpened = false;
+
+					{
+						DiscoveryProfiler::ScopedTimer timer(pProfiler, DiscoveryProfiler::Phase::SegmentOpen);
+						segmentOpened = customOrdinanceFiles->Open(true, false);
+					}
+
+					if (segmentOpened)
+					{
+						cRZAutoRefCount<cIGZPersistResourceKeyList> list;
+
+						if (mpCOM->GetClassObject(
+							GZCLSID_cIGZPersistResourceKeyList,
+							GZIID_cIGZPersistResourceKeyList,
+							list.AsPPVoid()))
+						{
+							uint32_t matchCount = 0;
+
+							{
+								DiscoveryProfiler::ScopedTimer timer(pProfiler, DiscoveryProfiler::Phase::GetResourceKeyList);
+								matchCount = customOrdinanceFiles->GetResourceKeyList(list, pKeyFilter);
+							}
+
+							if (matchCount == 0)
+							{
+								result = true;
+							}
+							else
+							{
+								constexpr uint32_t kExemplarResourceFactoryCLSID = 0x453429B3;
+								cRZAutoRefCount<cIGZPersistResourceFactory> exemplarResourceFactory;
+
+								if (mpCOM->GetClassObject(
+									kExemplarResourceFactoryCLSID,
+									GZIID_cIGZPersistResourceFactory,
+									exemplarResourceFactory.AsPPVoid()))
+								{
+									cRZAutoRefCount<cIGZPersistDBSegmentMultiPackedFiles> multiPackedFile;
+
+									if (customOrdinanceFiles->QueryInterface(
+										GZIID_cIGZPersistDBSegmentMultiPackedFiles,
+										multiPackedFile.AsPPVoid()))
+									{
+										EnumResourceKeyContext context(
+											multiPackedFile,
+											exemplarResourceFactory,
+											ordinanceExemplars,
+											pProfiler);
+
+										list->EnumKeys(EnumCustomOrdinanceResourceKeys, &context);
+
+										result = true;
+									}
+								}
+							}
+						}
+
+						customOrdinanceFiles->Close();
+					}
+				}
+
+				customOrdinanceFiles->Shutdown();
+			}
+		}
+
+		return result;
+	}
+
+	OrdinanceDefinitionRegistry ordinanceRegistry;
+	MonthlyIncomeEngine monthlyIncomeEngine;
+	AvailabilityConditionEngine availabilityConditionEngine;
+	cRZAutoRefCount<CityStatsTickService> tickService;
 };
 
 cRZCOMDllDirector* RZGetCOMDllDirector() {
@@ -0,0 +1,210 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DBPFFile.h"
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+
+namespace
+{
+	constexpr uint32_t DBPFSignature = 0x46504244; // DBPF
+	constexpr uint32_t CompressedRecordDirectoryType = 0xE86B1EEF;
+
+	constexpr size_t HeaderSize = 96;
+	constexpr size_t IndexEntrySize = 20;
+	constexpr size_t CompressedRecordDirectoryEntrySize = 16;
+
+	// The DBPF fields are stored in little-endian byte order.
+	uint32_t ReadUint32(const uint8_t* data)
+	{
+		return static_cast<uint32_t>(data[0])
+			| (static_cast<uint32_t>(data[1]) << 8)
+			| (static_cast<uint32_t>(data[2]) << 16)
+			| (static_cast<uint32_t>(data[3]) << 24);
+	}
+
+	bool IsInRange(size_t fileSize, uint64_t offset, uint64_t length)
+	{
+		return offset <= fileSize && length <= fileSize - offset;
+	}
+}
+
+DBPFFile::DBPFFile()
+	: indexTable(),
+	  indexEntryCount(0),
+	  compressedRecords()
+{
+}
+
+bool DBPFFile::Open(const std::filesystem::path& path)
+{
+	Close();
+
+	if (!file.Open(path))
+	{
+		return false;
+	}
+
+	const std::span<const uint8_t> data = file.GetData();
+
+	if (data.size() < HeaderSize)
+	{
+		Close();
+		return false;
+	}
+
+	const uint8_t* header = data.data();
+
+	const uint32_t signature = ReadUint32(header);
+	const uint32_t majorVersion = ReadUint32(header + 4);
+	const uint32_t minorVersion = ReadUint32(header + 8);
+	const uint32_t indexMajorVersion = ReadUint32(header + 32);
+	const uint32_t indexCount = ReadUint32(header + 36);
+	const uint32_t indexOffset = ReadUint32(header + 40);
+	const uint32_t indexSize = ReadUint32(header + 44);
+
+	// SC4 only uses DBPF 1.0 with a version 7.0 index.
+	if (signature != DBPFSignature
+		|| majorVersion != 1
+		|| minorVersion != 0
+		|| indexMajorVersion != 7
+		|| static_cast<uint64_t>(indexCount) * IndexEntrySize > indexSize
+		|| !IsInRange(data.size(), indexOffset, indexSize))
+	{
+		Close();
+		return false;
+	}
+
+	indexTable = data.subspan(indexOffset, static_cast<size_t>(indexCount) * IndexEntrySize);
+	indexEntryCount = indexCount;
+
+	if (!ReadCompressedRecordDirectory())
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void DBPFFile::Close()
+{
+	file.Close();
+	indexTable = std::span<const uint8_t>();
+	indexEntryCount = 0;
+	compressedRecords.clear();
+}
+
+bool DBPFFile::IsOpen() const
+{
+	return file.IsOpen();
+}
+
+uint32_t DBPFFile::GetIndexEntryCount() const
+{
+	return indexEntryCount;
+}
+
+DBPFFile::IndexEntry DBPFFile::GetIndexEntry(uint32_t index) const
+{
+	const uint8_t* entry = indexTable.data() + (static_cast<size_t>(index) * IndexEntrySize);
+
+	IndexEntry result{};
+	result.type = ReadUint32(entry);
+	result.group = ReadUint32(entry + 4);
+	result.instance = ReadUint32(entry + 8);
+	result.offset = ReadUint32(entry + 12);
+	result.size = ReadUint32(entry + 16);
+
+	return result;
+}
+
+std::span<const uint8_t> DBPFFile::GetRecordData(const IndexEntry& entry) const
+{
+	const std::span<const uint8_t> data = file.GetData();
+
+	if (!IsInRange(data.size(), entry.offset, entry.size))
+	{
+		return std::span<const uint8_t>();
+	}
+
+	return data.subspan(entry.offset, entry.size);
+}
+
+bool DBPFFile::IsRecordCompressed(const IndexEntry& entry) const
+{
+	const auto it = std::lower_bound(
+		compressedRecords.begin(),
+		compressedRecords.end(),
+		entry,
+		[](const CompressedRecordKey& lhs, const IndexEntry& rhs)
+		{
+			return std::tie(lhs.type, lhs.group, lhs.instance) < std::tie(rhs.type, rhs.group, rhs.instance);
+		});
+
+	return it != compressedRecords.end()
+		&& it->type == entry.type
+		&& it->group == entry.group
+		&& it->instance == entry.instance;
+}
+
+bool DBPFFile::ReadCompressedRecordDirectory()
+{
+	for (uint32_t i = 0; i < indexEntryCount; i++)
+	{
+		const IndexEntry entry = GetIndexEntry(i);
+
+		if (entry.type == CompressedRecordDirectoryType)
+		{
+			const std::span<const uint8_t> directory = GetRecordData(entry);
+
+			if (directory.size() != entry.size)
+			{
+				return false;
+			}
+
+			const size_t count = directory.size() / CompressedRecordDirectoryEntrySize;
+			compressedRecords.reserve(count);
+
+			for (size_t j = 0; j < count; j++)
+			{
+				const uint8_t* item = directory.data() + (j * CompressedRecordDirectoryEntrySize);
+
+				compressedRecords.push_back(CompressedRecordKey{
+					ReadUint32(item),
+					ReadUint32(item + 4),
+					ReadUint32(item + 8) });
+			}
+
+			std::sort(
+				compressedRecords.begin(),
+				compressedRecords.end(),
+				[](const CompressedRecordKey& lhs, const CompressedRecordKey& rhs)
+				{
+					return std::tie(lhs.type, lhs.group, lhs.instance) < std::tie(rhs.type, rhs.group, rhs.instance);
+				});
+			break;
+		}
+	}
+
+	return true;
+}
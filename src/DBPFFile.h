@@ -0,0 +1,77 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "MemoryMappedFile.h"
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+// A read-only DBPF 1.0 file reader that does not use the game's resource system.
+// The file is memory mapped, the index table and record data are read in place.
+class DBPFFile
+{
+public:
+	struct IndexEntry
+	{
+		uint32_t type;
+		uint32_t group;
+		uint32_t instance;
+		uint32_t offset;
+		uint32_t size;
+	};
+
+	DBPFFile();
+
+	// Opens the file and validates the header and index table.
+	// Returns false if the file is not a valid DBPF 1.0 file.
+	bool Open(const std::filesystem::path& path);
+	void Close();
+
+	bool IsOpen() const;
+
+	uint32_t GetIndexEntryCount() const;
+	IndexEntry GetIndexEntry(uint32_t index) const;
+
+	// Gets the data of the record, without decompressing it.
+	// Returns an empty span if the record is outside of the file.
+	std::span<const uint8_t> GetRecordData(const IndexEntry& entry) const;
+
+	// Gets a value indicating whether the record is listed in the
+	// compressed record directory.
+	bool IsRecordCompressed(const IndexEntry& entry) const;
+
+private:
+	struct CompressedRecordKey
+	{
+		uint32_t type;
+		uint32_t group;
+		uint32_t instance;
+	};
+
+	bool ReadCompressedRecordDirectory();
+
+	MemoryMappedFile file;
+	std::span<const uint8_t> indexTable;
+	uint32_t indexEntryCount;
+	std::vector<CompressedRecordKey> compressedRecords;
+};
@@ -0,0 +1,191 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DiscoveryProfiler.h"
+#include "Logger.h"
+#include <algorithm>
+
+namespace
+{
+	constexpr size_t SlowestItemCount = 10;
+
+	constexpr std::array<const char*, static_cast<size_t>(DiscoveryProfiler::Phase::Count)> PhaseNames =
+	{
+		"Directory enumeration",
+		"Discovery index refresh",
+		"Directory read",
+		"Segment Open",
+		"GetResourceKeyList",
+		"OpenRecord",
+		"Exemplar CreateInstance",
+		"Type validation",
+		"Key set insertion",
+	};
+
+	double ToMilliseconds(DiscoveryProfiler::Clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+}
+
+DiscoveryProfiler::ScopedTimer::ScopedTimer(DiscoveryProfiler* pProfiler, Phase phase)
+	: pProfiler(pProfiler),
+	  phase(phase),
+	  start(pProfiler ? Clock::now() : Clock::time_point())
+{
+}
+
+DiscoveryProfiler::ScopedTimer::~ScopedTimer()
+{
+	if (pProfiler)
+	{
+		pProfiler->AddPhaseTime(phase, Clock::now() - start);
+	}
+}
+
+DiscoveryProfiler::DiscoveryProfiler()
+	: phases(),
+	  files(),
+	  records(),
+	  totalBytesRead(0)
+{
+}
+
+void DiscoveryProfiler::AddPhaseTime(Phase phase, Clock::duration elapsed)
+{
+	PhaseStatistics& statistics = phases[static_cast<size_t>(phase)];
+
+	statistics.total += elapsed;
+	statistics.count++;
+}
+
+void DiscoveryProfiler::AddRecord(
+	const cGZPersistResourceKey& key,
+	const std::string& filePath,
+	Clock::duration elapsed,
+	uint64_t bytesRead)
+{
+	// The map node addresses are stable, the records point to the key string.
+	auto it = files.try_emplace(filePath, FileStatistics{}).first;
+
+	it->second.total += elapsed;
+	it->second.recordCount++;
+	it->second.bytesRead += bytesRead;
+
+	records.push_back(RecordStatistics{ key, &it->first, elapsed, bytesRead });
+	totalBytesRead += bytesRead;
+}
+
+void DiscoveryProfiler::WriteSummary(Logger& logger) const
+{
+	logger.WriteLine(LogLevel::Debug, "Ordinance discovery timing:");
+
+	for (size_t i = 0; i < phases.size(); i++)
+	{
+		const PhaseStatistics& statistics = phases[i];
+
+		if (statistics.count > 0)
+		{
+			logger.WriteLineFormatted(
+				LogLevel::Debug,
+				"  %s: %.3f ms, %u calls",
+				PhaseNames[i],
+				ToMilliseconds(statistics.total),
+				statistics.count);
+		}
+	}
+
+	if (records.empty())
+	{
+		return;
+	}
+
+	logger.WriteLineFormatted(
+		LogLevel::Debug,
+		"  Read %llu bytes from %zu records in %zu files.",
+		static_cast<unsigned long long>(totalBytesRead),
+		records.size(),
+		files.size());
+
+	std::vector<std::pair<const std::string*, const FileStatistics*>> slowestFiles;
+	slowestFiles.reserve(files.size());
+
+	for (const auto& [path, statistics] : files)
+	{
+		slowestFiles.emplace_back(&path, &statistics);
+	}
+
+	const size_t fileCount = std::min(slowestFiles.size(), SlowestItemCount);
+
+	std::partial_sort(
+		slowestFiles.begin(),
+		slowestFiles.begin() + fileCount,
+		slowestFiles.end(),
+		[](const auto& lhs, const auto& rhs) { return lhs.second->total > rhs.second->total; });
+
+	logger.WriteLine(LogLevel::Debug, "  Slowest files:");
+
+	for (size_t i = 0; i < fileCount; i++)
+	{
+		const FileStatistics& statistics = *slowestFiles[i].second;
+
+		logger.WriteLineFormatted(
+			LogLevel::Debug,
+			"    %.3f ms, %u records, %llu bytes: %s",
+			ToMilliseconds(statistics.total),
+			statistics.recordCount,
+			static_cast<unsigned long long>(statistics.bytesRead),
+			slowestFiles[i].first->c_str());
+	}
+
+	std::vector<const RecordStatistics*> slowestRecords;
+	slowestRecords.reserve(records.size());
+
+	for (const RecordStatistics& record : records)
+	{
+		slowestRecords.push_back(&record);
+	}
+
+	const size_t recordCount = std::min(slowestRecords.size(), SlowestItemCount);
+
+	std::partial_sort(
+		slowestRecords.begin(),
+		slowestRecords.begin() + recordCount,
+		slowestRecords.end(),
+		[](const RecordStatistics* lhs, const RecordStatistics* rhs) { return lhs->elapsed > rhs->elapsed; });
+
+	logger.WriteLine(LogLevel::Debug, "  Slowest records:");
+
+	for (size_t i = 0; i < recordCount; i++)
+	{
+		const RecordStatistics& record = *slowestRecords[i];
+
+		logger.WriteLineFormatted(
+			LogLevel::Debug,
+			"    %.3f ms, %llu bytes: 0x%08x, 0x%08x, 0x%08x in %s",
+			ToMilliseconds(record.elapsed),
+			static_cast<unsigned long long>(record.bytesRead),
+			record.key.type,
+			record.key.group,
+			record.key.instance,
+			record.filePath->c_str());
+	}
+}
@@ -0,0 +1,111 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "cGZPersistResourceKey.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Logger;
+
+// Collects the timing information for the ordinance discovery phases.
+// The profiler is only created when the Debug log level is enabled, all of the
+// instrumentation takes a pointer to the profiler and does nothing when it is null.
+class DiscoveryProfiler
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	enum class Phase : uint32_t
+	{
+		DirectoryEnumeration = 0,
+		DiscoveryIndexRefresh,
+		DirectoryRead,
+		SegmentOpen,
+		GetResourceKeyList,
+		OpenRecord,
+		CreateInstance,
+		TypeValidation,
+		KeySetInsertion,
+		Count
+	};
+
+	// Adds the time between the constructor and destructor to a phase.
+	class ScopedTimer
+	{
+	public:
+		ScopedTimer(DiscoveryProfiler* pProfiler, Phase phase);
+		~ScopedTimer();
+
+		ScopedTimer(const ScopedTimer& other) = delete;
+		ScopedTimer& operator=(const ScopedTimer& other) = delete;
+
+	private:
+		DiscoveryProfiler* pProfiler;
+		Phase phase;
+		Clock::time_point start;
+	};
+
+	DiscoveryProfiler();
+
+	void AddPhaseTime(Phase phase, Clock::duration elapsed);
+
+	// Adds the total time that was spent loading a record.
+	void AddRecord(
+		const cGZPersistResourceKey& key,
+		const std::string& filePath,
+		Clock::duration elapsed,
+		uint64_t bytesRead);
+
+	// Writes the phase totals, and the slowest files and records to the log.
+	void WriteSummary(Logger& logger) const;
+
+private:
+	struct PhaseStatistics
+	{
+		Clock::duration total;
+		uint32_t count;
+	};
+
+	struct FileStatistics
+	{
+		Clock::duration total;
+		uint32_t recordCount;
+		uint64_t bytesRead;
+	};
+
+	struct RecordStatistics
+	{
+		cGZPersistResourceKey key;
+		const std::string* filePath;
+		Clock::duration elapsed;
+		uint64_t bytesRead;
+	};
+
+	std::array<PhaseStatistics, static_cast<size_t>(Phase::Count)> phases;
+	std::unordered_map<std::string, FileStatistics> files;
+	std::vector<RecordStatistics> records;
+	uint64_t totalBytesRead;
+};
@@ -27,18 +27,32 @@
 #include "GlobalPointers.h"
 #include "GZStreamUtil.h"
 
+namespace
+{
+	bool IsValidKey(const cGZPersistResourceKey& key)
+	{
+		return key.type != 0 && key.group != 0 && key.instance != 0;
+	}
+}
+
 ExemplarPropertyHolder::ExemplarPropertyHolder()
-	: refCount(0), defaultExemplar()
+	: refCount(0), defaultExemplar(), defaultExemplarLoaded(true), defaultExemplarKey()
 {
 }
 
 ExemplarPropertyHolder::ExemplarPropertyHolder(const ExemplarPropertyHolder& other)
-	: refCount(other.refCount), defaultExemplar(other.defaultExemplar)
+	: refCount(other.refCount),
+	  defaultExemplar(other.defaultExemplar),
+	  defaultExemplarLoaded(other.defaultExemplarLoaded),
+	  defaultExemplarKey(other.defaultExemplarKey)
 {
 }
 
 ExemplarPropertyHolder::ExemplarPropertyHolder(ExemplarPropertyHolder&& other) noexcept
-	: refCount(other.refCount), defaultExemplar(std::move(other.defaultExemplar))
+	: refCount(other.refCount),
+	  defaultExemplar(std::move(other.defaultExemplar)),
+	  defaultExemplarLoaded(other.defaultExemplarLoaded),
+	  defaultExemplarKey(other.defaultExemplarKey)
 {
 }
 
@@ -46,6 +60,8 @@ ExemplarPropertyHolder& ExemplarPropertyHolder::operator=(const ExemplarProperty
 {
 	refCount = other.refCount;
 	defaultExemplar = other.defaultExemplar;
+	defaultExemplarLoaded = other.defaultExemplarLoaded;
+	defaultExemplarKey = other.defaultExemplarKey;
 
 	return *this;
 }
@@ -54,6 +70,8 @@ ExemplarPropertyHolder& ExemplarPropertyHolder::operator=(ExemplarPropertyHolder
 {
 	refCount = other.refCount;
 	defaultExemplar = std::move(other.defaultExemplar);
+	defaultExemplarLoaded = other.defaultExemplarLoaded;
+	defaultExemplarKey = other.defaultExemplarKey;
 
 	return *this;
 }
@@ -105,9 +123,11 @@ bool ExemplarPropertyHolder::HasProperty(uint32_t dwProperty) const
 {
 	bool result = false;
 
-	if (defaultExemplar)
+	cISCPropertyHolder* pPropertyHolder = GetDefaultPropertyHolder();
+
+	if (pPropertyHolder)
 	{
-		result = defaultExemplar->AsISCPropertyHolder()->HasProperty(dwProperty);
+		result = pPropertyHolder->HasProperty(dwProperty);
 	}
 
 	return result;
@@ -117,9 +137,11 @@ bool ExemplarPropertyHolder::GetPropertyList(cIGZUnknownList** ppList) const
 {
 	bool result = false;
 
-	if (defaultExemplar)
+	cISCPropertyHolder* pPropertyHolder = GetDefaultPropertyHolder();
+
+	if (pPropertyHolder)
 	{
-		result = defaultExemplar->AsISCPropertyHolder()->GetPropertyList(ppList);
+		result = pPropertyHolder->GetPropertyList(ppList);
 	}
 
 	return result;
@@ -129,9 +151,11 @@ cISCProperty* ExemplarPropertyHolder::GetProperty(uint32_t dwProperty) const
 {
 	cISCProperty* pProperty = nullptr;
 
-	if (defaultExemplar)
+	cISCPropertyHolder* pPropertyHolder = GetDefaultPropertyHolder();
+
+	if (pPropertyHolder)
 	{
-		pProperty = defaultExemplar->AsISCPropertyHolder()->GetProperty(dwProperty);
+		pProperty = pPropertyHolder->GetProperty(dwProperty);
 	}
 
 	return pProperty;
@@ -141,9 +165,11 @@ bool ExemplarPropertyHolder::GetProperty(uint32_t dwProperty, uint32_t& dwValueO
 {
 	bool result = false;
 
-	if (defaultExemplar)
+	cISCPropertyHolder* pPropertyHolder = GetDefaultPropertyHolder();
+
+	if (pPropertyHolder)
 	{
-		result = defaultExemplar->AsISCPropertyHolder()->GetProperty(dwProperty, dwValueOut);
+		result = pPropertyHolder->GetProperty(dwProperty, dwValueOut);
 	}
 
 	return result;
@@ -153,9 +179,11 @@ bool ExemplarPropertyHolder::GetProperty(uint32_t dwProperty, cIGZString& szValu
 {
 	bool result = false;
 
-	if (defaultExemplar)
+	cISCPropertyHolder* pPropertyHolder = GetDefaultPropertyHolder();
+
+	if (pPropertyHolder)
 	{
-		result = defaultExemplar->AsISCPropertyHolder()->GetProperty(dwProperty, szValueOut);
+		result = pPropertyHolder->GetProperty(dwProperty, szValueOut);
 	}
 
 	return result;
@@ -165,9 +193,11 @@ bool ExemplarPropertyHolder::GetProperty(uint32_t dwProperty, uint32_t riid, voi
 {
 	bool result = false;
 
-	if (defaultExemplar)
+	cISCPropertyHolder* pPropertyHolder = GetDefaultPropertyHolder();
+
+	if (pPropertyHolder)
 	{
-		result = defaultExemplar->AsISCPropertyHolder()->GetProperty(dwProperty, riid, ppvObj);
+		result = pPropertyHolder->GetProperty(dwProperty, riid, ppvObj);
 	}
 
 	return result;
@@ -177,9 +207,11 @@ bool ExemplarPropertyHolder::GetProperty(uint32_t dwProperty, void* pUnknown, ui
 {
 	bool result = false;
 
-	if (defaultExemplar)
+	cISCPropertyHolder* pPropertyHolder = GetDefaultPropertyHolder();
+
+	if (pPropertyHolder)
 	{
-		result = defaultExemplar->AsISCPropertyHolder()->GetProperty(dwProperty, pUnknown, dwUnknownOut);
+		result = pPropertyHolder->GetProperty(dwProperty, pUnknown, dwUnknownOut);
 	}
 
 	return result;
@@ -234,9 +266,11 @@ bool ExemplarPropertyHolder::EnumProperties(FunctionPtr1 pFunction1, void* pData
 {
 	bool result = false;
 
-	if (defaultExemplar)
+	cISCPropertyHolder* pPropertyHolder = GetDefaultPropertyHolder();
+
+	if (pPropertyHolder)
 	{
-		result = defaultExemplar->AsISCPropertyHolder()->EnumProperties(pFunction1, pData);
+		result = pPropertyHolder->EnumProperties(pFunction1, pData);
 	}
 
 	return result;
@@ -246,9 +280,11 @@ bool ExemplarPropertyHolder::EnumProperties(FunctionPtr2 pFunction2, FunctionPtr
 {
 	bool result = false;
 
-	if (defaultExemplar)
+	cISCPropertyHolder* pPropertyHolder = GetDefaultPropertyHolder();
+
+	if (pPropertyHolder)
 	{
-		result = defaultExemplar->AsISCPropertyHolder()->EnumProperties(pFunction2, pFunctionPipe);
+		result = pPropertyHolder->EnumProperties(pFunction2, pFunctionPipe);
 	}
 
 	return result;
@@ -262,11 +298,29 @@ bool ExemplarPropertyHolder::CompactProperties(void)
 bool ExemplarPropertyHolder::SetDefaultExemplar(cISCResExemplar* pExemplar)
 {
 	defaultExemplar = pExemplar;
+	defaultExemplarLoaded = true;
+	defaultExemplarKey = cGZPersistResourceKey();
+
+	if (pExemplar)
+	{
+		pExemplar->GetKey(defaultExemplarKey);
+	}
+
+	return true;
+}
+
+bool ExemplarPropertyHolder::SetDefaultExemplar(cISCResExemplar* pExemplar, const cGZPersistResourceKey& key)
+{
+	defaultExemplar = pExemplar;
+	defaultExemplarLoaded = pExemplar || !IsValidKey(key);
+	defaultExemplarKey = pExemplar || IsValidKey(key) ? key : cGZPersistResourceKey();
 	return true;
 }
 
 cISCResExemplar* ExemplarPropertyHolder::GetDefaultExemplar(void)
 {
+	GetDefaultPropertyHolder();
+
 	return defaultExemplar;
 }
 
@@ -286,24 +340,8 @@ bool ExemplarPropertyHolder::Read(cIGZIStream& stream)
 		return false;
 	}
 
-	if (key.type != 0 && key.group != 0 && key.instance != 0)
-	{
-		cRZAutoRefCount<cISCResExemplar> exemplar;
-
-		if (spRM->GetPrivateResource(
-			key,
-			GZIID_cISCResExemplar,
-			exemplar.AsPPVoid(),
-			0,
-			nullptr))
-		{
-			defaultExemplar = exemplar;
-		}
-	}
-	else
-	{
-		defaultExemplar.Reset();
-	}
+	// The exemplar is loaded when it is first used.
+	SetDefaultExemplar(nullptr, key);
 
 	return true;
 }
@@ -315,13 +353,29 @@ bool ExemplarPropertyHolder::Write(cIGZOStream& stream)
 		return false;
 	}
 
-	cGZPersistResourceKey key;
+	return GZStreamUtil::WriteResKey(stream, defaultExemplarKey);
+}
 
-	if (defaultExemplar)
+cISCPropertyHolder* ExemplarPropertyHolder::GetDefaultPropertyHolder() const
+{
+	if (!defaultExemplarLoaded)
 	{
-		defaultExemplar->GetKey(key);
+		defaultExemplarLoaded = true;
+
+		// Each property holder has its own private copy of the exemplar, the copies
+		// are not shared between ordinances or cities.
+		if (!spRM
+			|| !spRM->GetPrivateResource(
+				defaultExemplarKey,
+				GZIID_cISCResExemplar,
+				defaultExemplar.AsPPVoid(),
+				0,
+				nullptr))
+		{
+			defaultExemplar.Reset();
+		}
 	}
 
-	return GZStreamUtil::WriteResKey(stream, key);
+	return defaultExemplar ? defaultExemplar->AsISCPropertyHolder() : nullptr;
 }
 
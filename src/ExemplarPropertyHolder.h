@@ -20,6 +20,7 @@
  */
 
 #pragma once
+#include "cGZPersistResourceKey.h"
 #include "cISCPropertyHolder.h"
 #include "cISCExemplarPropertyHolder.h"
 #include "cIGZSerializable.h"
@@ -27,6 +28,9 @@
 #include "cRZAutoRefCount.h"
 
 // A read-only property holder that wraps an exemplar.
+// An exemplar that is only known by its resource key is loaded the first time
+// that a property is read, so the holders of the ordinances that were created
+// from a decoded property table do not load their exemplar unless the game uses it.
 class ExemplarPropertyHolder
 	: public cISCPropertyHolder,
 	  public cISCExemplarPropertyHolder
@@ -79,10 +83,22 @@ public:
 	bool SetDefaultExemplar(cISCResExemplar* pExemplar);
 	cISCResExemplar* GetDefaultExemplar(void);
 
+	// Sets the default exemplar and the resource key that is written to the save game.
+	// This is used for exemplars that were created directly from a DBPF record, which
+	// may not have their resource key set.
+	// If the exemplar is null, it is loaded from the key when it is first used.
+	bool SetDefaultExemplar(cISCResExemplar* pExemplar, const cGZPersistResourceKey& key);
+
 	bool Write(cIGZOStream& stream);
 	bool Read(cIGZIStream& stream);
 private:
+	// Gets the default exemplar's property holder, or null if there is no default exemplar.
+	cISCPropertyHolder* GetDefaultPropertyHolder() const;
+
 	uint32_t refCount;
-	cRZAutoRefCount<cISCResExemplar> defaultExemplar;
+	// The exemplar is loaded on first use, see GetDefaultPropertyHolder.
+	mutable cRZAutoRefCount<cISCResExemplar> defaultExemplar;
+	mutable bool defaultExemplarLoaded;
+	cGZPersistResourceKey defaultExemplarKey;
 };
 
@@ -0,0 +1,380 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ExemplarPropertyTable.h"
+#include <algorithm>
+#include <cstring>
+
+using ValueType = ExemplarPropertyTable::ValueType;
+
+namespace
+{
+	// The signature, the parent cohort TGI and the property count.
+	constexpr size_t BinaryExemplarHeaderSize = 8 + 12 + 4;
+	// The property id, value type, key type and an unused byte.
+	constexpr size_t BinaryPropertyHeaderSize = 9;
+
+	constexpr uint16_t SingleValueKeyType = 0x00;
+	constexpr uint16_t MultipleValueKeyType = 0x80;
+
+	uint16_t ReadUint16(const uint8_t* data)
+	{
+		return static_cast<uint16_t>(data[0] | (data[1] << 8));
+	}
+
+	uint32_t ReadUint32(const uint8_t* data)
+	{
+		return static_cast<uint32_t>(data[0])
+			| (static_cast<uint32_t>(data[1]) << 8)
+			| (static_cast<uint32_t>(data[2]) << 16)
+			| (static_cast<uint32_t>(data[3]) << 24);
+	}
+
+	uint32_t GetValueSize(ValueType type)
+	{
+		switch (type)
+		{
+		case ValueType::Uint8:
+		case ValueType::Bool:
+		case ValueType::String:
+			return 1;
+		case ValueType::Uint16:
+			return 2;
+		case ValueType::Uint32:
+		case ValueType::Sint32:
+		case ValueType::Float32:
+			return 4;
+		case ValueType::Sint64:
+			return 8;
+		default:
+			return 0;
+		}
+	}
+
+	bool IsValidExemplarSignature(std::span<const uint8_t> data)
+	{
+		return std::memcmp(data.data(), "EQZB", 4) == 0 || std::memcmp(data.data(), "CQZB", 4) == 0;
+	}
+}
+
+ExemplarPropertyTable::ExemplarPropertyTable()
+	: ids(), properties(), values(), hasParentCohort(false)
+{
+}
+
+bool ExemplarPropertyTable::Parse(std::span<const uint8_t> data)
+{
+	Clear();
+
+	if (data.size() < BinaryExemplarHeaderSize || !IsValidExemplarSignature(data))
+	{
+		return false;
+	}
+
+	const uint32_t propertyCount = ReadUint32(data.data() + 20);
+
+	// The parent cohort TGI follows the signature, it is all zeros when the
+	// exemplar does not have a parent cohort.
+	const bool parentCohort = ReadUint32(data.data() + 8) != 0
+		|| ReadUint32(data.data() + 12) != 0
+		|| ReadUint32(data.data() + 16) != 0;
+
+	// Every property uses at least 10 bytes, this prevents a corrupted count
+	// from allocating a large amount of memory.
+	if (propertyCount > (data.size() - BinaryExemplarHeaderSize) / (BinaryPropertyHeaderSize + 1))
+	{
+		return false;
+	}
+
+	std::vector<Property> parsed;
+	parsed.reserve(propertyCount);
+
+	// The value data can never be larger than the exemplar.
+	values.reserve(data.size() - BinaryExemplarHeaderSize);
+
+	size_t offset = BinaryExemplarHeaderSize;
+
+	for (uint32_t i = 0; i < propertyCount; i++)
+	{
+		if ((data.size() - offset) < BinaryPropertyHeaderSize)
+		{
+			Clear();
+			return false;
+		}
+
+		const uint8_t* header = data.data() + offset;
+
+		Property property{};
+		property.id = ReadUint32(header);
+		property.type = static_cast<ValueType>(ReadUint16(header + 4));
+		const uint16_t keyType = ReadUint16(header + 6);
+		offset += BinaryPropertyHeaderSize;
+
+		const uint32_t valueSize = GetValueSize(property.type);
+
+		if (valueSize == 0)
+		{
+			Clear();
+			return false;
+		}
+
+		if (keyType == MultipleValueKeyType)
+		{
+			if ((data.size() - offset) < 4)
+			{
+				Clear();
+				return false;
+			}
+
+			property.count = ReadUint32(data.data() + offset);
+			offset += 4;
+		}
+		else if (keyType == SingleValueKeyType)
+		{
+			property.count = 1;
+		}
+		else
+		{
+			Clear();
+			return false;
+		}
+
+		const uint64_t valuesLength = static_cast<uint64_t>(property.count) * valueSize;
+
+		if ((data.size() - offset) < valuesLength)
+		{
+			Clear();
+			return false;
+		}
+
+		property.offset = static_cast<uint32_t>(values.size());
+		values.insert(values.end(), data.begin() + offset, data.begin() + offset + static_cast<size_t>(valuesLength));
+		offset += static_cast<size_t>(valuesLength);
+
+		parsed.push_back(property);
+	}
+
+	// The exemplar properties are usually sorted by id, so the sort is cheap.
+	// A stable sort keeps the last property when an id is repeated, which matches
+	// the behavior of adding the properties to a property holder in order.
+	std::stable_sort(
+		parsed.begin(),
+		parsed.end(),
+		[](const Property& lhs, const Property& rhs) { return lhs.id < rhs.id; });
+
+	properties.reserve(parsed.size());
+	ids.reserve(parsed.size());
+
+	for (size_t i = 0; i < parsed.size(); i++)
+	{
+		if (!ids.empty() && ids.back() == parsed[i].id)
+		{
+			properties.back() = parsed[i];
+		}
+		else
+		{
+			ids.push_back(parsed[i].id);
+			properties.push_back(parsed[i]);
+		}
+	}
+
+	hasParentCohort = parentCohort;
+	return true;
+}
+
+void ExemplarPropertyTable::Clear()
+{
+	ids.clear();
+	properties.clear();
+	values.clear();
+	hasParentCohort = false;
+}
+
+bool ExemplarPropertyTable::IsEmpty() const
+{
+	return properties.empty();
+}
+
+bool ExemplarPropertyTable::HasParentCohort() const
+{
+	return hasParentCohort;
+}
+
+std::span<const ExemplarPropertyTable::Property> ExemplarPropertyTable::GetProperties() const
+{
+	return properties;
+}
+
+const ExemplarPropertyTable::Property* ExemplarPropertyTable::Find(uint32_t id) const
+{
+	const auto it = std::lower_bound(ids.begin(), ids.end(), id);
+
+	if (it != ids.end() && *it == id)
+	{
+		return &properties[static_cast<size_t>(it - ids.begin())];
+	}
+
+	return nullptr;
+}
+
+bool ExemplarPropertyTable::GetPropertyValue(uint32_t id, uint32_t& value) const
+{
+	const Property* property = Find(id);
+
+	return property && GetPropertyValue(*property, value);
+}
+
+bool ExemplarPropertyTable::GetPropertyValue(uint32_t id, int64_t& value) const
+{
+	const Property* property = Find(id);
+
+	return property && GetPropertyValue(*property, value);
+}
+
+bool ExemplarPropertyTable::GetPropertyValue(uint32_t id, float& value) const
+{
+	const Property* property = Find(id);
+
+	return property && GetPropertyValue(*property, value);
+}
+
+bool ExemplarPropertyTable::GetPropertyValue(uint32_t id, bool& value) const
+{
+	const Property* property = Find(id);
+
+	return property && GetPropertyValue(*property, value);
+}
+
+bool ExemplarPropertyTable::GetPropertyValue(uint32_t id, std::string_view& value) const
+{
+	const Property* property = Find(id);
+
+	return property && GetPropertyValue(*property, value);
+}
+
+bool ExemplarPropertyTable::GetPropertyValues(uint32_t id, std::span<uint32_t> output) const
+{
+	const Property* property = Find(id);
+
+	return property && GetPropertyValues(*property, output);
+}
+
+bool ExemplarPropertyTable::GetPropertyValue(const Property& property, uint32_t& value) const
+{
+	int64_t temp = 0;
+
+	if (property.count > 0
+		&& GetIntegerValue(property, 0, temp)
+		&& temp >= 0
+		&& temp <= UINT32_MAX)
+	{
+		value = static_cast<uint32_t>(temp);
+		return true;
+	}
+
+	return false;
+}
+
+bool ExemplarPropertyTable::GetPropertyValue(const Property& property, int64_t& value) const
+{
+	return property.count > 0 && GetIntegerValue(property, 0, value);
+}
+
+bool ExemplarPropertyTable::GetPropertyValue(const Property& property, float& value) const
+{
+	if (property.type == ValueType::Float32 && property.count > 0)
+	{
+		std::memcpy(&value, values.data() + property.offset, sizeof(float));
+		return true;
+	}
+
+	return false;
+}
+
+bool ExemplarPropertyTable::GetPropertyValue(const Property& property, bool& value) const
+{
+	if (property.type == ValueType::Bool && property.count > 0)
+	{
+		value = values[property.offset] != 0;
+		return true;
+	}
+
+	return false;
+}
+
+bool ExemplarPropertyTable::GetPropertyValue(const Property& property, std::string_view& value) const
+{
+	if (property.type == ValueType::String)
+	{
+		value = std::string_view(reinterpret_cast<const char*>(values.data() + property.offset), property.count);
+		return true;
+	}
+
+	return false;
+}
+
+bool ExemplarPropertyTable::GetPropertyValues(const Property& property, std::span<uint32_t> output) const
+{
+	if (property.count != output.size())
+	{
+		return false;
+	}
+
+	for (uint32_t i = 0; i < property.count; i++)
+	{
+		int64_t temp = 0;
+
+		if (!GetIntegerValue(property, i, temp) || temp < 0 || temp > UINT32_MAX)
+		{
+			return false;
+		}
+
+		output[i] = static_cast<uint32_t>(temp);
+	}
+
+	return true;
+}
+
+bool ExemplarPropertyTable::GetIntegerValue(const Property& property, uint32_t index, int64_t& value) const
+{
+	const uint8_t* data = values.data() + property.offset + (static_cast<size_t>(index) * GetValueSize(property.type));
+
+	switch (property.type)
+	{
+	case ValueType::Uint8:
+		value = data[0];
+		return true;
+	case ValueType::Uint16:
+		value = ReadUint16(data);
+		return true;
+	case ValueType::Uint32:
+		value = ReadUint32(data);
+		return true;
+	case ValueType::Sint32:
+		value = static_cast<int32_t>(ReadUint32(data));
+		return true;
+	case ValueType::Sint64:
+		value = static_cast<int64_t>(ReadUint32(data) | (static_cast<uint64_t>(ReadUint32(data + 4)) << 32));
+		return true;
+	default:
+		return false;
+	}
+}
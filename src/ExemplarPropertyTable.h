@@ -0,0 +1,107 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// A read-only copy of the properties in a binary exemplar.
+// The property block is decoded in a single pass into a table that is sorted
+// by property id, so that each lookup is a binary search instead of a scan of
+// the exemplar's property list.
+class ExemplarPropertyTable
+{
+public:
+	// The value types use the same values as the binary exemplar format.
+	enum class ValueType : uint16_t
+	{
+		Uint8 = 0x0100,
+		Uint16 = 0x0200,
+		Uint32 = 0x0300,
+		Sint32 = 0x0700,
+		Sint64 = 0x0800,
+		Float32 = 0x0900,
+		Bool = 0x0B00,
+		String = 0x0C00,
+	};
+
+	struct Property
+	{
+		uint32_t id;
+		ValueType type;
+		// The number of values, for a string this is the length in bytes.
+		uint32_t count;
+		// The offset of the first value in the value buffer.
+		uint32_t offset;
+	};
+
+	ExemplarPropertyTable();
+
+	// Decodes the properties of an uncompressed binary exemplar.
+	// Returns false if the data is not a valid binary exemplar, the table will
+	// be empty in that case.
+	bool Parse(std::span<const uint8_t> data);
+	void Clear();
+
+	bool IsEmpty() const;
+
+	// Gets a value indicating whether the exemplar has a parent cohort.
+	// The properties that the exemplar inherits from the cohort are not included
+	// in the table.
+	bool HasParentCohort() const;
+
+	// Gets the properties, sorted by id.
+	std::span<const Property> GetProperties() const;
+
+	const Property* Find(uint32_t id) const;
+
+	// The numeric methods use the first value of the property.
+	// Integer values are converted to the requested integer type, Float32 and Bool
+	// values must have the requested type.
+	bool GetPropertyValue(uint32_t id, uint32_t& value) const;
+	bool GetPropertyValue(uint32_t id, int64_t& value) const;
+	bool GetPropertyValue(uint32_t id, float& value) const;
+	bool GetPropertyValue(uint32_t id, bool& value) const;
+	bool GetPropertyValue(uint32_t id, std::string_view& value) const;
+
+	// Gets the values of an integer array property.
+	// The property must have exactly the same number of values as the output.
+	bool GetPropertyValues(uint32_t id, std::span<uint32_t> values) const;
+
+	bool GetPropertyValue(const Property& property, uint32_t& value) const;
+	bool GetPropertyValue(const Property& property, int64_t& value) const;
+	bool GetPropertyValue(const Property& property, float& value) const;
+	bool GetPropertyValue(const Property& property, bool& value) const;
+	bool GetPropertyValue(const Property& property, std::string_view& value) const;
+	bool GetPropertyValues(const Property& property, std::span<uint32_t> values) const;
+
+private:
+	bool GetIntegerValue(const Property& property, uint32_t index, int64_t& value) const;
+
+	// The property ids are stored separately from the rest of the property data
+	// to keep the binary search on as few cache lines as possible.
+	std::vector<uint32_t> ids;
+	std::vector<Property> properties;
+	std::vector<uint8_t> values;
+	bool hasParentCohort;
+};
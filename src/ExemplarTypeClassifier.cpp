@@ -0,0 +1,310 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ExemplarTypeClassifier.h"
+#include <charconv>
+#include <string_view>
+
+using Result = ExemplarTypeClassifier::Result;
+
+namespace
+{
+	constexpr uint32_t kExemplarType = 0x10;
+
+	constexpr size_t SignatureLength = 8;
+
+	uint16_t ReadUint16(const uint8_t* data)
+	{
+		return static_cast<uint16_t>(data[0] | (data[1] << 8));
+	}
+
+	uint32_t ReadUint32(const uint8_t* data)
+	{
+		return static_cast<uint32_t>(data[0])
+			| (static_cast<uint32_t>(data[1]) << 8)
+			| (static_cast<uint32_t>(data[2]) << 16)
+			| (static_cast<uint32_t>(data[3]) << 24);
+	}
+
+	size_t GetBinaryPropertyValueSize(uint16_t valueType)
+	{
+		switch (valueType)
+		{
+		case 0x0100: // Uint8
+		case 0x0B00: // Bool
+		case 0x0C00: // String
+			return 1;
+		case 0x0200: // Uint16
+			return 2;
+		case 0x0300: // Uint32
+		case 0x0700: // Sint32
+		case 0x0900: // Float32
+			return 4;
+		case 0x0800: // Sint64
+			return 8;
+		default:
+			return 0;
+		}
+	}
+
+	Result GetBinaryExemplarType(std::span<const uint8_t> data, uint32_t& exemplarType)
+	{
+		// The binary exemplar header is the signature, the parent cohort TGI
+		// and the property count.
+		constexpr size_t HeaderSize = SignatureLength + 12 + 4;
+		// The property id, value type, key type and an unused byte.
+		constexpr size_t PropertyHeaderSize = 9;
+
+		if (data.size() < HeaderSize)
+		{
+			return Result::InvalidData;
+		}
+
+		const bool hasParentCohort = ReadUint32(data.data() + 8) != 0
+			|| ReadUint32(data.data() + 12) != 0
+			|| ReadUint32(data.data() + 16) != 0;
+		const uint32_t propertyCount = ReadUint32(data.data() + 20);
+		size_t offset = HeaderSize;
+
+		Result result = hasParentCohort ? Result::Inherited : Result::NotFound;
+
+		for (uint32_t i = 0; i < propertyCount; i++)
+		{
+			if ((data.size() - offset) < PropertyHeaderSize)
+			{
+				return Result::InvalidData;
+			}
+
+			const uint8_t* property = data.data() + offset;
+
+			const uint32_t id = ReadUint32(property);
+			const uint16_t valueType = ReadUint16(property + 4);
+			const uint16_t keyType = ReadUint16(property + 6);
+			offset += PropertyHeaderSize;
+
+			const size_t valueSize = GetBinaryPropertyValueSize(valueType);
+
+			if (valueSize == 0)
+			{
+				return Result::InvalidData;
+			}
+
+			uint32_t valueCount = 1;
+
+			if (keyType == 0x80)
+			{
+				if ((data.size() - offset) < 4)
+				{
+					return Result::InvalidData;
+				}
+
+				valueCount = ReadUint32(data.data() + offset);
+				offset += 4;
+			}
+			else if (keyType != 0)
+			{
+				return Result::InvalidData;
+			}
+
+			const uint64_t valuesLength = static_cast<uint64_t>(valueCount) * valueSize;
+
+			if ((data.size() - offset) < valuesLength)
+			{
+				return Result::InvalidData;
+			}
+
+			if (id == kExemplarType)
+			{
+				if (valueCount == 0 || valueType == 0x0C00)
+				{
+					result = Result::NotFound;
+				}
+				else
+				{
+					// Only the low 32 bits of a Sint64 value are used.
+					uint32_t value = 0;
+
+					for (size_t j = 0; j < valueSize && j < sizeof(value); j++)
+					{
+						value |= static_cast<uint32_t>(data[offset + j]) << (j * 8);
+					}
+
+					exemplarType = value;
+					result = Result::Found;
+				}
+			}
+
+			offset += static_cast<size_t>(valuesLength);
+		}
+
+		return result;
+	}
+
+	std::string_view TrimStart(std::string_view value)
+	{
+		const size_t start = value.find_first_not_of(" \t");
+
+		return start != std::string_view::npos ? value.substr(start) : std::string_view();
+	}
+
+	bool ParseTextUint32(std::string_view text, uint32_t& value)
+	{
+		int base = 10;
+
+		if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X'))
+		{
+			text.remove_prefix(2);
+			base = 16;
+		}
+
+		const char* end = text.data() + text.size();
+		const std::from_chars_result result = std::from_chars(text.data(), end, value, base);
+
+		return result.ec == std::errc() && result.ptr != text.data();
+	}
+
+	// The parent cohort line has the following format:
+	// ParentCohort=Key:{0x00000000,0x00000000,0x00000000}
+	bool HasTextParentCohort(std::string_view line)
+	{
+		const size_t valuesStart = line.find('{');
+
+		if (valuesStart == std::string_view::npos)
+		{
+			return false;
+		}
+
+		std::string_view values = line.substr(valuesStart + 1);
+		values = values.substr(0, values.find('}'));
+
+		while (!values.empty())
+		{
+			const size_t separator = values.find(',');
+			uint32_t value = 0;
+
+			if (ParseTextUint32(TrimStart(values.substr(0, separator)), value) && value != 0)
+			{
+				return true;
+			}
+
+			values.remove_prefix(separator != std::string_view::npos ? separator + 1 : values.size());
+		}
+
+		return false;
+	}
+
+	// A text exemplar property line has the following format:
+	// 0x00000010:{"Exemplar Type"}=Uint32:0:{0x0000000E}
+	Result GetTextExemplarType(std::span<const uint8_t> data, uint32_t& exemplarType)
+	{
+		std::string_view text(reinterpret_cast<const char*>(data.data()), data.size());
+		text.remove_prefix(SignatureLength);
+
+		bool hasParentCohort = false;
+		bool foundProperty = false;
+		Result result = Result::NotFound;
+
+		while (!text.empty())
+		{
+			const size_t lineEnd = text.find_first_of("\r\n");
+			const std::string_view line = TrimStart(text.substr(0, lineEnd));
+
+			text.remove_prefix(lineEnd != std::string_view::npos ? lineEnd + 1 : text.size());
+
+			uint32_t id = 0;
+
+			if (line.starts_with("ParentCohort"))
+			{
+				hasParentCohort = HasTextParentCohort(line);
+			}
+			else if (line.size() > 2
+				&& line[0] == '0'
+				&& (line[1] == 'x' || line[1] == 'X')
+				&& ParseTextUint32(line.substr(0, line.find(':')), id)
+				&& id == kExemplarType)
+			{
+				const size_t typeStart = line.find('=');
+
+				if (typeStart == std::string_view::npos)
+				{
+					return Result::InvalidData;
+				}
+
+				const std::string_view valueType = line.substr(typeStart + 1, line.find(':', typeStart) - (typeStart + 1));
+
+				foundProperty = true;
+				result = Result::NotFound;
+
+				if (valueType != "String")
+				{
+					const size_t valuesStart = line.find('{', typeStart);
+
+					if (valuesStart == std::string_view::npos)
+					{
+						return Result::InvalidData;
+					}
+
+					std::string_view firstValue = line.substr(valuesStart + 1);
+					firstValue = TrimStart(firstValue.substr(0, firstValue.find_first_of(",}")));
+
+					if (!firstValue.empty())
+					{
+						if (!ParseTextUint32(firstValue, exemplarType))
+						{
+							return Result::InvalidData;
+						}
+
+						result = Result::Found;
+					}
+				}
+			}
+		}
+
+		if (!foundProperty && hasParentCohort)
+		{
+			result = Result::Inherited;
+		}
+
+		return result;
+	}
+}
+
+Result ExemplarTypeClassifier::GetExemplarType(std::span<const uint8_t> data, uint32_t& exemplarType)
+{
+	if (data.size() < SignatureLength)
+	{
+		return Result::InvalidData;
+	}
+
+	// The signature is followed by a 4 character version string, e.g. EQZB1###.
+	const std::string_view signature(reinterpret_cast<const char*>(data.data()), 4);
+
+	if (signature == "EQZB" || signature == "CQZB")
+	{
+		return GetBinaryExemplarType(data, exemplarType);
+	}
+	else if (signature == "EQZT" || signature == "CQZT")
+	{
+		return GetTextExemplarType(data, exemplarType);
+	}
+
+	return Result::UnsupportedFormat;
+}
@@ -0,0 +1,48 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstdint>
+#include <span>
+
+// Reads the ExemplarType property from uncompressed exemplar data without
+// creating the exemplar or any of its property objects.
+// Both the binary (EQZB) and text (EQZT) exemplar encodings are supported.
+// When the property is present more than once the last value is used, this
+// matches ExemplarPropertyTable.
+namespace ExemplarTypeClassifier
+{
+	enum class Result : uint8_t
+	{
+		Found = 0,
+		// The exemplar does not have an ExemplarType property, or the property
+		// does not have a numeric value.
+		NotFound,
+		// The exemplar does not have an ExemplarType property, but it has a parent
+		// cohort that the property can be inherited from. The caller must use the
+		// game's exemplar parser to resolve the cohort.
+		Inherited,
+		InvalidData,
+		UnsupportedFormat,
+	};
+
+	Result GetExemplarType(std::span<const uint8_t> data, uint32_t& exemplarType);
+}
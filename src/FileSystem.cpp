@@ -0,0 +1,87 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FileSystem.h"
+
+const NativeFileSystem& NativeFileSystem::GetInstance()
+{
+	static const NativeFileSystem instance;
+
+	return instance;
+}
+
+bool NativeFileSystem::DirectoryExists(const std::filesystem::path& path) const
+{
+	std::error_code ec;
+
+	return std::filesystem::is_directory(path, ec);
+}
+
+bool NativeFileSystem::GetDirectoryContents(
+	const std::filesystem::path& directory,
+	std::vector<std::filesystem::path>& subdirectories,
+	std::vector<FileInfo>& files) const
+{
+	std::error_code ec;
+
+	// On Windows the directory_entry caches the file attributes, size and last
+	// write time that are returned by the directory enumeration, so reading them
+	// does not require a separate call for each file.
+	for (std::filesystem::directory_iterator it(
+		directory,
+		std::filesystem::directory_options::skip_permission_denied,
+		ec), end; !ec && it != end; it.increment(ec))
+	{
+		const std::filesystem::directory_entry& dirEntry = *it;
+
+		if (dirEntry.is_directory(ec))
+		{
+			subdirectories.push_back(dirEntry.path());
+		}
+		else if (!ec && dirEntry.is_regular_file(ec))
+		{
+			FileInfo file{};
+			file.path = dirEntry.path();
+			file.size = dirEntry.file_size(ec);
+
+			if (ec)
+			{
+				break;
+			}
+
+			file.lastWriteTime = dirEntry.last_write_time(ec).time_since_epoch().count();
+
+			if (ec)
+			{
+				break;
+			}
+
+			files.push_back(std::move(file));
+		}
+
+		if (ec)
+		{
+			break;
+		}
+	}
+
+	return !ec;
+}
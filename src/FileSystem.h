@@ -0,0 +1,65 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+// A file that was found when enumerating a directory.
+struct FileInfo
+{
+	std::filesystem::path path;
+	uint64_t size;
+	int64_t lastWriteTime;
+};
+
+// The file system operations that are used by the ordinance discovery.
+// This allows the directory enumeration to be tested with an in-memory file system.
+class IFileSystem
+{
+public:
+	virtual ~IFileSystem() = default;
+
+	virtual bool DirectoryExists(const std::filesystem::path& path) const = 0;
+
+	// Gets the files and sub-directories of a single directory, the sub-directories
+	// are not enumerated.
+	// The size and last write time of the files are read as part of the enumeration.
+	virtual bool GetDirectoryContents(
+		const std::filesystem::path& directory,
+		std::vector<std::filesystem::path>& subdirectories,
+		std::vector<FileInfo>& files) const = 0;
+};
+
+// The IFileSystem implementation that uses the operating system's file system.
+class NativeFileSystem final : public IFileSystem
+{
+public:
+	static const NativeFileSystem& GetInstance();
+
+	bool DirectoryExists(const std::filesystem::path& path) const override;
+
+	bool GetDirectoryContents(
+		const std::filesystem::path& directory,
+		std::vector<std::filesystem::path>& subdirectories,
+		std::vector<FileInfo>& files) const override;
+};
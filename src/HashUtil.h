@@ -0,0 +1,34 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace HashUtil
+{
+	static constexpr uint64_t Fnv1a64OffsetBasis = 0xCBF29CE484222325ULL;
+
+	// Computes a 64-bit FNV-1a hash of the data.
+	// The hash of data that is split into multiple blocks can be computed by
+	// passing the result of the previous block as the initial hash value.
+	uint64_t Fnv1a64(const void* data, size_t length, uint64_t hash = Fnv1a64OffsetBasis);
+}
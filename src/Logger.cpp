@@ -20,7 +20,13 @@
  */
 
 #include "Logger.h"
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+
+#ifdef _WIN32
 #include <Windows.h>
+#endif // _WIN32
 
 namespace
 {
@@ -40,7 +46,7 @@ Logger& Logger::GetInstance()
 	return logger;
 }
 
-Logger::Logger() : initialized(false), logFile(), logLevel(LogLevel::Error)
+Logger::Logger() : initialized(false), logLevel(LogLevel::Error), logFile()
 {
 }
 
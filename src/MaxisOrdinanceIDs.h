@@ -0,0 +1,52 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "frozen/unordered_set.h"
+#include <cstdint>
+
+// The group id of the Maxis ordinance exemplars.
+static constexpr uint32_t kMaxisOrdinanceGroupID = 0xA9C2C209;
+
+// The Maxis ordinances use the exemplar instance id as their class id.
+static constexpr frozen::unordered_set<uint32_t, 20> MaxisOrdinanceCLSIDs =
+{
+	0xA2BF1DDC, // Carpool Incentive
+	0xA2BF1E43, // Clean Air
+	0x00D0723D, // CPR Training
+	0x40D07236, // Free Clinics
+	0x815B4CEF, // Junior Sports League
+	0x22F6E80C, // Landfill Gas Recovery
+	0xA0D07129, // Legalize Gambling
+	0x62BF1DAA, // Mandatory Smoke Detectors
+	0x62BF1DB9, // Neighborhood Watch
+	0xE0D0722E, // Nuclear Free Zone
+	0x22F6E81B, // Paper Reduction Act
+	0x82B9999B, // Power Conservation
+	0xE0D07233, // Pro Reading Campaign
+	0xA2BF1DE5, // Shuttle Service
+	0xC2F6E81F, // Tire Recycling
+	0x62F6E7CF, // Tourist Promotion
+	0x42BF1E18, // Trash Presort
+	0xC2BF1E04, // Vehicle Emission Standard
+	0x02BF1DFA, // Water Conservation
+	0xC2BF1DC5, // Youth Curfew
+};
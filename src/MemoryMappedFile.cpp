@@ -0,0 +1,195 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MemoryMappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include "wil/resource.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MemoryMappedFile::MemoryMappedFile()
+	: data(nullptr),
+	  size(0),
+	  open(false)
+{
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+	Close();
+}
+
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other) noexcept
+	: data(nullptr),
+	  size(0),
+	  open(false)
+{
+	Swap(other);
+}
+
+MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		Close();
+		Swap(other);
+	}
+
+	return *this;
+}
+
+bool MemoryMappedFile::Open(const std::filesystem::path& path)
+{
+	Close();
+
+#ifdef _WIN32
+	wil::unique_hfile file(CreateFileW(
+		path.c_str(),
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		nullptr,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL,
+		nullptr));
+
+	if (!file)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize{};
+
+	if (!GetFileSizeEx(file.get(), &fileSize)
+		|| static_cast<uint64_t>(fileSize.QuadPart) > SIZE_MAX)
+	{
+		return false;
+	}
+
+	if (fileSize.QuadPart > 0)
+	{
+		// The mapping object can be closed after the view has been created,
+		// the view keeps a reference to it.
+		wil::unique_handle mapping(CreateFileMappingW(
+			file.get(),
+			nullptr,
+			PAGE_READONLY,
+			0,
+			0,
+			nullptr));
+
+		if (!mapping)
+		{
+			return false;
+		}
+
+		void* view = MapViewOfFile(mapping.get(), FILE_MAP_READ, 0, 0, 0);
+
+		if (!view)
+		{
+			return false;
+		}
+
+		data = static_cast<const uint8_t*>(view);
+		size = static_cast<size_t>(fileSize.QuadPart);
+	}
+#else
+	const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+	if (fd == -1)
+	{
+		return false;
+	}
+
+	struct stat fileInfo {};
+
+	if (fstat(fd, &fileInfo) != 0 || !S_ISREG(fileInfo.st_mode))
+	{
+		::close(fd);
+		return false;
+	}
+
+	if (fileInfo.st_size > 0)
+	{
+		void* view = mmap(
+			nullptr,
+			static_cast<size_t>(fileInfo.st_size),
+			PROT_READ,
+			MAP_PRIVATE,
+			fd,
+			0);
+
+		if (view == MAP_FAILED)
+		{
+			::close(fd);
+			return false;
+		}
+
+		data = static_cast<const uint8_t*>(view);
+		size = static_cast<size_t>(fileInfo.st_size);
+	}
+
+	// The mapping stays valid after the file descriptor is closed.
+	::close(fd);
+#endif // _WIN32
+
+	open = true;
+	return true;
+}
+
+void MemoryMappedFile::Close()
+{
+	if (data)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(data);
+#else
+		munmap(const_cast<uint8_t*>(data), size);
+#endif // _WIN32
+	}
+
+	data = nullptr;
+	size = 0;
+	open = false;
+}
+
+bool MemoryMappedFile::IsOpen() const
+{
+	return open;
+}
+
+std::span<const uint8_t> MemoryMappedFile::GetData() const
+{
+	return std::span<const uint8_t>(data, size);
+}
+
+void MemoryMappedFile::Swap(MemoryMappedFile& other) noexcept
+{
+	std::swap(data, other.data);
+	std::swap(size, other.size);
+	std::swap(open, other.open);
+}
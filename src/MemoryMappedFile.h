@@ -0,0 +1,56 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+// A read-only memory mapping of a file.
+class MemoryMappedFile
+{
+public:
+	MemoryMappedFile();
+	~MemoryMappedFile();
+
+	MemoryMappedFile(const MemoryMappedFile& other) = delete;
+	MemoryMappedFile(MemoryMappedFile&& other) noexcept;
+
+	MemoryMappedFile& operator=(const MemoryMappedFile& other) = delete;
+	MemoryMappedFile& operator=(MemoryMappedFile&& other) noexcept;
+
+	// Maps the entire file into memory.
+	// Returns false if the file could not be opened or mapped, an empty file
+	// can be opened but it will not have any data.
+	bool Open(const std::filesystem::path& path);
+	void Close();
+
+	bool IsOpen() const;
+	std::span<const uint8_t> GetData() const;
+
+private:
+	void Swap(MemoryMappedFile& other) noexcept;
+
+	const uint8_t* data;
+	size_t size;
+	bool open;
+};
@@ -0,0 +1,326 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MonthlyIncomeEngine.h"
+#include "CityStatsSnapshot.h"
+#include "CpuFeatureUtil.h"
+#include <algorithm>
+#include <immintrin.h>
+
+namespace
+{
+	// The smallest and largest values that can be converted to a signed 64-bit integer
+	// are excluded so that the range check does not depend on how they are rounded,
+	// those values use SafeCast.
+	constexpr double MinInt64AsDouble = -9223372036854775808.0;
+	constexpr double MaxInt64AsDouble = 9223372036854775808.0;
+
+	constexpr size_t KernelRowCount = 4;
+
+	// The kernels add the columns to the constant incomes one column at a time,
+	// every row adds its coefficients in the column order.
+
+	void EvaluateMatrixScalar(
+		const double* constantIncomes,
+		const double* coefficients,
+		size_t rowStride,
+		const std::vector<uint32_t>& columns,
+		const double* metrics,
+		double* incomes,
+		uint8_t* inRange)
+	{
+		std::copy(constantIncomes, constantIncomes + rowStride, incomes);
+
+		for (uint32_t column : columns)
+		{
+			const double metric = metrics[column];
+			const double* pCoefficients = coefficients + (column * rowStride);
+
+			for (size_t row = 0; row < rowStride; row++)
+			{
+				incomes[row] += pCoefficients[row] * metric;
+			}
+		}
+
+		for (size_t row = 0; row < rowStride; row++)
+		{
+			inRange[row] = incomes[row] > MinInt64AsDouble && incomes[row] < MaxInt64AsDouble;
+		}
+	}
+
+	CPU_FEATURE_TARGET_AVX void EvaluateMatrixAvx(
+		const double* constantIncomes,
+		const double* coefficients,
+		size_t rowStride,
+		const std::vector<uint32_t>& columns,
+		const double* metrics,
+		double* incomes,
+		uint8_t* inRange)
+	{
+		std::copy(constantIncomes, constantIncomes + rowStride, incomes);
+
+		for (uint32_t column : columns)
+		{
+			const __m256d metric = _mm256_broadcast_sd(metrics + column);
+			const double* pCoefficients = coefficients + (column * rowStride);
+
+			for (size_t row = 0; row < rowStride; row += KernelRowCount)
+			{
+				const __m256d product = _mm256_mul_pd(_mm256_loadu_pd(pCoefficients + row), metric);
+
+				// A separate multiply and add is used because a fused multiply-add
+				// rounds differently than the scalar code.
+				_mm256_storeu_pd(incomes + row, _mm256_add_pd(_mm256_loadu_pd(incomes + row), product));
+			}
+		}
+
+		const __m256d minValue = _mm256_set1_pd(MinInt64AsDouble);
+		const __m256d maxValue = _mm256_set1_pd(MaxInt64AsDouble);
+
+		for (size_t row = 0; row < rowStride; row += KernelRowCount)
+		{
+			const __m256d income = _mm256_loadu_pd(incomes + row);
+
+			// The ordered comparisons are false for NaN.
+			const __m256d valid = _mm256_and_pd(
+				_mm256_cmp_pd(income, minValue, _CMP_GT_OQ),
+				_mm256_cmp_pd(income, maxValue, _CMP_LT_OQ));
+			const int mask = _mm256_movemask_pd(valid);
+
+			for (size_t i = 0; i < KernelRowCount; i++)
+			{
+				inRange[row + i] = static_cast<uint8_t>((mask >> i) & 1);
+			}
+		}
+	}
+
+	// Checks that the income instructions can be compiled into a matrix row.
+	bool IsMatrixCompatible(const OrdinanceProgram& program)
+	{
+		const OrdinanceProgram::Instruction* pInstructions = program.GetIncomeInstructions();
+		const size_t instructionCount = program.GetIncomeInstructionCount();
+
+		for (size_t i = 0; i < instructionCount; i++)
+		{
+			const OrdinanceProgram::Instruction& instruction = pInstructions[i];
+
+			// The matrix adds the metrics in order, and each metric once.
+			if (instruction.opcode != OrdinanceProgram::Opcode::AddMetricProduct
+				|| instruction.metric >= CityMetric::Count
+				|| (i > 0 && instruction.metric <= pInstructions[i - 1].metric))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+MonthlyIncomeEngine::MonthlyIncomeEngine()
+	: MonthlyIncomeEngine(CpuFeatureUtil::IsAvxSupported())
+{
+}
+
+MonthlyIncomeEngine::MonthlyIncomeEngine(bool useAvx)
+	: definitions(),
+	  slots(),
+	  programRows(),
+	  constantIncomes(),
+	  coefficients(),
+	  activeColumns(),
+	  matrixRowCount(0),
+	  rowStride(0),
+	  monthlyIncomes(),
+	  monthlyIncomeInRange(),
+	  evaluatedEpoch(0),
+	  evaluated(false),
+	  useAvx(useAvx)
+{
+}
+
+void MonthlyIncomeEngine::Compile(const std::vector<std::shared_ptr<const OrdinanceDefinition>>& newDefinitions)
+{
+	Clear();
+
+	definitions = newDefinitions;
+	slots.resize(definitions.size(), Slot{ nullptr, NoRow });
+
+	std::vector<size_t> matrixSlots;
+	std::vector<size_t> programSlots;
+
+	for (size_t i = 0; i < definitions.size(); i++)
+	{
+		const OrdinanceDefinition* pDefinition = definitions[i].get();
+
+		if (pDefinition && !pDefinition->GetProgram().HasLuaIncomeFunction())
+		{
+			if (IsMatrixCompatible(pDefinition->GetProgram()))
+			{
+				matrixSlots.push_back(i);
+			}
+			else
+			{
+				programSlots.push_back(i);
+			}
+		}
+	}
+
+	matrixRowCount = matrixSlots.size();
+	rowStride = (matrixRowCount + (KernelRowCount - 1)) & ~(KernelRowCount - 1);
+
+	constantIncomes.assign(rowStride, 0.0);
+	coefficients.assign(CityMetricUtil::MetricCount * rowStride, 0.0);
+
+	for (size_t row = 0; row < matrixRowCount; row++)
+	{
+		const size_t slot = matrixSlots[row];
+		const OrdinanceDefinition* pDefinition = definitions[slot].get();
+		const OrdinanceProgram& program = pDefinition->GetProgram();
+
+		const OrdinanceProgram::Instruction* pInstructions = program.GetIncomeInstructions();
+		const size_t instructionCount = program.GetIncomeInstructionCount();
+
+		constantIncomes[row] = static_cast<double>(pDefinition->GetMonthlyConstantIncome());
+
+		for (size_t i = 0; i < instructionCount; i++)
+		{
+			const size_t column = static_cast<size_t>(pInstructions[i].metric);
+
+			coefficients[(column * rowStride) + row] = pInstructions[i].value;
+		}
+
+		slots[slot] = Slot{ pDefinition, static_cast<uint32_t>(row) };
+	}
+
+	// Adding a zero coefficient does not change the income, the columns that are
+	// zero for every ordinance are skipped.
+	for (size_t column = 0; column < CityMetricUtil::MetricCount; column++)
+	{
+		const double* pColumn = coefficients.data() + (column * rowStride);
+
+		if (std::any_of(pColumn, pColumn + rowStride, [](double value) { return value != 0.0; }))
+		{
+			activeColumns.push_back(static_cast<uint32_t>(column));
+		}
+	}
+
+	programRows.reserve(programSlots.size());
+
+	for (size_t slot : programSlots)
+	{
+		const OrdinanceDefinition* pDefinition = definitions[slot].get();
+
+		slots[slot] = Slot{ pDefinition, static_cast<uint32_t>(rowStride + programRows.size()) };
+		programRows.push_back(pDefinition);
+	}
+
+	monthlyIncomes.resize(rowStride + programRows.size());
+	monthlyIncomeInRange.resize(rowStride + programRows.size());
+}
+
+void MonthlyIncomeEngine::Clear()
+{
+	definitions.clear();
+	slots.clear();
+	programRows.clear();
+	constantIncomes.clear();
+	coefficients.clear();
+	activeColumns.clear();
+	matrixRowCount = 0;
+	rowStride = 0;
+	monthlyIncomes.clear();
+	monthlyIncomeInRange.clear();
+	evaluated = false;
+}
+
+bool MonthlyIncomeEngine::TryGetMonthlyIncome(
+	size_t slot,
+	const OrdinanceDefinition* definition,
+	double& monthlyIncome,
+	bool& inRange)
+{
+	if (slot >= slots.size() || !definition || slots[slot].definition != definition)
+	{
+		return false;
+	}
+
+	CityStatsSnapshot& snapshot = CityStatsSnapshot::GetInstance();
+
+	if (!snapshot.Update())
+	{
+		return false;
+	}
+
+	if (!evaluated || snapshot.GetEpoch() != evaluatedEpoch)
+	{
+		Evaluate(snapshot.GetMetricValues());
+		evaluatedEpoch = snapshot.GetEpoch();
+		evaluated = true;
+	}
+
+	const uint32_t row = slots[slot].row;
+
+	monthlyIncome = monthlyIncomes[row];
+	inRange = monthlyIncomeInRange[row] != 0;
+	return true;
+}
+
+void MonthlyIncomeEngine::Evaluate(const std::array<double, CityMetricUtil::MetricCount>& metrics)
+{
+	if (rowStride > 0)
+	{
+		if (useAvx)
+		{
+			EvaluateMatrixAvx(
+				constantIncomes.data(),
+				coefficients.data(),
+				rowStride,
+				activeColumns,
+				metrics.data(),
+				monthlyIncomes.data(),
+				monthlyIncomeInRange.data());
+		}
+		else
+		{
+			EvaluateMatrixScalar(
+				constantIncomes.data(),
+				coefficients.data(),
+				rowStride,
+				activeColumns,
+				metrics.data(),
+				monthlyIncomes.data(),
+				monthlyIncomeInRange.data());
+		}
+	}
+
+	for (size_t i = 0; i < programRows.size(); i++)
+	{
+		const OrdinanceDefinition* pDefinition = programRows[i];
+
+		const double income = pDefinition->GetProgram().CalculateMonthlyIncome(
+			static_cast<double>(pDefinition->GetMonthlyConstantIncome()),
+			metrics);
+
+		monthlyIncomes[rowStride + i] = income;
+		monthlyIncomeInRange[rowStride + i] = income > MinInt64AsDouble && income < MaxInt64AsDouble;
+	}
+}
@@ -0,0 +1,111 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "CityMetric.h"
+#include "OrdinanceDefinition.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Computes the monthly income of all of the custom ordinances in one pass.
+// The income of every compiled ordinance is computed from the CityStatsSnapshot
+// when the first ordinance is simulated after the snapshot has changed, the
+// other ordinances read their precomputed income.
+//
+// The income factors are compiled into a dense coefficient matrix with a row for
+// each ordinance and a column for each city metric. The incomes are computed as
+// the constant income plus the matrix-vector product with the metric values, using
+// AVX when the CPU supports it.
+// The columns are added in metric order and the exemplar income factors are also
+// in metric order, this produces the same result as adding the factors one at a
+// time. The ordinances with factors in any other order are evaluated by their
+// OrdinanceProgram, and the ordinances that have a Lua income factor are not
+// compiled, their income is computed by the ordinance when it is simulated.
+class MonthlyIncomeEngine
+{
+public:
+	MonthlyIncomeEngine();
+	// Selects the kernel, this allows the tests and benchmarks to compare the AVX
+	// kernel with the scalar kernel.
+	// The AVX kernel must only be selected if CpuFeatureUtil::IsAvxSupported
+	// returns true.
+	explicit MonthlyIncomeEngine(bool useAvx);
+
+	MonthlyIncomeEngine(const MonthlyIncomeEngine& other) = delete;
+	MonthlyIncomeEngine(MonthlyIncomeEngine&& other) = delete;
+
+	MonthlyIncomeEngine& operator=(const MonthlyIncomeEngine& other) = delete;
+	MonthlyIncomeEngine& operator=(MonthlyIncomeEngine&& other) = delete;
+
+	// Compiles the income factors of the ordinance definitions.
+	// The slot of a definition is its index in the list, a null definition leaves
+	// its slot empty.
+	void Compile(const std::vector<std::shared_ptr<const OrdinanceDefinition>>& definitions);
+	void Clear();
+
+	// Gets the income of the ordinance in the specified slot for the current
+	// city statistics snapshot.
+	// The in range flag is false if the income cannot be represented as a signed
+	// 64-bit integer.
+	// Returns false if the slot was not compiled from the specified definition, the
+	// caller must compute the income itself.
+	bool TryGetMonthlyIncome(
+		size_t slot,
+		const OrdinanceDefinition* definition,
+		double& monthlyIncome,
+		bool& inRange);
+
+private:
+	static constexpr uint32_t NoRow = UINT32_MAX;
+
+	struct Slot
+	{
+		// The definition is only used to check that the ordinance still uses the
+		// definition that the slot was compiled from, a loaded city can replace it
+		// with the values from the save game.
+		const OrdinanceDefinition* definition;
+		uint32_t row;
+	};
+
+	void Evaluate(const std::array<double, CityMetricUtil::MetricCount>& metrics);
+
+	std::vector<std::shared_ptr<const OrdinanceDefinition>> definitions;
+	std::vector<Slot> slots;
+	// The ordinances that are evaluated by their program, these use the rows
+	// after the matrix rows.
+	std::vector<const OrdinanceDefinition*> programRows;
+	// The matrix is stored in column-major order, each column has rowStride
+	// elements so that the kernel can process the rows in groups of 4.
+	std::vector<double> constantIncomes;
+	std::vector<double> coefficients;
+	// The columns that have a non-zero coefficient, in metric order.
+	std::vector<uint32_t> activeColumns;
+	size_t matrixRowCount;
+	size_t rowStride;
+	std::vector<double> monthlyIncomes;
+	std::vector<uint8_t> monthlyIncomeInRange;
+	// The epoch of the CityStatsSnapshot that the incomes were computed from.
+	uint32_t evaluatedEpoch;
+	bool evaluated;
+	bool useAvx;
+};
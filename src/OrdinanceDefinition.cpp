@@ -0,0 +1,606 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OrdinanceDefinition.h"
+#include "CityLoadProfiler.h"
+#include "cISCProperty.h"
+#include "cISCPropertyHolder.h"
+#include "OrdiancePropertyIDs.h"
+#include "OrdinancePropertySources.h"
+#include "SessionResourceCache.h"
+#include <array>
+#include <cassert>
+#include <utility>
+
+#include "BuildingCountAvailabilityCondition.h"
+#include "GameYearAvailabilityCondition.h"
+#include "LuaFunctionAvailabilityCondition.h"
+#include "RCIGroupPopulationAvailabilityCondition.h"
+
+#include "BuildingCountIncomeFactor.h"
+#include "LuaFunctionIncomeFactor.h"
+#include "RCIGroupPopulationIncomeFactor.h"
+#include "TotalResidentialPopulationIncomeFactor.h"
+
+static constexpr std::array<std::pair<uint32_t, BuildingType>, 5> BuildingCountAvailabilityConditions =
+{
+	std::pair(kOrdinanceAvailabilityMinFireStationCount, BuildingType::FireStation),
+	std::pair(kOrdinanceAvailabilityMinHospitalCount, BuildingType::Hospital),
+	std::pair(kOrdinanceAvailabilityMinJailCount, BuildingType::Jail),
+	std::pair(kOrdinanceAvailabilityMinPoliceStationCount, BuildingType::PoliceStation),
+	std::pair(kOrdinanceAvailabilityMinSchoolBuildingCount, BuildingType::School),
+};
+
+static constexpr std::array<std::pair<uint32_t, RCIGroup>, 12> RCIGroupMinPopulationAvailabilityConditions =
+{
+	std::pair(kOrdinanceAvailabilityMinPopulationResLowWealth, RCIGroup::Res1),
+	std::pair(kOrdinanceAvailabilityMinPopulationResMediumWealth, RCIGroup::Res2),
+	std::pair(kOrdinanceAvailabilityMinPopulationResHighWealth, RCIGroup::Res3),
+	std::pair(kOrdinanceAvailabilityMinPopulationCsLowWealth, RCIGroup::Cs1),
+	std::pair(kOrdinanceAvailabilityMinPopulationCsMediumWealth, RCIGroup::Cs2),
+	std::pair(kOrdinanceAvailabilityMinPopulationCsHighWealth, RCIGroup::Cs3),
+	std::pair(kOrdinanceAvailabilityMinPopulationCoMediumWealth, RCIGroup::Co2),
+	std::pair(kOrdinanceAvailabilityMinPopulationCoHighWealth, RCIGroup::Co3),
+	std::pair(kOrdinanceAvailabilityMinPopulationIR, RCIGroup::IR),
+	std::pair(kOrdinanceAvailabilityMinPopulationID, RCIGroup::ID),
+	std::pair(kOrdinanceAvailabilityMinPopulationIM, RCIGroup::IM),
+	std::pair(kOrdinanceAvailabilityMinPopulationIHT, RCIGroup::IHT),
+};
+
+static constexpr std::array<std::pair<uint32_t, RCIGroup>, 3> ResWealthGroupMonthlyIncomeFactors =
+{
+	std::pair(kOrdinanceMonthlyIncomeFactorResLowWealthPopulation, RCIGroup::Res1),
+	std::pair(kOrdinanceMonthlyIncomeFactorResMediumWealthPopulation, RCIGroup::Res2),
+	std::pair(kOrdinanceMonthlyIncomeFactorResHighWealthPopulation, RCIGroup::Res3),
+};
+
+static constexpr std::array<std::pair<uint32_t, RCIGroup>, 3> CsWealthGroupMonthlyIncomeFactors =
+{
+	std::pair(kOrdinanceMonthlyIncomeFactorCsLowWealthPopulation, RCIGroup::Cs1),
+	std::pair(kOrdinanceMonthlyIncomeFactorCsMediumWealthPopulation, RCIGroup::Cs2),
+	std::pair(kOrdinanceMonthlyIncomeFactorCsHighWealthPopulation, RCIGroup::Cs3),
+};
+
+static constexpr std::array<std::pair<uint32_t, RCIGroup>, 2> CoWealthGroupMonthlyIncomeFactors =
+{
+	std::pair(kOrdinanceMonthlyIncomeFactorCoMediumWealthPopulation, RCIGroup::Co2),
+	std::pair(kOrdinanceMonthlyIncomeFactorCoHighWealthPopulation, RCIGroup::Co3),
+};
+
+static constexpr std::array<std::pair<uint32_t, RCIGroup>, 4> IndustrialMonthlyIncomeFactors =
+{
+	std::pair(kOrdinanceMonthlyIncomeFactorIRPopulation, RCIGroup::IR),
+	std::pair(kOrdinanceMonthlyIncomeFactorIDPopulation, RCIGroup::ID),
+	std::pair(kOrdinanceMonthlyIncomeFactorIMPopulation, RCIGroup::IM),
+	std::pair(kOrdinanceMonthlyIncomeFactorIHTPopulation, RCIGroup::IHT),
+};
+
+static constexpr std::array<std::pair<uint32_t, BuildingType>, 5> BuildingCountMonthlyIncomeFactors =
+{
+	std::pair(kOrdinanceMonthlyIncomeFactorFireStationCount, BuildingType::FireStation),
+	std::pair(kOrdinanceMonthlyIncomeFactorHospitalCount, BuildingType::Hospital),
+	std::pair(kOrdinanceMonthlyIncomeFactorJailCount, BuildingType::Jail),
+	std::pair(kOrdinanceMonthlyIncomeFactorPoliceStationCount, BuildingType::PoliceStation),
+	std::pair(kOrdinanceMonthlyIncomeFactorSchoolBuildingCount, BuildingType::School),
+};
+
+namespace
+{
+	using OrdinancePropertySources::CompiledPackSource;
+	using OrdinancePropertySources::ContentHashingSource;
+	using OrdinancePropertySources::PropertyHolderSource;
+	using OrdinancePropertySources::PropertySlots;
+	using OrdinancePropertySources::PropertyTableSource;
+
+	// The ids of the properties that are used by the ordinance definition, this
+	// includes the ids in the tables above.
+	static constexpr std::array<uint32_t, 12> CommonOrdinancePropertyIDs =
+	{
+		kOrdinanceNameKey,
+		kOrdinanceName,
+		kOrdinanceDescriptionKey,
+		kOrdinanceDescription,
+		kOrdinanceEnactmentIncome,
+		kOrdinanceRetracmentIncome,
+		kOrdinancemMonthlyConstantIncome,
+		kOrdinanceIsIncome,
+		kOrdinanceAvailabilityLuaFunction,
+		kOrdinanceAvailabilityGameYear,
+		kOrdinanceMonthlyIncomeFactorLuaFunction,
+		kOrdinanceMonthlyIncomeFactorResTotalPopulation,
+	};
+
+	constexpr uint32_t GetPropertyID(uint32_t id)
+	{
+		return id;
+	}
+
+	template <typename T>
+	constexpr uint32_t GetPropertyID(const std::pair<uint32_t, T>& item)
+	{
+		return item.first;
+	}
+
+	// Checks that every property the definition reads has a slot in the
+	// property table source.
+	template <typename... TArrays>
+	constexpr bool AllPropertiesHaveSlots(const TArrays&... arrays)
+	{
+		bool result = true;
+
+		([&](const auto& array)
+		{
+			for (const auto& item : array)
+			{
+				result = result && PropertySlots.find(GetPropertyID(item)) != PropertySlots.end();
+			}
+		}(arrays), ...);
+
+		return result;
+	}
+
+	static_assert(AllPropertiesHaveSlots(
+		CommonOrdinancePropertyIDs,
+		BuildingCountAvailabilityConditions,
+		RCIGroupMinPopulationAvailabilityConditions,
+		ResWealthGroupMonthlyIncomeFactors,
+		CsWealthGroupMonthlyIncomeFactors,
+		CoWealthGroupMonthlyIncomeFactors,
+		IndustrialMonthlyIncomeFactors,
+		BuildingCountMonthlyIncomeFactors));
+}
+
+std::shared_ptr<const OrdinanceDefinition> OrdinanceDefinition::CreateFromExemplar(
+	const cGZPersistResourceKey& key,
+	cISCResExemplar* pExemplar,
+	const ExemplarPropertyTable* pPropertyTable)
+{
+	std::shared_ptr<OrdinanceDefinition> definition(new OrdinanceDefinition(key));
+
+	// The property table does not include the properties of the parent cohort,
+	// those exemplars must use the game's property holder.
+	if (pPropertyTable
+		&& !pPropertyTable->IsEmpty()
+		&& (!pPropertyTable->HasParentCohort() || !pExemplar))
+	{
+		definition->exemplar = pExemplar;
+		definition->ReadProperties(PropertyTableSource(*pPropertyTable));
+		definition->LoadLocalizedStringResources();
+	}
+	else if (pExemplar)
+	{
+		definition->exemplar = pExemplar;
+		definition->ReadProperties(PropertyHolderSource(pExemplar->AsISCPropertyHolder()));
+		definition->LoadLocalizedStringResources();
+	}
+	else
+	{
+		definition->name.Sprintf("0x%08x", key.instance);
+		definition->description.Sprintf("0x%08x", key.instance);
+	}
+
+	return definition;
+}
+
+std::shared_ptr<const OrdinanceDefinition> OrdinanceDefinition::CreateFromCompiledPack(
+	const cGZPersistResourceKey& key,
+	cISCResExemplar* pExemplar,
+	const CompiledOrdinancePack& pack,
+	uint32_t index)
+{
+	return CreateFromDecoded(Decode(key, pack, index), pExemplar);
+}
+
+std::unique_ptr<OrdinanceDefinition> OrdinanceDefinition::Decode(
+	const cGZPersistResourceKey& key,
+	const ExemplarPropertyTable& propertyTable)
+{
+	assert(!propertyTable.IsEmpty() && !propertyTable.HasParentCohort());
+
+	std::unique_ptr<OrdinanceDefinition> definition(new OrdinanceDefinition(key));
+
+	definition->ReadProperties(PropertyTableSource(propertyTable));
+
+	return definition;
+}
+
+std::unique_ptr<OrdinanceDefinition> OrdinanceDefinition::Decode(
+	const cGZPersistResourceKey& key,
+	const CompiledOrdinancePack& pack,
+	uint32_t index)
+{
+	std::unique_ptr<OrdinanceDefinition> definition(new OrdinanceDefinition(key));
+
+	definition->ReadProperties(CompiledPackSource(pack, index));
+
+	return definition;
+}
+
+std::shared_ptr<const OrdinanceDefinition> OrdinanceDefinition::CreateFromDecoded(
+	std::unique_ptr<OrdinanceDefinition>&& decoded,
+	cISCResExemplar* pExemplar)
+{
+	decoded->exemplar = pExemplar;
+	decoded->LoadLocalizedStringResources();
+
+	return std::shared_ptr<const OrdinanceDefinition>(std::move(decoded));
+}
+
+std::shared_ptr<const OrdinanceDefinition> OrdinanceDefinition::Create(
+	const cGZPersistResourceKey& key,
+	AvailabilityConditionList&& availabilityConditions,
+	MonthlyIncomeFactorList&& monthlyIncomeFactors,
+	const cRZBaseString& name,
+	const StringResourceKey& nameKey,
+	const cRZBaseString& description,
+	const StringResourceKey& descriptionKey,
+	int64_t enactmentIncome,
+	int64_t retracmentIncome,
+	int64_t monthlyConstantIncome,
+	bool isIncomeOrdinance)
+{
+	std::shared_ptr<OrdinanceDefinition> definition(new OrdinanceDefinition(key));
+
+	definition->availabilityConditions = std::move(availabilityConditions);
+	definition->monthlyIncomeFactors = std::move(monthlyIncomeFactors);
+	definition->name = name;
+	definition->nameKey = nameKey;
+	definition->description = description;
+	definition->descriptionKey = descriptionKey;
+	definition->enactmentIncome = enactmentIncome;
+	definition->retracmentIncome = retracmentIncome;
+	definition->monthlyConstantIncome = monthlyConstantIncome;
+	definition->isIncomeOrdinance = isIncomeOrdinance;
+	definition->CompileProgram();
+	definition->LoadLocalizedStringResources();
+
+	return definition;
+}
+
+OrdinanceDefinition::OrdinanceDefinition(const cGZPersistResourceKey& key)
+	: enactmentIncome(0),
+	  retracmentIncome(0),
+	  monthlyConstantIncome(0),
+	  contentHash(0),
+	  key(key),
+	  exemplar(),
+	  availabilityConditions(),
+	  monthlyIncomeFactors(),
+	  program(),
+	  name(),
+	  nameKey(),
+	  description(),
+	  descriptionKey(),
+	  isIncomeOrdinance(false)
+{
+}
+
+const cGZPersistResourceKey& OrdinanceDefinition::GetKey() const
+{
+	return key;
+}
+
+cISCResExemplar* OrdinanceDefinition::GetExemplar() const
+{
+	return exemplar;
+}
+
+const OrdinanceDefinition::AvailabilityConditionList& OrdinanceDefinition::GetAvailabilityConditions() const
+{
+	return availabilityConditions;
+}
+
+const OrdinanceDefinition::MonthlyIncomeFactorList& OrdinanceDefinition::GetMonthlyIncomeFactors() const
+{
+	return monthlyIncomeFactors;
+}
+
+const OrdinanceProgram& OrdinanceDefinition::GetProgram() const
+{
+	return program;
+}
+
+const cRZBaseString& OrdinanceDefinition::GetName() const
+{
+	return name;
+}
+
+const StringResourceKey& OrdinanceDefinition::GetNameKey() const
+{
+	return nameKey;
+}
+
+const cRZBaseString& OrdinanceDefinition::GetDescription() const
+{
+	return description;
+}
+
+const StringResourceKey& OrdinanceDefinition::GetDescriptionKey() const
+{
+	return descriptionKey;
+}
+
+int64_t OrdinanceDefinition::GetEnactmentIncome() const
+{
+	return enactmentIncome;
+}
+
+int64_t OrdinanceDefinition::GetRetracmentIncome() const
+{
+	return retracmentIncome;
+}
+
+int64_t OrdinanceDefinition::GetMonthlyConstantIncome() const
+{
+	return monthlyConstantIncome;
+}
+
+bool OrdinanceDefinition::IsIncomeOrdinance() const
+{
+	return isIncomeOrdinance;
+}
+
+uint64_t OrdinanceDefinition::GetContentHash() const
+{
+	return contentHash;
+}
+
+void OrdinanceDefinition::CompileProgram()
+{
+	program = OrdinanceProgram();
+
+	for (const auto& condition : availabilityConditions)
+	{
+		condition->Compile(program);
+	}
+
+	for (const auto& factor : monthlyIncomeFactors)
+	{
+		factor->Compile(program);
+	}
+}
+
+void OrdinanceDefinition::LoadLocalizedStringResources()
+{
+	CityLoadProfiler::ScopedTimer timer(CityLoadProfiler::Phase::LoadLocalizedStrings, key.instance);
+
+	// The localized strings are cached for the game session, the saved ordinances
+	// create a new definition for each city load.
+	SessionResourceCache& cache = SessionResourceCache::GetInstance();
+
+	cRZAutoRefCount<cIGZString> localizedName;
+	cRZAutoRefCount<cIGZString> localizedDescription;
+
+	if (cache.GetLocalizedString(nameKey, localizedName.AsPPObj()))
+	{
+		if (cache.GetLocalizedString(descriptionKey, localizedDescription.AsPPObj()))
+		{
+			if (localizedName->Strlen() > 0 && !localizedName->IsEqual(this->name, false))
+			{
+				name.Copy(*localizedName);
+			}
+
+			if (localizedDescription->Strlen() > 0 && !localizedDescription->IsEqual(this->description, false))
+			{
+				description.Copy(*localizedDescription);
+			}
+		}
+	}
+}
+
+template <typename TPropertySource>
+void OrdinanceDefinition::ReadProperties(const TPropertySource& properties)
+{
+	const ContentHashingSource<TPropertySource> hashingSource(properties, key);
+
+	ReadCommonOrdinanceProperties(hashingSource);
+	ReadAvailabilityConditionProperties(hashingSource);
+	ReadMonthlyIncomeFactorProperties(hashingSource);
+
+	contentHash = hashingSource.GetHash();
+
+	CompileProgram();
+}
+
+template <typename TPropertySource>
+void OrdinanceDefinition::ReadCommonOrdinanceProperties(const TPropertySource& properties)
+{
+	if (!properties.GetPropertyValue(kOrdinanceNameKey, nameKey))
+	{
+		if (!properties.GetPropertyValue(kOrdinanceName, name))
+		{
+			name.Sprintf("0x%08x", key.instance);
+		}
+	}
+
+	if (!properties.GetPropertyValue(kOrdinanceDescriptionKey, descriptionKey))
+	{
+		if (!properties.GetPropertyValue(kOrdinanceDescription, description))
+		{
+			description.Sprintf("0x%08x", key.instance);
+		}
+	}
+
+	properties.GetPropertyValue(kOrdinanceEnactmentIncome, enactmentIncome);
+	properties.GetPropertyValue(kOrdinanceRetracmentIncome, retracmentIncome);
+	properties.GetPropertyValue(kOrdinancemMonthlyConstantIncome, monthlyConstantIncome);
+	properties.GetPropertyValue(kOrdinanceIsIncome, isIncomeOrdinance);
+}
+
+template <typename TPropertySource>
+void OrdinanceDefinition::ReadAvailabilityConditionProperties(const TPropertySource& properties)
+{
+	cRZBaseString luaFunctionName;
+
+	// The Lua function property takes precedence over all other availability condition properties.
+	if (properties.GetPropertyValue(kOrdinanceAvailabilityLuaFunction, luaFunctionName)
+		&& luaFunctionName.Strlen() > 0)
+	{
+		availabilityConditions.push_back(std::make_unique<LuaFunctionAvailabilityCondition>(luaFunctionName));
+	}
+	else
+	{
+		uint32_t yearAvailable = 0;
+
+		if (properties.GetPropertyValue(kOrdinanceAvailabilityGameYear, yearAvailable))
+		{
+			constexpr uint32_t kSC4StartYear = 2000;
+
+			if (yearAvailable > kSC4StartYear)
+			{
+				availabilityConditions.push_back(std::make_unique<GameYearAvailabilityCondition>(yearAvailable));
+			}
+		}
+
+		for (const auto& item : BuildingCountAvailabilityConditions)
+		{
+			ReadMinBuildingCountAvailabilityCondition(properties, item.first, item.second);
+		}
+
+		for (const auto& item : RCIGroupMinPopulationAvailabilityConditions)
+		{
+			ReadRCIGroupMinPopulationAvailabilityCondition(properties, item.first, item.second);
+		}
+	}
+}
+
+template <typename TPropertySource>
+void OrdinanceDefinition::ReadMonthlyIncomeFactorProperties(const TPropertySource& properties)
+{
+	cRZBaseString luaFunctionName;
+
+	// The Lua function property takes precedence over all other monthly income factor properties.
+	if (properties.GetPropertyValue(kOrdinanceMonthlyIncomeFactorLuaFunction, luaFunctionName)
+		&& luaFunctionName.Strlen() > 0)
+	{
+		monthlyIncomeFactors.push_back(std::make_unique<LuaFunctionIncomeFactor>(luaFunctionName));
+	}
+	else
+	{
+		float resTotalPopulationIncomeFactor = 0.0f;
+
+		if (properties.GetPropertyValue(
+			kOrdinanceMonthlyIncomeFactorResTotalPopulation,
+			resTotalPopulationIncomeFactor))
+		{
+			monthlyIncomeFactors.push_back(std::make_unique<TotalResidentialPopulationIncomeFactor>(resTotalPopulationIncomeFactor));
+		}
+		else
+		{
+			// The total residential population property takes precedence over the residential wealth group properties.
+			for (const auto& item : ResWealthGroupMonthlyIncomeFactors)
+			{
+				ReadRCIGroupPopulationMonthlyIncomeFactor(
+					properties,
+					item.first,
+					item.second);
+			}
+		}
+
+		for (const auto& item : CsWealthGroupMonthlyIncomeFactors)
+		{
+			ReadRCIGroupPopulationMonthlyIncomeFactor(
+				properties,
+				item.first,
+				item.second);
+		}
+
+		for (const auto& item : CoWealthGroupMonthlyIncomeFactors)
+		{
+			ReadRCIGroupPopulationMonthlyIncomeFactor(
+				properties,
+				item.first,
+				item.second);
+		}
+
+		for (const auto& item : IndustrialMonthlyIncomeFactors)
+		{
+			ReadRCIGroupPopulationMonthlyIncomeFactor(
+				properties,
+				item.first,
+				item.second);
+		}
+
+		for (const auto& item : BuildingCountMonthlyIncomeFactors)
+		{
+			ReadBuildingCountMonthlyIncomeFactor(
+				properties,
+				item.first,
+				item.second);
+		}
+	}
+}
+
+template <typename TPropertySource>
+void OrdinanceDefinition::ReadMinBuildingCountAvailabilityCondition(
+	const TPropertySource& properties,
+	uint32_t id,
+	BuildingType type)
+{
+	uint32_t count = 0;
+
+	if (properties.GetPropertyValue(id, count) && count > 0)
+	{
+		availabilityConditions.push_back(std::make_unique<BuildingCountAvailabilityCondition>(type, count));
+	}
+}
+
+template <typename TPropertySource>
+void OrdinanceDefinition::ReadRCIGroupMinPopulationAvailabilityCondition(
+	const TPropertySource& properties,
+	uint32_t id,
+	RCIGroup type)
+{
+	uint32_t minPopulation = 0;
+
+	if (properties.GetPropertyValue(id, minPopulation) && minPopulation > 0)
+	{
+		availabilityConditions.push_back(std::make_unique<RCIGroupPopulationAvailabilityCondition>(type, minPopulation));
+	}
+}
+
+template <typename TPropertySource>
+void OrdinanceDefinition::ReadBuildingCountMonthlyIncomeFactor(
+	const TPropertySource& properties,
+	uint32_t id,
+	BuildingType type)
+{
+	float factor = 0.0f;
+
+	if (properties.GetPropertyValue(id, factor))
+	{
+		monthlyIncomeFactors.push_back(std::make_unique<BuildingCountIncomeFactor>(type, factor));
+	}
+}
+
+template <typename TPropertySource>
+void OrdinanceDefinition::ReadRCIGroupPopulationMonthlyIncomeFactor(
+	const TPropertySource& properties,
+	uint32_t id,
+	RCIGroup type)
+{
+	float factor = 0.0f;
+
+	if (properties.GetPropertyValue(id, factor))
+	{
+		monthlyIncomeFactors.push_back(std::make_unique<RCIGroupPopulationIncomeFactor>(type, factor));
+	}
+}
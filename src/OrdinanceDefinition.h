@@ -0,0 +1,180 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "BuildingType.h"
+#include "cGZPersistResourceKey.h"
+#include "cISCResExemplar.h"
+#include "cRZAutoRefCount.h"
+#include "cRZBaseString.h"
+#include "CompiledOrdinancePack.h"
+#include "ExemplarPropertyTable.h"
+#include "IAvailabilityCondition.h"
+#include "IMonthlyIncomeFactor.h"
+#include "OrdinanceProgram.h"
+#include "RCIGroup.h"
+#include "StringResourceKey.h"
+#include <memory>
+#include <vector>
+
+// The exemplar-derived data of a custom ordinance.
+// A definition is immutable after it has been created, it is shared between
+// all of the CustomOrdinance instances that use the same ordinance exemplar.
+class OrdinanceDefinition
+{
+public:
+	using AvailabilityConditionList = std::vector<std::unique_ptr<IAvailabilityCondition>>;
+	using MonthlyIncomeFactorList = std::vector<std::unique_ptr<IMonthlyIncomeFactor>>;
+
+	// Creates a definition from the properties of an ordinance exemplar.
+	// The property table is optional, when it is provided the properties are read
+	// from the table instead of the exemplar.
+	// If the exemplar and property table are null, the definition will use the
+	// default values.
+	static std::shared_ptr<const OrdinanceDefinition> CreateFromExemplar(
+		const cGZPersistResourceKey& key,
+		cISCResExemplar* pExemplar,
+		const ExemplarPropertyTable* pPropertyTable = nullptr);
+
+	// Creates a definition from a compiled ordinance pack record.
+	// The exemplar is optional, it is only used for the ordinance's property holder.
+	static std::shared_ptr<const OrdinanceDefinition> CreateFromCompiledPack(
+		const cGZPersistResourceKey& key,
+		cISCResExemplar* pExemplar,
+		const CompiledOrdinancePack& pack,
+		uint32_t index);
+
+	// Decodes the properties of an ordinance without using any of the game's resources,
+	// this can be called from a background thread.
+	// The property table must not have a parent cohort.
+	// The definition is completed on the game thread by CreateFromDecoded.
+	static std::unique_ptr<OrdinanceDefinition> Decode(
+		const cGZPersistResourceKey& key,
+		const ExemplarPropertyTable& propertyTable);
+	static std::unique_ptr<OrdinanceDefinition> Decode(
+		const cGZPersistResourceKey& key,
+		const CompiledOrdinancePack& pack,
+		uint32_t index);
+
+	// Sets the exemplar and loads the localized strings of a decoded definition.
+	// The exemplar is optional, it is only used for the ordinance's property holder.
+	static std::shared_ptr<const OrdinanceDefinition> CreateFromDecoded(
+		std::unique_ptr<OrdinanceDefinition>&& decoded,
+		cISCResExemplar* pExemplar);
+
+	// Creates a definition from values that were read from the save game.
+	static std::shared_ptr<const OrdinanceDefinition> Create(
+		const cGZPersistResourceKey& key,
+		AvailabilityConditionList&& availabilityConditions,
+		MonthlyIncomeFactorList&& monthlyIncomeFactors,
+		const cRZBaseString& name,
+		const StringResourceKey& nameKey,
+		const cRZBaseString& description,
+		const StringResourceKey& descriptionKey,
+		int64_t enactmentIncome,
+		int64_t retracmentIncome,
+		int64_t monthlyConstantIncome,
+		bool isIncomeOrdinance);
+
+	OrdinanceDefinition(const OrdinanceDefinition& other) = delete;
+	OrdinanceDefinition(OrdinanceDefinition&& other) = delete;
+
+	OrdinanceDefinition& operator=(const OrdinanceDefinition& other) = delete;
+	OrdinanceDefinition& operator=(OrdinanceDefinition&& other) = delete;
+
+	const cGZPersistResourceKey& GetKey() const;
+	cISCResExemplar* GetExemplar() const;
+
+	// The condition and factor lists are used to write the save game data, the
+	// program is used to evaluate them.
+	const AvailabilityConditionList& GetAvailabilityConditions() const;
+	const MonthlyIncomeFactorList& GetMonthlyIncomeFactors() const;
+	const OrdinanceProgram& GetProgram() const;
+
+	const cRZBaseString& GetName() const;
+	const StringResourceKey& GetNameKey() const;
+	const cRZBaseString& GetDescription() const;
+	const StringResourceKey& GetDescriptionKey() const;
+
+	int64_t GetEnactmentIncome() const;
+	int64_t GetRetracmentIncome() const;
+	int64_t GetMonthlyConstantIncome() const;
+	bool IsIncomeOrdinance() const;
+
+	// Gets a hash of the exemplar property values that the definition was created from.
+	// The hash is zero for the definitions that were not created from an exemplar.
+	// The hash is stored in the save game, it is used to detect if the installed
+	// exemplar has changed since the city was saved.
+	uint64_t GetContentHash() const;
+
+private:
+	OrdinanceDefinition(const cGZPersistResourceKey& key);
+
+	void LoadLocalizedStringResources();
+	void CompileProgram();
+
+	// The property source is the exemplar's property holder, a property table or
+	// a compiled pack record, see OrdinanceDefinition.cpp.
+
+	template <typename TPropertySource> void ReadProperties(const TPropertySource& properties);
+	template <typename TPropertySource> void ReadCommonOrdinanceProperties(const TPropertySource& properties);
+	template <typename TPropertySource> void ReadAvailabilityConditionProperties(const TPropertySource& properties);
+	template <typename TPropertySource> void ReadMonthlyIncomeFactorProperties(const TPropertySource& properties);
+
+	template <typename TPropertySource>
+	void ReadMinBuildingCountAvailabilityCondition(
+		const TPropertySource& properties,
+		uint32_t id,
+		BuildingType type);
+	template <typename TPropertySource>
+	void ReadRCIGroupMinPopulationAvailabilityCondition(
+		const TPropertySource& properties,
+		uint32_t id,
+		RCIGroup type);
+
+	template <typename TPropertySource>
+	void ReadBuildingCountMonthlyIncomeFactor(
+		const TPropertySource& properties,
+		uint32_t id,
+		BuildingType type);
+	template <typename TPropertySource>
+	void ReadRCIGroupPopulationMonthlyIncomeFactor(
+		const TPropertySource& properties,
+		uint32_t id,
+		RCIGroup type);
+
+	// The 64-bit fields are first to eliminate 8 bytes of alignment padding.
+
+	int64_t enactmentIncome;
+	int64_t retracmentIncome;
+	int64_t monthlyConstantIncome;
+	uint64_t contentHash;
+	cGZPersistResourceKey key;
+	cRZAutoRefCount<cISCResExemplar> exemplar;
+	AvailabilityConditionList availabilityConditions;
+	MonthlyIncomeFactorList monthlyIncomeFactors;
+	OrdinanceProgram program;
+	cRZBaseString name;
+	StringResourceKey nameKey;
+	cRZBaseString description;
+	StringResourceKey descriptionKey;
+	bool isIncomeOrdinance;
+};
@@ -0,0 +1,188 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OrdinanceDefinitionRegistry.h"
+#include <cassert>
+#include <utility>
+
+OrdinanceDefinitionRegistry::Entry::Entry(
+	const cGZPersistResourceKey& key,
+	cISCResExemplar* pExemplar,
+	ExemplarPropertyTable&& properties,
+	size_t compiledPackIndex)
+	: key(key),
+	  exemplar(pExemplar),
+	  properties(std::move(properties)),
+	  compiledPackIndex(compiledPackIndex),
+	  definition()
+{
+}
+
+OrdinanceDefinitionRegistry::OrdinanceDefinitionRegistry()
+	: entries(), compiledPack(), lookupTable(), prefetcher()
+{
+}
+
+void OrdinanceDefinitionRegistry::Add(
+	const cGZPersistResourceKey& key,
+	cISCResExemplar* pExemplar,
+	ExemplarPropertyTable&& properties)
+{
+	entries.emplace_back(key, pExemplar, std::move(properties), npos);
+}
+
+void OrdinanceDefinitionRegistry::AddCompiledPack(CompiledOrdinancePack&& pack)
+{
+	compiledPack = std::move(pack);
+
+	const uint32_t count = compiledPack.GetRecordCount();
+	entries.reserve(entries.size() + count);
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const CompiledOrdinancePack::Key packKey = compiledPack.GetKey(i);
+
+		entries.emplace_back(
+			cGZPersistResourceKey(packKey.type, packKey.group, packKey.instance),
+			nullptr,
+			ExemplarPropertyTable(),
+			i);
+	}
+}
+
+void OrdinanceDefinitionRegistry::Clear()
+{
+	prefetcher.Stop();
+	entries.clear();
+	compiledPack.Close();
+	lookupTable.Clear();
+}
+
+void OrdinanceDefinitionRegistry::Reserve(size_t count)
+{
+	entries.reserve(count);
+}
+
+bool OrdinanceDefinitionRegistry::IsEmpty() const
+{
+	return entries.empty();
+}
+
+size_t OrdinanceDefinitionRegistry::GetCount() const
+{
+	return entries.size();
+}
+
+void OrdinanceDefinitionRegistry::BuildLookupTable()
+{
+	std::vector<uint32_t> ids;
+	ids.reserve(entries.size());
+
+	for (const Entry& entry : entries)
+	{
+		ids.push_back(entry.key.instance);
+	}
+
+	lookupTable.Build(ids);
+}
+
+void OrdinanceDefinitionRegistry::StartPrefetch()
+{
+	prefetcher.Start(
+		entries.size(),
+		[this](size_t index) -> std::unique_ptr<OrdinanceDefinition>
+		{
+			// The game's resource manager is not thread safe, the exemplar property holder
+			// definitions and the localized strings are left for the game thread.
+			const Entry& entry = entries[index];
+
+			if (entry.compiledPackIndex != npos)
+			{
+				return OrdinanceDefinition::Decode(
+					entry.key,
+					compiledPack,
+					static_cast<uint32_t>(entry.compiledPackIndex));
+			}
+			else if (!entry.properties.IsEmpty() && !entry.properties.HasParentCohort())
+			{
+				return OrdinanceDefinition::Decode(entry.key, entry.properties);
+			}
+
+			return nullptr;
+		});
+}
+
+void OrdinanceDefinitionRegistry::StopPrefetch()
+{
+	prefetcher.Stop();
+}
+
+size_t OrdinanceDefinitionRegistry::Find(uint32_t instance) const
+{
+	const uint32_t index = lookupTable.Find(instance);
+
+	return index != OrdinanceIDLookupTable::npos ? index : npos;
+}
+
+const cGZPersistResourceKey& OrdinanceDefinitionRegistry::GetKey(size_t index) const
+{
+	assert(index < entries.size());
+
+	return entries[index].key;
+}
+
+std::shared_ptr<const OrdinanceDefinition> OrdinanceDefinitionRegistry::GetDefinition(size_t index)
+{
+	assert(index < entries.size());
+
+	Entry& entry = entries[index];
+
+	if (!entry.definition)
+	{
+		// The definition is created from what the discovery already decoded, the
+		// exemplar is not loaded from the resource manager again.
+		// The entries without an exemplar leave it to the ordinance's property
+		// holder, which loads it the first time that the game reads a property.
+		std::unique_ptr<OrdinanceDefinition> decoded = prefetcher.Take(index);
+
+		if (decoded)
+		{
+			entry.definition = OrdinanceDefinition::CreateFromDecoded(std::move(decoded), entry.exemplar);
+		}
+		else if (entry.compiledPackIndex != npos)
+		{
+			entry.definition = OrdinanceDefinition::CreateFromCompiledPack(
+				entry.key,
+				entry.exemplar,
+				compiledPack,
+				static_cast<uint32_t>(entry.compiledPackIndex));
+		}
+		else
+		{
+			entry.definition = OrdinanceDefinition::CreateFromExemplar(entry.key, entry.exemplar, &entry.properties);
+		}
+
+		entry.exemplar.Reset();
+		entry.properties = ExemplarPropertyTable();
+	}
+
+	return entry.definition;
+}
@@ -0,0 +1,117 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "cGZPersistResourceKey.h"
+#include "cISCResExemplar.h"
+#include "cRZAutoRefCount.h"
+#include "CompiledOrdinancePack.h"
+#include "ExemplarPropertyTable.h"
+#include "OrdinanceDefinition.h"
+#include "OrdinanceDefinitionPrefetcher.h"
+#include "OrdinanceIDLookupTable.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Stores the custom ordinances that were found when the game started.
+// The ordinance definitions are created from the exemplars on first use, and
+// are shared by all of the cities that are loaded during the game session.
+// The definitions that do not depend on the game's resources can be decoded
+// in the background before the first city is loaded, see StartPrefetch.
+class OrdinanceDefinitionRegistry
+{
+public:
+	static constexpr size_t npos = static_cast<size_t>(-1);
+
+	OrdinanceDefinitionRegistry();
+
+	OrdinanceDefinitionRegistry(const OrdinanceDefinitionRegistry& other) = delete;
+	OrdinanceDefinitionRegistry(OrdinanceDefinitionRegistry&& other) = delete;
+
+	OrdinanceDefinitionRegistry& operator=(const OrdinanceDefinitionRegistry& other) = delete;
+	OrdinanceDefinitionRegistry& operator=(OrdinanceDefinitionRegistry&& other) = delete;
+
+	// Adds an ordinance with the exemplar and properties that were decoded when
+	// it was discovered.
+	// The exemplar is null when the discovery did not use the game's exemplar
+	// parser, the property table is empty for the exemplars that it cannot decode.
+	void Add(
+		const cGZPersistResourceKey& key,
+		cISCResExemplar* pExemplar,
+		ExemplarPropertyTable&& properties);
+	// Adds the ordinances in a compiled ordinance pack.
+	// The registry takes ownership of the pack, it is used to create the
+	// ordinance definitions.
+	void AddCompiledPack(CompiledOrdinancePack&& pack);
+	void Clear();
+	void Reserve(size_t count);
+
+	// Builds the instance id lookup table that is used by Find.
+	// This must be called after all of the ordinances have been added.
+	void BuildLookupTable();
+
+	// Starts decoding the compiled pack and property table definitions on a
+	// background thread.
+	// This must be called after all of the ordinances have been added.
+	void StartPrefetch();
+	void StopPrefetch();
+
+	bool IsEmpty() const;
+	size_t GetCount() const;
+
+	// Gets the index of the ordinance with the specified instance id, or npos
+	// if the instance id is not a custom ordinance.
+	size_t Find(uint32_t instance) const;
+
+	const cGZPersistResourceKey& GetKey(size_t index) const;
+	std::shared_ptr<const OrdinanceDefinition> GetDefinition(size_t index);
+
+private:
+	struct Entry
+	{
+		cGZPersistResourceKey key;
+		// The exemplar and properties are released after the definition has been
+		// created, the definition holds its own reference to the exemplar.
+		// Both are empty for the ordinances in the compiled pack.
+		cRZAutoRefCount<cISCResExemplar> exemplar;
+		ExemplarPropertyTable properties;
+		// The index of the ordinance's compiled pack record, or npos if the
+		// ordinance is not in the compiled pack.
+		size_t compiledPackIndex;
+		std::shared_ptr<const OrdinanceDefinition> definition;
+
+		Entry(
+			const cGZPersistResourceKey& key,
+			cISCResExemplar* pExemplar,
+			ExemplarPropertyTable&& properties,
+			size_t compiledPackIndex);
+	};
+
+	std::vector<Entry> entries;
+	CompiledOrdinancePack compiledPack;
+	OrdinanceIDLookupTable lookupTable;
+	// The prefetcher reads the entries and compiled pack, the director stops it
+	// in PostCityShutdown and PreAppShutdown.
+	// It must be the last member so that its destructor joins the background
+	// thread before the entries and compiled pack are destroyed.
+	OrdinanceDefinitionPrefetcher prefetcher;
+};
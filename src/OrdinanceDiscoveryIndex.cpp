@@ -0,0 +1,515 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OrdinanceDiscoveryIndex.h"
+#include "HashUtil.h"
+#include "Logger.h"
+#include "version.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <fstream>
+#include <memory>
+#include <unordered_map>
+
+namespace
+{
+	constexpr uint32_t IndexFileSignature = 0x58444E49; // INDX
+	constexpr uint32_t IndexFileVersion = 4;
+
+	// Limits that are used to reject corrupted index files before allocating memory.
+	constexpr uint32_t MaxStringLength = 32767;
+	constexpr uint32_t MaxItemCount = 1000000;
+	constexpr uint32_t MaxRecordDataSize = 16 * 1024 * 1024;
+
+	using DiscoveredExemplar = OrdinanceDiscoveryIndex::DiscoveredExemplar;
+	using ExemplarStatus = OrdinanceDiscoveryPipeline::ExemplarStatus;
+
+	bool ReadUint32(std::istream& stream, uint32_t& value)
+	{
+		return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(value)));
+	}
+
+	bool ReadUint64(std::istream& stream, uint64_t& value)
+	{
+		return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(value)));
+	}
+
+	bool ReadInt64(std::istream& stream, int64_t& value)
+	{
+		return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(value)));
+	}
+
+	bool ReadString(std::istream& stream, std::string& value)
+	{
+		uint32_t length = 0;
+
+		if (!ReadUint32(stream, length) || length > MaxStringLength)
+		{
+			return false;
+		}
+
+		value.resize(length);
+
+		return length == 0 || static_cast<bool>(stream.read(value.data(), length));
+	}
+
+	bool ReadExemplar(std::istream& stream, DiscoveredExemplar& exemplar)
+	{
+		uint32_t status = 0;
+		uint32_t dataSize = 0;
+
+		if (!ReadUint32(stream, exemplar.key.type)
+			|| !ReadUint32(stream, exemplar.key.group)
+			|| !ReadUint32(stream, exemplar.key.instance)
+			|| !ReadUint32(stream, status)
+			|| status > static_cast<uint32_t>(ExemplarStatus::InheritedExemplarType)
+			|| !ReadUint32(stream, dataSize)
+			|| dataSize > MaxRecordDataSize)
+		{
+			return false;
+		}
+
+		exemplar.status = static_cast<ExemplarStatus>(status);
+		exemplar.data.resize(dataSize);
+
+		return dataSize == 0 || static_cast<bool>(stream.read(reinterpret_cast<char*>(exemplar.data.data()), dataSize));
+	}
+
+	void WriteUint32(std::ostream& stream, uint32_t value)
+	{
+		stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	void WriteUint64(std::ostream& stream, uint64_t value)
+	{
+		stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	void WriteInt64(std::ostream& stream, int64_t value)
+	{
+		stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	void WriteString(std::ostream& stream, const std::string& value)
+	{
+		WriteUint32(stream, static_cast<uint32_t>(value.size()));
+		stream.write(value.data(), value.size());
+	}
+
+	void WriteExemplar(std::ostream& stream, const DiscoveredExemplar& exemplar)
+	{
+		WriteUint32(stream, exemplar.key.type);
+		WriteUint32(stream, exemplar.key.group);
+		WriteUint32(stream, exemplar.key.instance);
+		WriteUint32(stream, static_cast<uint32_t>(exemplar.status));
+		WriteUint32(stream, static_cast<uint32_t>(exemplar.data.size()));
+		stream.write(reinterpret_cast<const char*>(exemplar.data.data()), exemplar.data.size());
+	}
+
+	std::string ToUtf8String(const std::filesystem::path& path)
+	{
+		const std::u8string utf8 = path.generic_u8string();
+
+		return std::string(utf8.begin(), utf8.end());
+	}
+
+	bool ComputeFileContentHash(const std::filesystem::path& path, uint64_t& hash)
+	{
+		std::ifstream stream(path, std::ifstream::in | std::ifstream::binary);
+
+		if (!stream)
+		{
+			return false;
+		}
+
+		constexpr size_t BufferSize = 65536;
+		std::unique_ptr<char[]> buffer = std::make_unique_for_overwrite<char[]>(BufferSize);
+
+		hash = HashUtil::Fnv1a64OffsetBasis;
+
+		while (stream)
+		{
+			stream.read(buffer.get(), BufferSize);
+
+			const std::streamsize bytesRead = stream.gcount();
+
+			if (bytesRead > 0)
+			{
+				hash = HashUtil::Fnv1a64(buffer.get(), static_cast<size_t>(bytesRead), hash);
+			}
+		}
+
+		return stream.eof();
+	}
+}
+
+OrdinanceDiscoveryIndex::OrdinanceDiscoveryIndex()
+	: loaded(false), modified(false), rootDirectories(), keyFilterHash(0), files()
+{
+}
+
+bool OrdinanceDiscoveryIndex::Load(const std::filesystem::path& indexFilePath)
+{
+	loaded = false;
+	modified = false;
+	rootDirectories.clear();
+	keyFilterHash = 0;
+	files.clear();
+
+	std::ifstream stream(indexFilePath, std::ifstream::in | std::ifstream::binary);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	uint32_t signature = 0;
+	uint32_t version = 0;
+
+	if (!ReadUint32(stream, signature)
+		|| signature != IndexFileSignature
+		|| !ReadUint32(stream, version)
+		|| version != IndexFileVersion)
+	{
+		return false;
+	}
+
+	std::string pluginVersion;
+
+	if (!ReadString(stream, pluginVersion) || pluginVersion != PLUGIN_VERSION_STR)
+	{
+		// The ordinance validation rules may be different in other plugin versions.
+		return false;
+	}
+
+	if (!ReadString(stream, rootDirectories) || !ReadUint64(stream, keyFilterHash))
+	{
+		return false;
+	}
+
+	uint32_t fileCount = 0;
+
+	if (!ReadUint32(stream, fileCount) || fileCount > MaxItemCount)
+	{
+		return false;
+	}
+
+	files.reserve(fileCount);
+
+	for (uint32_t i = 0; i < fileCount; i++)
+	{
+		FileEntry entry{};
+		uint32_t exemplarCount = 0;
+
+		if (!ReadString(stream, entry.path)
+			|| !ReadUint64(stream, entry.size)
+			|| !ReadInt64(stream, entry.lastWriteTime)
+			|| !ReadUint64(stream, entry.contentHash)
+			|| !ReadUint32(stream, exemplarCount)
+			|| exemplarCount > MaxItemCount)
+		{
+			return false;
+		}
+
+		entry.decoded = true;
+		entry.exemplars.resize(exemplarCount);
+
+		for (DiscoveredExemplar& exemplar : entry.exemplars)
+		{
+			if (!ReadExemplar(stream, exemplar))
+			{
+				return false;
+			}
+		}
+
+		files.push_back(std::move(entry));
+	}
+
+	loaded = true;
+	return true;
+}
+
+bool OrdinanceDiscoveryIndex::Save(const std::filesystem::path& indexFilePath) const
+{
+	// The index is written to a temporary file that replaces the existing index,
+	// this prevents a partially written index from being used if the game crashes.
+
+	std::filesystem::path tempFilePath = indexFilePath;
+	tempFilePath += ".tmp";
+
+	{
+		std::ofstream stream(tempFilePath, std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+
+		if (!stream)
+		{
+			return false;
+		}
+
+		WriteUint32(stream, IndexFileSignature);
+		WriteUint32(stream, IndexFileVersion);
+		WriteString(stream, PLUGIN_VERSION_STR);
+		WriteString(stream, rootDirectories);
+		WriteUint64(stream, keyFilterHash);
+
+		// The files that were not decoded are left out, they are treated as new
+		// files when the index is loaded.
+		const uint32_t decodedFileCount = static_cast<uint32_t>(std::count_if(
+			files.begin(),
+			files.end(),
+			[](const FileEntry& entry) { return entry.decoded; }));
+
+		WriteUint32(stream, decodedFileCount);
+
+		for (const FileEntry& entry : files)
+		{
+			if (!entry.decoded)
+			{
+				continue;
+			}
+
+			WriteString(stream, entry.path);
+			WriteUint64(stream, entry.size);
+			WriteInt64(stream, entry.lastWriteTime);
+			WriteUint64(stream, entry.contentHash);
+			WriteUint32(stream, static_cast<uint32_t>(entry.exemplars.size()));
+
+			for (const DiscoveredExemplar& exemplar : entry.exemplars)
+			{
+				WriteExemplar(stream, exemplar);
+			}
+		}
+
+		stream.flush();
+
+		if (!stream)
+		{
+			return false;
+		}
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(tempFilePath, indexFilePath, ec);
+
+	return !ec;
+}
+
+bool OrdinanceDiscoveryIndex::Refresh(
+	const std::vector<std::filesystem::path>& roots,
+	const std::vector<FileInfo>& currentFiles,
+	uint64_t currentKeyFilterHash)
+{
+	bool unchanged = loaded;
+	bool reuseExemplars = loaded;
+
+	std::string rootsString;
+
+	for (const std::filesystem::path& root : roots)
+	{
+		rootsString += ToUtf8String(root);
+		rootsString += '\n';
+	}
+
+	if (rootsString != rootDirectories)
+	{
+		// The exemplars of each file are still valid, but a different set of
+		// files may take precedence.
+		unchanged = false;
+		rootDirectories = std::move(rootsString);
+	}
+
+	if (currentKeyFilterHash != keyFilterHash)
+	{
+		// The resource key filter may reject a different set of exemplars.
+		unchanged = false;
+		reuseExemplars = false;
+		keyFilterHash = currentKeyFilterHash;
+	}
+
+	std::unordered_map<std::string, FileEntry*> previousFiles;
+
+	if (reuseExemplars)
+	{
+		previousFiles.reserve(files.size());
+
+		for (FileEntry& entry : files)
+		{
+			previousFiles.emplace(entry.path, &entry);
+		}
+	}
+
+	std::vector<FileEntry> currentEntries;
+	currentEntries.reserve(currentFiles.size());
+
+	for (const FileInfo& file : currentFiles)
+	{
+		FileEntry entry{};
+		entry.path = ToUtf8String(file.path);
+		entry.size = file.size;
+		entry.lastWriteTime = file.lastWriteTime;
+		entry.decoded = false;
+
+		const auto previous = previousFiles.find(entry.path);
+		FileEntry* previousEntry = previous != previousFiles.end() ? previous->second : nullptr;
+		bool hashFile = true;
+
+		if (previousEntry)
+		{
+			if (previousEntry->size == entry.size && previousEntry->lastWriteTime == entry.lastWriteTime)
+			{
+				// The file is assumed to be unchanged if its size and last write time match,
+				// this avoids reading the file contents.
+				entry.contentHash = previousEntry->contentHash;
+				hashFile = false;
+			}
+			else
+			{
+				// The file content may still be the same, the new size and last write time
+				// will be written to the index when it is saved.
+				modified = true;
+			}
+		}
+		else
+		{
+			unchanged = false;
+		}
+
+		if (hashFile)
+		{
+			if (!ComputeFileContentHash(file.path, entry.contentHash))
+			{
+				Logger::GetInstance().WriteLineFormatted(
+					LogLevel::Error,
+					"Failed to read %s for the ordinance discovery index.",
+					entry.path.c_str());
+				unchanged = false;
+				previousEntry = nullptr;
+			}
+			else if (previousEntry && previousEntry->contentHash != entry.contentHash)
+			{
+				unchanged = false;
+				previousEntry = nullptr;
+			}
+		}
+
+		if (previousEntry)
+		{
+			entry.decoded = true;
+			entry.exemplars = std::move(previousEntry->exemplars);
+		}
+
+		currentEntries.push_back(std::move(entry));
+	}
+
+	if (currentEntries.size() != files.size())
+	{
+		// One or more files were removed.
+		unchanged = false;
+	}
+	else if (unchanged)
+	{
+		// The load order of the files determines which of the duplicate exemplars is used.
+		for (size_t i = 0; i < currentEntries.size(); i++)
+		{
+			if (currentEntries[i].path != files[i].path)
+			{
+				unchanged = false;
+				break;
+			}
+		}
+	}
+
+	files = std::move(currentEntries);
+
+	if (!unchanged)
+	{
+		modified = true;
+	}
+
+	loaded = unchanged;
+	return unchanged;
+}
+
+bool OrdinanceDiscoveryIndex::IsModified() const
+{
+	return modified;
+}
+
+std::vector<uint32_t> OrdinanceDiscoveryIndex::GetFilesToDecode() const
+{
+	std::vector<uint32_t> fileIndices;
+
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		if (!files[i].decoded)
+		{
+			fileIndices.push_back(static_cast<uint32_t>(i));
+		}
+	}
+
+	return fileIndices;
+}
+
+void OrdinanceDiscoveryIndex::SetFileExemplars(uint32_t fileIndex, std::vector<DiscoveredExemplar>&& exemplars)
+{
+	assert(fileIndex < files.size());
+
+	FileEntry& entry = files[fileIndex];
+
+	entry.decoded = true;
+	entry.exemplars = std::move(exemplars);
+
+	for (DiscoveredExemplar& exemplar : entry.exemplars)
+	{
+		exemplar.fileIndex = fileIndex;
+	}
+
+	modified = true;
+}
+
+void OrdinanceDiscoveryIndex::GetExemplars(std::vector<DiscoveredExemplar>& results) const
+{
+	results.clear();
+
+	size_t count = 0;
+
+	for (const FileEntry& entry : files)
+	{
+		count += entry.exemplars.size();
+	}
+
+	results.reserve(count);
+
+	for (size_t fileIndex = 0; fileIndex < files.size(); fileIndex++)
+	{
+		for (const DiscoveredExemplar& exemplar : files[fileIndex].exemplars)
+		{
+			DiscoveredExemplar& result = results.emplace_back(exemplar);
+			result.fileIndex = static_cast<uint32_t>(fileIndex);
+
+			if (result.properties.IsEmpty() && !result.data.empty())
+			{
+				// The exemplars that were loaded from the index file only have their record data.
+				result.properties.Parse(result.data);
+			}
+		}
+	}
+}
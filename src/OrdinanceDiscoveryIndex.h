@@ -0,0 +1,102 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "cGZPersistResourceKey.h"
+#include "FileSystem.h"
+#include "OrdinanceDiscoveryPipeline.h"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// A cache of the ordinance discovery results that is saved next to the plugin.
+// The index records the size, last write time and content hash of every file in
+// the custom ordinance folders, and the exemplars that were found in each file.
+// The files that have not changed since the index was saved do not need to be
+// opened and parsed again, only the new and changed files are decoded.
+class OrdinanceDiscoveryIndex
+{
+public:
+	using DiscoveredExemplar = OrdinanceDiscoveryPipeline::DiscoveredExemplar;
+
+	OrdinanceDiscoveryIndex();
+
+	// Loads the index from the specified file.
+	// Returns false if the file does not exist or is not a valid index, an index
+	// that was written by a different plugin version is also rejected.
+	bool Load(const std::filesystem::path& indexFilePath);
+
+	bool Save(const std::filesystem::path& indexFilePath) const;
+
+	// Compares the files that were found in the root directories with the loaded
+	// index, and updates the index file entries to match.
+	// The exemplars of the unchanged files are kept, the new and changed files
+	// must be decoded again, see GetFilesToDecode.
+	// The files must be in the order that their exemplars are loaded, see PluginFileEnumerator.
+	// The key filter hash identifies the resource key filter configuration that
+	// the exemplars were found with, all of the files are decoded again when it
+	// changes.
+	// Returns true if none of the files, their load order or the root directories
+	// have changed since the index was saved; otherwise, false.
+	bool Refresh(
+		const std::vector<std::filesystem::path>& roots,
+		const std::vector<FileInfo>& currentFiles,
+		uint64_t keyFilterHash);
+
+	// Gets a value indicating whether the index was changed after it was loaded.
+	bool IsModified() const;
+
+	// Gets the indices of the files that do not have their exemplars in the index,
+	// in the file list order.
+	std::vector<uint32_t> GetFilesToDecode() const;
+
+	// Sets the exemplars that were found in the file at the specified index of
+	// the file list that was passed to Refresh.
+	void SetFileExemplars(uint32_t fileIndex, std::vector<DiscoveredExemplar>&& exemplars);
+
+	// Gets the exemplars of all of the files, in the file list order.
+	// The file index of each exemplar is its file's position in the file list,
+	// and the ordinance properties are decoded from the stored record data.
+	void GetExemplars(std::vector<DiscoveredExemplar>& results) const;
+
+private:
+	// Only the record data of the exemplars is written to the index file, the
+	// properties of the exemplars that were loaded from it are decoded by GetExemplars.
+	struct FileEntry
+	{
+		// The UTF-8 encoded path.
+		std::string path;
+		uint64_t size;
+		int64_t lastWriteTime;
+		uint64_t contentHash;
+		// False if the file was added or changed since the index was saved.
+		bool decoded;
+		std::vector<DiscoveredExemplar> exemplars;
+	};
+
+	bool loaded;
+	bool modified;
+	// The UTF-8 encoded root directory paths, in order and separated by new lines.
+	std::string rootDirectories;
+	uint64_t keyFilterHash;
+	std::vector<FileEntry> files;
+};
@@ -0,0 +1,262 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OrdinanceDiscoveryPipeline.h"
+#include "DBPFFile.h"
+#include "ExemplarTypeClassifier.h"
+#include "QFSCompression.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <system_error>
+#include <thread>
+
+namespace
+{
+	constexpr uint32_t kExemplarResourceType = 0x6534284A;
+	constexpr uint32_t kExemplarType_Ordinance = 14;
+
+	// The number of records that a worker thread claims at a time.
+	constexpr size_t WorkItemBatchSize = 32;
+
+	using ExemplarStatus = OrdinanceDiscoveryPipeline::ExemplarStatus;
+
+	struct WorkItem
+	{
+		const DBPFFile* file;
+		uint32_t fileIndex;
+		DBPFFile::IndexEntry entry;
+	};
+
+	ExemplarStatus ClassifyExemplar(std::span<const uint8_t> data)
+	{
+		uint32_t exemplarType = 0;
+
+		switch (ExemplarTypeClassifier::GetExemplarType(data, exemplarType))
+		{
+		case ExemplarTypeClassifier::Result::Found:
+			return exemplarType == kExemplarType_Ordinance ? ExemplarStatus::Ordinance : ExemplarStatus::NotOrdinance;
+		case ExemplarTypeClassifier::Result::NotFound:
+			return ExemplarStatus::MissingExemplarType;
+		case ExemplarTypeClassifier::Result::Inherited:
+			return ExemplarStatus::InheritedExemplarType;
+		case ExemplarTypeClassifier::Result::UnsupportedFormat:
+			return ExemplarStatus::UnsupportedFormat;
+		case ExemplarTypeClassifier::Result::InvalidData:
+		default:
+			return ExemplarStatus::InvalidData;
+		}
+	}
+
+	void ProcessWorkItem(
+		const WorkItem& item,
+		std::vector<uint8_t>& buffer,
+		OrdinanceDiscoveryPipeline::DiscoveredExemplar& result)
+	{
+		std::span<const uint8_t> exemplarData = item.file->GetRecordData(item.entry);
+
+		if (exemplarData.size() != item.entry.size)
+		{
+			result.status = ExemplarStatus::InvalidData;
+			return;
+		}
+
+		if (item.file->IsRecordCompressed(item.entry))
+		{
+			if (!QFSCompression::Decompress(exemplarData, buffer))
+			{
+				result.status = ExemplarStatus::InvalidData;
+				return;
+			}
+
+			exemplarData = buffer;
+		}
+
+		result.status = ClassifyExemplar(exemplarData);
+
+		if (result.status == ExemplarStatus::Ordinance)
+		{
+			// Text exemplars are not supported by the property table, their
+			// properties will be read from the game's exemplar.
+			if (result.properties.Parse(exemplarData))
+			{
+				result.data.assign(exemplarData.begin(), exemplarData.end());
+			}
+		}
+	}
+
+	void ProcessWorkItems(
+		const std::vector<WorkItem>& items,
+		std::vector<OrdinanceDiscoveryPipeline::DiscoveredExemplar>& results,
+		std::atomic<size_t>& nextItem)
+	{
+		std::vector<uint8_t> buffer;
+
+		while (true)
+		{
+			const size_t start = nextItem.fetch_add(WorkItemBatchSize, std::memory_order_relaxed);
+
+			if (start >= items.size())
+			{
+				break;
+			}
+
+			const size_t end = std::min(start + WorkItemBatchSize, items.size());
+
+			for (size_t i = start; i < end; i++)
+			{
+				// Each thread writes to a different set of elements.
+				ProcessWorkItem(items[i], buffer, results[i]);
+			}
+		}
+	}
+}
+
+OrdinanceDiscoveryPipeline::OrdinanceDiscoveryPipeline(uint32_t threadCount)
+	: threadCount(threadCount != 0 ? threadCount : std::max(std::thread::hardware_concurrency(), 1U))
+{
+}
+
+bool OrdinanceDiscoveryPipeline::Run(
+	const std::filesystem::path& directory,
+	std::vector<DiscoveredExemplar>& results) const
+{
+	results.clear();
+
+	std::error_code ec;
+
+	if (!std::filesystem::is_directory(directory, ec))
+	{
+		return false;
+	}
+
+	Run(GetFilesInDirectory(directory), results);
+	return true;
+}
+
+void OrdinanceDiscoveryPipeline::Run(
+	const std::vector<std::filesystem::path>& paths,
+	std::vector<DiscoveredExemplar>& results,
+	const KeyFilter& keyFilter) const
+{
+	results.clear();
+
+	// Stage 1: Map the files and collect the exemplar records.
+	// The files must stay open until the worker threads have finished.
+
+	std::vector<std::unique_ptr<DBPFFile>> files;
+	files.reserve(paths.size());
+
+	std::vector<WorkItem> items;
+
+	for (size_t fileIndex = 0; fileIndex < paths.size(); fileIndex++)
+	{
+		std::unique_ptr<DBPFFile> file = std::make_unique<DBPFFile>();
+
+		if (file->Open(paths[fileIndex]))
+		{
+			const uint32_t entryCount = file->GetIndexEntryCount();
+
+			for (uint32_t i = 0; i < entryCount; i++)
+			{
+				const DBPFFile::IndexEntry entry = file->GetIndexEntry(i);
+
+				if (entry.type == kExemplarResourceType
+					&& (!keyFilter || keyFilter(cGZPersistResourceKey(entry.type, entry.group, entry.instance))))
+				{
+					items.push_back(WorkItem{ file.get(), static_cast<uint32_t>(fileIndex), entry });
+				}
+			}
+
+			files.push_back(std::move(file));
+		}
+	}
+
+	// Stage 2: Decompress, classify and decode the exemplars.
+	// The results are created in the enumeration order before the worker threads
+	// start.
+
+	results.reserve(items.size());
+
+	for (const WorkItem& item : items)
+	{
+		results.push_back(DiscoveredExemplar{
+			cGZPersistResourceKey(item.entry.type, item.entry.group, item.entry.instance),
+			item.fileIndex,
+			ExemplarStatus::InvalidData,
+			ExemplarPropertyTable(),
+			std::vector<uint8_t>() });
+	}
+
+	std::atomic<size_t> nextItem = 0;
+
+	const size_t batchCount = (items.size() + WorkItemBatchSize - 1) / WorkItemBatchSize;
+	const size_t workerCount = std::min<size_t>(threadCount, batchCount);
+
+	std::vector<std::thread> workers;
+
+	if (workerCount > 1)
+	{
+		workers.reserve(workerCount - 1);
+
+		for (size_t i = 1; i < workerCount; i++)
+		{
+			try
+			{
+				workers.emplace_back(ProcessWorkItems, std::cref(items), std::ref(results), std::ref(nextItem));
+			}
+			catch (const std::system_error&)
+			{
+				// The calling thread will process the remaining items.
+				break;
+			}
+		}
+	}
+
+	ProcessWorkItems(items, results, nextItem);
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+std::vector<std::filesystem::path> OrdinanceDiscoveryPipeline::GetFilesInDirectory(const std::filesystem::path& directory)
+{
+	std::vector<std::filesystem::path> files;
+
+	std::error_code ec;
+
+	for (std::filesystem::recursive_directory_iterator it(
+		directory,
+		std::filesystem::directory_options::skip_permission_denied,
+		ec), end; !ec && it != end; it.increment(ec))
+	{
+		if (it->is_regular_file(ec))
+		{
+			files.push_back(it->path());
+		}
+	}
+
+	std::sort(files.begin(), files.end());
+
+	return files;
+}
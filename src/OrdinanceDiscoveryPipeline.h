@@ -0,0 +1,96 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "cGZPersistResourceKey.h"
+#include "ExemplarPropertyTable.h"
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+// Reads the exemplars in the custom ordinance folder without using the game's
+// resource system.
+// The folder is enumerated on the calling thread, the exemplar records are then
+// decompressed, classified and decoded on a pool of worker threads.
+class OrdinanceDiscoveryPipeline
+{
+public:
+	enum class ExemplarStatus : uint8_t
+	{
+		Ordinance = 0,
+		// The exemplar has an ExemplarType property that is not Ordinance.
+		NotOrdinance,
+		MissingExemplarType,
+		InvalidData,
+		// The exemplar uses an encoding that the pipeline does not support,
+		// the caller must load it with the game's resource system.
+		UnsupportedFormat,
+		// The exemplar does not have an ExemplarType property, but it can inherit
+		// one from its parent cohort. The caller must load it with the game's
+		// resource system.
+		InheritedExemplarType,
+	};
+
+	struct DiscoveredExemplar
+	{
+		cGZPersistResourceKey key;
+		// The index of the file that contains the exemplar, in the file list
+		// that was scanned.
+		uint32_t fileIndex;
+		ExemplarStatus status;
+		// The decoded properties of a binary ordinance exemplar, this is empty
+		// for the other exemplars.
+		ExemplarPropertyTable properties;
+		// The uncompressed record data that the properties were decoded from,
+		// it is stored in the discovery index.
+		std::vector<uint8_t> data;
+	};
+
+	// Returns true if the exemplar with the specified key should be read.
+	using KeyFilter = std::function<bool(const cGZPersistResourceKey&)>;
+
+	// A thread count of zero uses the number of hardware threads.
+	explicit OrdinanceDiscoveryPipeline(uint32_t threadCount = 0);
+
+	// Scans the files in the directory and its sub-directories.
+	// The results are ordered by file path and then by the position of the record
+	// in the file index, so they do not depend on the number of threads.
+	// Files that are not DBPF files are skipped.
+	bool Run(
+		const std::filesystem::path& directory,
+		std::vector<DiscoveredExemplar>& results) const;
+
+	// Scans the files in the list, in the list order.
+	// Files that are not DBPF files are skipped.
+	// The key filter is optional, the exemplars that it rejects are skipped before
+	// their records are read. The filter is only called on the calling thread.
+	void Run(
+		const std::vector<std::filesystem::path>& paths,
+		std::vector<DiscoveredExemplar>& results,
+		const KeyFilter& keyFilter = nullptr) const;
+
+	// Gets the files in the directory and its sub-directories, sorted by path.
+	static std::vector<std::filesystem::path> GetFilesInDirectory(const std::filesystem::path& directory);
+
+private:
+	uint32_t threadCount;
+};
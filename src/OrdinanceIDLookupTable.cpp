@@ -0,0 +1,98 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OrdinanceIDLookupTable.h"
+#include <bit>
+#include <cassert>
+
+OrdinanceIDLookupTable::OrdinanceIDLookupTable()
+	: slots(), slotMask(0), hashShift(32)
+{
+}
+
+void OrdinanceIDLookupTable::Build(const std::vector<uint32_t>& ids)
+{
+	Clear();
+
+	if (ids.empty())
+	{
+		return;
+	}
+
+	// The table is kept at most half full to keep the probe sequences short.
+	const uint32_t slotCount = std::bit_ceil(static_cast<uint32_t>(ids.size()) * 2);
+
+	slots.resize(slotCount, Slot{ 0, npos });
+	slotMask = slotCount - 1;
+	hashShift = 32 - static_cast<uint32_t>(std::countr_zero(slotCount));
+
+	for (uint32_t i = 0; i < ids.size(); i++)
+	{
+		const uint32_t id = ids[i];
+		uint32_t slotIndex = GetHomeSlot(id);
+
+		while (slots[slotIndex].index != npos)
+		{
+			assert(slots[slotIndex].id != id);
+			slotIndex = (slotIndex + 1) & slotMask;
+		}
+
+		slots[slotIndex] = Slot{ id, i };
+	}
+}
+
+void OrdinanceIDLookupTable::Clear()
+{
+	slots.clear();
+	slotMask = 0;
+	hashShift = 32;
+}
+
+uint32_t OrdinanceIDLookupTable::Find(uint32_t id) const
+{
+	if (slots.empty())
+	{
+		return npos;
+	}
+
+	uint32_t slotIndex = GetHomeSlot(id);
+
+	while (true)
+	{
+		const Slot& slot = slots[slotIndex];
+
+		if (slot.index == npos || slot.id == id)
+		{
+			return slot.index;
+		}
+
+		slotIndex = (slotIndex + 1) & slotMask;
+	}
+}
+
+uint32_t OrdinanceIDLookupTable::GetHomeSlot(uint32_t id) const
+{
+	assert(hashShift < 32);
+
+	// Fibonacci hashing, the top bits of the product are used as the slot index.
+	// This spreads ids that only differ in their low bits across the table.
+	return (id * 0x9E3779B9U) >> hashShift;
+}
@@ -0,0 +1,56 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// A read-only hash table that maps the ordinance instance ids to an index.
+// The table uses open addressing with linear probing in a flat array, it is
+// built once after the ordinances have been loaded.
+class OrdinanceIDLookupTable
+{
+public:
+	static constexpr uint32_t npos = UINT32_MAX;
+
+	OrdinanceIDLookupTable();
+
+	// Builds the table, the index of each id is its position in the vector.
+	// The ids must be unique.
+	void Build(const std::vector<uint32_t>& ids);
+	void Clear();
+
+	// Gets the index of the specified id, or npos if the id is not in the table.
+	uint32_t Find(uint32_t id) const;
+
+private:
+	struct Slot
+	{
+		uint32_t id;
+		uint32_t index;
+	};
+
+	uint32_t GetHomeSlot(uint32_t id) const;
+
+	std::vector<Slot> slots;
+	uint32_t slotMask;
+	uint32_t hashShift;
+};
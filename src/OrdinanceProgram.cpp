@@ -0,0 +1,191 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OrdinanceProgram.h"
+#include "BuildingCountProvider.h"
+#include "LuaFunctionAvailabilityCondition.h"
+#include "LuaFunctionIncomeFactor.h"
+#include "PopulationProvider.h"
+
+OrdinanceProgram::OrdinanceProgram()
+	: instructions(),
+	  luaFunctionNames(),
+	  conditionCount(0),
+	  hasLuaIncomeFunction(false)
+{
+}
+
+void OrdinanceProgram::AddMetricCondition(CityMetric metric, double minValue)
+{
+	AddCondition(Instruction{ Opcode::RequireMetricAtLeast, metric, 0, minValue });
+}
+
+void OrdinanceProgram::AddLuaFunctionCondition(const cRZBaseString& functionName)
+{
+	const uint32_t luaFunctionIndex = AddLuaFunctionName(functionName);
+
+	AddCondition(Instruction{ Opcode::RequireLuaFunction, CityMetric::Count, luaFunctionIndex, 0.0 });
+}
+
+void OrdinanceProgram::AddDemandSupplyCondition(uint32_t demandID, double minValue)
+{
+	AddCondition(Instruction{ Opcode::RequireDemandSupplyAtLeast, CityMetric::Count, demandID, minValue });
+}
+
+void OrdinanceProgram::AddBuildingCountCondition(BuildingType type, double minValue)
+{
+	AddCondition(Instruction{ Opcode::RequireBuildingCountAtLeast, CityMetric::Count, static_cast<uint32_t>(type), minValue });
+}
+
+void OrdinanceProgram::AddMetricIncome(CityMetric metric, double coefficient)
+{
+	instructions.push_back(Instruction{ Opcode::AddMetricProduct, metric, 0, coefficient });
+}
+
+void OrdinanceProgram::AddLuaFunctionIncome(const cRZBaseString& functionName)
+{
+	const uint32_t luaFunctionIndex = AddLuaFunctionName(functionName);
+
+	instructions.push_back(Instruction{ Opcode::CallLuaIncomeFunction, CityMetric::Count, luaFunctionIndex, 0.0 });
+	hasLuaIncomeFunction = true;
+}
+
+void OrdinanceProgram::AddDemandSupplyIncome(uint32_t demandID, double coefficient)
+{
+	instructions.push_back(Instruction{ Opcode::AddDemandSupplyProduct, CityMetric::Count, demandID, coefficient });
+}
+
+void OrdinanceProgram::AddBuildingCountIncome(BuildingType type, double coefficient)
+{
+	instructions.push_back(Instruction{ Opcode::AddBuildingCountProduct, CityMetric::Count, static_cast<uint32_t>(type), coefficient });
+}
+
+bool OrdinanceProgram::CheckConditions(const MetricValues& metrics) const
+{
+	const Instruction* pInstruction = instructions.data();
+	const Instruction* pEnd = pInstruction + conditionCount;
+
+	for (; pInstruction != pEnd; pInstruction++)
+	{
+		switch (pInstruction->opcode)
+		{
+		case Opcode::RequireMetricAtLeast:
+			if (metrics[static_cast<size_t>(pInstruction->metric)] < pInstruction->value)
+			{
+				return false;
+			}
+			break;
+		case Opcode::RequireLuaFunction:
+			if (!LuaFunctionAvailabilityCondition::CallFunction(luaFunctionNames[pInstruction->operand]))
+			{
+				return false;
+			}
+			break;
+		case Opcode::RequireDemandSupplyAtLeast:
+			if (static_cast<double>(PopulationProvider::GetRCIGroupPopulation(pInstruction->operand)) < pInstruction->value)
+			{
+				return false;
+			}
+			break;
+		case Opcode::RequireBuildingCountAtLeast:
+			if (static_cast<double>(BuildingCountProvider::GetBuildingCount(static_cast<BuildingType>(pInstruction->operand))) < pInstruction->value)
+			{
+				return false;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	return true;
+}
+
+double OrdinanceProgram::CalculateMonthlyIncome(double monthlyConstantIncome, const MetricValues& metrics) const
+{
+	double monthlyIncome = monthlyConstantIncome;
+
+	const Instruction* pInstruction = instructions.data() + conditionCount;
+	const Instruction* pEnd = instructions.data() + instructions.size();
+
+	for (; pInstruction != pEnd; pInstruction++)
+	{
+		switch (pInstruction->opcode)
+		{
+		case Opcode::AddMetricProduct:
+			monthlyIncome += pInstruction->value * metrics[static_cast<size_t>(pInstruction->metric)];
+			break;
+		case Opcode::CallLuaIncomeFunction:
+			monthlyIncome = LuaFunctionIncomeFactor::CallFunction(
+				luaFunctionNames[pInstruction->operand],
+				monthlyIncome);
+			break;
+		case Opcode::AddDemandSupplyProduct:
+			monthlyIncome += pInstruction->value * static_cast<double>(PopulationProvider::GetRCIGroupPopulation(pInstruction->operand));
+			break;
+		case Opcode::AddBuildingCountProduct:
+			monthlyIncome += static_cast<double>(BuildingCountProvider::GetBuildingCount(static_cast<BuildingType>(pInstruction->operand))) * pInstruction->value;
+			break;
+		default:
+			break;
+		}
+	}
+
+	return monthlyIncome;
+}
+
+bool OrdinanceProgram::HasLuaIncomeFunction() const
+{
+	return hasLuaIncomeFunction;
+}
+
+const OrdinanceProgram::Instruction* OrdinanceProgram::GetConditionInstructions() const
+{
+	return instructions.data();
+}
+
+size_t OrdinanceProgram::GetConditionCount() const
+{
+	return conditionCount;
+}
+
+const OrdinanceProgram::Instruction* OrdinanceProgram::GetIncomeInstructions() const
+{
+	return instructions.data() + conditionCount;
+}
+
+size_t OrdinanceProgram::GetIncomeInstructionCount() const
+{
+	return instructions.size() - conditionCount;
+}
+
+void OrdinanceProgram::AddCondition(const Instruction& instruction)
+{
+	instructions.insert(instructions.begin() + conditionCount, instruction);
+	conditionCount++;
+}
+
+uint32_t OrdinanceProgram::AddLuaFunctionName(const cRZBaseString& functionName)
+{
+	luaFunctionNames.push_back(functionName);
+
+	return static_cast<uint32_t>(luaFunctionNames.size() - 1);
+}
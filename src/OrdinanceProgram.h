@@ -0,0 +1,108 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "BuildingType.h"
+#include "CityMetric.h"
+#include "cRZBaseString.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// The availability conditions and monthly income factors of an ordinance,
+// compiled into one contiguous array of tagged instructions.
+// The conditions are first, followed by the income factors in the order that
+// they are applied. The program is evaluated by a switch loop against the
+// city metric values, see CityStatsSnapshot. The demand ids and building types
+// that do not have a metric are read from the game when the program runs.
+// The IAvailabilityCondition and IMonthlyIncomeFactor classes are only used to
+// read and write the save game data, they add their instructions with Compile.
+class OrdinanceProgram
+{
+public:
+	using MetricValues = std::array<double, CityMetricUtil::MetricCount>;
+
+	enum class Opcode : uint8_t
+	{
+		// The metric must be greater than or equal to the value.
+		RequireMetricAtLeast = 0,
+		// The Lua function must return true.
+		RequireLuaFunction,
+		// Adds the value multiplied by the metric to the monthly income.
+		AddMetricProduct,
+		// Replaces the monthly income with the result of the Lua function.
+		CallLuaIncomeFunction,
+		// The demand supply or building count in the operand must be greater than
+		// or equal to the value.
+		RequireDemandSupplyAtLeast,
+		RequireBuildingCountAtLeast,
+		// Adds the value multiplied by the demand supply or building count in the
+		// operand to the monthly income.
+		AddDemandSupplyProduct,
+		AddBuildingCountProduct,
+	};
+
+	struct Instruction
+	{
+		Opcode opcode;
+		CityMetric metric;
+		// The index of the function name for the Lua instructions, or the
+		// demand id or building type for the instructions that query the game.
+		uint32_t operand;
+		// The threshold or coefficient for the metric instructions.
+		double value;
+	};
+
+	static_assert(sizeof(Instruction) == 16);
+
+	OrdinanceProgram();
+
+	void AddMetricCondition(CityMetric metric, double minValue);
+	void AddLuaFunctionCondition(const cRZBaseString& functionName);
+	void AddDemandSupplyCondition(uint32_t demandID, double minValue);
+	void AddBuildingCountCondition(BuildingType type, double minValue);
+	void AddMetricIncome(CityMetric metric, double coefficient);
+	void AddLuaFunctionIncome(const cRZBaseString& functionName);
+	void AddDemandSupplyIncome(uint32_t demandID, double coefficient);
+	void AddBuildingCountIncome(BuildingType type, double coefficient);
+
+	bool CheckConditions(const MetricValues& metrics) const;
+	double CalculateMonthlyIncome(double monthlyConstantIncome, const MetricValues& metrics) const;
+
+	// Gets a value indicating whether the monthly income calls a Lua function,
+	// the income of the other programs is a function of the city statistics.
+	bool HasLuaIncomeFunction() const;
+
+	const Instruction* GetConditionInstructions() const;
+	size_t GetConditionCount() const;
+
+	const Instruction* GetIncomeInstructions() const;
+	size_t GetIncomeInstructionCount() const;
+
+private:
+	uint32_t AddLuaFunctionName(const cRZBaseString& functionName);
+	void AddCondition(const Instruction& instruction);
+
+	std::vector<Instruction> instructions;
+	std::vector<cRZBaseString> luaFunctionNames;
+	uint32_t conditionCount;
+	bool hasLuaIncomeFunction;
+};
@@ -0,0 +1,252 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "cGZPersistResourceKey.h"
+#include "cISCPropertyHolder.h"
+#include "cRZBaseString.h"
+#include "CompiledOrdinancePack.h"
+#include "CompiledOrdinancePackFormat.h"
+#include "ExemplarPropertyTable.h"
+#include "HashUtil.h"
+#include "SCPropertyUtil.h"
+#include "StringResourceKey.h"
+#include "frozen/unordered_map.h"
+#include <array>
+#include <cassert>
+#include <string_view>
+#include <type_traits>
+
+// The sources that an ordinance definition reads its properties from.
+// Each source has a GetPropertyValue method for the value types that the
+// definition reads, see OrdinanceDefinition::ReadProperties.
+namespace OrdinancePropertySources
+{
+	// Reads the properties from the exemplar's property holder.
+	class PropertyHolderSource
+	{
+	public:
+		explicit PropertyHolderSource(const cISCPropertyHolder* pPropertyHolder)
+			: pPropertyHolder(pPropertyHolder)
+		{
+		}
+
+		template <typename T>
+		bool GetPropertyValue(uint32_t id, T& value) const
+		{
+			return SCPropertyUtil::GetPropertyValue(pPropertyHolder, id, value);
+		}
+
+	private:
+		const cISCPropertyHolder* pPropertyHolder;
+	};
+
+	// Assigns each property that the definition reads a slot index, the
+	// compiled pack schema lists all of them.
+	constexpr auto MakePropertySlotItems()
+	{
+		std::array<std::pair<uint32_t, uint8_t>, CompiledOrdinancePackFormat::PropertySchema.size()> items{};
+
+		for (size_t i = 0; i < items.size(); i++)
+		{
+			items[i] = std::pair(CompiledOrdinancePackFormat::PropertySchema[i].id, static_cast<uint8_t>(i));
+		}
+
+		return items;
+	}
+
+	static constexpr auto PropertySlots = frozen::make_unordered_map(MakePropertySlotItems());
+
+	// Reads the properties from a property table that was decoded when the
+	// exemplar was discovered.
+	// The table is walked once when the source is created, each property that the
+	// definition uses is dispatched to its slot through a perfect hash map.
+	// The property reads are then a hash map lookup and an array access instead
+	// of a search of the exemplar's properties.
+	class PropertyTableSource
+	{
+	public:
+		explicit PropertyTableSource(const ExemplarPropertyTable& table)
+			: table(table), slots{}
+		{
+			for (const ExemplarPropertyTable::Property& property : table.GetProperties())
+			{
+				const auto it = PropertySlots.find(property.id);
+
+				if (it != PropertySlots.end())
+				{
+					slots[it->second] = &property;
+				}
+			}
+		}
+
+		template <typename T>
+		bool GetPropertyValue(uint32_t id, T& value) const
+		{
+			const ExemplarPropertyTable::Property* pProperty = GetProperty(id);
+
+			return pProperty && table.GetPropertyValue(*pProperty, value);
+		}
+
+		bool GetPropertyValue(uint32_t id, cRZBaseString& value) const
+		{
+			const ExemplarPropertyTable::Property* pProperty = GetProperty(id);
+			std::string_view text;
+
+			if (pProperty && table.GetPropertyValue(*pProperty, text))
+			{
+				value = cRZBaseString(text.data(), static_cast<uint32_t>(text.size()));
+				return true;
+			}
+
+			return false;
+		}
+
+		bool GetPropertyValue(uint32_t id, StringResourceKey& value) const
+		{
+			const ExemplarPropertyTable::Property* pProperty = GetProperty(id);
+			// The string resource key is a TGI, the type is not used.
+			std::array<uint32_t, 3> tgi{};
+
+			if (pProperty && table.GetPropertyValues(*pProperty, tgi))
+			{
+				value.groupID = tgi[1];
+				value.instanceID = tgi[2];
+				return true;
+			}
+
+			return false;
+		}
+
+	private:
+		const ExemplarPropertyTable::Property* GetProperty(uint32_t id) const
+		{
+			const auto it = PropertySlots.find(id);
+			assert(it != PropertySlots.end());
+
+			return it != PropertySlots.end() ? slots[it->second] : nullptr;
+		}
+
+		const ExemplarPropertyTable& table;
+		std::array<const ExemplarPropertyTable::Property*, PropertySlots.size()> slots;
+	};
+
+	// Reads the properties from a compiled ordinance pack record.
+	class CompiledPackSource
+	{
+	public:
+		CompiledPackSource(const CompiledOrdinancePack& pack, uint32_t index)
+			: pack(pack), index(index)
+		{
+		}
+
+		template <typename T>
+		bool GetPropertyValue(uint32_t id, T& value) const
+		{
+			return pack.GetPropertyValue(index, id, value);
+		}
+
+		bool GetPropertyValue(uint32_t id, cRZBaseString& value) const
+		{
+			std::string_view text;
+
+			if (pack.GetPropertyValue(index, id, text))
+			{
+				value = cRZBaseString(text.data(), static_cast<uint32_t>(text.size()));
+				return true;
+			}
+
+			return false;
+		}
+
+		bool GetPropertyValue(uint32_t id, StringResourceKey& value) const
+		{
+			return pack.GetStringResourceKey(index, id, value.groupID, value.instanceID);
+		}
+
+	private:
+		const CompiledOrdinancePack& pack;
+		uint32_t index;
+	};
+
+	// Computes the content hash of the property values that are read from
+	// another property source.
+	// The sources produce the same values for the same exemplar, so the hash does not
+	// depend on which of them the definition was created from.
+	template <typename TPropertySource>
+	class ContentHashingSource
+	{
+	public:
+		ContentHashingSource(const TPropertySource& source, const cGZPersistResourceKey& key)
+			: source(source), hash(HashUtil::Fnv1a64OffsetBasis)
+		{
+			AddValue(key.type);
+			AddValue(key.group);
+			AddValue(key.instance);
+		}
+
+		template <typename T>
+		bool GetPropertyValue(uint32_t id, T& value) const
+		{
+			const bool result = source.GetPropertyValue(id, value);
+
+			AddValue(id);
+			AddValue(result);
+
+			if (result)
+			{
+				AddValue(value);
+			}
+
+			return result;
+		}
+
+		uint64_t GetHash() const
+		{
+			// Zero is reserved for the definitions that do not have a content hash.
+			return hash != 0 ? hash : 1;
+		}
+
+	private:
+		template <typename T>
+		void AddValue(const T& value) const
+		{
+			static_assert(std::is_arithmetic_v<T>);
+
+			hash = HashUtil::Fnv1a64(&value, sizeof(value), hash);
+		}
+
+		void AddValue(const cRZBaseString& value) const
+		{
+			AddValue(value.Strlen());
+			hash = HashUtil::Fnv1a64(value.ToChar(), value.Strlen(), hash);
+		}
+
+		void AddValue(const StringResourceKey& value) const
+		{
+			AddValue(value.groupID);
+			AddValue(value.instanceID);
+		}
+
+		const TPropertySource& source;
+		mutable uint64_t hash;
+	};
+}
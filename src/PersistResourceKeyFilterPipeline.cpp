@@ -0,0 +1,142 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PersistResourceKeyFilterPipeline.h"
+#include "cGZPersistResourceKey.h"
+#include "HashUtil.h"
+#include "Logger.h"
+#include <algorithm>
+#include <utility>
+
+bool PersistResourceKeyFilterPipeline::Predicate::Rejects(const cGZPersistResourceKey& key) const
+{
+	switch (kind)
+	{
+	case PredicateKind::RequireType:
+		return key.type != first;
+	case PredicateKind::ExcludeGroupRange:
+		return key.group >= first && key.group <= last;
+	case PredicateKind::ExcludeInstances:
+		return (first == AnyGroup || key.group == first)
+			&& std::binary_search(instances.begin(), instances.end(), key.instance);
+	default:
+		return false;
+	}
+}
+
+PersistResourceKeyFilterPipeline::PersistResourceKeyFilterPipeline()
+	: predicates()
+{
+}
+
+void PersistResourceKeyFilterPipeline::RequireType(const char* name, uint32_t type)
+{
+	predicates.push_back(Predicate{ name, PredicateKind::RequireType, type, 0, {}, 0 });
+}
+
+void PersistResourceKeyFilterPipeline::ExcludeGroupRange(const char* name, uint32_t firstGroup, uint32_t lastGroup)
+{
+	predicates.push_back(Predicate{ name, PredicateKind::ExcludeGroupRange, firstGroup, lastGroup, {}, 0 });
+}
+
+void PersistResourceKeyFilterPipeline::ExcludeInstances(
+	const char* name,
+	std::vector<uint32_t>&& instances,
+	uint32_t group)
+{
+	std::sort(instances.begin(), instances.end());
+
+	predicates.push_back(Predicate{ name, PredicateKind::ExcludeInstances, group, 0, std::move(instances), 0 });
+}
+
+uint64_t PersistResourceKeyFilterPipeline::GetConfigurationHash() const
+{
+	uint64_t hash = HashUtil::Fnv1a64OffsetBasis;
+
+	for (const Predicate& predicate : predicates)
+	{
+		const uint32_t values[3] = { static_cast<uint32_t>(predicate.kind), predicate.first, predicate.last };
+
+		hash = HashUtil::Fnv1a64(values, sizeof(values), hash);
+
+		if (!predicate.instances.empty())
+		{
+			hash = HashUtil::Fnv1a64(
+				predicate.instances.data(),
+				predicate.instances.size() * sizeof(uint32_t),
+				hash);
+		}
+	}
+
+	return hash;
+}
+
+void PersistResourceKeyFilterPipeline::WriteRejectionCounts(Logger& logger) const
+{
+	for (const Predicate& predicate : predicates)
+	{
+		if (predicate.rejectedCount > 0)
+		{
+			logger.WriteLineFormatted(
+				LogLevel::Debug,
+				"Resource key filter '%s' rejected %u keys.",
+				predicate.name.c_str(),
+				predicate.rejectedCount);
+		}
+	}
+}
+
+bool PersistResourceKeyFilterPipeline::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZPersistResourceKeyFilter)
+	{
+		*ppvObj = static_cast<cIGZPersistResourceKeyFilter*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return cRZBaseUnknown::QueryInterface(riid, ppvObj);
+}
+
+uint32_t PersistResourceKeyFilterPipeline::AddRef()
+{
+	return cRZBaseUnknown::AddRef();
+}
+
+uint32_t PersistResourceKeyFilterPipeline::Release()
+{
+	return cRZBaseUnknown::Release();
+}
+
+bool PersistResourceKeyFilterPipeline::IsKeyIncluded(cGZPersistResourceKey const& key)
+{
+	for (Predicate& predicate : predicates)
+	{
+		if (predicate.Rejects(key))
+		{
+			predicate.rejectedCount++;
+			return false;
+		}
+	}
+
+	return true;
+}
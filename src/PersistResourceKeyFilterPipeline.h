@@ -0,0 +1,91 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "cRZBaseUnknown.h"
+#include "cIGZPersistResourceKeyFilter.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Logger;
+
+// A resource key filter that is made of a list of predicates.
+// A key is included if every predicate accepts it, the predicates are checked in
+// the order that they were added and the first predicate that rejects a key
+// counts the rejection.
+// The filter is used by GetResourceKeyList, the rejected keys are never enumerated
+// or opened.
+class PersistResourceKeyFilterPipeline : public cRZBaseUnknown, public cIGZPersistResourceKeyFilter
+{
+public:
+	static constexpr uint32_t AnyGroup = 0xFFFFFFFF;
+
+	PersistResourceKeyFilterPipeline();
+
+	// Rejects the keys that do not have the specified type.
+	void RequireType(const char* name, uint32_t type);
+
+	// Rejects the keys with a group id in the range [firstGroup, lastGroup].
+	void ExcludeGroupRange(const char* name, uint32_t firstGroup, uint32_t lastGroup);
+
+	// Rejects the keys with one of the specified instance ids.
+	// If the group is not AnyGroup, only the keys with that group id are rejected.
+	void ExcludeInstances(const char* name, std::vector<uint32_t>&& instances, uint32_t group = AnyGroup);
+
+	// Gets a hash of the predicates, the names and rejection counts are not included.
+	// The discovery index uses the hash to detect a configuration change.
+	uint64_t GetConfigurationHash() const;
+
+	// Writes the number of keys that each predicate rejected to the log.
+	void WriteRejectionCounts(Logger& logger) const;
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+	bool IsKeyIncluded(cGZPersistResourceKey const& key) override;
+
+private:
+	enum class PredicateKind : uint8_t
+	{
+		RequireType,
+		ExcludeGroupRange,
+		ExcludeInstances,
+	};
+
+	struct Predicate
+	{
+		std::string name;
+		PredicateKind kind;
+		// The type for RequireType, the first group for ExcludeGroupRange and the
+		// group or AnyGroup for ExcludeInstances.
+		uint32_t first;
+		// The last group for ExcludeGroupRange.
+		uint32_t last;
+		// The sorted instance ids for ExcludeInstances.
+		std::vector<uint32_t> instances;
+		uint32_t rejectedCount;
+
+		bool Rejects(const cGZPersistResourceKey& key) const;
+	};
+
+	std::vector<Predicate> predicates;
+};
@@ -0,0 +1,187 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PluginFileEnumerator.h"
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace
+{
+	bool EqualsIgnoreCase(const std::string& lhs, const std::string& rhs)
+	{
+		return lhs.size() == rhs.size()
+			&& std::equal(
+				lhs.begin(),
+				lhs.end(),
+				rhs.begin(),
+				[](char a, char b)
+				{
+					return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+				});
+	}
+
+	struct DirectoryWorkItem
+	{
+		size_t rootIndex;
+		std::filesystem::path directory;
+	};
+}
+
+PluginFileEnumerator::PluginFileEnumerator(
+	const IFileSystem& fileSystem,
+	const std::vector<std::string>& fileExtensions,
+	uint32_t threadCount)
+	: fileSystem(fileSystem),
+	  fileExtensions(fileExtensions),
+	  threadCount(threadCount != 0 ? threadCount : std::max(1U, std::thread::hardware_concurrency()))
+{
+}
+
+std::vector<std::string> PluginFileEnumerator::GetDefaultFileExtensions()
+{
+	return { ".dat", ".sc4desc", ".sc4lot", ".sc4model" };
+}
+
+bool PluginFileEnumerator::Enumerate(
+	const std::vector<std::filesystem::path>& roots,
+	std::vector<FileInfo>& files) const
+{
+	files.clear();
+
+	std::mutex mutex;
+	std::condition_variable workAvailable;
+	std::deque<DirectoryWorkItem> pendingDirectories;
+	size_t activeWorkers = 0;
+	bool result = true;
+
+	// The files are collected for each root, and sorted when the enumeration
+	// has finished.
+	std::vector<std::vector<FileInfo>> rootFiles(roots.size());
+
+	for (size_t i = 0; i < roots.size(); i++)
+	{
+		if (fileSystem.DirectoryExists(roots[i]))
+		{
+			pendingDirectories.push_back(DirectoryWorkItem{ i, roots[i] });
+		}
+	}
+
+	auto worker = [&]()
+	{
+		std::vector<std::filesystem::path> subdirectories;
+		std::vector<FileInfo> directoryFiles;
+
+		std::unique_lock<std::mutex> lock(mutex);
+
+		while (true)
+		{
+			workAvailable.wait(lock, [&] { return !pendingDirectories.empty() || activeWorkers == 0; });
+
+			if (pendingDirectories.empty())
+			{
+				break;
+			}
+
+			const DirectoryWorkItem item = std::move(pendingDirectories.front());
+			pendingDirectories.pop_front();
+			activeWorkers++;
+
+			lock.unlock();
+
+			subdirectories.clear();
+			directoryFiles.clear();
+
+			const bool directoryRead = fileSystem.GetDirectoryContents(item.directory, subdirectories, directoryFiles);
+
+			directoryFiles.erase(
+				std::remove_if(
+					directoryFiles.begin(),
+					directoryFiles.end(),
+					[this](const FileInfo& file) { return !HasPluginFileExtension(file.path); }),
+				directoryFiles.end());
+
+			lock.lock();
+
+			if (!directoryRead)
+			{
+				result = false;
+			}
+
+			for (std::filesystem::path& subdirectory : subdirectories)
+			{
+				pendingDirectories.push_back(DirectoryWorkItem{ item.rootIndex, std::move(subdirectory) });
+			}
+
+			std::vector<FileInfo>& output = rootFiles[item.rootIndex];
+			output.insert(
+				output.end(),
+				std::make_move_iterator(directoryFiles.begin()),
+				std::make_move_iterator(directoryFiles.end()));
+
+			activeWorkers--;
+			workAvailable.notify_all();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount - 1);
+
+	for (uint32_t i = 1; i < threadCount; i++)
+	{
+		threads.emplace_back(worker);
+	}
+
+	// The calling thread is also used as a worker.
+	worker();
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	for (std::vector<FileInfo>& items : rootFiles)
+	{
+		std::sort(
+			items.begin(),
+			items.end(),
+			[](const FileInfo& lhs, const FileInfo& rhs) { return lhs.path < rhs.path; });
+
+		files.insert(files.end(), std::make_move_iterator(items.begin()), std::make_move_iterator(items.end()));
+	}
+
+	return result;
+}
+
+bool PluginFileEnumerator::HasPluginFileExtension(const std::filesystem::path& path) const
+{
+	const std::u8string extension = path.extension().u8string();
+	const std::string extensionString(extension.begin(), extension.end());
+
+	return std::any_of(
+		fileExtensions.begin(),
+		fileExtensions.end(),
+		[&](const std::string& item) { return EqualsIgnoreCase(item, extensionString); });
+}
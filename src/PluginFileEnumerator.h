@@ -0,0 +1,64 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "FileSystem.h"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Enumerates the plugin files in one or more root directories.
+// The directories are walked on a pool of worker threads, and the files are filtered
+// by extension before they are opened.
+//
+// The results are ordered by root, in the order that the roots were specified,
+// and then by path. The order does not depend on the number of threads, callers
+// that keep the first of a set of duplicate items give the earlier roots precedence.
+class PluginFileEnumerator
+{
+public:
+	// The file extensions must include the leading period, they are compared without
+	// case sensitivity.
+	// A thread count of zero uses the number of hardware threads.
+	PluginFileEnumerator(
+		const IFileSystem& fileSystem,
+		const std::vector<std::string>& fileExtensions,
+		uint32_t threadCount = 0);
+
+	// Gets the default file extensions, the extensions of the files that
+	// SC4 loads from its plugin folders.
+	static std::vector<std::string> GetDefaultFileExtensions();
+
+	// Enumerates the files in the root directories and their sub-directories.
+	// The roots that do not exist are skipped.
+	// Returns false if one of the directories could not be read.
+	bool Enumerate(
+		const std::vector<std::filesystem::path>& roots,
+		std::vector<FileInfo>& files) const;
+
+private:
+	bool HasPluginFileExtension(const std::filesystem::path& path) const;
+
+	const IFileSystem& fileSystem;
+	std::vector<std::string> fileExtensions;
+	uint32_t threadCount;
+};
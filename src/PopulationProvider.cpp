@@ -23,9 +23,30 @@
 #include "cISC4Demand.h"
 #include "cISC4DemandSimulator.h"
 #include "cISC4ResidentialSimulator.h"
+#include "CityStatsSnapshot.h"
 #include "GlobalPointers.h"
 
 int32_t PopulationProvider::GetRCIGroupPopulation(uint32_t demandID)
+{
+	CityStatsSnapshot& snapshot = CityStatsSnapshot::GetInstance();
+	int32_t population = 0;
+
+	if (!snapshot.Update() || !snapshot.TryGetRCIGroupPopulation(demandID, population))
+	{
+		population = QueryRCIGroupPopulation(demandID);
+	}
+
+	return population;
+}
+
+int32_t PopulationProvider::GetTotalResidentialPopulation()
+{
+	CityStatsSnapshot& snapshot = CityStatsSnapshot::GetInstance();
+
+	return snapshot.Update() ? snapshot.GetTotalResidentialPopulation() : QueryTotalResidentialPopulation();
+}
+
+int32_t PopulationProvider::QueryRCIGroupPopulation(uint32_t demandID)
 {
 	int32_t population = 0;
 
@@ -44,7 +65,7 @@ int32_t PopulationProvider::GetRCIGroupPopulation(uint32_t demandID)
 	return population;
 }
 
-int32_t PopulationProvider::GetTotalResidentialPopulation()
+int32_t PopulationProvider::QueryTotalResidentialPopulation()
 {
 	return spResidentialSim ? spResidentialSim->GetPopulation() : 0;
 }
@@ -24,6 +24,13 @@
 
 namespace PopulationProvider
 {
+	// These values are served from the CityStatsSnapshot.
+
 	int32_t GetRCIGroupPopulation(uint32_t demandID);
 	int32_t GetTotalResidentialPopulation();
+
+	// These values are read from the game's simulators.
+
+	int32_t QueryRCIGroupPopulation(uint32_t demandID);
+	int32_t QueryTotalResidentialPopulation();
 }
\ No newline at end of file
@@ -0,0 +1,273 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "QFSCompression.h"
+#include <cstring>
+
+namespace
+{
+	// The QFS data in a DBPF record is prefixed by the compressed size.
+	constexpr size_t RecordHeaderSize = 4;
+	constexpr size_t QFSHeaderSize = 5;
+
+	constexpr uint8_t QFSSignature = 0xFB;
+
+	struct QFSHeaderInfo
+	{
+		size_t headerSize;
+		uint32_t uncompressedSize;
+	};
+
+	bool ReadQFSHeader(std::span<const uint8_t> recordData, QFSHeaderInfo& info)
+	{
+		if (recordData.size() < RecordHeaderSize + QFSHeaderSize)
+		{
+			return false;
+		}
+
+		const uint8_t* header = recordData.data() + RecordHeaderSize;
+
+		// The low bits of the first byte are flags.
+		// 0x80 indicates that the sizes are 4 bytes instead of 3 bytes, and
+		// 0x01 indicates that the uncompressed size is preceded by the compressed size.
+		const uint8_t flags = header[0];
+
+		if ((flags & 0x3E) != 0x10 || header[1] != QFSSignature)
+		{
+			return false;
+		}
+
+		const size_t sizeFieldLength = (flags & 0x80) != 0 ? 4 : 3;
+		size_t offset = RecordHeaderSize + 2;
+
+		if ((flags & 0x01) != 0)
+		{
+			offset += sizeFieldLength;
+		}
+
+		if (recordData.size() < offset + sizeFieldLength)
+		{
+			return false;
+		}
+
+		// The sizes are stored in big-endian byte order.
+		uint32_t uncompressedSize = 0;
+
+		for (size_t i = 0; i < sizeFieldLength; i++)
+		{
+			uncompressedSize = (uncompressedSize << 8) | recordData[offset + i];
+		}
+
+		info.headerSize = offset + sizeFieldLength;
+		info.uncompressedSize = uncompressedSize;
+		return true;
+	}
+
+	void CopyBackReference(uint8_t* dest, size_t offset, size_t length)
+	{
+		const uint8_t* src = dest - offset;
+
+		if (offset >= length)
+		{
+			// The source and destination do not overlap.
+			std::memcpy(dest, src, length);
+		}
+		else if (offset >= sizeof(uint64_t))
+		{
+			// The source is always at least 8 bytes behind the destination,
+			// so each 8 byte block only reads data that has already been written.
+			while (length >= sizeof(uint64_t))
+			{
+				uint64_t block;
+				std::memcpy(&block, src, sizeof(block));
+				std::memcpy(dest, &block, sizeof(block));
+
+				src += sizeof(uint64_t);
+				dest += sizeof(uint64_t);
+				length -= sizeof(uint64_t);
+			}
+
+			while (length > 0)
+			{
+				*dest++ = *src++;
+				length--;
+			}
+		}
+		else if (offset == 1)
+		{
+			// A run of a single byte.
+			std::memset(dest, *src, length);
+		}
+		else
+		{
+			// Short repeating patterns must be copied one byte at a time.
+			for (size_t i = 0; i < length; i++)
+			{
+				dest[i] = src[i];
+			}
+		}
+	}
+}
+
+bool QFSCompression::IsCompressed(std::span<const uint8_t> recordData)
+{
+	QFSHeaderInfo info{};
+
+	return ReadQFSHeader(recordData, info);
+}
+
+bool QFSCompression::GetUncompressedSize(std::span<const uint8_t> recordData, uint32_t& uncompressedSize)
+{
+	QFSHeaderInfo info{};
+
+	if (!ReadQFSHeader(recordData, info))
+	{
+		return false;
+	}
+
+	uncompressedSize = info.uncompressedSize;
+	return true;
+}
+
+bool QFSCompression::Decompress(std::span<const uint8_t> recordData, std::vector<uint8_t>& output)
+{
+	QFSHeaderInfo info{};
+
+	if (!ReadQFSHeader(recordData, info))
+	{
+		return false;
+	}
+
+	output.resize(info.uncompressedSize);
+
+	const uint8_t* input = recordData.data();
+	const size_t inputLength = recordData.size();
+	size_t inputOffset = info.headerSize;
+
+	uint8_t* const outputStart = output.data();
+	const size_t outputLength = output.size();
+	size_t outputOffset = 0;
+
+	while (inputOffset < inputLength)
+	{
+		const uint8_t controlByte = input[inputOffset];
+
+		size_t literalLength = 0;
+		size_t copyLength = 0;
+		size_t copyOffset = 0;
+		size_t controlLength = 0;
+		bool endOfData = false;
+
+		if (controlByte < 0x80)
+		{
+			controlLength = 2;
+
+			if ((inputLength - inputOffset) < controlLength)
+			{
+				return false;
+			}
+
+			const uint8_t byte1 = input[inputOffset + 1];
+
+			literalLength = controlByte & 0x03;
+			copyLength = static_cast<size_t>((controlByte & 0x1C) >> 2) + 3;
+			copyOffset = (static_cast<size_t>(controlByte & 0x60) << 3) + byte1 + 1;
+		}
+		else if (controlByte < 0xC0)
+		{
+			controlLength = 3;
+
+			if ((inputLength - inputOffset) < controlLength)
+			{
+				return false;
+			}
+
+			const uint8_t byte1 = input[inputOffset + 1];
+			const uint8_t byte2 = input[inputOffset + 2];
+
+			literalLength = (byte1 >> 6) & 0x03;
+			copyLength = static_cast<size_t>(controlByte & 0x3F) + 4;
+			copyOffset = (static_cast<size_t>(byte1 & 0x3F) << 8) + byte2 + 1;
+		}
+		else if (controlByte < 0xE0)
+		{
+			controlLength = 4;
+
+			if ((inputLength - inputOffset) < controlLength)
+			{
+				return false;
+			}
+
+			const uint8_t byte1 = input[inputOffset + 1];
+			const uint8_t byte2 = input[inputOffset + 2];
+			const uint8_t byte3 = input[inputOffset + 3];
+
+			literalLength = controlByte & 0x03;
+			copyLength = (static_cast<size_t>(controlByte & 0x0C) << 6) + byte3 + 5;
+			copyOffset = (static_cast<size_t>(controlByte & 0x10) << 12)
+				+ (static_cast<size_t>(byte1) << 8)
+				+ byte2
+				+ 1;
+		}
+		else if (controlByte < 0xFC)
+		{
+			controlLength = 1;
+			literalLength = (static_cast<size_t>(controlByte & 0x1F) << 2) + 4;
+		}
+		else
+		{
+			controlLength = 1;
+			literalLength = controlByte & 0x03;
+			endOfData = true;
+		}
+
+		inputOffset += controlLength;
+
+		if (literalLength > 0)
+		{
+			if ((inputLength - inputOffset) < literalLength
+				|| (outputLength - outputOffset) < literalLength)
+			{
+				return false;
+			}
+
+			std::memcpy(outputStart + outputOffset, input + inputOffset, literalLength);
+
+			inputOffset += literalLength;
+			outputOffset += literalLength;
+		}
+
+		if (endOfData)
+		{
+			break;
+		}
+
+		if (copyOffset > outputOffset || (outputLength - outputOffset) < copyLength)
+		{
+			return false;
+		}
+
+		CopyBackReference(outputStart + outputOffset, copyOffset, copyLength);
+		outputOffset += copyLength;
+	}
+
+	return outputOffset == outputLength;
+}
@@ -0,0 +1,40 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Decompression of the QFS/RefPack format that is used for compressed DBPF records.
+namespace QFSCompression
+{
+	// Gets a value indicating whether the DBPF record data starts with a QFS header.
+	bool IsCompressed(std::span<const uint8_t> recordData);
+
+	// Reads the uncompressed size from the QFS header of the DBPF record data.
+	bool GetUncompressedSize(std::span<const uint8_t> recordData, uint32_t& uncompressedSize);
+
+	// Decompresses the DBPF record data.
+	// Returns false if the data is not valid QFS data, the contents of the output
+	// buffer are undefined in that case.
+	bool Decompress(std::span<const uint8_t> recordData, std::vector<uint8_t>& output);
+}
@@ -0,0 +1,131 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SessionResourceCache.h"
+#include "GlobalPointers.h"
+#include "Logger.h"
+#include "StringResourceManager.h"
+
+namespace
+{
+	double ToMilliseconds(std::chrono::steady_clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+}
+
+SessionResourceCache& SessionResourceCache::GetInstance()
+{
+	static SessionResourceCache instance;
+
+	return instance;
+}
+
+SessionResourceCache::SessionResourceCache()
+	: localizedStrings(),
+	  sessionStringStatistics(),
+	  cityLoadStringStatistics()
+{
+}
+
+bool SessionResourceCache::GetLocalizedString(const StringResourceKey& key, cIGZString** ppString)
+{
+	if (!spRM)
+	{
+		// The string resources are not available before PostAppInit, the result is not cached.
+		return StringResourceManager::GetLocalizedString(key, ppString);
+	}
+
+	const uint64_t cacheKey = (static_cast<uint64_t>(key.groupID) << 32) | key.instanceID;
+
+	auto it = localizedStrings.find(cacheKey);
+
+	if (it != localizedStrings.end())
+	{
+		sessionStringStatistics.hits++;
+		cityLoadStringStatistics.hits++;
+	}
+	else
+	{
+		const Clock::time_point start = Clock::now();
+
+		cRZAutoRefCount<cIGZString> localizedString;
+
+		if (!StringResourceManager::GetLocalizedString(key, localizedString.AsPPObj()))
+		{
+			localizedString.Reset();
+		}
+
+		it = localizedStrings.emplace(cacheKey, localizedString).first;
+
+		const Clock::duration elapsed = Clock::now() - start;
+
+		sessionStringStatistics.misses++;
+		sessionStringStatistics.missTime += elapsed;
+		cityLoadStringStatistics.misses++;
+		cityLoadStringStatistics.missTime += elapsed;
+	}
+
+	if (!it->second)
+	{
+		return false;
+	}
+
+	*ppString = it->second;
+	(*ppString)->AddRef();
+
+	return true;
+}
+
+void SessionResourceCache::WriteCityLoadStatistics(Logger& logger) const
+{
+	WriteStatistics(logger, "Localized string", sessionStringStatistics, cityLoadStringStatistics);
+}
+
+void SessionResourceCache::ResetCityLoadStatistics()
+{
+	cityLoadStringStatistics = Statistics();
+}
+
+void SessionResourceCache::Clear()
+{
+	localizedStrings.clear();
+}
+
+void SessionResourceCache::WriteStatistics(
+	Logger& logger,
+	const char* name,
+	const Statistics& session,
+	const Statistics& cityLoad) const
+{
+	const Clock::duration averageMissTime = session.misses > 0 ? session.missTime / session.misses : Clock::duration::zero();
+
+	logger.WriteLineFormatted(
+		LogLevel::Debug,
+		"%s cache: %u hits, %u misses, %.3f ms saved this city load (session: %u hits, %u misses, %.3f ms saved).",
+		name,
+		cityLoad.hits,
+		cityLoad.misses,
+		ToMilliseconds(averageMissTime * cityLoad.hits),
+		session.hits,
+		session.misses,
+		ToMilliseconds(averageMissTime * session.hits));
+}
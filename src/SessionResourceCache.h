@@ -0,0 +1,81 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "cIGZString.h"
+#include "cRZAutoRefCount.h"
+#include "StringResourceKey.h"
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+
+class Logger;
+
+// Caches the localized strings that the ordinances load.
+// The ordinance definitions and their localized names are kept by the registry
+// for the whole game session, the cache only prevents a string from being loaded
+// more than once during a city load. It is cleared when the city is shut down.
+// The cache is only used on the game thread.
+class SessionResourceCache
+{
+public:
+	static SessionResourceCache& GetInstance();
+
+	// Gets a localized string.
+	// The strings that are not found are also cached.
+	bool GetLocalizedString(const StringResourceKey& key, cIGZString** ppString);
+
+	// Writes the hits, misses and the estimated time saved since the last reset.
+	void WriteCityLoadStatistics(Logger& logger) const;
+	void ResetCityLoadStatistics();
+
+	// Releases the cached strings, this must be called before the resource
+	// manager is released.
+	void Clear();
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	SessionResourceCache();
+
+	struct Statistics
+	{
+		uint32_t hits;
+		uint32_t misses;
+		// The total time of the misses, the session average is used to estimate
+		// the time that the hits saved.
+		Clock::duration missTime;
+	};
+
+	void WriteStatistics(
+		Logger& logger,
+		const char* name,
+		const Statistics& session,
+		const Statistics& cityLoad) const;
+
+	// The key is the string resource group id in the upper 32 bits and the
+	// instance id in the lower 32 bits.
+	// The value is null if the string was not found.
+	std::unordered_map<uint64_t, cRZAutoRefCount<cIGZString>> localizedStrings;
+
+	Statistics sessionStringStatistics;
+	Statistics cityLoadStringStatistics;
+};
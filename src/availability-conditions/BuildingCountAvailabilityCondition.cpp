@@ -20,8 +20,8 @@
  */
 
 #include "BuildingCountAvailabilityCondition.h"
-#include "BuildingCountProvider.h"
 #include "GZStreamUtil.h"
+#include "OrdinanceProgram.h"
 
 BuildingCountAvailabilityCondition::BuildingCountAvailabilityCondition()
 	: type(BuildingType::FireStation), minBuildingCount(0)
@@ -34,9 +34,20 @@ BuildingCountAvailabilityCondition::BuildingCountAvailabilityCondition(
 {
 }
 
-bool BuildingCountAvailabilityCondition::CheckCondition() const
+void BuildingCountAvailabilityCondition::Compile(OrdinanceProgram& program) const
 {
-	return BuildingCountProvider::GetBuildingCount(type) >= minBuildingCount;
+	CityMetric metric{};
+
+	// The save game can use a building type that this version does not know,
+	// the game is queried for its value when the condition is checked.
+	if (CityMetricUtil::TryGetBuildingCountMetric(type, metric))
+	{
+		program.AddMetricCondition(metric, static_cast<double>(minBuildingCount));
+	}
+	else
+	{
+		program.AddBuildingCountCondition(type, static_cast<double>(minBuildingCount));
+	}
 }
 
 IAvailabilityCondition::Type BuildingCountAvailabilityCondition::GetType() const
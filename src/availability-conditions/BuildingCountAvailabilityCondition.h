@@ -29,7 +29,7 @@ public:
 	BuildingCountAvailabilityCondition();
 	BuildingCountAvailabilityCondition(BuildingType type, uint32_t minBuildingCount);
 
-	bool CheckCondition() const;
+	void Compile(OrdinanceProgram& program) const;
 	Type GetType() const;
 
 	bool Read(cIGZIStream& stream);
@@ -20,9 +20,7 @@
  */
 
 #include "GameYearAvailabilityCondition.h"
-#include "cIGZDate.h"
-#include "cISC4Simulator.h"
-#include "GlobalPointers.h"
+#include "OrdinanceProgram.h"
 
 GameYearAvailabilityCondition::GameYearAvailabilityCondition()
 	: yearFirstAvailable(0)
@@ -34,20 +32,9 @@ GameYearAvailabilityCondition::GameYearAvailabilityCondition(uint32_t yearFirstA
 {
 }
 
-bool GameYearAvailabilityCondition::CheckCondition() const
+void GameYearAvailabilityCondition::Compile(OrdinanceProgram& program) const
 {
-	bool result = false;
-
-	if (spSimulator)
-	{
-		uint32_t currentYear = 0;
-
-		spSimulator->GetSimDate(&currentYear, nullptr, nullptr, nullptr, nullptr);
-
-		result = currentYear >= yearFirstAvailable;
-	}
-
-	return result;
+	program.AddMetricCondition(CityMetric::SimYear, static_cast<double>(yearFirstAvailable));
 }
 
 IAvailabilityCondition::Type GameYearAvailabilityCondition::GetType() const
@@ -28,7 +28,7 @@ public:
 	GameYearAvailabilityCondition();
 	GameYearAvailabilityCondition(uint32_t yearFirstAvailable);
 
-	bool CheckCondition() const;
+	void Compile(OrdinanceProgram& program) const;
 	Type GetType() const;
 
 	bool Read(cIGZIStream& stream);
@@ -23,6 +23,8 @@
 #include "cIGZIStream.h"
 #include "cIGZOStream.h"
 
+class OrdinanceProgram;
+
 class IAvailabilityCondition
 {
 public:
@@ -37,7 +39,8 @@ public:
 		LuaFunction = 3,
 	};
 
-	virtual bool CheckCondition() const = 0;
+	// Adds the condition to the ordinance's evaluation program.
+	virtual void Compile(OrdinanceProgram& program) const = 0;
 	virtual Type GetType() const = 0;
 
 	virtual bool Read(cIGZIStream& stream) = 0;
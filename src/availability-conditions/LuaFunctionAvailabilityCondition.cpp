@@ -23,6 +23,19 @@
 #include "cISCLua.h"
 #include "GlobalPointers.h"
 #include "Logger.h"
+#include "OrdinanceProgram.h"
+
+namespace
+{
+	void LogLuaFunctionCallError(const cRZBaseString& functionName, const char* message)
+	{
+		Logger::GetInstance().WriteLineFormatted(
+			LogLevel::Error,
+			"Error calling Lua function '%s': %s",
+			functionName.ToChar(),
+			message);
+	}
+}
 
 LuaFunctionAvailabilityCondition::LuaFunctionAvailabilityCondition()
 	: functionName()
@@ -34,7 +47,12 @@ LuaFunctionAvailabilityCondition::LuaFunctionAvailabilityCondition(const cRZBase
 {
 }
 
-bool LuaFunctionAvailabilityCondition::CheckCondition() const
+void LuaFunctionAvailabilityCondition::Compile(OrdinanceProgram& program) const
+{
+	program.AddLuaFunctionCondition(functionName);
+}
+
+bool LuaFunctionAvailabilityCondition::CallFunction(const cRZBaseString& functionName)
 {
 	bool result = false;
 
@@ -66,24 +84,24 @@ bool LuaFunctionAvailabilityCondition::CheckCondition() const
 					}
 					else
 					{
-						LogLuaFunctionCallError("The function return value must be a Boolean (true or false).");
+						LogLuaFunctionCallError(functionName, "The function return value must be a Boolean (true or false).");
 					}
 				}
 				else
 				{
-					LogLuaFunctionCallError("The game returned an error when calling the function.");
+					LogLuaFunctionCallError(functionName, "The game returned an error when calling the function.");
 				}
 			}
 			else
 			{
-				LogLuaFunctionCallError("The function has the wrong type.");
+				LogLuaFunctionCallError(functionName, "The function has the wrong type.");
 			}
 
 			spLua->SetTop(top);
 		}
 		else
 		{
-			LogLuaFunctionCallError("The function was not found.");
+			LogLuaFunctionCallError(functionName, "The function was not found.");
 		}
 	}
 
@@ -126,12 +144,3 @@ bool LuaFunctionAvailabilityCondition::Write(cIGZOStream& stream) const
 
 	return true;
 }
-
-void LuaFunctionAvailabilityCondition::LogLuaFunctionCallError(const char* message) const
-{
-	Logger::GetInstance().WriteLineFormatted(
-		LogLevel::Error,
-		"Error calling Lua function '%s': %s",
-		functionName.ToChar(),
-		message);
-}
@@ -29,15 +29,17 @@ public:
 	LuaFunctionAvailabilityCondition();
 	LuaFunctionAvailabilityCondition(const cRZBaseString& name);
 
-	bool CheckCondition() const;
+	void Compile(OrdinanceProgram& program) const;
+
+	// Calls a Lua function that returns a Boolean, the result is false if the
+	// function cannot be called.
+	static bool CallFunction(const cRZBaseString& functionName);
 	Type GetType() const;
 
 	bool Read(cIGZIStream& stream);
 	bool Write(cIGZOStream& stream) const;
 
 private:
-	void LogLuaFunctionCallError(const char* message) const;
-
 	cRZBaseString functionName;
 };
 
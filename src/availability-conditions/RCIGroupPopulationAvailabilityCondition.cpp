@@ -20,7 +20,7 @@
  */
 
 #include "RCIGroupPopulationAvailabilityCondition.h"
-#include "PopulationProvider.h"
+#include "OrdinanceProgram.h"
 
 RCIGroupPopulationAvailabilityCondition::RCIGroupPopulationAvailabilityCondition()
 	: demandID(0), minPopulation(0)
@@ -34,9 +34,20 @@ RCIGroupPopulationAvailabilityCondition::RCIGroupPopulationAvailabilityCondition
 {
 }
 
-bool RCIGroupPopulationAvailabilityCondition::CheckCondition() const
+void RCIGroupPopulationAvailabilityCondition::Compile(OrdinanceProgram& program) const
 {
-	return PopulationProvider::GetRCIGroupPopulation(demandID) >= minPopulation;
+	CityMetric metric{};
+
+	// The save game can use a demand id that is not an RCI group, the game
+	// is queried for its value when the condition is checked.
+	if (CityMetricUtil::TryGetRCIGroupMetric(demandID, metric))
+	{
+		program.AddMetricCondition(metric, static_cast<double>(minPopulation));
+	}
+	else
+	{
+		program.AddDemandSupplyCondition(demandID, static_cast<double>(minPopulation));
+	}
 }
 
 IAvailabilityCondition::Type RCIGroupPopulationAvailabilityCondition::GetType() const
@@ -29,7 +29,7 @@ public:
 	RCIGroupPopulationAvailabilityCondition();
 	RCIGroupPopulationAvailabilityCondition(RCIGroup group, int32_t minPopulation);
 
-	bool CheckCondition() const;
+	void Compile(OrdinanceProgram& program) const;
 	Type GetType() const;
 
 	bool Read(cIGZIStream& stream);
@@ -20,8 +20,8 @@
  */
 
 #include "BuildingCountIncomeFactor.h"
-#include "BuildingCountProvider.h"
 #include "GZStreamUtil.h"
+#include "OrdinanceProgram.h"
 
 BuildingCountIncomeFactor::BuildingCountIncomeFactor()
 	: type(BuildingType::FireStation), monthlyIncomeFactor(1.0)
@@ -38,12 +38,20 @@ IMonthlyIncomeFactor::Type BuildingCountIncomeFactor::GetType() const
 	return IMonthlyIncomeFactor::Type::BuildingCount;
 }
 
-double BuildingCountIncomeFactor::Calculate(double monthlyIncome) const
+void BuildingCountIncomeFactor::Compile(OrdinanceProgram& program) const
 {
-	const uint32_t buildingCount = BuildingCountProvider::GetBuildingCount(type);
-	const double perBuildingIncome = static_cast<double>(buildingCount) * monthlyIncomeFactor;
+	CityMetric metric{};
 
-	return monthlyIncome + perBuildingIncome;
+	// The save game can use a building type that this version does not know,
+	// the game is queried for its value when the income is calculated.
+	if (CityMetricUtil::TryGetBuildingCountMetric(type, metric))
+	{
+		program.AddMetricIncome(metric, monthlyIncomeFactor);
+	}
+	else
+	{
+		program.AddBuildingCountIncome(type, monthlyIncomeFactor);
+	}
 }
 
 bool BuildingCountIncomeFactor::Read(cIGZIStream& stream)
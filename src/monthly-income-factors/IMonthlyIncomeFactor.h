@@ -23,6 +23,8 @@
 #include "cIGZIStream.h"
 #include "cIGZOStream.h"
 
+class OrdinanceProgram;
+
 class IMonthlyIncomeFactor
 {
 public:
@@ -37,7 +39,8 @@ public:
 		LuaFunction = 3,
 	};
 
-	virtual double Calculate(double monthlyIncome) const = 0;
+	// Adds the factor to the ordinance's evaluation program.
+	virtual void Compile(OrdinanceProgram& program) const = 0;
 	virtual Type GetType() const = 0;
 
 	virtual bool Read(cIGZIStream& gzIn) = 0;
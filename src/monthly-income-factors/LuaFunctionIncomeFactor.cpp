@@ -23,6 +23,19 @@
 #include "cISCLua.h"
 #include "GlobalPointers.h"
 #include "Logger.h"
+#include "OrdinanceProgram.h"
+
+namespace
+{
+	void LogLuaFunctionCallError(const cRZBaseString& functionName, const char* message)
+	{
+		Logger::GetInstance().WriteLineFormatted(
+			LogLevel::Error,
+			"Error calling Lua function '%s': %s",
+			functionName.ToChar(),
+			message);
+	}
+}
 
 LuaFunctionIncomeFactor::LuaFunctionIncomeFactor()
 	: functionName()
@@ -39,7 +52,12 @@ IMonthlyIncomeFactor::Type LuaFunctionIncomeFactor::GetType() const
 	return IMonthlyIncomeFactor::Type::LuaFunction;
 }
 
-double LuaFunctionIncomeFactor::Calculate(double monthlyIncome) const
+void LuaFunctionIncomeFactor::Compile(OrdinanceProgram& program) const
+{
+	program.AddLuaFunctionIncome(functionName);
+}
+
+double LuaFunctionIncomeFactor::CallFunction(const cRZBaseString& functionName, double monthlyIncome)
 {
 	double result = monthlyIncome;
 
@@ -73,24 +91,24 @@ double LuaFunctionIncomeFactor::Calculate(double monthlyIncome) const
 					}
 					else
 					{
-						LogLuaFunctionCallError("The function return value must be a number.");
+						LogLuaFunctionCallError(functionName, "The function return value must be a number.");
 					}
 				}
 				else
 				{
-					LogLuaFunctionCallError("The game returned an error when calling the function.");
+					LogLuaFunctionCallError(functionName, "The game returned an error when calling the function.");
 				}
 			}
 			else
 			{
-				LogLuaFunctionCallError("The function has the wrong type.");
+				LogLuaFunctionCallError(functionName, "The function has the wrong type.");
 			}
 
 			spLua->SetTop(top);
 		}
 		else
 		{
-			LogLuaFunctionCallError("The function was not found.");
+			LogLuaFunctionCallError(functionName, "The function was not found.");
 		}
 	}
 
@@ -128,12 +146,3 @@ bool LuaFunctionIncomeFactor::Write(cIGZOStream& stream) const
 
 	return true;
 }
-
-void LuaFunctionIncomeFactor::LogLuaFunctionCallError(const char* message) const
-{
-	Logger::GetInstance().WriteLineFormatted(
-		LogLevel::Error,
-		"Error calling Lua function '%s': %s",
-		functionName.ToChar(),
-		message);
-}
@@ -30,13 +30,15 @@ public:
 	LuaFunctionIncomeFactor(const cRZBaseString& name);
 
 	IMonthlyIncomeFactor::Type GetType() const override;
-	double Calculate(double monthlyIncome) const override;
+	void Compile(OrdinanceProgram& program) const override;
+
+	// Calls a Lua function that takes and returns the monthly income, the
+	// income is unchanged if the function cannot be called.
+	static double CallFunction(const cRZBaseString& functionName, double monthlyIncome);
 
 	bool Read(cIGZIStream& stream) override;
 	bool Write(cIGZOStream& stream) const override;
 private:
-	void LogLuaFunctionCallError(const char* message) const;
-
 	cRZBaseString functionName;
 };
 
@@ -20,7 +20,7 @@
  */
 
 #include "RCIGroupPopulationIncomeFactor.h"
-#include "PopulationProvider.h"
+#include "OrdinanceProgram.h"
 
 RCIGroupPopulationIncomeFactor::RCIGroupPopulationIncomeFactor()
 	: demandID(0), monthlyIncomeFactor(0.0)
@@ -39,12 +39,20 @@ IMonthlyIncomeFactor::Type RCIGroupPopulationIncomeFactor::GetType() const
 	return IMonthlyIncomeFactor::Type::RCIGroupPopulation;
 }
 
-double RCIGroupPopulationIncomeFactor::Calculate(double monthlyIncome) const
+void RCIGroupPopulationIncomeFactor::Compile(OrdinanceProgram& program) const
 {
-	const int32_t population = PopulationProvider::GetRCIGroupPopulation(demandID);
-	const double populationIncome = monthlyIncomeFactor * static_cast<double>(population);
+	CityMetric metric{};
 
-	return monthlyIncome + populationIncome;
+	// The save game can use a demand id that is not an RCI group, the game
+	// is queried for its value when the income is calculated.
+	if (CityMetricUtil::TryGetRCIGroupMetric(demandID, metric))
+	{
+		program.AddMetricIncome(metric, monthlyIncomeFactor);
+	}
+	else
+	{
+		program.AddDemandSupplyIncome(demandID, monthlyIncomeFactor);
+	}
 }
 
 bool RCIGroupPopulationIncomeFactor::Read(cIGZIStream& stream)
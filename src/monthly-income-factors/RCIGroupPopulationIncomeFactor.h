@@ -30,7 +30,7 @@ public:
 	RCIGroupPopulationIncomeFactor(RCIGroup group, float factor);
 
 	IMonthlyIncomeFactor::Type GetType() const override;
-	double Calculate(double monthlyIncome) const override;
+	void Compile(OrdinanceProgram& program) const override;
 
 	bool Read(cIGZIStream& stream) override;
 	bool Write(cIGZOStream& stream) const override;
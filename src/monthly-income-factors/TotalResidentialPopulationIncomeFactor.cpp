@@ -20,7 +20,7 @@
  */
 
 #include "TotalResidentialPopulationIncomeFactor.h"
-#include "PopulationProvider.h"
+#include "OrdinanceProgram.h"
 
 TotalResidentialPopulationIncomeFactor::TotalResidentialPopulationIncomeFactor()
 	: monthlyIncomeFactor(0)
@@ -37,12 +37,9 @@ IMonthlyIncomeFactor::Type TotalResidentialPopulationIncomeFactor::GetType() con
 	return IMonthlyIncomeFactor::Type::TotalResidentialPop;
 }
 
-double TotalResidentialPopulationIncomeFactor::Calculate(double monthlyIncome) const
+void TotalResidentialPopulationIncomeFactor::Compile(OrdinanceProgram& program) const
 {
-	const int32_t cityPopulation = PopulationProvider::GetTotalResidentialPopulation();
-	const double populationIncome = monthlyIncomeFactor * static_cast<double>(cityPopulation);
-
-	return monthlyIncome + populationIncome;
+	program.AddMetricIncome(CityMetric::TotalResidentialPopulation, monthlyIncomeFactor);
 }
 
 bool TotalResidentialPopulationIncomeFactor::Read(cIGZIStream& stream)
@@ -0,0 +1,108 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AvailabilityConditionEngine.h"
+#include "Benchmark.h"
+#include "CityStatsSnapshot.h"
+#include "CityStatsTestData.h"
+#include "CpuFeatureUtil.h"
+#include "OrdinanceDefinitionTestData.h"
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace CityStatsTestData;
+using namespace OrdinanceDefinitionTestData;
+
+// Compares checking the conditions of every ordinance with its program against
+// the engine's threshold kernels. The snapshot is refilled before each pass, so
+// that the engine checks all of the conditions again.
+BENCHMARK(AvailabilityConditionEngine_CheckOrdinances)
+{
+	std::mt19937 random(1);
+
+	TestCityStatsSource source;
+	source.Randomize(random);
+	ScopedCityStatsSource scopedSource(&source);
+
+	CityStatsSnapshot& snapshot = CityStatsSnapshot::GetInstance();
+
+	constexpr size_t OrdinanceCount = 2000;
+
+	std::vector<std::shared_ptr<const OrdinanceDefinition>> definitions;
+	definitions.reserve(OrdinanceCount);
+
+	for (size_t i = 0; i < OrdinanceCount; i++)
+	{
+		definitions.push_back(CreateRandomDefinition(random, static_cast<uint32_t>(0x1000 + i)));
+	}
+
+	Benchmark::Measure("program, 2000 ordinances", [&]()
+	{
+		snapshot.Invalidate();
+		snapshot.Update();
+
+		const OrdinanceProgram::MetricValues& metrics = snapshot.GetMetricValues();
+		uint64_t availableCount = 0;
+
+		for (const auto& definition : definitions)
+		{
+			if (definition->GetProgram().CheckConditions(metrics))
+			{
+				availableCount++;
+			}
+		}
+
+		Benchmark::Consume(availableCount);
+	});
+
+	const auto measureEngine = [&](const char* label, bool useAvx)
+	{
+		AvailabilityConditionEngine engine(useAvx);
+		engine.Compile(definitions);
+
+		Benchmark::Measure(label, [&]()
+		{
+			snapshot.Invalidate();
+
+			uint64_t availableCount = 0;
+
+			for (size_t slot = 0; slot < definitions.size(); slot++)
+			{
+				bool conditionsMet = false;
+
+				if (engine.TryCheckConditions(slot, definitions[slot].get(), conditionsMet) && conditionsMet)
+				{
+					availableCount++;
+				}
+			}
+
+			Benchmark::Consume(availableCount);
+		});
+	};
+
+	measureEngine("engine scalar kernel, 2000 ordinances", false);
+
+	if (CpuFeatureUtil::IsAvxSupported())
+	{
+		measureEngine("engine AVX kernel, 2000 ordinances", true);
+	}
+}
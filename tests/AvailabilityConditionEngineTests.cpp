@@ -0,0 +1,218 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AvailabilityConditionEngine.h"
+#include "BuildingCountAvailabilityCondition.h"
+#include "CityStatsSnapshot.h"
+#include "CityStatsTestData.h"
+#include "CpuFeatureUtil.h"
+#include "GameYearAvailabilityCondition.h"
+#include "OrdinanceDefinitionTestData.h"
+#include "RCIGroupPopulationAvailabilityCondition.h"
+#include "TestFramework.h"
+#include <initializer_list>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace CityStatsTestData;
+using namespace OrdinanceDefinitionTestData;
+
+namespace
+{
+	using DefinitionList = std::vector<std::shared_ptr<const OrdinanceDefinition>>;
+
+	// An engine for each kernel that this CPU supports, the scalar kernel is first.
+	std::vector<std::unique_ptr<AvailabilityConditionEngine>> CreateEngines(const DefinitionList& definitions)
+	{
+		std::vector<std::unique_ptr<AvailabilityConditionEngine>> engines;
+		engines.push_back(std::make_unique<AvailabilityConditionEngine>(false));
+
+		if (CpuFeatureUtil::IsAvxSupported())
+		{
+			engines.push_back(std::make_unique<AvailabilityConditionEngine>(true));
+		}
+
+		for (auto& engine : engines)
+		{
+			engine->Compile(definitions);
+		}
+
+		return engines;
+	}
+
+	// Fills the snapshot from its source, the engines check the conditions again
+	// when they see the new epoch.
+	const OrdinanceProgram::MetricValues& RefreshSnapshot()
+	{
+		CityStatsSnapshot& snapshot = CityStatsSnapshot::GetInstance();
+		snapshot.Invalidate();
+		snapshot.Update();
+
+		return snapshot.GetMetricValues();
+	}
+
+	std::shared_ptr<const OrdinanceDefinition> CreateDefinition(
+		uint32_t instance,
+		OrdinanceDefinition::AvailabilityConditionList&& conditions)
+	{
+		return OrdinanceDefinition::Create(
+			cGZPersistResourceKey(0x6534284A, 0x4A5E8EF6, instance),
+			std::move(conditions),
+			OrdinanceDefinition::MonthlyIncomeFactorList(),
+			cRZBaseString("Test Ordinance"),
+			StringResourceKey(),
+			cRZBaseString(),
+			StringResourceKey(),
+			0,
+			0,
+			0,
+			false);
+	}
+
+	std::shared_ptr<const OrdinanceDefinition> CreateDefinition(
+		uint32_t instance,
+		RCIGroup group,
+		std::initializer_list<int32_t> minPopulations)
+	{
+		OrdinanceDefinition::AvailabilityConditionList conditions;
+
+		for (int32_t minPopulation : minPopulations)
+		{
+			conditions.push_back(std::make_unique<RCIGroupPopulationAvailabilityCondition>(group, minPopulation));
+		}
+
+		return CreateDefinition(instance, std::move(conditions));
+	}
+}
+
+TEST_CASE(AvailabilityConditionEngine_KernelsMatchTheProgram)
+{
+	std::mt19937 random(1);
+
+	// The rows use more than one word of the bitset, and some of the slots
+	// are empty.
+	constexpr size_t DefinitionCount = 203;
+
+	DefinitionList definitions;
+
+	for (size_t i = 0; i < DefinitionCount; i++)
+	{
+		definitions.push_back((i % 50) == 7 ? nullptr : CreateRandomDefinition(random, static_cast<uint32_t>(0x1000 + i)));
+	}
+
+	const auto engines = CreateEngines(definitions);
+
+	TestCityStatsSource source;
+	ScopedCityStatsSource scopedSource(&source);
+
+	size_t availableCount = 0;
+
+	for (int iteration = 0; iteration < 20; iteration++)
+	{
+		source.Randomize(random);
+		const OrdinanceProgram::MetricValues& metrics = RefreshSnapshot();
+
+		for (size_t slot = 0; slot < definitions.size(); slot++)
+		{
+			const OrdinanceDefinition* pDefinition = definitions[slot].get();
+
+			for (const auto& engine : engines)
+			{
+				bool conditionsMet = false;
+
+				if (!pDefinition)
+				{
+					CHECK(!engine->TryCheckConditions(slot, pDefinition, conditionsMet));
+					continue;
+				}
+
+				REQUIRE(engine->TryCheckConditions(slot, pDefinition, conditionsMet));
+				CHECK(conditionsMet == pDefinition->GetProgram().CheckConditions(metrics));
+
+				if (conditionsMet)
+				{
+					availableCount++;
+				}
+			}
+		}
+	}
+
+	// Both outcomes are tested.
+	CHECK(availableCount > 0);
+	CHECK(availableCount < (DefinitionCount * 20 * engines.size()));
+}
+
+TEST_CASE(AvailabilityConditionEngine_UnusedMetricsAreAlwaysMet)
+{
+	OrdinanceDefinition::AvailabilityConditionList yearConditions;
+	yearConditions.push_back(std::make_unique<GameYearAvailabilityCondition>(2051));
+
+	OrdinanceDefinition::AvailabilityConditionList buildingConditions;
+	buildingConditions.push_back(std::make_unique<BuildingCountAvailabilityCondition>(BuildingType::School, 0));
+
+	OrdinanceDefinition::AvailabilityConditionList gameConditions;
+	// A demand id that is not an RCI group is read from the game, the ordinance
+	// is not compiled.
+	gameConditions.push_back(std::make_unique<RCIGroupPopulationAvailabilityCondition>(static_cast<RCIGroup>(0x5000), 0));
+
+	const DefinitionList definitions
+	{
+		// The thresholds of every metric are negative infinity.
+		CreateDefinition(0x1001, OrdinanceDefinition::AvailabilityConditionList()),
+		// The threshold is equal to the population.
+		CreateDefinition(0x1002, RCIGroup::Res1, { -40 }),
+		CreateDefinition(0x1003, RCIGroup::Res1, { -39 }),
+		// A metric with more than one condition uses the largest threshold.
+		CreateDefinition(0x1004, RCIGroup::Res1, { -100, -40, -60 }),
+		CreateDefinition(0x1005, RCIGroup::Res1, { -100, -39 }),
+		CreateDefinition(0x1006, std::move(yearConditions)),
+		CreateDefinition(0x1007, std::move(buildingConditions)),
+		CreateDefinition(0x1008, std::move(gameConditions)),
+	};
+
+	// The city has negative populations, which only pass the metrics that
+	// the ordinance does not test.
+	TestCityStatsSource source;
+	source.year = 2050;
+	source.totalResidentialPopulation = -1000;
+	source.rciGroupPopulations.fill(-40);
+	ScopedCityStatsSource scopedSource(&source);
+
+	const OrdinanceProgram::MetricValues& metrics = RefreshSnapshot();
+
+	const bool expectedResults[] = { true, true, false, true, false, false, true };
+
+	for (const auto& engine : CreateEngines(definitions))
+	{
+		for (size_t slot = 0; slot < 7; slot++)
+		{
+			bool conditionsMet = false;
+
+			REQUIRE(engine->TryCheckConditions(slot, definitions[slot].get(), conditionsMet));
+			CHECK(conditionsMet == expectedResults[slot]);
+			CHECK(conditionsMet == definitions[slot]->GetProgram().CheckConditions(metrics));
+		}
+
+		bool conditionsMet = false;
+		CHECK(!engine->TryCheckConditions(7, definitions[7].get(), conditionsMet));
+	}
+}
@@ -0,0 +1,329 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BackgroundDecoder.h"
+#include "TestFramework.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	struct Item
+	{
+		size_t index;
+	};
+
+	// Records the indices that the background thread decoded, and allows a
+	// test to block the decoding of one item.
+	class DecodeRecorder
+	{
+	public:
+		explicit DecodeRecorder(size_t count)
+			: decodeCounts(count, 0), blockedIndex(static_cast<size_t>(-1)), blockedIndexStarted(false), released(false)
+		{
+		}
+
+		void BlockIndex(size_t index)
+		{
+			blockedIndex = index;
+		}
+
+		BackgroundDecoder<Item>::DecodeFunction GetDecodeFunction(bool decodeOddIndices = true)
+		{
+			return [this, decodeOddIndices](size_t index) -> std::unique_ptr<Item>
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				decodeCounts[index]++;
+
+				if (index == blockedIndex)
+				{
+					blockedIndexStarted = true;
+					changed.notify_all();
+					changed.wait(lock, [this] { return released; });
+				}
+
+				if (!decodeOddIndices && (index % 2) != 0)
+				{
+					return nullptr;
+				}
+
+				return std::make_unique<Item>(Item{ index });
+			};
+		}
+
+		void WaitForBlockedIndex()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			changed.wait(lock, [this] { return blockedIndexStarted; });
+		}
+
+		void Release()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			released = true;
+			changed.notify_all();
+		}
+
+		void WaitForDecodeCount(size_t count)
+		{
+			while (GetDecodeCount() < count)
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		size_t GetDecodeCount()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			return std::accumulate(decodeCounts.begin(), decodeCounts.end(), size_t(0));
+		}
+
+		uint32_t GetDecodeCount(size_t index)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			return decodeCounts[index];
+		}
+
+	private:
+		std::mutex mutex;
+		std::condition_variable changed;
+		std::vector<uint32_t> decodeCounts;
+		size_t blockedIndex;
+		bool blockedIndexStarted;
+		bool released;
+	};
+}
+
+TEST_CASE(BackgroundDecoder_TakesTheDecodedItems)
+{
+	constexpr size_t Count = 100;
+
+	DecodeRecorder recorder(Count);
+	BackgroundDecoder<Item> decoder;
+
+	decoder.Start(Count, recorder.GetDecodeFunction(false));
+	recorder.WaitForDecodeCount(Count);
+
+	for (size_t i = 0; i < Count; i++)
+	{
+		const std::unique_ptr<Item> item = decoder.Take(i);
+
+		// The decode function returns null for the odd indices.
+		if ((i % 2) == 0)
+		{
+			REQUIRE(item);
+			CHECK(item->index == i);
+		}
+		else
+		{
+			CHECK(!item);
+		}
+
+		CHECK(recorder.GetDecodeCount(i) == 1);
+	}
+
+	// An item can only be taken once.
+	CHECK(!decoder.Take(0));
+	CHECK(!decoder.Take(Count));
+
+	decoder.Stop();
+}
+
+TEST_CASE(BackgroundDecoder_SkipsTheItemsThatWereTakenFirst)
+{
+	constexpr size_t Count = 10;
+
+	DecodeRecorder recorder(Count);
+	recorder.BlockIndex(0);
+
+	BackgroundDecoder<Item> decoder;
+	decoder.Start(Count, recorder.GetDecodeFunction());
+	recorder.WaitForBlockedIndex();
+
+	// The background thread has not reached these items, the game thread
+	// creates them instead.
+	CHECK(!decoder.Take(5));
+	CHECK(!decoder.Take(9));
+
+	recorder.Release();
+	recorder.WaitForDecodeCount(Count - 2);
+	decoder.Stop();
+
+	for (size_t i = 0; i < Count; i++)
+	{
+		CHECK(recorder.GetDecodeCount(i) == ((i == 5 || i == 9) ? 0u : 1u));
+	}
+}
+
+TEST_CASE(BackgroundDecoder_TakeWaitsForTheItemBeingDecoded)
+{
+	constexpr size_t Count = 3;
+
+	DecodeRecorder recorder(Count);
+	recorder.BlockIndex(1);
+
+	BackgroundDecoder<Item> decoder;
+	decoder.Start(Count, recorder.GetDecodeFunction());
+	recorder.WaitForBlockedIndex();
+
+	std::thread releaseThread([&recorder]()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		recorder.Release();
+	});
+
+	// The item is being decoded, Take waits for it instead of skipping it.
+	const std::unique_ptr<Item> item = decoder.Take(1);
+	releaseThread.join();
+
+	CHECK(item && item->index == 1);
+	CHECK(recorder.GetDecodeCount(1) == 1);
+
+	decoder.Stop();
+}
+
+TEST_CASE(BackgroundDecoder_StopDiscardsTheRemainingItems)
+{
+	constexpr size_t Count = 1000;
+
+	std::atomic<size_t> decodeCount = 0;
+	std::atomic<bool> started = false;
+
+	BackgroundDecoder<Item> decoder;
+	decoder.Start(Count, [&](size_t index) -> std::unique_ptr<Item>
+	{
+		decodeCount++;
+		started = true;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		return std::make_unique<Item>(Item{ index });
+	});
+
+	while (!started)
+	{
+		std::this_thread::yield();
+	}
+
+	decoder.Stop();
+
+	CHECK(decodeCount < Count);
+	CHECK(!decoder.Take(0));
+
+	// The decoder can be started again after it was stopped.
+	DecodeRecorder recorder(Count);
+	decoder.Start(Count, recorder.GetDecodeFunction());
+	recorder.WaitForDecodeCount(Count);
+
+	const std::unique_ptr<Item> item = decoder.Take(Count - 1);
+	CHECK(item && item->index == Count - 1);
+
+	decoder.Stop();
+
+	// Starting with no items does not start the background thread.
+	decoder.Start(0, recorder.GetDecodeFunction());
+	CHECK(!decoder.Take(0));
+	decoder.Stop();
+}
+
+TEST_CASE(BackgroundDecoder_GameThreadTakesWhileDecoding)
+{
+	constexpr size_t Count = 5000;
+
+	std::mt19937 random(1);
+
+	for (int iteration = 0; iteration < 10; iteration++)
+	{
+		DecodeRecorder recorder(Count);
+		BackgroundDecoder<Item> decoder;
+		decoder.Start(Count, recorder.GetDecodeFunction());
+
+		std::vector<size_t> order(Count);
+		std::iota(order.begin(), order.end(), size_t(0));
+		std::shuffle(order.begin(), order.end(), random);
+
+		size_t decodedItems = 0;
+
+		for (size_t index : order)
+		{
+			const std::unique_ptr<Item> item = decoder.Take(index);
+
+			// The item was either decoded once and handed over, or skipped.
+			if (item)
+			{
+				CHECK(item->index == index);
+				CHECK(recorder.GetDecodeCount(index) == 1);
+				decodedItems++;
+			}
+		}
+
+		decoder.Stop();
+
+		for (size_t i = 0; i < Count; i++)
+		{
+			CHECK(recorder.GetDecodeCount(i) <= 1);
+		}
+
+		CHECK(decodedItems <= recorder.GetDecodeCount());
+	}
+}
+
+TEST_CASE(BackgroundDecoder_DestructorWaitsForTheBackgroundThread)
+{
+	constexpr size_t Count = 1000;
+
+	std::atomic<size_t> activeCalls = 0;
+	std::atomic<size_t> decodeCount = 0;
+
+	{
+		BackgroundDecoder<Item> decoder;
+		decoder.Start(Count, [&](size_t index) -> std::unique_ptr<Item>
+		{
+			activeCalls++;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			decodeCount++;
+			activeCalls--;
+			return std::make_unique<Item>(Item{ index });
+		});
+
+		while (decodeCount == 0)
+		{
+			std::this_thread::yield();
+		}
+
+		// The decoder is destroyed without calling Stop.
+	}
+
+	// The background thread has exited, it does not decode any more items.
+	CHECK(activeCalls == 0);
+
+	const size_t countAfterDestruction = decodeCount;
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+	CHECK(decodeCount == countAfterDestruction);
+	CHECK(countAfterDestruction < Count);
+}
@@ -0,0 +1,78 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	struct RegisteredBenchmark
+	{
+		const char* name;
+		Benchmark::BenchmarkFunction function;
+	};
+
+	std::vector<RegisteredBenchmark>& GetBenchmarks()
+	{
+		static std::vector<RegisteredBenchmark> benchmarks;
+
+		return benchmarks;
+	}
+
+	volatile uint64_t consumedValue = 0;
+}
+
+bool Benchmark::RegisterBenchmark(const char* name, BenchmarkFunction function)
+{
+	GetBenchmarks().push_back(RegisteredBenchmark{ name, function });
+	return true;
+}
+
+void Benchmark::Consume(uint64_t value)
+{
+	consumedValue = value;
+}
+
+void Benchmark::PrintThroughput(const char* label, uint64_t byteCount, double nanoseconds)
+{
+	// Bytes per nanosecond is the same as 1000 MB per second.
+	const double megabytesPerSecond = nanoseconds > 0 ? (static_cast<double>(byteCount) / nanoseconds) * 1000.0 : 0.0;
+
+	std::printf("  %-48s %14.1f MB/s\n", label, megabytesPerSecond);
+}
+
+// Runs all of the benchmarks, or the benchmarks whose name contains the first argument.
+int main(int argc, char** argv)
+{
+	const char* filter = argc > 1 ? argv[1] : nullptr;
+
+	for (const RegisteredBenchmark& benchmark : GetBenchmarks())
+	{
+		if (!filter || std::strstr(benchmark.name, filter))
+		{
+			std::printf("%s\n", benchmark.name);
+			benchmark.function();
+		}
+	}
+
+	return 0;
+}
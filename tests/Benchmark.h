@@ -0,0 +1,76 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+// A minimal benchmark harness, the benchmarks are registered by the BENCHMARK
+// macro and run in registration order by Benchmark.cpp.
+namespace Benchmark
+{
+	using BenchmarkFunction = void(*)();
+
+	bool RegisterBenchmark(const char* name, BenchmarkFunction function);
+
+	// Stores the value in a volatile variable, so that the compiler cannot
+	// remove the code that computes it.
+	void Consume(uint64_t value);
+
+	// Runs the function until at least 200 ms have passed, and prints the average
+	// time of one call. The function is called once before the measurement.
+	// Returns the average time of one call in nanoseconds.
+	template <typename Function> double Measure(const char* label, Function&& function)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		constexpr auto MinimumDuration = std::chrono::milliseconds(200);
+
+		function();
+
+		uint64_t iterations = 0;
+		const Clock::time_point start = Clock::now();
+		Clock::duration elapsed{};
+
+		do
+		{
+			function();
+			iterations++;
+			elapsed = Clock::now() - start;
+		} while (elapsed < MinimumDuration);
+
+		const double nanoseconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count())
+			/ static_cast<double>(iterations);
+
+		std::printf("  %-48s %14.1f ns\n", label, nanoseconds);
+
+		return nanoseconds;
+	}
+
+	// Prints the throughput of a measurement that processed the specified number of bytes.
+	void PrintThroughput(const char* label, uint64_t byteCount, double nanoseconds);
+}
+
+#define BENCHMARK(name) \
+	static void name(); \
+	static const bool name##Registered = Benchmark::RegisterBenchmark(#name, name); \
+	static void name()
@@ -0,0 +1,250 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CityStatsSnapshot.h"
+#include "TestFramework.h"
+
+namespace
+{
+	// A city whose statistics are derived from a generation number, so that
+	// every fill of the snapshot can be identified.
+	class FakeCityStatsSource final : public ICityStatsSource
+	{
+	public:
+		FakeCityStatsSource()
+			: cityLoaded(true), year(2000), month(1), day(1), generation(1), populationQueries(0)
+		{
+		}
+
+		bool GetSimDate(uint32_t& outYear, uint32_t& outMonth, uint32_t& outDay) const override
+		{
+			outYear = year;
+			outMonth = month;
+			outDay = day;
+
+			return cityLoaded;
+		}
+
+		int32_t GetTotalResidentialPopulation() const override
+		{
+			populationQueries++;
+			return static_cast<int32_t>(generation * 1000);
+		}
+
+		int32_t GetRCIGroupPopulation(uint32_t demandID) const override
+		{
+			return static_cast<int32_t>(demandID + generation);
+		}
+
+		uint32_t GetBuildingCount(BuildingType type) const override
+		{
+			return (static_cast<uint32_t>(type) + 1) * generation;
+		}
+
+		bool cityLoaded;
+		uint32_t year;
+		uint32_t month;
+		uint32_t day;
+		uint32_t generation;
+		mutable uint32_t populationQueries;
+	};
+
+	// The tests share the snapshot instance, the source is reset when the
+	// test ends.
+	class ScopedSource
+	{
+	public:
+		explicit ScopedSource(const ICityStatsSource* source)
+		{
+			CityStatsSnapshot::GetInstance().SetSource(source);
+		}
+
+		~ScopedSource()
+		{
+			CityStatsSnapshot::GetInstance().SetSource(nullptr);
+		}
+	};
+}
+
+TEST_CASE(CityStatsSnapshot_WithoutACityReportsZero)
+{
+	CityStatsSnapshot& snapshot = CityStatsSnapshot::GetInstance();
+
+	CHECK(!snapshot.Update());
+	CHECK(snapshot.GetTotalResidentialPopulation() == 0);
+
+	FakeCityStatsSource source;
+	source.cityLoaded = false;
+	ScopedSource scopedSource(&source);
+
+	CHECK(!snapshot.Update());
+	CHECK(snapshot.GetSimYear() == 0);
+	CHECK(snapshot.GetBuildingCount(BuildingType::School) == 0);
+	CHECK(source.populationQueries == 0);
+}
+
+TEST_CASE(CityStatsSnapshot_CopiesTheSourceValues)
+{
+	FakeCityStatsSource source;
+	source.year = 2010;
+	source.generation = 3;
+	ScopedSource scopedSource(&source);
+
+	CityStatsSnapshot& snapshot = CityStatsSnapshot::GetInstance();
+	REQUIRE(snapshot.Update());
+
+	CHECK(snapshot.GetSimYear() == 2010);
+	CHECK(snapshot.GetTotalResidentialPopulation() == 3000);
+
+	int32_t population = 0;
+	CHECK(snapshot.TryGetRCIGroupPopulation(static_cast<uint32_t>(RCIGroup::Cs2), population));
+	CHECK(population == 0x3120 + 3);
+	CHECK(!snapshot.TryGetRCIGroupPopulation(0x1234, population));
+
+	CHECK(snapshot.GetBuildingCount(BuildingType::FireStation) == 3);
+	CHECK(snapshot.GetBuildingCount(BuildingType::School) == 15);
+	CHECK(snapshot.GetBuildingCount(static_cast<BuildingType>(100)) == 0);
+
+	const auto& metricValues = snapshot.GetMetricValues();
+	CHECK(metricValues[static_cast<size_t>(CityMetric::SimYear)] == 2010.0);
+	CHECK(metricValues[static_cast<size_t>(CityMetric::TotalResidentialPopulation)] == 3000.0);
+	CHECK(metricValues[static_cast<size_t>(CityMetric::IHTPopulation)] == static_cast<double>(0x4400 + 3));
+	CHECK(metricValues[static_cast<size_t>(CityMetric::JailCount)] == 9.0);
+}
+
+TEST_CASE(CityStatsSnapshot_FillsOnceForTheSameDate)
+{
+	FakeCityStatsSource source;
+	ScopedSource scopedSource(&source);
+
+	CityStatsSnapshot& snapshot = CityStatsSnapshot::GetInstance();
+	REQUIRE(snapshot.Update());
+
+	const uint32_t epoch = snapshot.GetEpoch();
+
+	source.generation = 2;
+
+	for (int i = 0; i < 10; i++)
+	{
+		CHECK(snapshot.Update());
+	}
+
+	CHECK(snapshot.GetEpoch() == epoch);
+	CHECK(source.populationQueries == 1);
+	CHECK(snapshot.GetTotalResidentialPopulation() == 1000);
+}
+
+TEST_CASE(CityStatsSnapshot_RefillsWhenTheDateChanges)
+{
+	FakeCityStatsSource source;
+	ScopedSource scopedSource(&source);
+
+	CityStatsSnapshot& snapshot = CityStatsSnapshot::GetInstance();
+	REQUIRE(snapshot.Update());
+
+	const uint32_t epoch = snapshot.GetEpoch();
+
+	source.day = 2;
+	source.generation = 2;
+	REQUIRE(snapshot.Update());
+	CHECK(snapshot.GetEpoch() == epoch + 1);
+	CHECK(snapshot.GetTotalResidentialPopulation() == 2000);
+
+	source.month = 2;
+	source.day = 2;
+	source.generation = 3;
+	REQUIRE(snapshot.Update());
+	CHECK(snapshot.GetEpoch() == epoch + 2);
+	CHECK(snapshot.GetTotalResidentialPopulation() == 3000);
+}
+
+TEST_CASE(CityStatsSnapshot_RefillsOncePerTick)
+{
+	FakeCityStatsSource source;
+	ScopedSource scopedSource(&source);
+
+	CityStatsSnapshot& snapshot = CityStatsSnapshot::GetInstance();
+
+	// The ordinances that read the snapshot in one tick share one fill.
+	for (int i = 0; i < 3; i++)
+	{
+		REQUIRE(snapshot.Update());
+	}
+
+	const uint32_t epoch = snapshot.GetEpoch();
+	CHECK(source.populationQueries == 1);
+
+	// A new tick on the same date fills the snapshot on its first read.
+	source.generation = 2;
+	snapshot.AdvanceTick();
+	CHECK(snapshot.GetTotalResidentialPopulation() == 1000);
+
+	for (int i = 0; i < 3; i++)
+	{
+		REQUIRE(snapshot.Update());
+	}
+
+	CHECK(snapshot.GetEpoch() == epoch + 1);
+	CHECK(snapshot.GetTotalResidentialPopulation() == 2000);
+	CHECK(source.populationQueries == 2);
+
+	// The ticks without a read do not query the city.
+	source.generation = 3;
+
+	for (int i = 0; i < 5; i++)
+	{
+		snapshot.AdvanceTick();
+	}
+
+	CHECK(source.populationQueries == 2);
+
+	REQUIRE(snapshot.Update());
+	CHECK(snapshot.GetEpoch() == epoch + 2);
+	CHECK(snapshot.GetTotalResidentialPopulation() == 3000);
+	CHECK(source.populationQueries == 3);
+}
+
+TEST_CASE(CityStatsSnapshot_InvalidateForcesARefill)
+{
+	FakeCityStatsSource source;
+	ScopedSource scopedSource(&source);
+
+	CityStatsSnapshot& snapshot = CityStatsSnapshot::GetInstance();
+	REQUIRE(snapshot.Update());
+
+	const uint32_t epoch = snapshot.GetEpoch();
+
+	snapshot.Invalidate();
+	CHECK(snapshot.GetTotalResidentialPopulation() == 0);
+	CHECK(snapshot.GetSimYear() == 0);
+
+	// The snapshot is filled again in the same tick and on the same date.
+	source.generation = 2;
+	REQUIRE(snapshot.Update());
+	CHECK(snapshot.GetEpoch() == epoch + 1);
+	CHECK(snapshot.GetTotalResidentialPopulation() == 2000);
+	CHECK(source.populationQueries == 2);
+
+	// Removing the source is treated as unloading the city.
+	CityStatsSnapshot::GetInstance().SetSource(nullptr);
+	CHECK(!snapshot.Update());
+	CHECK(snapshot.GetTotalResidentialPopulation() == 0);
+}
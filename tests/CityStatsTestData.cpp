@@ -0,0 +1,94 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CityStatsTestData.h"
+#include "CityStatsSnapshot.h"
+
+using namespace CityStatsTestData;
+
+TestCityStatsSource::TestCityStatsSource()
+	: year(2000), totalResidentialPopulation(0), rciGroupPopulations(), buildingCounts()
+{
+}
+
+void TestCityStatsSource::Randomize(std::mt19937& random)
+{
+	year = std::uniform_int_distribution<uint32_t>(2000, 2100)(random);
+	totalResidentialPopulation = std::uniform_int_distribution<int32_t>(0, 500000)(random);
+
+	std::uniform_int_distribution<int32_t> populationDistribution(0, 60000);
+
+	for (int32_t& population : rciGroupPopulations)
+	{
+		population = populationDistribution(random);
+	}
+
+	std::uniform_int_distribution<uint32_t> buildingCountDistribution(0, 25);
+
+	for (uint32_t& count : buildingCounts)
+	{
+		count = buildingCountDistribution(random);
+	}
+}
+
+bool TestCityStatsSource::GetSimDate(uint32_t& outYear, uint32_t& outMonth, uint32_t& outDay) const
+{
+	outYear = year;
+	outMonth = 1;
+	outDay = 1;
+
+	return true;
+}
+
+int32_t TestCityStatsSource::GetTotalResidentialPopulation() const
+{
+	return totalResidentialPopulation;
+}
+
+int32_t TestCityStatsSource::GetRCIGroupPopulation(uint32_t demandID) const
+{
+	for (size_t i = 0; i < CityMetricUtil::RCIGroups.size(); i++)
+	{
+		if (static_cast<uint32_t>(CityMetricUtil::RCIGroups[i]) == demandID)
+		{
+			return rciGroupPopulations[i];
+		}
+	}
+
+	return 0;
+}
+
+uint32_t TestCityStatsSource::GetBuildingCount(BuildingType type) const
+{
+	const size_t index = static_cast<size_t>(type);
+
+	return index < buildingCounts.size() ? buildingCounts[index] : 0;
+}
+
+ScopedCityStatsSource::ScopedCityStatsSource(const ICityStatsSource* source)
+{
+	CityStatsSnapshot::GetInstance().SetSource(source);
+}
+
+ScopedCityStatsSource::~ScopedCityStatsSource()
+{
+	CityStatsSnapshot::GetInstance().SetSource(nullptr);
+}
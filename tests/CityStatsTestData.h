@@ -0,0 +1,65 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "CityMetric.h"
+#include "CityStatsSource.h"
+#include <array>
+#include <cstdint>
+#include <random>
+
+// A city statistics source for the tests and benchmarks that use the
+// CityStatsSnapshot, the values are set by the caller.
+namespace CityStatsTestData
+{
+	class TestCityStatsSource final : public ICityStatsSource
+	{
+	public:
+		TestCityStatsSource();
+
+		// Sets random values in the ranges that the test ordinances use.
+		void Randomize(std::mt19937& random);
+
+		bool GetSimDate(uint32_t& year, uint32_t& month, uint32_t& day) const override;
+
+		int32_t GetTotalResidentialPopulation() const override;
+		int32_t GetRCIGroupPopulation(uint32_t demandID) const override;
+		uint32_t GetBuildingCount(BuildingType type) const override;
+
+		uint32_t year;
+		int32_t totalResidentialPopulation;
+		// The populations in the CityMetricUtil::RCIGroups order.
+		std::array<int32_t, CityMetricUtil::RCIGroups.size()> rciGroupPopulations;
+		std::array<uint32_t, CityMetricUtil::BuildingTypeCount> buildingCounts;
+	};
+
+	// Sets the source of the CityStatsSnapshot instance, the source is removed
+	// when the test ends.
+	class ScopedCityStatsSource
+	{
+	public:
+		explicit ScopedCityStatsSource(const ICityStatsSource* source);
+		~ScopedCityStatsSource();
+
+		ScopedCityStatsSource(const ScopedCityStatsSource& other) = delete;
+		ScopedCityStatsSource& operator=(const ScopedCityStatsSource& other) = delete;
+	};
+}
@@ -0,0 +1,303 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CompiledOrdinancePack.h"
+#include "CompiledOrdinancePackWriter.h"
+#include "ExemplarBuilder.h"
+#include "ExemplarPropertyTable.h"
+#include "OrdiancePropertyIDs.h"
+#include "TestFramework.h"
+#include "TestUtil.h"
+#include <array>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace CompiledOrdinancePackFormat;
+
+namespace
+{
+	constexpr uint32_t ExemplarTypeID = 0x6534284A;
+	constexpr uint32_t OrdinanceGroupID = 0x4A5E8EF6;
+
+	std::vector<uint8_t> CreateOrdinanceExemplar(uint32_t index)
+	{
+		ExemplarBuilder builder;
+
+		builder.AddUint32(0x00000010, 0x0000000E) // ExemplarType: Ordinance
+			.AddUint32Array(kOrdinanceNameKey, { 0x2026960B, 0x6A231EAA, 0x1000 + index })
+			.AddString(kOrdinanceName, index == 0 ? "Shared Name" : "Ordinance " + std::to_string(index))
+			.AddString(kOrdinanceDescription, "Shared Name")
+			.AddSint64(kOrdinanceEnactmentIncome, -1000 * static_cast<int64_t>(index))
+			.AddSint64(kOrdinancemMonthlyConstantIncome, 250)
+			.AddBool(kOrdinanceIsIncome, (index % 2) == 0)
+			.AddUint32(kOrdinanceAvailabilityGameYear, 2000 + index)
+			.AddFloat32(kOrdinanceMonthlyIncomeFactorResTotalPopulation, 0.25f * static_cast<float>(index));
+
+		if (index == 2)
+		{
+			builder.AddString(kOrdinanceMonthlyIncomeFactorLuaFunction, "custom_income");
+		}
+
+		return builder.Build();
+	}
+
+	// Writes a pack with three ordinances and returns their property tables.
+	bool WriteTestPack(const std::filesystem::path& path, std::vector<ExemplarPropertyTable>& tables)
+	{
+		CompiledOrdinancePackWriter writer;
+
+		tables.resize(3);
+
+		for (uint32_t i = 0; i < tables.size(); i++)
+		{
+			if (!tables[i].Parse(CreateOrdinanceExemplar(i))
+				|| !writer.Add(ExemplarTypeID, OrdinanceGroupID, 0x10000000 + i, tables[i]))
+			{
+				return false;
+			}
+		}
+
+		return writer.Save(path);
+	}
+
+	// Compares every schema property of the pack record with the property table.
+	bool RecordMatchesTable(const CompiledOrdinancePack& pack, uint32_t index, const ExemplarPropertyTable& table)
+	{
+		for (const PropertySchemaItem& item : PropertySchema)
+		{
+			bool inTable = false;
+			bool inPack = false;
+			bool equal = true;
+
+			switch (item.kind)
+			{
+			case ValueKind::Int64:
+			{
+				int64_t expected = 0;
+				int64_t actual = 0;
+				inTable = table.GetPropertyValue(item.id, expected);
+				inPack = pack.GetPropertyValue(index, item.id, actual);
+				equal = expected == actual;
+				break;
+			}
+			case ValueKind::Uint32:
+			{
+				uint32_t expected = 0;
+				uint32_t actual = 0;
+				inTable = table.GetPropertyValue(item.id, expected);
+				inPack = pack.GetPropertyValue(index, item.id, actual);
+				equal = expected == actual;
+				break;
+			}
+			case ValueKind::Float32:
+			{
+				float expected = 0;
+				float actual = 0;
+				inTable = table.GetPropertyValue(item.id, expected);
+				inPack = pack.GetPropertyValue(index, item.id, actual);
+				equal = std::memcmp(&expected, &actual, sizeof(float)) == 0;
+				break;
+			}
+			case ValueKind::Bool:
+			{
+				bool expected = false;
+				bool actual = false;
+				inTable = table.GetPropertyValue(item.id, expected);
+				inPack = pack.GetPropertyValue(index, item.id, actual);
+				equal = expected == actual;
+				break;
+			}
+			case ValueKind::String:
+			{
+				std::string_view expected;
+				std::string_view actual;
+				inTable = table.GetPropertyValue(item.id, expected);
+				inPack = pack.GetPropertyValue(index, item.id, actual);
+				equal = expected == actual;
+				break;
+			}
+			case ValueKind::StringResourceKey:
+			{
+				std::array<uint32_t, 3> expected{};
+				uint32_t group = 0;
+				uint32_t instance = 0;
+				inTable = table.GetPropertyValues(item.id, expected);
+				inPack = pack.GetStringResourceKey(index, item.id, group, instance);
+				equal = expected[1] == group && expected[2] == instance;
+				break;
+			}
+			}
+
+			if (inTable != inPack || (inTable && !equal))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool OpenModifiedPack(
+		const std::filesystem::path& packPath,
+		const std::filesystem::path& modifiedPath,
+		size_t offset,
+		uint8_t xorValue)
+	{
+		std::vector<uint8_t> data;
+
+		if (!TestUtil::ReadFile(packPath, data) || offset >= data.size())
+		{
+			return true;
+		}
+
+		data[offset] ^= xorValue;
+
+		if (!TestUtil::WriteFile(modifiedPath, data))
+		{
+			return true;
+		}
+
+		CompiledOrdinancePack pack;
+		return pack.Open(modifiedPath);
+	}
+}
+
+TEST_CASE(CompiledOrdinancePack_RoundTripsTheSchemaProperties)
+{
+	TestUtil::TemporaryDirectory directory;
+	const std::filesystem::path packPath = directory.GetPath() / "ordinances.pack";
+
+	std::vector<ExemplarPropertyTable> tables;
+	REQUIRE(WriteTestPack(packPath, tables));
+
+	CompiledOrdinancePack pack;
+	REQUIRE(pack.Open(packPath));
+	REQUIRE(pack.GetRecordCount() == tables.size());
+
+	for (uint32_t i = 0; i < pack.GetRecordCount(); i++)
+	{
+		const CompiledOrdinancePack::Key key = pack.GetKey(i);
+
+		CHECK(key.type == ExemplarTypeID);
+		CHECK(key.group == OrdinanceGroupID);
+		CHECK(key.instance == 0x10000000 + i);
+		CHECK(RecordMatchesTable(pack, i, tables[i]));
+	}
+
+	std::string_view luaFunction;
+	CHECK(!pack.GetPropertyValue(0, kOrdinanceMonthlyIncomeFactorLuaFunction, luaFunction));
+	CHECK(pack.GetPropertyValue(2, kOrdinanceMonthlyIncomeFactorLuaFunction, luaFunction));
+	CHECK(luaFunction == "custom_income");
+}
+
+TEST_CASE(CompiledOrdinancePack_RejectsMismatchedValueTypes)
+{
+	TestUtil::TemporaryDirectory directory;
+	const std::filesystem::path packPath = directory.GetPath() / "ordinances.pack";
+
+	std::vector<ExemplarPropertyTable> tables;
+	REQUIRE(WriteTestPack(packPath, tables));
+
+	CompiledOrdinancePack pack;
+	REQUIRE(pack.Open(packPath));
+
+	float floatValue = 0;
+	CHECK(!pack.GetPropertyValue(0, kOrdinanceName, floatValue));
+
+	// Properties that are not in the schema are never present.
+	uint32_t uint32Value = 0;
+	CHECK(!pack.GetPropertyValue(0, 0x00000010, uint32Value));
+}
+
+TEST_CASE(CompiledOrdinancePackWriter_RejectsParentCohortExemplars)
+{
+	ExemplarPropertyTable table;
+	REQUIRE(table.Parse(ExemplarBuilder()
+		.SetParentCohort(0x05342861, 0x4A5E8EF6, 0x12345678)
+		.AddString(kOrdinanceName, "Inherits")
+		.Build()));
+
+	CompiledOrdinancePackWriter writer;
+	CHECK(!writer.Add(ExemplarTypeID, OrdinanceGroupID, 1, table));
+	CHECK(!writer.Add(ExemplarTypeID, OrdinanceGroupID, 2, ExemplarPropertyTable()));
+	CHECK(writer.GetRecordCount() == 0);
+}
+
+TEST_CASE(CompiledOrdinancePack_RejectsSchemaHashMismatch)
+{
+	TestUtil::TemporaryDirectory directory;
+	const std::filesystem::path packPath = directory.GetPath() / "ordinances.pack";
+
+	std::vector<ExemplarPropertyTable> tables;
+	REQUIRE(WriteTestPack(packPath, tables));
+
+	// Every byte of the 64-bit schema hash is checked.
+	for (size_t offset = 8; offset < 16; offset++)
+	{
+		CHECK(!OpenModifiedPack(packPath, directory.GetPath() / "modified.pack", offset, 0x01));
+	}
+
+	// The signature and version.
+	CHECK(!OpenModifiedPack(packPath, directory.GetPath() / "modified.pack", 0, 0x01));
+	CHECK(!OpenModifiedPack(packPath, directory.GetPath() / "modified.pack", 4, 0x02));
+}
+
+TEST_CASE(CompiledOrdinancePack_RejectsTruncatedFiles)
+{
+	TestUtil::TemporaryDirectory directory;
+	const std::filesystem::path packPath = directory.GetPath() / "ordinances.pack";
+	const std::filesystem::path truncatedPath = directory.GetPath() / "truncated.pack";
+
+	std::vector<ExemplarPropertyTable> tables;
+	REQUIRE(WriteTestPack(packPath, tables));
+
+	std::vector<uint8_t> data;
+	REQUIRE(TestUtil::ReadFile(packPath, data));
+
+	for (size_t size = 0; size < data.size(); size++)
+	{
+		REQUIRE(TestUtil::WriteFile(truncatedPath, std::span<const uint8_t>(data.data(), size)));
+
+		CompiledOrdinancePack pack;
+		CHECK(!pack.Open(truncatedPath));
+	}
+}
+
+TEST_CASE(CompiledOrdinancePack_RejectsStringsOutsideThePool)
+{
+	TestUtil::TemporaryDirectory directory;
+	const std::filesystem::path packPath = directory.GetPath() / "ordinances.pack";
+
+	std::vector<ExemplarPropertyTable> tables;
+	REQUIRE(WriteTestPack(packPath, tables));
+
+	std::vector<uint8_t> data;
+	REQUIRE(TestUtil::ReadFile(packPath, data));
+
+	const uint32_t recordOffset = data[24] | (data[25] << 8) | (data[26] << 16) | (data[27] << 24);
+
+	// The length of the name string in the first record, schema slot 1.
+	const size_t lengthOffset = recordOffset + RecordHeaderSize + RecordValueSize + 7;
+
+	CHECK(!OpenModifiedPack(packPath, directory.GetPath() / "modified.pack", lengthOffset, 0x80));
+}
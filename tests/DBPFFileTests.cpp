@@ -0,0 +1,349 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DBPFFile.h"
+#include "DBPFWriter.h"
+#include "QFSCompression.h"
+#include "TestFramework.h"
+#include "TestUtil.h"
+#include <array>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t ExemplarTypeID = 0x6534284A;
+	constexpr uint32_t CompressedRecordDirectoryType = 0xE86B1EEF;
+
+	// The header offsets of the DBPF index fields.
+	constexpr size_t IndexCountOffset = 36;
+	constexpr size_t IndexOffsetOffset = 40;
+	constexpr size_t IndexSizeOffset = 44;
+
+	const std::vector<uint8_t> FirstRecord = { 'E', 'Q', 'Z', 'B', '1', '#', '#', '#', 1, 2, 3 };
+	const std::vector<uint8_t> SecondRecord = { 'E', 'Q', 'Z', 'T', '1', '#', '#', '#', 4, 5 };
+	// A QFS stream with one 4 byte literal run and the stop command.
+	const std::vector<uint8_t> CompressedRecord =
+	{
+		15, 0, 0, 0, 0x10, 0xFB, 0, 0, 4,
+		0xE0, 'D', 'A', 'T', 'A',
+		0xFC
+	};
+
+	uint32_t ReadUint32(const std::vector<uint8_t>& data, size_t offset)
+	{
+		return static_cast<uint32_t>(data[offset])
+			| (static_cast<uint32_t>(data[offset + 1]) << 8)
+			| (static_cast<uint32_t>(data[offset + 2]) << 16)
+			| (static_cast<uint32_t>(data[offset + 3]) << 24);
+	}
+
+	void WriteUint32(std::vector<uint8_t>& data, size_t offset, uint32_t value)
+	{
+		for (size_t i = 0; i < 4; i++)
+		{
+			data[offset + i] = static_cast<uint8_t>(value >> (i * 8));
+		}
+	}
+
+	bool WriteTestFile(const std::filesystem::path& path)
+	{
+		DBPFWriter writer;
+		DBPFWriter::Statistics statistics{};
+
+		return writer.Add(ExemplarTypeID, 0x4A5E8EF6, 0x00000002, SecondRecord, false)
+			&& writer.Add(ExemplarTypeID, 0x4A5E8EF6, 0x00000001, FirstRecord, false)
+			&& writer.Add(ExemplarTypeID, 0x4A5E8EF6, 0x00000003, CompressedRecord, true)
+			&& writer.Save(path, statistics);
+	}
+
+	bool FindEntry(const DBPFFile& file, uint32_t type, uint32_t instance, DBPFFile::IndexEntry& entry)
+	{
+		for (uint32_t i = 0; i < file.GetIndexEntryCount(); i++)
+		{
+			entry = file.GetIndexEntry(i);
+
+			if (entry.type == type && entry.instance == instance)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool SpanEquals(std::span<const uint8_t> span, const std::vector<uint8_t>& expected)
+	{
+		return span.size() == expected.size() && std::memcmp(span.data(), expected.data(), span.size()) == 0;
+	}
+
+	// Writes a modified copy of the test file and opens it.
+	bool OpenModifiedFile(
+		const TestUtil::TemporaryDirectory& directory,
+		const std::vector<uint8_t>& data,
+		DBPFFile& file)
+	{
+		const std::filesystem::path path = directory.GetPath() / "modified.dat";
+
+		return TestUtil::WriteFile(path, data) && file.Open(path);
+	}
+}
+
+TEST_CASE(DBPFFile_ReadsTheIndexAndRecords)
+{
+	TestUtil::TemporaryDirectory directory;
+	const std::filesystem::path path = directory.GetPath() / "test.dat";
+	REQUIRE(WriteTestFile(path));
+
+	DBPFFile file;
+	REQUIRE(file.Open(path));
+
+	// The three records and the compressed record directory.
+	CHECK(file.GetIndexEntryCount() == 4);
+
+	DBPFFile::IndexEntry entry{};
+
+	REQUIRE(FindEntry(file, ExemplarTypeID, 1, entry));
+	CHECK(SpanEquals(file.GetRecordData(entry), FirstRecord));
+	CHECK(!file.IsRecordCompressed(entry));
+
+	REQUIRE(FindEntry(file, ExemplarTypeID, 2, entry));
+	CHECK(SpanEquals(file.GetRecordData(entry), SecondRecord));
+	CHECK(!file.IsRecordCompressed(entry));
+
+	REQUIRE(FindEntry(file, ExemplarTypeID, 3, entry));
+	CHECK(SpanEquals(file.GetRecordData(entry), CompressedRecord));
+	CHECK(file.IsRecordCompressed(entry));
+
+	std::vector<uint8_t> decompressed;
+	CHECK(QFSCompression::Decompress(file.GetRecordData(entry), decompressed));
+	CHECK(decompressed == std::vector<uint8_t>({ 'D', 'A', 'T', 'A' }));
+
+	CHECK(FindEntry(file, CompressedRecordDirectoryType, 0x286B1F03, entry));
+}
+
+TEST_CASE(DBPFFile_RejectsInvalidHeaders)
+{
+	TestUtil::TemporaryDirectory directory;
+	const std::filesystem::path path = directory.GetPath() / "test.dat";
+	REQUIRE(WriteTestFile(path));
+
+	std::vector<uint8_t> original;
+	REQUIRE(TestUtil::ReadFile(path, original));
+
+	// The signature, major version, minor version and index major version.
+	for (size_t offset : { 0, 4, 8, 32 })
+	{
+		std::vector<uint8_t> data = original;
+		data[offset] ^= 0x40;
+
+		DBPFFile file;
+		CHECK(!OpenModifiedFile(directory, data, file));
+	}
+
+	std::vector<uint8_t> data(original.begin(), original.begin() + 95);
+
+	DBPFFile file;
+	CHECK(!OpenModifiedFile(directory, data, file));
+}
+
+TEST_CASE(DBPFFile_RejectsIndexTablesOutsideTheFile)
+{
+	TestUtil::TemporaryDirectory directory;
+	const std::filesystem::path path = directory.GetPath() / "test.dat";
+	REQUIRE(WriteTestFile(path));
+
+	std::vector<uint8_t> original;
+	REQUIRE(TestUtil::ReadFile(path, original));
+
+	const uint32_t indexCount = ReadUint32(original, IndexCountOffset);
+	const uint32_t indexOffset = ReadUint32(original, IndexOffsetOffset);
+	const uint32_t indexSize = ReadUint32(original, IndexSizeOffset);
+
+	{
+		// The index starts after the end of the file.
+		std::vector<uint8_t> data = original;
+		WriteUint32(data, IndexOffsetOffset, static_cast<uint32_t>(data.size()) + 1);
+
+		DBPFFile file;
+		CHECK(!OpenModifiedFile(directory, data, file));
+	}
+
+	{
+		// The index ends after the end of the file.
+		std::vector<uint8_t> data = original;
+		WriteUint32(data, IndexOffsetOffset, indexOffset + 1);
+
+		DBPFFile file;
+		CHECK(!OpenModifiedFile(directory, data, file));
+	}
+
+	{
+		// The index size is larger than the file.
+		std::vector<uint8_t> data = original;
+		WriteUint32(data, IndexSizeOffset, 0xFFFFFFFF);
+
+		DBPFFile file;
+		CHECK(!OpenModifiedFile(directory, data, file));
+	}
+
+	{
+		// The entry count does not fit in the index size.
+		std::vector<uint8_t> data = original;
+		WriteUint32(data, IndexCountOffset, indexCount + 1);
+
+		DBPFFile file;
+		CHECK(!OpenModifiedFile(directory, data, file));
+
+		WriteUint32(data, IndexCountOffset, 0x40000000);
+		CHECK(!OpenModifiedFile(directory, data, file));
+	}
+
+	// Every truncation of the file cuts into the index table.
+	for (size_t size = indexOffset; size < static_cast<size_t>(indexOffset) + indexSize; size++)
+	{
+		std::vector<uint8_t> data(original.begin(), original.begin() + size);
+
+		DBPFFile file;
+		CHECK(!OpenModifiedFile(directory, data, file));
+	}
+}
+
+TEST_CASE(DBPFFile_ReturnsNoDataForRecordsOutsideTheFile)
+{
+	TestUtil::TemporaryDirectory directory;
+	const std::filesystem::path path = directory.GetPath() / "test.dat";
+	REQUIRE(WriteTestFile(path));
+
+	std::vector<uint8_t> data;
+	REQUIRE(TestUtil::ReadFile(path, data));
+
+	const uint32_t indexCount = ReadUint32(data, IndexCountOffset);
+	const uint32_t indexOffset = ReadUint32(data, IndexOffsetOffset);
+
+	// Move the records that are not the compressed record directory, the first
+	// past the end of the file and the second so that it overlaps the end.
+	uint32_t movedCount = 0;
+
+	for (uint32_t i = 0; i < indexCount && movedCount < 2; i++)
+	{
+		const size_t entryOffset = indexOffset + (static_cast<size_t>(i) * 20);
+
+		if (ReadUint32(data, entryOffset) == ExemplarTypeID)
+		{
+			const uint32_t recordOffset = movedCount == 0
+				? static_cast<uint32_t>(data.size()) + 1
+				: static_cast<uint32_t>(data.size()) - 1;
+
+			WriteUint32(data, entryOffset + 12, recordOffset);
+			movedCount++;
+		}
+	}
+
+	REQUIRE(movedCount == 2);
+
+	DBPFFile file;
+	REQUIRE(OpenModifiedFile(directory, data, file));
+
+	uint32_t emptyRecordCount = 0;
+
+	for (uint32_t i = 0; i < file.GetIndexEntryCount(); i++)
+	{
+		if (file.GetRecordData(file.GetIndexEntry(i)).empty())
+		{
+			emptyRecordCount++;
+		}
+	}
+
+	CHECK(emptyRecordCount == 2);
+}
+
+TEST_CASE(DBPFFile_RejectsCompressedRecordDirectoryOutsideTheFile)
+{
+	TestUtil::TemporaryDirectory directory;
+	const std::filesystem::path path = directory.GetPath() / "test.dat";
+	REQUIRE(WriteTestFile(path));
+
+	std::vector<uint8_t> data;
+	REQUIRE(TestUtil::ReadFile(path, data));
+
+	const uint32_t indexCount = ReadUint32(data, IndexCountOffset);
+	const uint32_t indexOffset = ReadUint32(data, IndexOffsetOffset);
+
+	bool found = false;
+
+	for (uint32_t i = 0; i < indexCount; i++)
+	{
+		const size_t entryOffset = indexOffset + (static_cast<size_t>(i) * 20);
+
+		if (ReadUint32(data, entryOffset) == CompressedRecordDirectoryType)
+		{
+			WriteUint32(data, entryOffset + 16, 0x7FFFFFFF);
+			found = true;
+		}
+	}
+
+	REQUIRE(found);
+
+	DBPFFile file;
+	CHECK(!OpenModifiedFile(directory, data, file));
+}
+
+TEST_CASE(DBPFFile_ReadsTheExampleFiles)
+{
+	const std::filesystem::path examplesDirectory(EXAMPLES_DIRECTORY);
+
+	uint32_t fileCount = 0;
+
+	for (const auto& dirEntry : std::filesystem::directory_iterator(examplesDirectory))
+	{
+		if (dirEntry.path().extension() != ".dat")
+		{
+			continue;
+		}
+
+		DBPFFile file;
+		REQUIRE(file.Open(dirEntry.path()));
+		fileCount++;
+
+		CHECK(file.GetIndexEntryCount() > 0);
+
+		for (uint32_t i = 0; i < file.GetIndexEntryCount(); i++)
+		{
+			const DBPFFile::IndexEntry entry = file.GetIndexEntry(i);
+			const std::span<const uint8_t> recordData = file.GetRecordData(entry);
+
+			CHECK(recordData.size() == entry.size);
+
+			if (file.IsRecordCompressed(entry))
+			{
+				uint32_t uncompressedSize = 0;
+				std::vector<uint8_t> decompressed;
+
+				CHECK(QFSCompression::GetUncompressedSize(recordData, uncompressedSize));
+				CHECK(QFSCompression::Decompress(recordData, decompressed));
+				CHECK(decompressed.size() == uncompressedSize);
+			}
+		}
+	}
+
+	CHECK(fileCount > 0);
+}
@@ -0,0 +1,152 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ExemplarBuilder.h"
+#include <cstring>
+
+namespace
+{
+	constexpr uint16_t Uint32Type = 0x0300;
+	constexpr uint16_t Sint64Type = 0x0800;
+	constexpr uint16_t Float32Type = 0x0900;
+	constexpr uint16_t BoolType = 0x0B00;
+	constexpr uint16_t StringType = 0x0C00;
+
+	constexpr uint16_t SingleValueKeyType = 0x00;
+	constexpr uint16_t MultipleValueKeyType = 0x80;
+
+	void AppendUint16(std::vector<uint8_t>& data, uint16_t value)
+	{
+		data.push_back(static_cast<uint8_t>(value));
+		data.push_back(static_cast<uint8_t>(value >> 8));
+	}
+
+	void AppendUint32(std::vector<uint8_t>& data, uint32_t value)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			data.push_back(static_cast<uint8_t>(value >> (i * 8)));
+		}
+	}
+}
+
+ExemplarBuilder::ExemplarBuilder()
+	: parentCohort(), propertyCount(0), propertyData()
+{
+}
+
+ExemplarBuilder& ExemplarBuilder::SetParentCohort(uint32_t type, uint32_t group, uint32_t instance)
+{
+	parentCohort = { type, group, instance };
+	return *this;
+}
+
+ExemplarBuilder& ExemplarBuilder::AddUint32(uint32_t id, uint32_t value)
+{
+	AddProperty(id, Uint32Type, false, 1, &value, sizeof(value));
+	return *this;
+}
+
+ExemplarBuilder& ExemplarBuilder::AddUint32Array(uint32_t id, const std::vector<uint32_t>& values)
+{
+	AddProperty(
+		id,
+		Uint32Type,
+		true,
+		static_cast<uint32_t>(values.size()),
+		values.data(),
+		values.size() * sizeof(uint32_t));
+	return *this;
+}
+
+ExemplarBuilder& ExemplarBuilder::AddSint64(uint32_t id, int64_t value)
+{
+	AddProperty(id, Sint64Type, false, 1, &value, sizeof(value));
+	return *this;
+}
+
+ExemplarBuilder& ExemplarBuilder::AddFloat32(uint32_t id, float value)
+{
+	AddProperty(id, Float32Type, false, 1, &value, sizeof(value));
+	return *this;
+}
+
+ExemplarBuilder& ExemplarBuilder::AddBool(uint32_t id, bool value)
+{
+	const uint8_t byte = value ? 1 : 0;
+
+	AddProperty(id, BoolType, false, 1, &byte, sizeof(byte));
+	return *this;
+}
+
+ExemplarBuilder& ExemplarBuilder::AddString(uint32_t id, std::string_view value)
+{
+	AddProperty(id, StringType, true, static_cast<uint32_t>(value.size()), value.data(), value.size());
+	return *this;
+}
+
+std::vector<uint8_t> ExemplarBuilder::Build() const
+{
+	std::vector<uint8_t> data(8);
+	data.reserve(24 + propertyData.size());
+
+	std::memcpy(data.data(), "EQZB1###", 8);
+
+	for (uint32_t value : parentCohort)
+	{
+		AppendUint32(data, value);
+	}
+
+	AppendUint32(data, propertyCount);
+	data.insert(data.end(), propertyData.begin(), propertyData.end());
+
+	return data;
+}
+
+void ExemplarBuilder::AddProperty(
+	uint32_t id,
+	uint16_t valueType,
+	bool multipleValues,
+	uint32_t count,
+	const void* values,
+	size_t valuesSize)
+{
+	// The values are stored in little-endian order, the same as the test hosts.
+	AppendUint32(propertyData, id);
+	AppendUint16(propertyData, valueType);
+	AppendUint16(propertyData, multipleValues ? MultipleValueKeyType : SingleValueKeyType);
+	propertyData.push_back(0);
+
+	if (multipleValues)
+	{
+		AppendUint32(propertyData, count);
+	}
+
+	const size_t offset = propertyData.size();
+	propertyData.resize(offset + valuesSize);
+
+	if (valuesSize > 0)
+	{
+		std::memcpy(propertyData.data() + offset, values, valuesSize);
+	}
+
+	propertyCount++;
+}
@@ -0,0 +1,53 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Builds the data of an uncompressed binary (EQZB) exemplar.
+// The properties are written in the order that they are added, so the tests
+// can create exemplars with unsorted and duplicate property ids.
+class ExemplarBuilder
+{
+public:
+	ExemplarBuilder();
+
+	ExemplarBuilder& SetParentCohort(uint32_t type, uint32_t group, uint32_t instance);
+
+	ExemplarBuilder& AddUint32(uint32_t id, uint32_t value);
+	ExemplarBuilder& AddUint32Array(uint32_t id, const std::vector<uint32_t>& values);
+	ExemplarBuilder& AddSint64(uint32_t id, int64_t value);
+	ExemplarBuilder& AddFloat32(uint32_t id, float value);
+	ExemplarBuilder& AddBool(uint32_t id, bool value);
+	ExemplarBuilder& AddString(uint32_t id, std::string_view value);
+
+	std::vector<uint8_t> Build() const;
+
+private:
+	void AddProperty(uint32_t id, uint16_t valueType, bool multipleValues, uint32_t count, const void* values, size_t valuesSize);
+
+	std::array<uint32_t, 3> parentCohort;
+	uint32_t propertyCount;
+	std::vector<uint8_t> propertyData;
+};
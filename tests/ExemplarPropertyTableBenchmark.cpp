@@ -0,0 +1,133 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include "ExemplarBuilder.h"
+#include "ExemplarPropertyTable.h"
+#include "OrdiancePropertyIDs.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+	std::vector<uint8_t> CreateOrdinanceExemplar()
+	{
+		ExemplarBuilder builder;
+
+		builder.AddUint32(0x10, 14)
+			.AddUint32Array(kOrdinanceNameKey, { 0x2026960B, 0x6A231EAA, 1 })
+			.AddString(kOrdinanceName, "Benchmark Ordinance")
+			.AddUint32Array(kOrdinanceDescriptionKey, { 0x2026960B, 0x6A231EAA, 2 })
+			.AddString(kOrdinanceDescription, "An ordinance that is used by the benchmarks.")
+			.AddSint64(kOrdinanceEnactmentIncome, -100)
+			.AddSint64(kOrdinanceRetracmentIncome, 0)
+			.AddSint64(kOrdinancemMonthlyConstantIncome, -25)
+			.AddBool(kOrdinanceIsIncome, false)
+			.AddUint32(kOrdinanceAvailabilityGameYear, 2005);
+
+		// Unrelated properties, e.g. from a modding tool.
+		for (uint32_t i = 0; i < 32; i++)
+		{
+			builder.AddUint32(0x88000000 + i, i);
+		}
+
+		return builder.Build();
+	}
+
+	// The ids that are read when an ordinance is loaded, including properties
+	// that the exemplar does not have.
+	const std::vector<uint32_t> LookupIDs =
+	{
+		kOrdinanceNameKey,
+		kOrdinanceName,
+		kOrdinanceDescriptionKey,
+		kOrdinanceDescription,
+		kOrdinanceEnactmentIncome,
+		kOrdinanceRetracmentIncome,
+		kOrdinancemMonthlyConstantIncome,
+		kOrdinanceIsIncome,
+		kOrdinanceAvailabilityGameYear,
+		kOrdinanceAvailabilityMinPopulationResLowWealth,
+		kOrdinanceAvailabilityMinPopulationIHT,
+		kOrdinanceAvailabilityMinFireStationCount,
+		kOrdinanceAvailabilityMinSchoolBuildingCount,
+		kOrdinanceAvailabilityLuaFunction,
+	};
+}
+
+// Compares a lookup in the sorted table with a scan of the properties in
+// exemplar order, which is how a property list is searched.
+BENCHMARK(ExemplarPropertyTable_FindOrdinanceProperties)
+{
+	const std::vector<uint8_t> data = CreateOrdinanceExemplar();
+
+	ExemplarPropertyTable table;
+	table.Parse(data);
+
+	// The table properties are sorted by id, they are reversed so that the scan
+	// does not stop early because of the order.
+	std::vector<ExemplarPropertyTable::Property> unsortedProperties(table.GetProperties().begin(), table.GetProperties().end());
+	std::reverse(unsortedProperties.begin(), unsortedProperties.end());
+
+	Benchmark::Measure("parse the exemplar", [&]()
+	{
+		ExemplarPropertyTable parsed;
+		parsed.Parse(data);
+
+		Benchmark::Consume(parsed.GetProperties().size());
+	});
+
+	Benchmark::Measure("linear search, every ordinance id", [&]()
+	{
+		uint64_t sum = 0;
+
+		for (uint32_t id : LookupIDs)
+		{
+			const auto it = std::ranges::find_if(
+				unsortedProperties,
+				[id](const ExemplarPropertyTable::Property& property) { return property.id == id; });
+
+			if (it != unsortedProperties.end())
+			{
+				sum += it->offset;
+			}
+		}
+
+		Benchmark::Consume(sum);
+	});
+
+	Benchmark::Measure("property table, every ordinance id", [&]()
+	{
+		uint64_t sum = 0;
+
+		for (uint32_t id : LookupIDs)
+		{
+			const ExemplarPropertyTable::Property* property = table.Find(id);
+
+			if (property)
+			{
+				sum += property->offset;
+			}
+		}
+
+		Benchmark::Consume(sum);
+	});
+}
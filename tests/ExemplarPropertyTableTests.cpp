@@ -0,0 +1,209 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ExemplarBuilder.h"
+#include "ExemplarPropertyTable.h"
+#include "TestFramework.h"
+#include "TestUtil.h"
+#include <array>
+#include <string_view>
+#include <vector>
+
+using ValueType = ExemplarPropertyTable::ValueType;
+
+TEST_CASE(ExemplarPropertyTable_SortsTheProperties)
+{
+	const std::vector<uint8_t> data = ExemplarBuilder()
+		.AddUint32(0x30, 3)
+		.AddUint32(0x10, 1)
+		.AddUint32(0x20, 2)
+		.Build();
+
+	ExemplarPropertyTable table;
+	REQUIRE(table.Parse(data));
+
+	const std::span<const ExemplarPropertyTable::Property> properties = table.GetProperties();
+	REQUIRE(properties.size() == 3);
+	CHECK(properties[0].id == 0x10);
+	CHECK(properties[1].id == 0x20);
+	CHECK(properties[2].id == 0x30);
+
+	for (uint32_t id = 1; id <= 3; id++)
+	{
+		uint32_t value = 0;
+		CHECK(table.GetPropertyValue(id * 0x10, value));
+		CHECK(value == id);
+	}
+
+	CHECK(table.Find(0x15) == nullptr);
+	CHECK(table.Find(0) == nullptr);
+	CHECK(table.Find(0xFFFFFFFF) == nullptr);
+}
+
+TEST_CASE(ExemplarPropertyTable_DuplicatePropertiesUseTheLastValue)
+{
+	const std::vector<uint8_t> data = ExemplarBuilder()
+		.AddUint32(0x20, 1)
+		.AddString(0x10, "first")
+		.AddUint32(0x20, 2)
+		.AddUint32(0x05, 5)
+		.AddString(0x10, "second")
+		.AddUint32(0x20, 3)
+		.Build();
+
+	ExemplarPropertyTable table;
+	REQUIRE(table.Parse(data));
+	CHECK(table.GetProperties().size() == 3);
+
+	uint32_t value = 0;
+	CHECK(table.GetPropertyValue(0x20, value));
+	CHECK(value == 3);
+
+	std::string_view text;
+	CHECK(table.GetPropertyValue(0x10, text));
+	CHECK(text == "second");
+
+	CHECK(table.GetPropertyValue(0x05, value));
+	CHECK(value == 5);
+
+	// The last property is used even when it has a different type.
+	const std::vector<uint8_t> changedType = ExemplarBuilder()
+		.AddUint32(0x20, 1)
+		.AddString(0x20, "text")
+		.Build();
+
+	REQUIRE(table.Parse(changedType));
+	CHECK(!table.GetPropertyValue(0x20, value));
+	CHECK(table.GetPropertyValue(0x20, text));
+	CHECK(text == "text");
+}
+
+TEST_CASE(ExemplarPropertyTable_ConvertsTheValues)
+{
+	const std::vector<uint8_t> data = ExemplarBuilder()
+		.AddUint32(0x01, 42)
+		.AddSint64(0x02, -5)
+		.AddSint64(0x03, 0x100000000)
+		.AddFloat32(0x04, 1.5f)
+		.AddBool(0x05, true)
+		.AddString(0x06, "Name")
+		.AddUint32Array(0x07, { 1, 2, 3 })
+		.AddUint32Array(0x08, {})
+		.Build();
+
+	ExemplarPropertyTable table;
+	REQUIRE(table.Parse(data));
+	CHECK(!table.HasParentCohort());
+
+	uint32_t uintValue = 0;
+	int64_t sint64Value = 0;
+	float floatValue = 0;
+	bool boolValue = false;
+	std::string_view stringValue;
+
+	CHECK(table.GetPropertyValue(0x01, uintValue) && uintValue == 42);
+	CHECK(table.GetPropertyValue(0x01, sint64Value) && sint64Value == 42);
+	CHECK(table.GetPropertyValue(0x02, sint64Value) && sint64Value == -5);
+	CHECK(table.GetPropertyValue(0x03, sint64Value) && sint64Value == 0x100000000);
+	CHECK(table.GetPropertyValue(0x04, floatValue) && floatValue == 1.5f);
+	CHECK(table.GetPropertyValue(0x05, boolValue) && boolValue);
+	CHECK(table.GetPropertyValue(0x06, stringValue) && stringValue == "Name");
+	CHECK(table.GetPropertyValue(0x07, uintValue) && uintValue == 1);
+
+	// Values that are out of range or have the wrong type are rejected.
+	CHECK(!table.GetPropertyValue(0x02, uintValue));
+	CHECK(!table.GetPropertyValue(0x03, uintValue));
+	CHECK(!table.GetPropertyValue(0x01, floatValue));
+	CHECK(!table.GetPropertyValue(0x01, boolValue));
+	CHECK(!table.GetPropertyValue(0x01, stringValue));
+	CHECK(!table.GetPropertyValue(0x04, uintValue));
+	CHECK(!table.GetPropertyValue(0x06, uintValue));
+	CHECK(!table.GetPropertyValue(0x08, uintValue));
+
+	std::array<uint32_t, 3> values{};
+	CHECK(table.GetPropertyValues(0x07, values));
+	CHECK(values == (std::array<uint32_t, 3>{ 1, 2, 3 }));
+
+	std::array<uint32_t, 2> tooFewValues{};
+	CHECK(!table.GetPropertyValues(0x07, tooFewValues));
+	CHECK(!table.GetPropertyValues(0x10, values));
+}
+
+TEST_CASE(ExemplarPropertyTable_ReportsTheParentCohort)
+{
+	const std::vector<uint8_t> data = ExemplarBuilder()
+		.SetParentCohort(0x05342861, 0x1, 0x2)
+		.AddUint32(0x10, 1)
+		.Build();
+
+	ExemplarPropertyTable table;
+	REQUIRE(table.Parse(data));
+	CHECK(table.HasParentCohort());
+
+	table.Clear();
+	CHECK(table.IsEmpty());
+	CHECK(!table.HasParentCohort());
+}
+
+TEST_CASE(ExemplarPropertyTable_RejectsInvalidData)
+{
+	const std::vector<uint8_t> data = ExemplarBuilder()
+		.AddUint32Array(0x10, { 1, 2, 3 })
+		.AddString(0x20, "Name")
+		.Build();
+
+	ExemplarPropertyTable table;
+
+	for (size_t length = 0; length < data.size(); length++)
+	{
+		const std::vector<uint8_t> truncated(data.begin(), data.begin() + length);
+
+		CHECK(!table.Parse(truncated));
+		CHECK(table.IsEmpty());
+	}
+
+	CHECK(!table.Parse(TestUtil::ToBytes("EQZT1###\r\nParentCohort=Key:{0x00000000,0x00000000,0x00000000}\r\n")));
+
+	// A property count that is larger than the data can hold.
+	std::vector<uint8_t> badCount = data;
+	badCount[23] = 0x10;
+	CHECK(!table.Parse(badCount));
+
+	// An unknown value type, the first property header starts at offset 24.
+	std::vector<uint8_t> badValueType = data;
+	badValueType[28] = 0x55;
+	CHECK(!table.Parse(badValueType));
+
+	// An unknown key type.
+	std::vector<uint8_t> badKeyType = data;
+	badKeyType[30] = 0x40;
+	CHECK(!table.Parse(badKeyType));
+
+	// An array value count that exceeds the data.
+	std::vector<uint8_t> badValueCount = data;
+	badValueCount[36] = 0x10;
+	CHECK(!table.Parse(badValueCount));
+
+	// A failed parse clears the previous properties.
+	REQUIRE(table.Parse(data));
+	CHECK(!table.Parse(badValueType));
+	CHECK(table.IsEmpty());
+}
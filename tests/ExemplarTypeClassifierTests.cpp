@@ -0,0 +1,254 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ExemplarBuilder.h"
+#include "ExemplarTypeClassifier.h"
+#include "TestFramework.h"
+#include "TestUtil.h"
+#include <string_view>
+#include <vector>
+
+using Result = ExemplarTypeClassifier::Result;
+
+namespace
+{
+	constexpr uint32_t ExemplarTypePropertyID = 0x10;
+	constexpr uint32_t OrdinanceExemplarType = 14;
+	constexpr uint32_t BuildingExemplarType = 2;
+	constexpr uint32_t OtherPropertyID = 0x20;
+
+	Result Classify(const std::vector<uint8_t>& data, uint32_t& exemplarType)
+	{
+		exemplarType = 0;
+		return ExemplarTypeClassifier::GetExemplarType(data, exemplarType);
+	}
+
+	Result ClassifyText(std::string_view text, uint32_t& exemplarType)
+	{
+		return Classify(TestUtil::ToBytes(text), exemplarType);
+	}
+}
+
+TEST_CASE(ExemplarTypeClassifier_Binary_FindsTheExemplarType)
+{
+	const std::vector<uint8_t> data = ExemplarBuilder()
+		.AddString(OtherPropertyID, "Name")
+		.AddUint32Array(0x30, { 1, 2, 3 })
+		.AddUint32(ExemplarTypePropertyID, OrdinanceExemplarType)
+		.AddFloat32(0x40, 1.5f)
+		.Build();
+
+	uint32_t exemplarType = 0;
+	CHECK(Classify(data, exemplarType) == Result::Found);
+	CHECK(exemplarType == OrdinanceExemplarType);
+}
+
+TEST_CASE(ExemplarTypeClassifier_Binary_UsesTheLastDuplicateProperty)
+{
+	const std::vector<uint8_t> data = ExemplarBuilder()
+		.AddUint32(ExemplarTypePropertyID, BuildingExemplarType)
+		.AddUint32(OtherPropertyID, 5)
+		.AddUint32(ExemplarTypePropertyID, OrdinanceExemplarType)
+		.Build();
+
+	uint32_t exemplarType = 0;
+	CHECK(Classify(data, exemplarType) == Result::Found);
+	CHECK(exemplarType == OrdinanceExemplarType);
+
+	// A later string value replaces the earlier numeric value.
+	const std::vector<uint8_t> stringLast = ExemplarBuilder()
+		.AddUint32(ExemplarTypePropertyID, OrdinanceExemplarType)
+		.AddString(ExemplarTypePropertyID, "14")
+		.Build();
+
+	CHECK(Classify(stringLast, exemplarType) == Result::NotFound);
+}
+
+TEST_CASE(ExemplarTypeClassifier_Binary_ReadsOtherNumericTypes)
+{
+	uint32_t exemplarType = 0;
+
+	CHECK(Classify(ExemplarBuilder().AddUint32Array(ExemplarTypePropertyID, { OrdinanceExemplarType, 1 }).Build(), exemplarType) == Result::Found);
+	CHECK(exemplarType == OrdinanceExemplarType);
+
+	CHECK(Classify(ExemplarBuilder().AddSint64(ExemplarTypePropertyID, OrdinanceExemplarType).Build(), exemplarType) == Result::Found);
+	CHECK(exemplarType == OrdinanceExemplarType);
+
+	CHECK(Classify(ExemplarBuilder().AddUint32Array(ExemplarTypePropertyID, {}).Build(), exemplarType) == Result::NotFound);
+}
+
+TEST_CASE(ExemplarTypeClassifier_Binary_ReportsMissingAndInheritedTypes)
+{
+	uint32_t exemplarType = 0;
+
+	CHECK(Classify(ExemplarBuilder().AddUint32(OtherPropertyID, 1).Build(), exemplarType) == Result::NotFound);
+	CHECK(Classify(ExemplarBuilder().Build(), exemplarType) == Result::NotFound);
+
+	const std::vector<uint8_t> inherited = ExemplarBuilder()
+		.SetParentCohort(0x05342861, 0x1, 0x2)
+		.AddUint32(OtherPropertyID, 1)
+		.Build();
+
+	CHECK(Classify(inherited, exemplarType) == Result::Inherited);
+
+	// A type that is set in the exemplar overrides the parent cohort.
+	const std::vector<uint8_t> overridden = ExemplarBuilder()
+		.SetParentCohort(0x05342861, 0x1, 0x2)
+		.AddUint32(ExemplarTypePropertyID, OrdinanceExemplarType)
+		.Build();
+
+	CHECK(Classify(overridden, exemplarType) == Result::Found);
+	CHECK(exemplarType == OrdinanceExemplarType);
+}
+
+TEST_CASE(ExemplarTypeClassifier_Binary_RejectsInvalidData)
+{
+	const std::vector<uint8_t> data = ExemplarBuilder()
+		.AddUint32Array(OtherPropertyID, { 1, 2, 3 })
+		.AddUint32(ExemplarTypePropertyID, OrdinanceExemplarType)
+		.Build();
+
+	uint32_t exemplarType = 0;
+
+	// Every truncation of the exemplar is rejected, the type property is the
+	// last value in the data.
+	for (size_t length = 0; length < data.size(); length++)
+	{
+		const std::vector<uint8_t> truncated(data.begin(), data.begin() + length);
+
+		CHECK(Classify(truncated, exemplarType) == Result::InvalidData);
+	}
+
+	// Property count larger than the data.
+	std::vector<uint8_t> badCount = data;
+	badCount[20] = 3;
+	CHECK(Classify(badCount, exemplarType) == Result::InvalidData);
+
+	// Unknown value type, the first property header starts at offset 24.
+	std::vector<uint8_t> badValueType = data;
+	badValueType[28] = 0x55;
+	CHECK(Classify(badValueType, exemplarType) == Result::InvalidData);
+
+	// Unknown key type.
+	std::vector<uint8_t> badKeyType = data;
+	badKeyType[30] = 0x40;
+	CHECK(Classify(badKeyType, exemplarType) == Result::InvalidData);
+
+	// An array value count that exceeds the data, the count follows the 9 byte
+	// property header.
+	std::vector<uint8_t> badValueCount = data;
+	badValueCount[33] = 0xFF;
+	badValueCount[34] = 0xFF;
+	badValueCount[35] = 0xFF;
+	badValueCount[36] = 0xFF;
+	CHECK(Classify(badValueCount, exemplarType) == Result::InvalidData);
+}
+
+TEST_CASE(ExemplarTypeClassifier_RejectsUnsupportedFormats)
+{
+	uint32_t exemplarType = 0;
+
+	CHECK(ClassifyText("Not an exemplar", exemplarType) == Result::UnsupportedFormat);
+	CHECK(ClassifyText("EQZ", exemplarType) == Result::InvalidData);
+}
+
+TEST_CASE(ExemplarTypeClassifier_Text_FindsTheExemplarType)
+{
+	uint32_t exemplarType = 0;
+
+	CHECK(ClassifyText(
+		"EQZT1###\r\n"
+		"ParentCohort=Key:{0x00000000,0x00000000,0x00000000}\r\n"
+		"PropCount=0x00000002\r\n"
+		"0x00000020:{\"Exemplar Name\"}=String:1:{\"Test\"}\r\n"
+		"0x00000010:{\"Exemplar Type\"}=Uint32:0:{0x0000000E}\r\n",
+		exemplarType) == Result::Found);
+	CHECK(exemplarType == OrdinanceExemplarType);
+
+	// Decimal values, LF line endings and leading whitespace.
+	CHECK(ClassifyText(
+		"EQZT1###\n"
+		"  0x00000010:{\"Exemplar Type\"}=Uint32:0:{14}\n",
+		exemplarType) == Result::Found);
+	CHECK(exemplarType == OrdinanceExemplarType);
+}
+
+TEST_CASE(ExemplarTypeClassifier_Text_UsesTheLastDuplicateProperty)
+{
+	uint32_t exemplarType = 0;
+
+	CHECK(ClassifyText(
+		"EQZT1###\r\n"
+		"0x00000010:{\"Exemplar Type\"}=Uint32:0:{0x00000002}\r\n"
+		"0x00000010:{\"Exemplar Type\"}=Uint32:0:{0x0000000E}\r\n",
+		exemplarType) == Result::Found);
+	CHECK(exemplarType == OrdinanceExemplarType);
+
+	CHECK(ClassifyText(
+		"EQZT1###\r\n"
+		"0x00000010:{\"Exemplar Type\"}=Uint32:0:{0x0000000E}\r\n"
+		"0x00000010:{\"Exemplar Type\"}=String:1:{\"Ordinance\"}\r\n",
+		exemplarType) == Result::NotFound);
+}
+
+TEST_CASE(ExemplarTypeClassifier_Text_ReportsMissingAndInheritedTypes)
+{
+	uint32_t exemplarType = 0;
+
+	CHECK(ClassifyText(
+		"EQZT1###\r\n"
+		"ParentCohort=Key:{0x00000000,0x00000000,0x00000000}\r\n"
+		"0x00000020:{\"Exemplar Name\"}=String:1:{\"Test\"}\r\n",
+		exemplarType) == Result::NotFound);
+
+	CHECK(ClassifyText(
+		"EQZT1###\r\n"
+		"ParentCohort=Key:{0x05342861,0x00000001,0x00000002}\r\n"
+		"0x00000020:{\"Exemplar Name\"}=String:1:{\"Test\"}\r\n",
+		exemplarType) == Result::Inherited);
+
+	CHECK(ClassifyText(
+		"EQZT1###\r\n"
+		"ParentCohort=Key:{0x05342861,0x00000001,0x00000002}\r\n"
+		"0x00000010:{\"Exemplar Type\"}=Uint32:0:{0x0000000E}\r\n",
+		exemplarType) == Result::Found);
+	CHECK(exemplarType == OrdinanceExemplarType);
+}
+
+TEST_CASE(ExemplarTypeClassifier_Text_RejectsInvalidData)
+{
+	uint32_t exemplarType = 0;
+
+	CHECK(ClassifyText(
+		"EQZT1###\r\n"
+		"0x00000010:{\"Exemplar Type\"}\r\n",
+		exemplarType) == Result::InvalidData);
+
+	CHECK(ClassifyText(
+		"EQZT1###\r\n"
+		"0x00000010:{\"Exemplar Type\"}=Uint32:0:0x0000000E\r\n",
+		exemplarType) == Result::InvalidData);
+
+	CHECK(ClassifyText(
+		"EQZT1###\r\n"
+		"0x00000010:{\"Exemplar Type\"}=Uint32:0:{Ordinance}\r\n",
+		exemplarType) == Result::InvalidData);
+}
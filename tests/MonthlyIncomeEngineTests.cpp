@@ -0,0 +1,267 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MonthlyIncomeEngine.h"
+#include "BuildingCountIncomeFactor.h"
+#include "CityStatsSnapshot.h"
+#include "CityStatsTestData.h"
+#include "CpuFeatureUtil.h"
+#include "OrdinanceDefinitionTestData.h"
+#include "RCIGroupPopulationIncomeFactor.h"
+#include "TestFramework.h"
+#include "TotalResidentialPopulationIncomeFactor.h"
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace CityStatsTestData;
+using namespace OrdinanceDefinitionTestData;
+
+namespace
+{
+	using DefinitionList = std::vector<std::shared_ptr<const OrdinanceDefinition>>;
+
+	// An engine for each kernel that this CPU supports, the scalar kernel is first.
+	std::vector<std::unique_ptr<MonthlyIncomeEngine>> CreateEngines(const DefinitionList& definitions)
+	{
+		std::vector<std::unique_ptr<MonthlyIncomeEngine>> engines;
+		engines.push_back(std::make_unique<MonthlyIncomeEngine>(false));
+
+		if (CpuFeatureUtil::IsAvxSupported())
+		{
+			engines.push_back(std::make_unique<MonthlyIncomeEngine>(true));
+		}
+
+		for (auto& engine : engines)
+		{
+			engine->Compile(definitions);
+		}
+
+		return engines;
+	}
+
+	// Fills the snapshot from its source, the engines compute the incomes again
+	// when they see the new epoch.
+	const OrdinanceProgram::MetricValues& RefreshSnapshot()
+	{
+		CityStatsSnapshot& snapshot = CityStatsSnapshot::GetInstance();
+		snapshot.Invalidate();
+		snapshot.Update();
+
+		return snapshot.GetMetricValues();
+	}
+
+	std::shared_ptr<const OrdinanceDefinition> CreateDefinition(
+		uint32_t instance,
+		int64_t monthlyConstantIncome,
+		OrdinanceDefinition::MonthlyIncomeFactorList&& incomeFactors)
+	{
+		return OrdinanceDefinition::Create(
+			cGZPersistResourceKey(0x6534284A, 0x4A5E8EF6, instance),
+			OrdinanceDefinition::AvailabilityConditionList(),
+			std::move(incomeFactors),
+			cRZBaseString("Test Ordinance"),
+			StringResourceKey(),
+			cRZBaseString(),
+			StringResourceKey(),
+			0,
+			0,
+			monthlyConstantIncome,
+			false);
+	}
+
+	double CalculateProgramIncome(const OrdinanceDefinition& definition, const OrdinanceProgram::MetricValues& metrics)
+	{
+		return definition.GetProgram().CalculateMonthlyIncome(
+			static_cast<double>(definition.GetMonthlyConstantIncome()),
+			metrics);
+	}
+}
+
+TEST_CASE(MonthlyIncomeEngine_KernelsMatchTheProgram)
+{
+	std::mt19937 random(1);
+
+	// The row count is not a multiple of the kernel width, and some of the slots
+	// are empty.
+	constexpr size_t DefinitionCount = 203;
+
+	DefinitionList definitions;
+
+	for (size_t i = 0; i < DefinitionCount; i++)
+	{
+		definitions.push_back((i % 50) == 7 ? nullptr : CreateRandomDefinition(random, static_cast<uint32_t>(0x1000 + i)));
+	}
+
+	const auto engines = CreateEngines(definitions);
+
+	TestCityStatsSource source;
+	ScopedCityStatsSource scopedSource(&source);
+
+	for (int iteration = 0; iteration < 20; iteration++)
+	{
+		source.Randomize(random);
+		const OrdinanceProgram::MetricValues& metrics = RefreshSnapshot();
+
+		for (size_t slot = 0; slot < definitions.size(); slot++)
+		{
+			const OrdinanceDefinition* pDefinition = definitions[slot].get();
+
+			for (const auto& engine : engines)
+			{
+				double monthlyIncome = 0;
+				bool inRange = false;
+
+				if (!pDefinition)
+				{
+					CHECK(!engine->TryGetMonthlyIncome(slot, pDefinition, monthlyIncome, inRange));
+					continue;
+				}
+
+				REQUIRE(engine->TryGetMonthlyIncome(slot, pDefinition, monthlyIncome, inRange));
+
+				// The kernels add the factors in the same order as the program, the
+				// result is exactly the same.
+				CHECK(monthlyIncome == CalculateProgramIncome(*pDefinition, metrics));
+				CHECK(inRange);
+			}
+		}
+	}
+}
+
+TEST_CASE(MonthlyIncomeEngine_SkipsTheColumnsThatAreZero)
+{
+	OrdinanceDefinition::MonthlyIncomeFactorList zeroFactors;
+	// No other ordinance uses this metric, its column is zero.
+	zeroFactors.push_back(std::make_unique<TotalResidentialPopulationIncomeFactor>(0.0f));
+
+	OrdinanceDefinition::MonthlyIncomeFactorList factors;
+	factors.push_back(std::make_unique<RCIGroupPopulationIncomeFactor>(RCIGroup::Res1, 0.5f));
+	factors.push_back(std::make_unique<BuildingCountIncomeFactor>(BuildingType::School, -2.0f));
+
+	const DefinitionList definitions
+	{
+		CreateDefinition(0x1001, 100, OrdinanceDefinition::MonthlyIncomeFactorList()),
+		CreateDefinition(0x1002, -25, std::move(zeroFactors)),
+		CreateDefinition(0x1003, 10, std::move(factors)),
+		// The constant incomes are converted to 2^63 and -2^63, which are
+		// outside of the range that SafeCast accepts.
+		CreateDefinition(0x1004, std::numeric_limits<int64_t>::max(), OrdinanceDefinition::MonthlyIncomeFactorList()),
+		CreateDefinition(0x1005, std::numeric_limits<int64_t>::min(), OrdinanceDefinition::MonthlyIncomeFactorList()),
+	};
+
+	TestCityStatsSource source;
+	source.totalResidentialPopulation = 50000;
+	source.rciGroupPopulations[0] = 3000;
+	source.buildingCounts[static_cast<size_t>(BuildingType::School)] = 4;
+	ScopedCityStatsSource scopedSource(&source);
+
+	const OrdinanceProgram::MetricValues& metrics = RefreshSnapshot();
+
+	const double expectedIncomes[] = { 100.0, -25.0, 1502.0 };
+
+	for (const auto& engine : CreateEngines(definitions))
+	{
+		for (size_t slot = 0; slot < definitions.size(); slot++)
+		{
+			double monthlyIncome = 0;
+			bool inRange = false;
+
+			REQUIRE(engine->TryGetMonthlyIncome(slot, definitions[slot].get(), monthlyIncome, inRange));
+			CHECK(monthlyIncome == CalculateProgramIncome(*definitions[slot], metrics));
+
+			if (slot < 3)
+			{
+				CHECK(monthlyIncome == expectedIncomes[slot]);
+				CHECK(inRange);
+			}
+			else
+			{
+				CHECK(!inRange);
+			}
+		}
+	}
+
+	// The engine has no active columns when none of the ordinances have an
+	// income factor, and no rows when there are no ordinances.
+	const DefinitionList constantDefinitions{ definitions[0], nullptr };
+
+	for (const auto& engine : CreateEngines(constantDefinitions))
+	{
+		double monthlyIncome = 0;
+		bool inRange = false;
+
+		REQUIRE(engine->TryGetMonthlyIncome(0, constantDefinitions[0].get(), monthlyIncome, inRange));
+		CHECK(monthlyIncome == 100.0);
+		CHECK(inRange);
+		CHECK(!engine->TryGetMonthlyIncome(1, definitions[0].get(), monthlyIncome, inRange));
+
+		engine->Compile(DefinitionList());
+		CHECK(!engine->TryGetMonthlyIncome(0, definitions[0].get(), monthlyIncome, inRange));
+	}
+}
+
+TEST_CASE(MonthlyIncomeEngine_ComputesTheIncomesOncePerSnapshot)
+{
+	OrdinanceDefinition::MonthlyIncomeFactorList factors;
+	factors.push_back(std::make_unique<TotalResidentialPopulationIncomeFactor>(1.0f));
+
+	const DefinitionList definitions{ CreateDefinition(0x1001, 0, std::move(factors)) };
+	const OrdinanceDefinition* pDefinition = definitions[0].get();
+
+	MonthlyIncomeEngine engine;
+	engine.Compile(definitions);
+
+	double monthlyIncome = 0;
+	bool inRange = false;
+
+	{
+		TestCityStatsSource source;
+		source.totalResidentialPopulation = 100;
+		ScopedCityStatsSource scopedSource(&source);
+
+		RefreshSnapshot();
+		REQUIRE(engine.TryGetMonthlyIncome(0, pDefinition, monthlyIncome, inRange));
+		CHECK(monthlyIncome == 100.0);
+
+		// The ordinances read the incomes that were computed from the current
+		// snapshot, the city is not queried again.
+		source.totalResidentialPopulation = 200;
+		REQUIRE(engine.TryGetMonthlyIncome(0, pDefinition, monthlyIncome, inRange));
+		CHECK(monthlyIncome == 100.0);
+
+		RefreshSnapshot();
+		REQUIRE(engine.TryGetMonthlyIncome(0, pDefinition, monthlyIncome, inRange));
+		CHECK(monthlyIncome == 200.0);
+
+		// The ordinance computes its own income if it no longer uses the definition
+		// that the slot was compiled from.
+		const auto otherDefinition = CreateDefinition(0x1001, 0, OrdinanceDefinition::MonthlyIncomeFactorList());
+
+		CHECK(!engine.TryGetMonthlyIncome(0, otherDefinition.get(), monthlyIncome, inRange));
+		CHECK(!engine.TryGetMonthlyIncome(0, nullptr, monthlyIncome, inRange));
+		CHECK(!engine.TryGetMonthlyIncome(1, pDefinition, monthlyIncome, inRange));
+	}
+
+	// The incomes are not available without a city.
+	CHECK(!engine.TryGetMonthlyIncome(0, pDefinition, monthlyIncome, inRange));
+}
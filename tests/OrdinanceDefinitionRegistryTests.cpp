@@ -0,0 +1,254 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CompiledOrdinancePackWriter.h"
+#include "DBPFWriter.h"
+#include "ExemplarBuilder.h"
+#include "OrdiancePropertyIDs.h"
+#include "OrdinanceDefinitionRegistry.h"
+#include "OrdinanceDefinitionTestData.h"
+#include "OrdinanceDiscoveryPipeline.h"
+#include "TestFramework.h"
+#include "TestUtil.h"
+#include <string>
+#include <vector>
+
+using namespace OrdinanceDefinitionTestData;
+
+namespace
+{
+	constexpr uint32_t ExemplarTypeID = 0x6534284A;
+	constexpr uint32_t GroupID = 0x4A5E8EF6;
+	constexpr uint32_t ExemplarTypePropertyID = 0x10;
+	constexpr uint32_t OrdinanceExemplarType = 14;
+	constexpr uint32_t FirstInstance = 0x1000;
+	constexpr uint32_t OrdinanceCount = 50;
+
+	std::string GetOrdinanceName(uint32_t index)
+	{
+		return "Ordinance " + std::to_string(index);
+	}
+
+	bool WriteOrdinanceFile(const std::filesystem::path& path)
+	{
+		std::vector<std::vector<uint8_t>> records;
+		records.reserve(OrdinanceCount);
+
+		DBPFWriter writer;
+
+		for (uint32_t i = 0; i < OrdinanceCount; i++)
+		{
+			records.push_back(ExemplarBuilder()
+				.AddUint32(ExemplarTypePropertyID, OrdinanceExemplarType)
+				.AddString(kOrdinanceName, GetOrdinanceName(i))
+				.Build());
+
+			// Every other record is compressed.
+			std::vector<uint8_t>& record = records.back();
+			const bool compressed = (i % 2) != 0;
+
+			if (compressed)
+			{
+				record = TestUtil::CompressWithLiterals(record);
+			}
+
+			if (!writer.Add(ExemplarTypeID, GroupID, FirstInstance + i, record, compressed))
+			{
+				return false;
+			}
+		}
+
+		DBPFWriter::Statistics statistics{};
+
+		return writer.Save(path, statistics);
+	}
+
+	// Discovers the ordinances in the same way as the director, see
+	// ReadCustomOrdinanceFiles in CustomOrdinanceHostDllDirector.cpp.
+	bool DiscoverOrdinances(
+		const std::filesystem::path& path,
+		std::vector<OrdinanceDiscoveryPipeline::DiscoveredExemplar>& ordinances)
+	{
+		std::vector<OrdinanceDiscoveryPipeline::DiscoveredExemplar> results;
+		OrdinanceDiscoveryPipeline(2).Run(
+			std::vector<std::filesystem::path>{ path },
+			results,
+			[](const cGZPersistResourceKey&) { return true; });
+
+		for (OrdinanceDiscoveryPipeline::DiscoveredExemplar& result : results)
+		{
+			if (result.status == OrdinanceDiscoveryPipeline::ExemplarStatus::Ordinance)
+			{
+				ordinances.push_back(std::move(result));
+			}
+		}
+
+		return ordinances.size() == OrdinanceCount;
+	}
+
+	bool HasExpectedDefinitions(OrdinanceDefinitionRegistry& registry)
+	{
+		if (registry.GetCount() != OrdinanceCount)
+		{
+			return false;
+		}
+
+		for (uint32_t i = 0; i < OrdinanceCount; i++)
+		{
+			const size_t index = registry.Find(FirstInstance + i);
+
+			if (index == OrdinanceDefinitionRegistry::npos)
+			{
+				return false;
+			}
+
+			const std::shared_ptr<const OrdinanceDefinition> definition = registry.GetDefinition(index);
+
+			if (!definition
+				|| definition->GetKey().instance != FirstInstance + i
+				|| definition->GetName().ToChar() != GetOrdinanceName(i)
+				// The definition is created once and then shared.
+				|| registry.GetDefinition(index) != definition)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// The registry never loads an exemplar from the game's resource manager, the
+	// definitions must all be created from the properties that the discovery
+	// decoded.
+	// The exemplar is only loaded by the ordinance's property holder, if the game
+	// reads the ordinance's properties.
+	void CheckNoExemplarWasLoaded()
+	{
+		const CallCounts& counts = GetCallCounts();
+
+		CHECK(counts.createdWithoutProperties == 0);
+		CHECK(counts.createdWithExemplar == 0);
+	}
+}
+
+TEST_CASE(OrdinanceDefinitionRegistry_CreatesDefinitionsFromTheDiscoveredProperties)
+{
+	TestUtil::TemporaryDirectory directory;
+	const std::filesystem::path path = directory.GetPath() / "ordinances.dat";
+	REQUIRE(WriteOrdinanceFile(path));
+
+	std::vector<OrdinanceDiscoveryPipeline::DiscoveredExemplar> ordinances;
+	REQUIRE(DiscoverOrdinances(path, ordinances));
+
+	ResetCallCounts();
+
+	OrdinanceDefinitionRegistry registry;
+	registry.Reserve(ordinances.size());
+
+	for (OrdinanceDiscoveryPipeline::DiscoveredExemplar& item : ordinances)
+	{
+		registry.Add(item.key, nullptr, std::move(item.properties));
+	}
+
+	registry.BuildLookupTable();
+
+	CHECK(HasExpectedDefinitions(registry));
+	CheckNoExemplarWasLoaded();
+	CHECK(GetCallCounts().createdFromPropertyTable == OrdinanceCount);
+
+	registry.Clear();
+}
+
+TEST_CASE(OrdinanceDefinitionRegistry_PrefetchedDefinitionsUseTheDiscoveredProperties)
+{
+	TestUtil::TemporaryDirectory directory;
+	const std::filesystem::path path = directory.GetPath() / "ordinances.dat";
+	REQUIRE(WriteOrdinanceFile(path));
+
+	std::vector<OrdinanceDiscoveryPipeline::DiscoveredExemplar> ordinances;
+	REQUIRE(DiscoverOrdinances(path, ordinances));
+
+	ResetCallCounts();
+
+	OrdinanceDefinitionRegistry registry;
+
+	for (OrdinanceDiscoveryPipeline::DiscoveredExemplar& item : ordinances)
+	{
+		registry.Add(item.key, nullptr, std::move(item.properties));
+	}
+
+	registry.BuildLookupTable();
+	registry.StartPrefetch();
+
+	// The definitions that the prefetcher has not reached yet are created on
+	// this thread, either way they are created from the decoded properties.
+	CHECK(HasExpectedDefinitions(registry));
+	registry.StopPrefetch();
+
+	const CallCounts& counts = GetCallCounts();
+
+	CheckNoExemplarWasLoaded();
+	CHECK(counts.createdFromDecoded + counts.createdFromPropertyTable == OrdinanceCount);
+	CHECK(counts.createdFromDecoded <= counts.decodedFromPropertyTable);
+
+	registry.Clear();
+}
+
+TEST_CASE(OrdinanceDefinitionRegistry_CreatesDefinitionsFromTheCompiledPack)
+{
+	TestUtil::TemporaryDirectory directory;
+	const std::filesystem::path path = directory.GetPath() / "ordinances.dat";
+	const std::filesystem::path packPath = directory.GetPath() / "ordinances.pack";
+	REQUIRE(WriteOrdinanceFile(path));
+
+	std::vector<OrdinanceDiscoveryPipeline::DiscoveredExemplar> ordinances;
+	REQUIRE(DiscoverOrdinances(path, ordinances));
+
+	CompiledOrdinancePackWriter writer;
+
+	for (const OrdinanceDiscoveryPipeline::DiscoveredExemplar& item : ordinances)
+	{
+		REQUIRE(writer.Add(item.key.type, item.key.group, item.key.instance, item.properties));
+	}
+
+	REQUIRE(writer.Save(packPath));
+
+	CompiledOrdinancePack pack;
+	REQUIRE(pack.Open(packPath));
+
+	ResetCallCounts();
+
+	OrdinanceDefinitionRegistry registry;
+	registry.AddCompiledPack(std::move(pack));
+	registry.BuildLookupTable();
+	registry.StartPrefetch();
+
+	CHECK(HasExpectedDefinitions(registry));
+	registry.StopPrefetch();
+
+	const CallCounts& counts = GetCallCounts();
+
+	CheckNoExemplarWasLoaded();
+	CHECK(counts.createdFromDecoded + counts.createdFromCompiledPack == OrdinanceCount);
+	CHECK(counts.createdFromPropertyTable == 0);
+
+	registry.Clear();
+}
@@ -0,0 +1,343 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OrdinanceDefinitionTestData.h"
+#include "BuildingCountAvailabilityCondition.h"
+#include "BuildingCountIncomeFactor.h"
+#include "CityMetric.h"
+#include "GameYearAvailabilityCondition.h"
+#include "OrdiancePropertyIDs.h"
+#include "RCIGroupPopulationAvailabilityCondition.h"
+#include "RCIGroupPopulationIncomeFactor.h"
+#include "TotalResidentialPopulationIncomeFactor.h"
+#include <string_view>
+
+using namespace OrdinanceDefinitionTestData;
+
+namespace
+{
+	constexpr uint32_t ExemplarTypeID = 0x6534284A;
+	constexpr uint32_t GroupID = 0x4A5E8EF6;
+
+	CallCounts callCounts{};
+
+	cRZBaseString ToRZBaseString(std::string_view value)
+	{
+		return cRZBaseString(value.data(), static_cast<uint32_t>(value.size()));
+	}
+
+	RCIGroup GetRandomRCIGroup(std::mt19937& random)
+	{
+		std::uniform_int_distribution<size_t> distribution(0, CityMetricUtil::RCIGroups.size() - 1);
+
+		return CityMetricUtil::RCIGroups[distribution(random)];
+	}
+
+	BuildingType GetRandomBuildingType(std::mt19937& random)
+	{
+		std::uniform_int_distribution<uint32_t> distribution(0, CityMetricUtil::BuildingTypeCount - 1);
+
+		return static_cast<BuildingType>(distribution(random));
+	}
+
+	// The thresholds are in the same range as the CityStatsTestData values, so
+	// that about half of the conditions are met.
+	std::unique_ptr<IAvailabilityCondition> CreateRandomCondition(std::mt19937& random)
+	{
+		switch (std::uniform_int_distribution<int>(0, 2)(random))
+		{
+		case 0:
+			return std::make_unique<GameYearAvailabilityCondition>(
+				std::uniform_int_distribution<uint32_t>(2000, 2100)(random));
+		case 1:
+			return std::make_unique<RCIGroupPopulationAvailabilityCondition>(
+				GetRandomRCIGroup(random),
+				std::uniform_int_distribution<int32_t>(0, 60000)(random));
+		default:
+			return std::make_unique<BuildingCountAvailabilityCondition>(
+				GetRandomBuildingType(random),
+				std::uniform_int_distribution<uint32_t>(0, 25)(random));
+		}
+	}
+
+	std::unique_ptr<IMonthlyIncomeFactor> CreateRandomIncomeFactor(std::mt19937& random)
+	{
+		const float factor = std::uniform_real_distribution<float>(-2.0f, 2.0f)(random);
+
+		switch (std::uniform_int_distribution<int>(0, 2)(random))
+		{
+		case 0:
+			return std::make_unique<TotalResidentialPopulationIncomeFactor>(factor);
+		case 1:
+			return std::make_unique<RCIGroupPopulationIncomeFactor>(GetRandomRCIGroup(random), factor);
+		default:
+			return std::make_unique<BuildingCountIncomeFactor>(GetRandomBuildingType(random), factor);
+		}
+	}
+}
+
+CallCounts& OrdinanceDefinitionTestData::GetCallCounts()
+{
+	return callCounts;
+}
+
+void OrdinanceDefinitionTestData::ResetCallCounts()
+{
+	callCounts.decodedFromPropertyTable = 0;
+	callCounts.decodedFromCompiledPack = 0;
+	callCounts.createdFromDecoded = 0;
+	callCounts.createdFromPropertyTable = 0;
+	callCounts.createdFromCompiledPack = 0;
+	callCounts.createdWithoutProperties = 0;
+	callCounts.createdWithExemplar = 0;
+}
+
+std::shared_ptr<const OrdinanceDefinition> OrdinanceDefinitionTestData::CreateRandomDefinition(
+	std::mt19937& random,
+	uint32_t instance)
+{
+	std::uniform_int_distribution<int> countDistribution(0, 4);
+
+	OrdinanceDefinition::AvailabilityConditionList conditions;
+	OrdinanceDefinition::MonthlyIncomeFactorList incomeFactors;
+
+	const int conditionCount = countDistribution(random);
+
+	for (int i = 0; i < conditionCount; i++)
+	{
+		conditions.push_back(CreateRandomCondition(random));
+	}
+
+	const int incomeFactorCount = countDistribution(random);
+
+	for (int i = 0; i < incomeFactorCount; i++)
+	{
+		incomeFactors.push_back(CreateRandomIncomeFactor(random));
+	}
+
+	return OrdinanceDefinition::Create(
+		cGZPersistResourceKey(ExemplarTypeID, GroupID, instance),
+		std::move(conditions),
+		std::move(incomeFactors),
+		cRZBaseString("Test Ordinance"),
+		StringResourceKey(),
+		cRZBaseString(),
+		StringResourceKey(),
+		0,
+		0,
+		std::uniform_int_distribution<int64_t>(-500, 500)(random),
+		false);
+}
+
+std::shared_ptr<const OrdinanceDefinition> OrdinanceDefinition::CreateFromExemplar(
+	const cGZPersistResourceKey& key,
+	cISCResExemplar* pExemplar,
+	const ExemplarPropertyTable* pPropertyTable)
+{
+	std::shared_ptr<OrdinanceDefinition> definition(new OrdinanceDefinition(key));
+	definition->exemplar = pExemplar;
+
+	std::string_view name;
+
+	if (pPropertyTable && pPropertyTable->GetPropertyValue(kOrdinanceName, name))
+	{
+		definition->name = ToRZBaseString(name);
+		callCounts.createdFromPropertyTable++;
+	}
+	else
+	{
+		callCounts.createdWithoutProperties++;
+	}
+
+	if (pExemplar)
+	{
+		callCounts.createdWithExemplar++;
+	}
+
+	return definition;
+}
+
+std::shared_ptr<const OrdinanceDefinition> OrdinanceDefinition::CreateFromCompiledPack(
+	const cGZPersistResourceKey& key,
+	cISCResExemplar* pExemplar,
+	const CompiledOrdinancePack& pack,
+	uint32_t index)
+{
+	std::shared_ptr<OrdinanceDefinition> definition(new OrdinanceDefinition(key));
+	definition->exemplar = pExemplar;
+
+	std::string_view name;
+
+	if (pack.GetPropertyValue(index, kOrdinanceName, name))
+	{
+		definition->name = ToRZBaseString(name);
+	}
+
+	callCounts.createdFromCompiledPack++;
+
+	if (pExemplar)
+	{
+		callCounts.createdWithExemplar++;
+	}
+
+	return definition;
+}
+
+std::unique_ptr<OrdinanceDefinition> OrdinanceDefinition::Decode(
+	const cGZPersistResourceKey& key,
+	const ExemplarPropertyTable& propertyTable)
+{
+	std::unique_ptr<OrdinanceDefinition> definition(new OrdinanceDefinition(key));
+
+	std::string_view name;
+
+	if (propertyTable.GetPropertyValue(kOrdinanceName, name))
+	{
+		definition->name = ToRZBaseString(name);
+	}
+
+	callCounts.decodedFromPropertyTable++;
+
+	return definition;
+}
+
+std::unique_ptr<OrdinanceDefinition> OrdinanceDefinition::Decode(
+	const cGZPersistResourceKey& key,
+	const CompiledOrdinancePack& pack,
+	uint32_t index)
+{
+	std::unique_ptr<OrdinanceDefinition> definition(new OrdinanceDefinition(key));
+
+	std::string_view name;
+
+	if (pack.GetPropertyValue(index, kOrdinanceName, name))
+	{
+		definition->name = ToRZBaseString(name);
+	}
+
+	callCounts.decodedFromCompiledPack++;
+
+	return definition;
+}
+
+std::shared_ptr<const OrdinanceDefinition> OrdinanceDefinition::CreateFromDecoded(
+	std::unique_ptr<OrdinanceDefinition>&& decoded,
+	cISCResExemplar* pExemplar)
+{
+	std::shared_ptr<OrdinanceDefinition> definition(decoded.release());
+	definition->exemplar = pExemplar;
+	callCounts.createdFromDecoded++;
+
+	if (pExemplar)
+	{
+		callCounts.createdWithExemplar++;
+	}
+
+	return definition;
+}
+
+OrdinanceDefinition::OrdinanceDefinition(const cGZPersistResourceKey& key)
+	: enactmentIncome(0),
+	  retracmentIncome(0),
+	  monthlyConstantIncome(0),
+	  contentHash(0),
+	  key(key),
+	  exemplar(),
+	  availabilityConditions(),
+	  monthlyIncomeFactors(),
+	  program(),
+	  name(),
+	  nameKey(),
+	  description(),
+	  descriptionKey(),
+	  isIncomeOrdinance(false)
+{
+}
+
+const cGZPersistResourceKey& OrdinanceDefinition::GetKey() const
+{
+	return key;
+}
+
+cISCResExemplar* OrdinanceDefinition::GetExemplar() const
+{
+	return exemplar;
+}
+
+const cRZBaseString& OrdinanceDefinition::GetName() const
+{
+	return name;
+}
+
+std::shared_ptr<const OrdinanceDefinition> OrdinanceDefinition::Create(
+	const cGZPersistResourceKey& key,
+	AvailabilityConditionList&& availabilityConditions,
+	MonthlyIncomeFactorList&& monthlyIncomeFactors,
+	const cRZBaseString& name,
+	const StringResourceKey& nameKey,
+	const cRZBaseString& description,
+	const StringResourceKey& descriptionKey,
+	int64_t enactmentIncome,
+	int64_t retracmentIncome,
+	int64_t monthlyConstantIncome,
+	bool isIncomeOrdinance)
+{
+	std::shared_ptr<OrdinanceDefinition> definition(new OrdinanceDefinition(key));
+
+	definition->availabilityConditions = std::move(availabilityConditions);
+	definition->monthlyIncomeFactors = std::move(monthlyIncomeFactors);
+	definition->name = name;
+	definition->nameKey = nameKey;
+	definition->description = description;
+	definition->descriptionKey = descriptionKey;
+	definition->enactmentIncome = enactmentIncome;
+	definition->retracmentIncome = retracmentIncome;
+	definition->monthlyConstantIncome = monthlyConstantIncome;
+	definition->isIncomeOrdinance = isIncomeOrdinance;
+	definition->CompileProgram();
+
+	return definition;
+}
+
+const OrdinanceProgram& OrdinanceDefinition::GetProgram() const
+{
+	return program;
+}
+
+int64_t OrdinanceDefinition::GetMonthlyConstantIncome() const
+{
+	return monthlyConstantIncome;
+}
+
+void OrdinanceDefinition::CompileProgram()
+{
+	program = OrdinanceProgram();
+
+	for (const auto& condition : availabilityConditions)
+	{
+		condition->Compile(program);
+	}
+
+	for (const auto& factor : monthlyIncomeFactors)
+	{
+		factor->Compile(program);
+	}
+}
@@ -0,0 +1,60 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "OrdinanceDefinition.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <random>
+
+// Stand-ins for the OrdinanceDefinition factory functions, which use the game's
+// property holders and localized strings.
+// The stand-ins read the ordinance name from the decoded properties and count
+// the calls, so that the tests can check which source each definition was
+// created from. The definitions that are created from the save game values
+// compile their program as the real definition does.
+namespace OrdinanceDefinitionTestData
+{
+	struct CallCounts
+	{
+		// Decode is called by the prefetcher on a background thread.
+		std::atomic<uint32_t> decodedFromPropertyTable;
+		std::atomic<uint32_t> decodedFromCompiledPack;
+		uint32_t createdFromDecoded;
+		uint32_t createdFromPropertyTable;
+		uint32_t createdFromCompiledPack;
+		// The definitions that were created without any decoded properties, the
+		// real definition would have to load the exemplar from the resource manager
+		// to read them.
+		uint32_t createdWithoutProperties;
+		// The factory calls that were passed one of the game's exemplars.
+		uint32_t createdWithExemplar;
+	};
+
+	CallCounts& GetCallCounts();
+	void ResetCallCounts();
+
+	// Creates a definition with random metric conditions and income factors.
+	// The income factors are added in a random order, so the income of some of
+	// the definitions cannot be computed by the MonthlyIncomeEngine matrix.
+	std::shared_ptr<const OrdinanceDefinition> CreateRandomDefinition(std::mt19937& random, uint32_t instance);
+}
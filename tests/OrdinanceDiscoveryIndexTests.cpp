@@ -0,0 +1,358 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ExemplarBuilder.h"
+#include "FileSystem.h"
+#include "OrdiancePropertyIDs.h"
+#include "OrdinanceDiscoveryIndex.h"
+#include "TestFramework.h"
+#include "TestUtil.h"
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using DiscoveredExemplar = OrdinanceDiscoveryIndex::DiscoveredExemplar;
+using ExemplarStatus = OrdinanceDiscoveryPipeline::ExemplarStatus;
+
+namespace
+{
+	constexpr uint64_t KeyFilterHash = 0x0123456789ABCDEF;
+	constexpr uint32_t ExemplarTypeID = 0x6534284A;
+	constexpr uint32_t GroupID = 0x4A5E8EF6;
+	// The instance id of a file's ordinance is this value plus the file index.
+	constexpr uint32_t FirstInstance = 0x12345678;
+
+	DiscoveredExemplar CreateOrdinance(uint32_t fileIndex)
+	{
+		DiscoveredExemplar exemplar{};
+		exemplar.key = cGZPersistResourceKey(ExemplarTypeID, GroupID, FirstInstance + fileIndex);
+		exemplar.status = ExemplarStatus::Ordinance;
+		exemplar.data = ExemplarBuilder()
+			.AddString(kOrdinanceName, "Ordinance " + std::to_string(fileIndex))
+			.Build();
+		exemplar.properties.Parse(exemplar.data);
+
+		return exemplar;
+	}
+
+	// Stands in for the discovery pipeline, each file has one ordinance.
+	void DecodeFiles(OrdinanceDiscoveryIndex& index)
+	{
+		for (uint32_t fileIndex : index.GetFilesToDecode())
+		{
+			std::vector<DiscoveredExemplar> exemplars;
+			exemplars.push_back(CreateOrdinance(fileIndex));
+
+			index.SetFileExemplars(fileIndex, std::move(exemplars));
+		}
+	}
+
+	class IndexTestDirectory
+	{
+	public:
+		IndexTestDirectory()
+			: pluginsDirectory(directory.GetPath() / "Plugins"),
+			  indexPath(directory.GetPath() / "ordinances.idx")
+		{
+			std::filesystem::create_directories(pluginsDirectory);
+		}
+
+		bool WriteFile(const char* name, std::string_view contents) const
+		{
+			return TestUtil::WriteFile(pluginsDirectory / name, TestUtil::ToBytes(contents));
+		}
+
+		// Gets the files in the plugins directory, sorted by path.
+		std::vector<FileInfo> GetFiles() const
+		{
+			std::vector<std::filesystem::path> subdirectories;
+			std::vector<FileInfo> files;
+
+			NativeFileSystem::GetInstance().GetDirectoryContents(pluginsDirectory, subdirectories, files);
+
+			std::sort(
+				files.begin(),
+				files.end(),
+				[](const FileInfo& lhs, const FileInfo& rhs) { return lhs.path < rhs.path; });
+
+			return files;
+		}
+
+		std::vector<std::filesystem::path> GetRoots() const
+		{
+			return { pluginsDirectory };
+		}
+
+		// Refreshes an index that was loaded from the index file.
+		bool LoadAndRefresh(OrdinanceDiscoveryIndex& index) const
+		{
+			return index.Load(indexPath) && index.Refresh(GetRoots(), GetFiles(), KeyFilterHash);
+		}
+
+		// Creates the index file for the current files, with one ordinance in each file.
+		bool CreateIndex() const
+		{
+			OrdinanceDiscoveryIndex index;
+
+			if (index.Load(indexPath) || index.Refresh(GetRoots(), GetFiles(), KeyFilterHash))
+			{
+				// The index file must not exist yet.
+				return false;
+			}
+
+			DecodeFiles(index);
+
+			return index.Save(indexPath);
+		}
+
+		TestUtil::TemporaryDirectory directory;
+		std::filesystem::path pluginsDirectory;
+		std::filesystem::path indexPath;
+	};
+
+	// Checks that the index has the expected ordinances, in the file order.
+	// The ordinances are identified by the file index that they were created
+	// for, which may differ from their current file index.
+	bool HasOrdinances(const OrdinanceDiscoveryIndex& index, const std::vector<uint32_t>& createdFileIndices)
+	{
+		std::vector<DiscoveredExemplar> exemplars;
+		index.GetExemplars(exemplars);
+
+		if (exemplars.size() != createdFileIndices.size())
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < exemplars.size(); i++)
+		{
+			const DiscoveredExemplar& exemplar = exemplars[i];
+			const uint32_t createdFileIndex = createdFileIndices[i];
+
+			std::string_view name;
+
+			if (exemplar.key.instance != FirstInstance + createdFileIndex
+				|| exemplar.status != ExemplarStatus::Ordinance
+				|| !exemplar.properties.GetPropertyValue(kOrdinanceName, name)
+				|| name != "Ordinance " + std::to_string(createdFileIndex))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Moves the last write time of the file forward without changing its contents.
+	void TouchFile(const std::filesystem::path& path)
+	{
+		std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::seconds(10));
+	}
+}
+
+TEST_CASE(OrdinanceDiscoveryIndex_RoundTripsTheFileExemplars)
+{
+	IndexTestDirectory test;
+	REQUIRE(test.WriteFile("a.dat", "first"));
+	REQUIRE(test.WriteFile("b.dat", "second"));
+	REQUIRE(test.CreateIndex());
+
+	OrdinanceDiscoveryIndex index;
+	CHECK(test.LoadAndRefresh(index));
+	CHECK(index.GetFilesToDecode().empty());
+	CHECK(HasOrdinances(index, { 0, 1 }));
+	CHECK(!index.IsModified());
+}
+
+TEST_CASE(OrdinanceDiscoveryIndex_StaleTimestampWithSameContentsIsStillValid)
+{
+	IndexTestDirectory test;
+	REQUIRE(test.WriteFile("a.dat", "first"));
+	REQUIRE(test.CreateIndex());
+
+	TouchFile(test.pluginsDirectory / "a.dat");
+
+	// The file is hashed again, and the new time stamp must be saved.
+	OrdinanceDiscoveryIndex index;
+	CHECK(test.LoadAndRefresh(index));
+	CHECK(index.GetFilesToDecode().empty());
+	CHECK(HasOrdinances(index, { 0 }));
+	CHECK(index.IsModified());
+	REQUIRE(index.Save(test.indexPath));
+
+	OrdinanceDiscoveryIndex updatedIndex;
+	CHECK(test.LoadAndRefresh(updatedIndex));
+	CHECK(!updatedIndex.IsModified());
+}
+
+TEST_CASE(OrdinanceDiscoveryIndex_OnlyChangedFilesAreDecodedAgain)
+{
+	IndexTestDirectory test;
+	REQUIRE(test.WriteFile("a.dat", "first"));
+	REQUIRE(test.WriteFile("b.dat", "second"));
+	REQUIRE(test.WriteFile("c.dat", "third"));
+	REQUIRE(test.CreateIndex());
+
+	// The same size, but a different time stamp and contents.
+	REQUIRE(test.WriteFile("b.dat", "SECOND"));
+	TouchFile(test.pluginsDirectory / "b.dat");
+
+	OrdinanceDiscoveryIndex index;
+	CHECK(!test.LoadAndRefresh(index));
+	CHECK(index.IsModified());
+	CHECK(index.GetFilesToDecode() == std::vector<uint32_t>{ 1 });
+	// The changed file has no exemplars until it is decoded again.
+	CHECK(HasOrdinances(index, { 0, 2 }));
+
+	DecodeFiles(index);
+	CHECK(index.GetFilesToDecode().empty());
+	CHECK(HasOrdinances(index, { 0, 1, 2 }));
+	REQUIRE(index.Save(test.indexPath));
+
+	OrdinanceDiscoveryIndex updatedIndex;
+	CHECK(test.LoadAndRefresh(updatedIndex));
+	CHECK(HasOrdinances(updatedIndex, { 0, 1, 2 }));
+}
+
+TEST_CASE(OrdinanceDiscoveryIndex_AddedAndRemovedFilesKeepTheOtherFiles)
+{
+	IndexTestDirectory test;
+	REQUIRE(test.WriteFile("a.dat", "first"));
+	REQUIRE(test.WriteFile("c.dat", "third"));
+	REQUIRE(test.CreateIndex());
+
+	REQUIRE(test.WriteFile("b.dat", "second"));
+
+	OrdinanceDiscoveryIndex addedIndex;
+	CHECK(!test.LoadAndRefresh(addedIndex));
+	CHECK(addedIndex.GetFilesToDecode() == std::vector<uint32_t>{ 1 });
+	// c.dat is now the third file, it keeps the ordinance that was created for it.
+	CHECK(HasOrdinances(addedIndex, { 0, 1 }));
+
+	std::vector<DiscoveredExemplar> exemplars;
+	addedIndex.GetExemplars(exemplars);
+	REQUIRE(exemplars.size() == 2);
+	CHECK(exemplars[0].fileIndex == 0);
+	CHECK(exemplars[1].fileIndex == 2);
+
+	std::filesystem::remove(test.pluginsDirectory / "b.dat");
+	std::filesystem::remove(test.pluginsDirectory / "c.dat");
+
+	OrdinanceDiscoveryIndex removedIndex;
+	CHECK(!test.LoadAndRefresh(removedIndex));
+	CHECK(removedIndex.GetFilesToDecode().empty());
+	CHECK(HasOrdinances(removedIndex, { 0 }));
+}
+
+TEST_CASE(OrdinanceDiscoveryIndex_UndecodedFilesAreNotSaved)
+{
+	IndexTestDirectory test;
+	REQUIRE(test.WriteFile("a.dat", "first"));
+	REQUIRE(test.CreateIndex());
+
+	REQUIRE(test.WriteFile("b.dat", "second"));
+
+	OrdinanceDiscoveryIndex index;
+	CHECK(!test.LoadAndRefresh(index));
+	REQUIRE(index.Save(test.indexPath));
+
+	OrdinanceDiscoveryIndex reloadedIndex;
+	CHECK(!test.LoadAndRefresh(reloadedIndex));
+	CHECK(reloadedIndex.GetFilesToDecode() == std::vector<uint32_t>{ 1 });
+}
+
+TEST_CASE(OrdinanceDiscoveryIndex_LoadOrderAndRootsKeepTheFileExemplars)
+{
+	IndexTestDirectory test;
+	REQUIRE(test.WriteFile("a.dat", "first"));
+	REQUIRE(test.WriteFile("b.dat", "second"));
+	REQUIRE(test.CreateIndex());
+
+	{
+		// The load order determines which duplicate exemplar is used.
+		std::vector<FileInfo> files = test.GetFiles();
+		std::reverse(files.begin(), files.end());
+
+		OrdinanceDiscoveryIndex index;
+		REQUIRE(index.Load(test.indexPath));
+		CHECK(!index.Refresh(test.GetRoots(), files, KeyFilterHash));
+		CHECK(index.GetFilesToDecode().empty());
+		CHECK(HasOrdinances(index, { 1, 0 }));
+	}
+
+	{
+		std::vector<std::filesystem::path> roots = test.GetRoots();
+		roots.push_back(test.directory.GetPath() / "Other");
+
+		OrdinanceDiscoveryIndex index;
+		REQUIRE(index.Load(test.indexPath));
+		CHECK(!index.Refresh(roots, test.GetFiles(), KeyFilterHash));
+		CHECK(index.GetFilesToDecode().empty());
+	}
+}
+
+TEST_CASE(OrdinanceDiscoveryIndex_KeyFilterChangeDecodesEveryFile)
+{
+	IndexTestDirectory test;
+	REQUIRE(test.WriteFile("a.dat", "first"));
+	REQUIRE(test.WriteFile("b.dat", "second"));
+	REQUIRE(test.CreateIndex());
+
+	OrdinanceDiscoveryIndex index;
+	REQUIRE(index.Load(test.indexPath));
+	CHECK(!index.Refresh(test.GetRoots(), test.GetFiles(), KeyFilterHash + 1));
+	CHECK((index.GetFilesToDecode() == std::vector<uint32_t>{ 0, 1 }));
+	CHECK(HasOrdinances(index, {}));
+}
+
+TEST_CASE(OrdinanceDiscoveryIndex_RejectsDamagedIndexFiles)
+{
+	IndexTestDirectory test;
+	REQUIRE(test.WriteFile("a.dat", "first"));
+	REQUIRE(test.CreateIndex());
+
+	std::vector<uint8_t> data;
+	REQUIRE(TestUtil::ReadFile(test.indexPath, data));
+
+	const std::filesystem::path damagedPath = test.directory.GetPath() / "damaged.idx";
+
+	for (size_t size = 0; size < data.size(); size++)
+	{
+		REQUIRE(TestUtil::WriteFile(damagedPath, std::span<const uint8_t>(data.data(), size)));
+
+		OrdinanceDiscoveryIndex index;
+		CHECK(!index.Load(damagedPath));
+	}
+
+	// The index file version.
+	std::vector<uint8_t> wrongVersion = data;
+	wrongVersion[4] ^= 0x01;
+	REQUIRE(TestUtil::WriteFile(damagedPath, wrongVersion));
+
+	OrdinanceDiscoveryIndex index;
+	CHECK(!index.Load(damagedPath));
+
+	// A missing index is not loaded, and every file must be decoded.
+	CHECK(!index.Load(test.directory.GetPath() / "missing.idx"));
+	CHECK(!index.Refresh(test.GetRoots(), test.GetFiles(), KeyFilterHash));
+	CHECK(index.GetFilesToDecode() == std::vector<uint32_t>{ 0 });
+}
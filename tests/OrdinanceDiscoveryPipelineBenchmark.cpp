@@ -0,0 +1,161 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include "DBPFWriter.h"
+#include "ExemplarBuilder.h"
+#include "OrdiancePropertyIDs.h"
+#include "OrdinanceDiscoveryPipeline.h"
+#include "TestUtil.h"
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t ExemplarTypeID = 0x6534284A;
+	constexpr uint32_t GroupID = 0x4A5E8EF6;
+	constexpr uint32_t ExemplarTypePropertyID = 0x10;
+	constexpr uint32_t OrdinanceExemplarType = 14;
+	constexpr uint32_t BuildingExemplarType = 2;
+
+	std::vector<uint8_t> CreateRandomExemplar(std::mt19937& random, uint32_t instance)
+	{
+		// One exemplar in eight is a building, the pipeline classifies it and
+		// skips its properties.
+		if (std::uniform_int_distribution<int>(0, 7)(random) == 0)
+		{
+			return ExemplarBuilder()
+				.AddUint32(ExemplarTypePropertyID, BuildingExemplarType)
+				.AddString(kOrdinanceName, "Building " + std::to_string(instance))
+				.Build();
+		}
+
+		const std::string name = "Ordinance " + std::to_string(instance);
+
+		return ExemplarBuilder()
+			.AddUint32(ExemplarTypePropertyID, OrdinanceExemplarType)
+			.AddString(kOrdinanceName, name)
+			.AddString(kOrdinanceDescription, "The description of " + name + ", which is longer than its name.")
+			.AddSint64(kOrdinanceEnactmentIncome, std::uniform_int_distribution<int64_t>(-1000, 0)(random))
+			.AddSint64(kOrdinanceRetracmentIncome, std::uniform_int_distribution<int64_t>(-1000, 0)(random))
+			.AddSint64(kOrdinancemMonthlyConstantIncome, std::uniform_int_distribution<int64_t>(-500, 500)(random))
+			.AddBool(kOrdinanceIsIncome, std::bernoulli_distribution(0.5)(random))
+			.AddUint32(kOrdinanceAvailabilityGameYear, std::uniform_int_distribution<uint32_t>(2000, 2100)(random))
+			.AddUint32(kOrdinanceAvailabilityMinPopulationResLowWealth, std::uniform_int_distribution<uint32_t>(0, 60000)(random))
+			.AddUint32(kOrdinanceAvailabilityMinSchoolBuildingCount, std::uniform_int_distribution<uint32_t>(0, 25)(random))
+			.AddFloat32(kOrdinanceMonthlyIncomeFactorResTotalPopulation, std::uniform_real_distribution<float>(-2.0f, 2.0f)(random))
+			.Build();
+	}
+
+	// Writes a pack of synthetic exemplars split over several DBPF files, half of
+	// the records are QFS compressed.
+	bool WriteSyntheticPack(
+		std::mt19937& random,
+		const std::filesystem::path& directory,
+		uint32_t exemplarCount,
+		uint32_t fileCount,
+		std::vector<std::filesystem::path>& paths,
+		uint64_t& totalSize)
+	{
+		totalSize = 0;
+
+		for (uint32_t fileIndex = 0; fileIndex < fileCount; fileIndex++)
+		{
+			// The writer references the record data until the file is saved.
+			std::vector<std::vector<uint8_t>> records;
+			records.reserve(exemplarCount / fileCount);
+
+			DBPFWriter writer;
+
+			for (uint32_t instance = fileIndex; instance < exemplarCount; instance += fileCount)
+			{
+				const std::vector<uint8_t> exemplar = CreateRandomExemplar(random, instance);
+				const bool compressed = (instance % 2) != 0;
+
+				records.push_back(compressed ? TestUtil::CompressWithLiterals(exemplar) : exemplar);
+
+				if (!writer.Add(ExemplarTypeID, GroupID, 0x1000 + instance, records.back(), compressed))
+				{
+					return false;
+				}
+			}
+
+			const std::filesystem::path path = directory / ("pack" + std::to_string(fileIndex) + ".dat");
+			DBPFWriter::Statistics statistics{};
+
+			if (!writer.Save(path, statistics))
+			{
+				return false;
+			}
+
+			paths.push_back(path);
+			totalSize += std::filesystem::file_size(path);
+		}
+
+		return true;
+	}
+}
+
+// Scans a synthetic pack of ordinance exemplars with several worker thread counts.
+// The files are in the operating system's file cache after the first run, so
+// the benchmark measures the decompression, classification and decoding.
+BENCHMARK(OrdinanceDiscoveryPipeline_ScanSyntheticPack)
+{
+	constexpr uint32_t ExemplarCount = 10000;
+	constexpr uint32_t FileCount = 8;
+
+	std::mt19937 random(1);
+	TestUtil::TemporaryDirectory directory;
+
+	std::vector<std::filesystem::path> paths;
+	uint64_t totalSize = 0;
+
+	if (!WriteSyntheticPack(random, directory.GetPath(), ExemplarCount, FileCount, paths, totalSize))
+	{
+		std::printf("  The synthetic pack could not be written.\n");
+		return;
+	}
+
+	for (uint32_t threadCount : { 1u, 2u, 4u, 8u, 0u })
+	{
+		const OrdinanceDiscoveryPipeline pipeline(threadCount);
+		std::vector<OrdinanceDiscoveryPipeline::DiscoveredExemplar> results;
+
+		// A thread count of zero uses the number of hardware threads.
+		const std::string label = threadCount == 0
+			? "10000 exemplars, " + std::to_string(std::thread::hardware_concurrency()) + " hardware threads"
+			: "10000 exemplars, " + std::to_string(threadCount) + " threads";
+
+		const double time = Benchmark::Measure(label.c_str(), [&]()
+		{
+			results.clear();
+			pipeline.Run(paths, results);
+
+			Benchmark::Consume(results.size());
+		});
+
+		Benchmark::PrintThroughput(label.c_str(), totalSize, time);
+	}
+}
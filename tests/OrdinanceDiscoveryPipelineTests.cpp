@@ -0,0 +1,286 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DBPFWriter.h"
+#include "ExemplarBuilder.h"
+#include "OrdiancePropertyIDs.h"
+#include "OrdinanceDiscoveryPipeline.h"
+#include "TestFramework.h"
+#include "TestUtil.h"
+#include <map>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+using ExemplarStatus = OrdinanceDiscoveryPipeline::ExemplarStatus;
+
+namespace
+{
+	constexpr uint32_t ExemplarTypeID = 0x6534284A;
+	constexpr uint32_t LTextTypeID = 0x2026960B;
+	constexpr uint32_t GroupID = 0x4A5E8EF6;
+	constexpr uint32_t ExemplarTypePropertyID = 0x10;
+	constexpr uint32_t OrdinanceExemplarType = 14;
+
+	constexpr uint32_t OrdinanceInstance = 1;
+	constexpr uint32_t CompressedOrdinanceInstance = 2;
+	constexpr uint32_t BuildingInstance = 3;
+	constexpr uint32_t MissingTypeInstance = 4;
+	constexpr uint32_t InheritedTypeInstance = 5;
+	constexpr uint32_t TextOrdinanceInstance = 6;
+	constexpr uint32_t FilteredInstance = 7;
+	constexpr uint32_t ManyOrdinancesFirstInstance = 0x1000;
+	constexpr uint32_t ManyOrdinancesCount = 100;
+
+	std::vector<uint8_t> CreateOrdinanceExemplar(std::string_view name)
+	{
+		return ExemplarBuilder()
+			.AddUint32(ExemplarTypePropertyID, OrdinanceExemplarType)
+			.AddString(kOrdinanceName, name)
+			.AddSint64(kOrdinancemMonthlyConstantIncome, 100)
+			.Build();
+	}
+
+	// The record data must remain valid until the files are written.
+	struct TestFiles
+	{
+		std::vector<std::vector<uint8_t>> records;
+		std::vector<std::filesystem::path> paths;
+	};
+
+	bool WriteTestFiles(const std::filesystem::path& directory, TestFiles& files)
+	{
+		files.records.reserve(16 + ManyOrdinancesCount);
+
+		auto addRecord = [&](std::vector<uint8_t> data) -> std::span<const uint8_t>
+		{
+			files.records.push_back(std::move(data));
+			return files.records.back();
+		};
+
+		DBPFWriter first;
+		DBPFWriter::Statistics statistics{};
+
+		const bool added = first.Add(ExemplarTypeID, GroupID, OrdinanceInstance, addRecord(CreateOrdinanceExemplar("Ordinance")), false)
+			&& first.Add(
+				ExemplarTypeID,
+				GroupID,
+				CompressedOrdinanceInstance,
+				addRecord(TestUtil::CompressWithLiterals(CreateOrdinanceExemplar("Compressed Ordinance"))),
+				true)
+			&& first.Add(
+				ExemplarTypeID,
+				GroupID,
+				BuildingInstance,
+				addRecord(ExemplarBuilder().AddUint32(ExemplarTypePropertyID, 0x02).AddString(kOrdinanceName, "Building").Build()),
+				false)
+			&& first.Add(
+				ExemplarTypeID,
+				GroupID,
+				MissingTypeInstance,
+				addRecord(ExemplarBuilder().AddString(kOrdinanceName, "No Type").Build()),
+				false)
+			&& first.Add(
+				ExemplarTypeID,
+				GroupID,
+				InheritedTypeInstance,
+				addRecord(ExemplarBuilder().SetParentCohort(0x05342861, GroupID, 0x100).AddString(kOrdinanceName, "Cohort").Build()),
+				false)
+			&& first.Add(
+				ExemplarTypeID,
+				GroupID,
+				TextOrdinanceInstance,
+				addRecord(TestUtil::ToBytes(
+					"EQZT1###\r\n"
+					"ParentCohort=Key:{0x00000000,0x00000000,0x00000000}\r\n"
+					"PropCount=0x00000001\r\n"
+					"0x00000010:{\"Exemplar Type\"}=Uint32:0:{0x0000000E}\r\n")),
+				false)
+			&& first.Add(ExemplarTypeID, GroupID, FilteredInstance, addRecord(CreateOrdinanceExemplar("Filtered")), false)
+			&& first.Add(LTextTypeID, GroupID, OrdinanceInstance, addRecord(TestUtil::ToBytes("Not an exemplar")), false);
+
+		if (!added)
+		{
+			return false;
+		}
+
+		DBPFWriter second;
+
+		for (uint32_t i = 0; i < ManyOrdinancesCount; i++)
+		{
+			const std::string name = "Ordinance " + std::to_string(i);
+
+			if (!second.Add(ExemplarTypeID, GroupID, ManyOrdinancesFirstInstance + i, addRecord(CreateOrdinanceExemplar(name)), false))
+			{
+				return false;
+			}
+		}
+
+		files.paths.push_back(directory / "a.dat");
+		files.paths.push_back(directory / "b.dat");
+		// A file that is not a DBPF file is skipped.
+		files.paths.push_back(directory / "c.txt");
+
+		return first.Save(files.paths[0], statistics)
+			&& second.Save(files.paths[1], statistics)
+			&& TestUtil::WriteFile(files.paths[2], TestUtil::ToBytes("text"));
+	}
+
+	const OrdinanceDiscoveryPipeline::DiscoveredExemplar* FindResult(
+		const std::vector<OrdinanceDiscoveryPipeline::DiscoveredExemplar>& results,
+		uint32_t instance)
+	{
+		for (const OrdinanceDiscoveryPipeline::DiscoveredExemplar& result : results)
+		{
+			if (result.key.instance == instance)
+			{
+				return &result;
+			}
+		}
+
+		return nullptr;
+	}
+
+	bool HasName(const OrdinanceDiscoveryPipeline::DiscoveredExemplar* result, std::string_view expected)
+	{
+		std::string_view name;
+
+		return result && result->properties.GetPropertyValue(kOrdinanceName, name) && name == expected;
+	}
+}
+
+TEST_CASE(OrdinanceDiscoveryPipeline_FiltersEachExemplarKeyOnce)
+{
+	TestUtil::TemporaryDirectory directory;
+	TestFiles files;
+	REQUIRE(WriteTestFiles(directory.GetPath(), files));
+
+	// The key filter counts the number of times that each key is checked.
+	std::map<std::tuple<uint32_t, uint32_t, uint32_t>, uint32_t> checkCounts;
+
+	const OrdinanceDiscoveryPipeline::KeyFilter filter = [&](const cGZPersistResourceKey& key)
+	{
+		checkCounts[std::make_tuple(key.type, key.group, key.instance)]++;
+		return key.instance != FilteredInstance;
+	};
+
+	std::vector<OrdinanceDiscoveryPipeline::DiscoveredExemplar> results;
+	OrdinanceDiscoveryPipeline(4).Run(files.paths, results, filter);
+
+	// Every exemplar key is checked once, the other resource types are never checked.
+	CHECK(checkCounts.size() == 7 + ManyOrdinancesCount);
+
+	for (const auto& [key, count] : checkCounts)
+	{
+		CHECK(std::get<0>(key) == ExemplarTypeID);
+		CHECK(count == 1);
+	}
+
+	CHECK(results.size() == 6 + ManyOrdinancesCount);
+	CHECK(FindResult(results, FilteredInstance) == nullptr);
+
+	// The ordinance properties are decoded by the discovery, the registry creates
+	// the definitions from them, see OrdinanceDefinitionRegistryTests.cpp.
+	const auto* ordinance = FindResult(results, OrdinanceInstance);
+	REQUIRE(ordinance);
+	CHECK(ordinance->status == ExemplarStatus::Ordinance);
+	CHECK(ordinance->fileIndex == 0);
+	CHECK(HasName(ordinance, "Ordinance"));
+	// The record data is kept for the discovery index.
+	CHECK(!ordinance->data.empty());
+
+	const auto* compressedOrdinance = FindResult(results, CompressedOrdinanceInstance);
+	REQUIRE(compressedOrdinance);
+	CHECK(compressedOrdinance->status == ExemplarStatus::Ordinance);
+	CHECK(HasName(compressedOrdinance, "Compressed Ordinance"));
+
+	const auto* building = FindResult(results, BuildingInstance);
+	REQUIRE(building);
+	CHECK(building->status == ExemplarStatus::NotOrdinance);
+	CHECK(building->properties.IsEmpty());
+	CHECK(building->data.empty());
+
+	const auto* missingType = FindResult(results, MissingTypeInstance);
+	REQUIRE(missingType);
+	CHECK(missingType->status == ExemplarStatus::MissingExemplarType);
+
+	const auto* inheritedType = FindResult(results, InheritedTypeInstance);
+	REQUIRE(inheritedType);
+	CHECK(inheritedType->status == ExemplarStatus::InheritedExemplarType);
+
+	// Text exemplars are classified, but their properties are read by the game.
+	const auto* textOrdinance = FindResult(results, TextOrdinanceInstance);
+	REQUIRE(textOrdinance);
+	CHECK(textOrdinance->status == ExemplarStatus::Ordinance);
+	CHECK(textOrdinance->properties.IsEmpty());
+	CHECK(textOrdinance->data.empty());
+
+	for (uint32_t i = 0; i < ManyOrdinancesCount; i++)
+	{
+		const auto* result = FindResult(results, ManyOrdinancesFirstInstance + i);
+		REQUIRE(result);
+		CHECK(result->fileIndex == 1);
+		CHECK(HasName(result, "Ordinance " + std::to_string(i)));
+	}
+}
+
+TEST_CASE(OrdinanceDiscoveryPipeline_ResultsDoNotDependOnTheThreadCount)
+{
+	TestUtil::TemporaryDirectory directory;
+	TestFiles files;
+	REQUIRE(WriteTestFiles(directory.GetPath(), files));
+
+	std::vector<OrdinanceDiscoveryPipeline::DiscoveredExemplar> singleThreadResults;
+	OrdinanceDiscoveryPipeline(1).Run(files.paths, singleThreadResults);
+
+	std::vector<OrdinanceDiscoveryPipeline::DiscoveredExemplar> multipleThreadResults;
+	OrdinanceDiscoveryPipeline(8).Run(files.paths, multipleThreadResults);
+
+	REQUIRE(singleThreadResults.size() == multipleThreadResults.size());
+
+	for (size_t i = 0; i < singleThreadResults.size(); i++)
+	{
+		const auto& expected = singleThreadResults[i];
+		const auto& actual = multipleThreadResults[i];
+
+		CHECK(expected.key.instance == actual.key.instance);
+		CHECK(expected.fileIndex == actual.fileIndex);
+		CHECK(expected.status == actual.status);
+		CHECK(expected.properties.GetProperties().size() == actual.properties.GetProperties().size());
+	}
+}
+
+TEST_CASE(OrdinanceDiscoveryPipeline_ScansTheDirectoryInPathOrder)
+{
+	TestUtil::TemporaryDirectory directory;
+	TestFiles files;
+	REQUIRE(WriteTestFiles(directory.GetPath(), files));
+
+	const std::vector<std::filesystem::path> paths = OrdinanceDiscoveryPipeline::GetFilesInDirectory(directory.GetPath());
+	CHECK(paths == files.paths);
+
+	std::vector<OrdinanceDiscoveryPipeline::DiscoveredExemplar> results;
+	CHECK(OrdinanceDiscoveryPipeline().Run(directory.GetPath(), results));
+	CHECK(results.size() == 7 + ManyOrdinancesCount);
+
+	CHECK(!OrdinanceDiscoveryPipeline().Run(directory.GetPath() / "missing", results));
+}
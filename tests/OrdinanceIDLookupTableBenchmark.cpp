@@ -0,0 +1,85 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include "OrdinanceIDLookupTable.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// Compares the lookup table with the linear search that GetClassObject used,
+// looking up every id once.
+BENCHMARK(OrdinanceIDLookupTable_FindEveryID)
+{
+	std::mt19937 random(1);
+
+	for (size_t count : { 10, 1000, 10000 })
+	{
+		std::vector<uint32_t> ids;
+		std::unordered_set<uint32_t> idSet;
+
+		while (ids.size() < count)
+		{
+			const uint32_t id = random();
+
+			if (idSet.insert(id).second)
+			{
+				ids.push_back(id);
+			}
+		}
+
+		// The lookups use a different order than the table.
+		std::vector<uint32_t> lookups = ids;
+		std::shuffle(lookups.begin(), lookups.end(), random);
+
+		OrdinanceIDLookupTable table;
+		table.Build(ids);
+
+		const std::string linearLabel = "linear search, " + std::to_string(count) + " ids";
+		const std::string tableLabel = "lookup table, " + std::to_string(count) + " ids";
+
+		Benchmark::Measure(linearLabel.c_str(), [&]()
+		{
+			uint64_t sum = 0;
+
+			for (uint32_t id : lookups)
+			{
+				sum += static_cast<uint64_t>(std::ranges::find(ids, id) - ids.begin());
+			}
+
+			Benchmark::Consume(sum);
+		});
+
+		Benchmark::Measure(tableLabel.c_str(), [&]()
+		{
+			uint64_t sum = 0;
+
+			for (uint32_t id : lookups)
+			{
+				sum += table.Find(id);
+			}
+
+			Benchmark::Consume(sum);
+		});
+	}
+}
@@ -0,0 +1,147 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OrdinanceIDLookupTable.h"
+#include "TestFramework.h"
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+	std::vector<uint32_t> CreateRandomIDs(size_t count, std::mt19937& random, std::unordered_set<uint32_t>& idSet)
+	{
+		std::vector<uint32_t> ids;
+		ids.reserve(count);
+
+		while (ids.size() < count)
+		{
+			const uint32_t id = random();
+
+			if (idSet.insert(id).second)
+			{
+				ids.push_back(id);
+			}
+		}
+
+		return ids;
+	}
+
+	bool FindsEveryID(const OrdinanceIDLookupTable& table, const std::vector<uint32_t>& ids)
+	{
+		for (uint32_t i = 0; i < ids.size(); i++)
+		{
+			if (table.Find(ids[i]) != i)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+TEST_CASE(OrdinanceIDLookupTable_EmptyTableFindsNothing)
+{
+	OrdinanceIDLookupTable table;
+	CHECK(table.Find(0) == OrdinanceIDLookupTable::npos);
+	CHECK(table.Find(0x12345678) == OrdinanceIDLookupTable::npos);
+
+	table.Build({});
+	CHECK(table.Find(0) == OrdinanceIDLookupTable::npos);
+}
+
+TEST_CASE(OrdinanceIDLookupTable_FindsSmallTables)
+{
+	OrdinanceIDLookupTable table;
+
+	table.Build({ 0 });
+	CHECK(table.Find(0) == 0);
+	CHECK(table.Find(1) == OrdinanceIDLookupTable::npos);
+
+	table.Build({ 0xFFFFFFFF, 0 });
+	CHECK(table.Find(0xFFFFFFFF) == 0);
+	CHECK(table.Find(0) == 1);
+	CHECK(table.Find(0x7FFFFFFF) == OrdinanceIDLookupTable::npos);
+}
+
+TEST_CASE(OrdinanceIDLookupTable_FindsSequentialIDs)
+{
+	// Ordinance instance ids are often allocated in sequence.
+	std::vector<uint32_t> ids;
+
+	for (uint32_t i = 0; i < 5000; i++)
+	{
+		ids.push_back(0x5A3B0000 + i);
+	}
+
+	OrdinanceIDLookupTable table;
+	table.Build(ids);
+
+	CHECK(FindsEveryID(table, ids));
+	CHECK(table.Find(0x5A3B0000 + 5000) == OrdinanceIDLookupTable::npos);
+	CHECK(table.Find(0x5A3AFFFF) == OrdinanceIDLookupTable::npos);
+}
+
+TEST_CASE(OrdinanceIDLookupTable_FindsRandomIDs)
+{
+	std::mt19937 random(1);
+
+	for (size_t count : { 1, 2, 3, 10, 1000, 10000 })
+	{
+		std::unordered_set<uint32_t> idSet;
+		const std::vector<uint32_t> ids = CreateRandomIDs(count, random, idSet);
+
+		OrdinanceIDLookupTable table;
+		table.Build(ids);
+
+		CHECK(FindsEveryID(table, ids));
+
+		uint32_t falseMatchCount = 0;
+
+		for (uint32_t i = 0; i < 10000; i++)
+		{
+			const uint32_t id = random();
+
+			if (!idSet.contains(id) && table.Find(id) != OrdinanceIDLookupTable::npos)
+			{
+				falseMatchCount++;
+			}
+		}
+
+		CHECK(falseMatchCount == 0);
+	}
+}
+
+TEST_CASE(OrdinanceIDLookupTable_BuildReplacesTheTable)
+{
+	OrdinanceIDLookupTable table;
+
+	table.Build({ 1, 2, 3 });
+	table.Build({ 3, 4 });
+
+	CHECK(table.Find(1) == OrdinanceIDLookupTable::npos);
+	CHECK(table.Find(3) == 0);
+	CHECK(table.Find(4) == 1);
+
+	table.Clear();
+	CHECK(table.Find(3) == OrdinanceIDLookupTable::npos);
+}
@@ -0,0 +1,86 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include "OrdinanceProgram.h"
+#include "OrdinanceProgramTestData.h"
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace OrdinanceProgramTestData;
+
+// Compares the compiled programs with the virtual condition and income factor
+// classes that they replaced. The virtual classes read every value through the
+// provider functions as they did before, so that lookup is part of their time.
+// The ordinances do not use Lua functions, their cost would hide the difference
+// in the evaluation.
+BENCHMARK(OrdinanceProgram_EvaluateOrdinances)
+{
+	std::mt19937 random(1);
+
+	const City city = CreateRandomCity(random);
+	SetCurrentCity(&city);
+
+	const OrdinanceProgram::MetricValues metrics = city.GetMetricValues();
+
+	constexpr size_t OrdinanceCount = 2000;
+
+	std::vector<std::unique_ptr<TestOrdinance>> ordinances;
+	ordinances.reserve(OrdinanceCount);
+
+	for (size_t i = 0; i < OrdinanceCount; i++)
+	{
+		ordinances.push_back(CreateRandomOrdinance(random, false));
+	}
+
+	Benchmark::Measure("virtual classes, 2000 ordinances", [&]()
+	{
+		double total = 0;
+
+		for (const auto& ordinance : ordinances)
+		{
+			if (ordinance->CheckConditionsReference())
+			{
+				total += ordinance->CalculateMonthlyIncomeReference();
+			}
+		}
+
+		Benchmark::Consume(static_cast<uint64_t>(total));
+	});
+
+	Benchmark::Measure("program, 2000 ordinances", [&]()
+	{
+		double total = 0;
+
+		for (const auto& ordinance : ordinances)
+		{
+			if (ordinance->program.CheckConditions(metrics))
+			{
+				total += ordinance->program.CalculateMonthlyIncome(ordinance->monthlyConstantIncome, metrics);
+			}
+		}
+
+		Benchmark::Consume(static_cast<uint64_t>(total));
+	});
+
+	SetCurrentCity(nullptr);
+}
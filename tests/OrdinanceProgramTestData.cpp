@@ -0,0 +1,498 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OrdinanceProgramTestData.h"
+#include "BuildingCountAvailabilityCondition.h"
+#include "BuildingCountIncomeFactor.h"
+#include "BuildingCountProvider.h"
+#include "CityMetric.h"
+#include "GameYearAvailabilityCondition.h"
+#include "LuaFunctionAvailabilityCondition.h"
+#include "LuaFunctionIncomeFactor.h"
+#include "PopulationProvider.h"
+#include "RCIGroupPopulationAvailabilityCondition.h"
+#include "RCIGroupPopulationIncomeFactor.h"
+#include "TotalResidentialPopulationIncomeFactor.h"
+#include <array>
+
+using namespace OrdinanceProgramTestData;
+
+namespace
+{
+	const City* currentCity = nullptr;
+
+	// A demand id and a building type that do not have a city metric, the
+	// program queries the game for their values.
+	constexpr uint32_t UnknownDemandID = 0x5000;
+	constexpr uint32_t UnknownBuildingType = 7;
+
+	const std::array<std::string, 2> LuaConditionFunctions = { "condition_a", "condition_b" };
+	const std::array<std::string, 2> LuaIncomeFunctions = { "income_a", "income_b" };
+
+	// The values are read with the same types as the game provides them.
+
+	int32_t GetDemandSupply(uint32_t demandID)
+	{
+		const auto it = currentCity->demandSupply.find(demandID);
+
+		return it != currentCity->demandSupply.end() ? it->second : 0;
+	}
+
+	uint32_t GetBuildingCount(uint32_t type)
+	{
+		const auto it = currentCity->buildingCounts.find(type);
+
+		return it != currentCity->buildingCounts.end() ? it->second : 0;
+	}
+
+	class GameYearReferenceCondition final : public IReferenceCondition
+	{
+	public:
+		explicit GameYearReferenceCondition(uint32_t yearFirstAvailable)
+			: yearFirstAvailable(yearFirstAvailable)
+		{
+		}
+
+		bool CheckCondition() const override
+		{
+			return currentCity->year >= yearFirstAvailable;
+		}
+
+	private:
+		uint32_t yearFirstAvailable;
+	};
+
+	class RCIGroupPopulationReferenceCondition final : public IReferenceCondition
+	{
+	public:
+		RCIGroupPopulationReferenceCondition(uint32_t demandID, int32_t minPopulation)
+			: demandID(demandID), minPopulation(minPopulation)
+		{
+		}
+
+		bool CheckCondition() const override
+		{
+			return PopulationProvider::GetRCIGroupPopulation(demandID) >= minPopulation;
+		}
+
+	private:
+		uint32_t demandID;
+		int32_t minPopulation;
+	};
+
+	class BuildingCountReferenceCondition final : public IReferenceCondition
+	{
+	public:
+		BuildingCountReferenceCondition(BuildingType type, uint32_t minBuildingCount)
+			: type(type), minBuildingCount(minBuildingCount)
+		{
+		}
+
+		bool CheckCondition() const override
+		{
+			return BuildingCountProvider::GetBuildingCount(type) >= minBuildingCount;
+		}
+
+	private:
+		BuildingType type;
+		uint32_t minBuildingCount;
+	};
+
+	class LuaFunctionReferenceCondition final : public IReferenceCondition
+	{
+	public:
+		explicit LuaFunctionReferenceCondition(const cRZBaseString& functionName)
+			: functionName(functionName)
+		{
+		}
+
+		bool CheckCondition() const override
+		{
+			return LuaFunctionAvailabilityCondition::CallFunction(functionName);
+		}
+
+	private:
+		cRZBaseString functionName;
+	};
+
+	class TotalResidentialPopulationReferenceIncomeFactor final : public IReferenceIncomeFactor
+	{
+	public:
+		explicit TotalResidentialPopulationReferenceIncomeFactor(float factor)
+			: monthlyIncomeFactor(factor)
+		{
+		}
+
+		double Calculate(double monthlyIncome) const override
+		{
+			const int32_t cityPopulation = PopulationProvider::GetTotalResidentialPopulation();
+			const double populationIncome = monthlyIncomeFactor * static_cast<double>(cityPopulation);
+
+			return monthlyIncome + populationIncome;
+		}
+
+	private:
+		float monthlyIncomeFactor;
+	};
+
+	class RCIGroupPopulationReferenceIncomeFactor final : public IReferenceIncomeFactor
+	{
+	public:
+		RCIGroupPopulationReferenceIncomeFactor(uint32_t demandID, float factor)
+			: demandID(demandID), monthlyIncomeFactor(factor)
+		{
+		}
+
+		double Calculate(double monthlyIncome) const override
+		{
+			const int32_t population = PopulationProvider::GetRCIGroupPopulation(demandID);
+			const double populationIncome = monthlyIncomeFactor * static_cast<double>(population);
+
+			return monthlyIncome + populationIncome;
+		}
+
+	private:
+		uint32_t demandID;
+		float monthlyIncomeFactor;
+	};
+
+	class BuildingCountReferenceIncomeFactor final : public IReferenceIncomeFactor
+	{
+	public:
+		BuildingCountReferenceIncomeFactor(BuildingType type, float factor)
+			: type(type), monthlyIncomeFactor(factor)
+		{
+		}
+
+		double Calculate(double monthlyIncome) const override
+		{
+			const uint32_t buildingCount = BuildingCountProvider::GetBuildingCount(type);
+			const double perBuildingIncome = static_cast<double>(buildingCount) * monthlyIncomeFactor;
+
+			return monthlyIncome + perBuildingIncome;
+		}
+
+	private:
+		BuildingType type;
+		float monthlyIncomeFactor;
+	};
+
+	class LuaFunctionReferenceIncomeFactor final : public IReferenceIncomeFactor
+	{
+	public:
+		explicit LuaFunctionReferenceIncomeFactor(const cRZBaseString& functionName)
+			: functionName(functionName)
+		{
+		}
+
+		double Calculate(double monthlyIncome) const override
+		{
+			return LuaFunctionIncomeFactor::CallFunction(functionName, monthlyIncome);
+		}
+
+	private:
+		cRZBaseString functionName;
+	};
+
+	uint32_t GetRandomDemandID(std::mt19937& random)
+	{
+		std::uniform_int_distribution<size_t> distribution(0, CityMetricUtil::RCIGroups.size());
+
+		const size_t index = distribution(random);
+
+		return index < CityMetricUtil::RCIGroups.size() ? static_cast<uint32_t>(CityMetricUtil::RCIGroups[index]) : UnknownDemandID;
+	}
+
+	BuildingType GetRandomBuildingType(std::mt19937& random)
+	{
+		std::uniform_int_distribution<uint32_t> distribution(0, static_cast<uint32_t>(CityMetricUtil::BuildingTypeCount));
+
+		const uint32_t value = distribution(random);
+
+		return static_cast<BuildingType>(value < CityMetricUtil::BuildingTypeCount ? value : UnknownBuildingType);
+	}
+
+	float GetRandomFactor(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+
+		return distribution(random);
+	}
+
+	void AddRandomCondition(std::mt19937& random, bool useLuaFunctions, TestOrdinance& ordinance)
+	{
+		std::uniform_int_distribution<int> typeDistribution(0, useLuaFunctions ? 3 : 2);
+
+		switch (typeDistribution(random))
+		{
+		case 0:
+		{
+			const uint32_t year = std::uniform_int_distribution<uint32_t>(2000, 2100)(random);
+
+			GameYearAvailabilityCondition(year).Compile(ordinance.program);
+			ordinance.conditions.push_back(std::make_unique<GameYearReferenceCondition>(year));
+			break;
+		}
+		case 1:
+		{
+			const uint32_t demandID = GetRandomDemandID(random);
+			const int32_t minPopulation = std::uniform_int_distribution<int32_t>(1, 50000)(random);
+
+			// The condition class only accepts RCI groups, the other demand ids
+			// are compiled by the program directly.
+			if (demandID != UnknownDemandID)
+			{
+				RCIGroupPopulationAvailabilityCondition(static_cast<RCIGroup>(demandID), minPopulation).Compile(ordinance.program);
+			}
+			else
+			{
+				ordinance.program.AddDemandSupplyCondition(demandID, static_cast<double>(minPopulation));
+			}
+			ordinance.conditions.push_back(std::make_unique<RCIGroupPopulationReferenceCondition>(demandID, minPopulation));
+			break;
+		}
+		case 2:
+		{
+			const BuildingType type = GetRandomBuildingType(random);
+			const uint32_t minBuildingCount = std::uniform_int_distribution<uint32_t>(1, 20)(random);
+
+			BuildingCountAvailabilityCondition(type, minBuildingCount).Compile(ordinance.program);
+			ordinance.conditions.push_back(std::make_unique<BuildingCountReferenceCondition>(type, minBuildingCount));
+			break;
+		}
+		case 3:
+		{
+			const cRZBaseString functionName(LuaConditionFunctions[std::uniform_int_distribution<size_t>(0, 1)(random)].c_str());
+
+			ordinance.program.AddLuaFunctionCondition(functionName);
+			ordinance.conditions.push_back(std::make_unique<LuaFunctionReferenceCondition>(functionName));
+			break;
+		}
+		}
+	}
+
+	void AddRandomIncomeFactor(std::mt19937& random, bool useLuaFunctions, TestOrdinance& ordinance)
+	{
+		std::uniform_int_distribution<int> typeDistribution(0, useLuaFunctions ? 3 : 2);
+
+		switch (typeDistribution(random))
+		{
+		case 0:
+		{
+			const float factor = GetRandomFactor(random);
+
+			TotalResidentialPopulationIncomeFactor(factor).Compile(ordinance.program);
+			ordinance.incomeFactors.push_back(std::make_unique<TotalResidentialPopulationReferenceIncomeFactor>(factor));
+			break;
+		}
+		case 1:
+		{
+			const uint32_t demandID = GetRandomDemandID(random);
+			const float factor = GetRandomFactor(random);
+
+			if (demandID != UnknownDemandID)
+			{
+				RCIGroupPopulationIncomeFactor(static_cast<RCIGroup>(demandID), factor).Compile(ordinance.program);
+			}
+			else
+			{
+				ordinance.program.AddDemandSupplyIncome(demandID, factor);
+			}
+			ordinance.incomeFactors.push_back(std::make_unique<RCIGroupPopulationReferenceIncomeFactor>(demandID, factor));
+			break;
+		}
+		case 2:
+		{
+			const BuildingType type = GetRandomBuildingType(random);
+			const float factor = GetRandomFactor(random);
+
+			BuildingCountIncomeFactor(type, factor).Compile(ordinance.program);
+			ordinance.incomeFactors.push_back(std::make_unique<BuildingCountReferenceIncomeFactor>(type, factor));
+			break;
+		}
+		case 3:
+		{
+			const cRZBaseString functionName(LuaIncomeFunctions[std::uniform_int_distribution<size_t>(0, 1)(random)].c_str());
+
+			ordinance.program.AddLuaFunctionIncome(functionName);
+			ordinance.incomeFactors.push_back(std::make_unique<LuaFunctionReferenceIncomeFactor>(functionName));
+			break;
+		}
+		}
+	}
+}
+
+// The game functions that OrdinanceProgram and the reference classes call.
+
+int32_t PopulationProvider::GetRCIGroupPopulation(uint32_t demandID)
+{
+	return GetDemandSupply(demandID);
+}
+
+int32_t PopulationProvider::GetTotalResidentialPopulation()
+{
+	return currentCity->totalResidentialPopulation;
+}
+
+uint32_t BuildingCountProvider::GetBuildingCount(BuildingType type)
+{
+	return ::GetBuildingCount(static_cast<uint32_t>(type));
+}
+
+bool LuaFunctionAvailabilityCondition::CallFunction(const cRZBaseString& functionName)
+{
+	const auto it = currentCity->luaConditionResults.find(functionName.ToChar());
+
+	return it != currentCity->luaConditionResults.end() && it->second;
+}
+
+double LuaFunctionIncomeFactor::CallFunction(const cRZBaseString& functionName, double monthlyIncome)
+{
+	const auto it = currentCity->luaIncomeAdjustments.find(functionName.ToChar());
+
+	// The result depends on the income of the previous factors, and replaces it.
+	return it != currentCity->luaIncomeAdjustments.end() ? (monthlyIncome * 0.5) + it->second : monthlyIncome;
+}
+
+OrdinanceProgram::MetricValues City::GetMetricValues() const
+{
+	OrdinanceProgram::MetricValues values{};
+
+	values[static_cast<size_t>(CityMetric::SimYear)] = static_cast<double>(year);
+	values[static_cast<size_t>(CityMetric::TotalResidentialPopulation)] = static_cast<double>(totalResidentialPopulation);
+
+	for (size_t i = 0; i < CityMetricUtil::RCIGroups.size(); i++)
+	{
+		const auto it = demandSupply.find(static_cast<uint32_t>(CityMetricUtil::RCIGroups[i]));
+
+		values[CityMetricUtil::FirstRCIGroupMetric + i] = it != demandSupply.end() ? static_cast<double>(it->second) : 0.0;
+	}
+
+	for (size_t i = 0; i < CityMetricUtil::BuildingTypeCount; i++)
+	{
+		const auto it = buildingCounts.find(static_cast<uint32_t>(i));
+
+		values[CityMetricUtil::FirstBuildingCountMetric + i] = it != buildingCounts.end() ? static_cast<double>(it->second) : 0.0;
+	}
+
+	return values;
+}
+
+void OrdinanceProgramTestData::SetCurrentCity(const City* city)
+{
+	currentCity = city;
+}
+
+bool TestOrdinance::CheckConditionsReference() const
+{
+	for (const auto& condition : conditions)
+	{
+		if (!condition->CheckCondition())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+double TestOrdinance::CalculateMonthlyIncomeReference() const
+{
+	double monthlyIncome = monthlyConstantIncome;
+
+	for (const auto& factor : incomeFactors)
+	{
+		monthlyIncome = factor->Calculate(monthlyIncome);
+	}
+
+	return monthlyIncome;
+}
+
+City OrdinanceProgramTestData::CreateRandomCity(std::mt19937& random)
+{
+	City city{};
+	city.year = std::uniform_int_distribution<uint32_t>(2000, 2100)(random);
+	city.totalResidentialPopulation = std::uniform_int_distribution<int32_t>(0, 500000)(random);
+
+	std::uniform_int_distribution<int32_t> populationDistribution(0, 60000);
+
+	for (RCIGroup group : CityMetricUtil::RCIGroups)
+	{
+		city.demandSupply[static_cast<uint32_t>(group)] = populationDistribution(random);
+	}
+	city.demandSupply[UnknownDemandID] = populationDistribution(random);
+
+	std::uniform_int_distribution<uint32_t> buildingCountDistribution(0, 25);
+
+	for (uint32_t i = 0; i < CityMetricUtil::BuildingTypeCount; i++)
+	{
+		city.buildingCounts[i] = buildingCountDistribution(random);
+	}
+	city.buildingCounts[UnknownBuildingType] = buildingCountDistribution(random);
+
+	std::bernoulli_distribution luaResultDistribution(0.75);
+
+	for (const std::string& name : LuaConditionFunctions)
+	{
+		city.luaConditionResults[name] = luaResultDistribution(random);
+	}
+
+	std::uniform_real_distribution<double> adjustmentDistribution(-1000.0, 1000.0);
+
+	for (const std::string& name : LuaIncomeFunctions)
+	{
+		city.luaIncomeAdjustments[name] = adjustmentDistribution(random);
+	}
+
+	return city;
+}
+
+std::unique_ptr<TestOrdinance> OrdinanceProgramTestData::CreateRandomOrdinance(std::mt19937& random, bool useLuaFunctions)
+{
+	auto ordinance = std::make_unique<TestOrdinance>();
+	ordinance->monthlyConstantIncome = static_cast<double>(std::uniform_int_distribution<int64_t>(-500, 500)(random));
+
+	std::uniform_int_distribution<int> countDistribution(0, 4);
+
+	// The conditions and income factors are added in a random order, the
+	// program keeps the conditions before the income factors.
+	const int conditionCount = countDistribution(random);
+	const int incomeFactorCount = countDistribution(random);
+	int addedConditions = 0;
+	int addedIncomeFactors = 0;
+
+	while (addedConditions < conditionCount || addedIncomeFactors < incomeFactorCount)
+	{
+		if (addedIncomeFactors == incomeFactorCount
+			|| (addedConditions < conditionCount && std::bernoulli_distribution(0.5)(random)))
+		{
+			AddRandomCondition(random, useLuaFunctions, *ordinance);
+			addedConditions++;
+		}
+		else
+		{
+			AddRandomIncomeFactor(random, useLuaFunctions, *ordinance);
+			addedIncomeFactors++;
+		}
+	}
+
+	return ordinance;
+}
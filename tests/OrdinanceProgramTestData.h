@@ -0,0 +1,92 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "BuildingType.h"
+#include "OrdinanceProgram.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// The test data for OrdinanceProgram, and a reference model of the virtual
+// condition and income factor classes that the program replaced.
+// The game functions that the program calls are replaced by stand-ins that
+// read the city that is passed to SetCurrentCity.
+namespace OrdinanceProgramTestData
+{
+	struct City
+	{
+		uint32_t year;
+		int32_t totalResidentialPopulation;
+		// Includes demand ids that are not RCI groups.
+		std::map<uint32_t, int32_t> demandSupply;
+		// Includes building types that do not have a metric.
+		std::map<uint32_t, uint32_t> buildingCounts;
+		std::map<std::string, bool> luaConditionResults;
+		std::map<std::string, double> luaIncomeAdjustments;
+
+		// Gets the values in the same layout as CityStatsSnapshot.
+		OrdinanceProgram::MetricValues GetMetricValues() const;
+	};
+
+	void SetCurrentCity(const City* city);
+
+	// The CheckCondition and Calculate methods of the condition and income factor
+	// classes before they were compiled into a program.
+	class IReferenceCondition
+	{
+	public:
+		virtual ~IReferenceCondition() = default;
+
+		virtual bool CheckCondition() const = 0;
+	};
+
+	class IReferenceIncomeFactor
+	{
+	public:
+		virtual ~IReferenceIncomeFactor() = default;
+
+		virtual double Calculate(double monthlyIncome) const = 0;
+	};
+
+	// An ordinance in both representations.
+	struct TestOrdinance
+	{
+		double monthlyConstantIncome;
+		std::vector<std::unique_ptr<IReferenceCondition>> conditions;
+		std::vector<std::unique_ptr<IReferenceIncomeFactor>> incomeFactors;
+		OrdinanceProgram program;
+
+		bool CheckConditionsReference() const;
+		double CalculateMonthlyIncomeReference() const;
+	};
+
+	// Creates a city that has values for every demand id, building type and
+	// Lua function that CreateRandomOrdinance uses.
+	City CreateRandomCity(std::mt19937& random);
+
+	// Creates an ordinance with random conditions and income factors.
+	// The program is compiled by the condition and income factor classes.
+	std::unique_ptr<TestOrdinance> CreateRandomOrdinance(std::mt19937& random, bool useLuaFunctions);
+}
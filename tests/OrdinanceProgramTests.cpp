@@ -0,0 +1,184 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OrdinanceProgram.h"
+#include "OrdinanceProgramTestData.h"
+#include "TestFramework.h"
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace OrdinanceProgramTestData;
+
+namespace
+{
+	// Clears the city that the game stand-ins read when the test ends.
+	class ScopedCity
+	{
+	public:
+		explicit ScopedCity(const City& city)
+		{
+			SetCurrentCity(&city);
+		}
+
+		~ScopedCity()
+		{
+			SetCurrentCity(nullptr);
+		}
+	};
+
+	City CreateExampleCity()
+	{
+		City city{};
+		city.year = 2010;
+		city.totalResidentialPopulation = 20000;
+		city.demandSupply[static_cast<uint32_t>(RCIGroup::Res1)] = 8000;
+		city.demandSupply[static_cast<uint32_t>(RCIGroup::IHT)] = 1500;
+		city.demandSupply[0x5000] = 300;
+		city.buildingCounts[static_cast<uint32_t>(BuildingType::School)] = 4;
+		city.buildingCounts[7] = 2;
+
+		return city;
+	}
+}
+
+TEST_CASE(OrdinanceProgram_ChecksTheConditions)
+{
+	const City city = CreateExampleCity();
+	ScopedCity scopedCity(city);
+
+	const OrdinanceProgram::MetricValues metrics = city.GetMetricValues();
+
+	OrdinanceProgram empty;
+	CHECK(empty.CheckConditions(metrics));
+
+	OrdinanceProgram program;
+	program.AddMetricCondition(CityMetric::SimYear, 2010.0);
+	program.AddMetricCondition(CityMetric::Res1Population, 8000.0);
+	program.AddDemandSupplyCondition(0x5000, 300.0);
+	program.AddBuildingCountCondition(static_cast<BuildingType>(7), 2.0);
+	CHECK(program.CheckConditions(metrics));
+	CHECK(program.GetConditionCount() == 4);
+
+	OrdinanceProgram failedMetric;
+	failedMetric.AddMetricCondition(CityMetric::SchoolCount, 5.0);
+	CHECK(!failedMetric.CheckConditions(metrics));
+
+	OrdinanceProgram failedDemandSupply;
+	failedDemandSupply.AddDemandSupplyCondition(0x5000, 301.0);
+	CHECK(!failedDemandSupply.CheckConditions(metrics));
+
+	OrdinanceProgram failedBuildingCount;
+	failedBuildingCount.AddBuildingCountCondition(static_cast<BuildingType>(7), 3.0);
+	CHECK(!failedBuildingCount.CheckConditions(metrics));
+}
+
+TEST_CASE(OrdinanceProgram_CalculatesTheMonthlyIncome)
+{
+	const City city = CreateExampleCity();
+	ScopedCity scopedCity(city);
+
+	const OrdinanceProgram::MetricValues metrics = city.GetMetricValues();
+
+	OrdinanceProgram program;
+	program.AddMetricIncome(CityMetric::TotalResidentialPopulation, 0.5);
+	// A condition that is added after an income factor is still a condition.
+	program.AddMetricCondition(CityMetric::SimYear, 2000.0);
+	program.AddMetricIncome(CityMetric::SchoolCount, -25.0);
+	program.AddDemandSupplyIncome(0x5000, 2.0);
+	program.AddBuildingCountIncome(static_cast<BuildingType>(7), 10.0);
+
+	CHECK(program.GetConditionCount() == 1);
+	CHECK(program.GetIncomeInstructionCount() == 4);
+	CHECK(program.GetConditionInstructions()[0].opcode == OrdinanceProgram::Opcode::RequireMetricAtLeast);
+	CHECK(!program.HasLuaIncomeFunction());
+
+	// 100 + 20000 * 0.5 - 4 * 25 + 300 * 2 + 2 * 10
+	CHECK(program.CalculateMonthlyIncome(100.0, metrics) == 10620.0);
+}
+
+TEST_CASE(OrdinanceProgram_LuaIncomeFunctionReplacesTheIncome)
+{
+	City city = CreateExampleCity();
+	city.luaIncomeAdjustments["income"] = 1000.0;
+	city.luaConditionResults["available"] = true;
+	city.luaConditionResults["unavailable"] = false;
+	ScopedCity scopedCity(city);
+
+	const OrdinanceProgram::MetricValues metrics = city.GetMetricValues();
+
+	OrdinanceProgram program;
+	program.AddLuaFunctionCondition(cRZBaseString("available"));
+	program.AddMetricIncome(CityMetric::IHTPopulation, 1.0);
+	program.AddLuaFunctionIncome(cRZBaseString("income"));
+	program.AddMetricIncome(CityMetric::SchoolCount, 1.0);
+
+	CHECK(program.HasLuaIncomeFunction());
+	CHECK(program.CheckConditions(metrics));
+	// ((500 + 1500) * 0.5 + 1000) + 4
+	CHECK(program.CalculateMonthlyIncome(500.0, metrics) == 2004.0);
+
+	program.AddLuaFunctionCondition(cRZBaseString("unavailable"));
+	CHECK(!program.CheckConditions(metrics));
+}
+
+// Compares the compiled programs with the virtual condition and income
+// factor classes that they replaced, the results must be identical.
+TEST_CASE(OrdinanceProgram_MatchesTheVirtualEvaluation)
+{
+	std::mt19937 random(1);
+
+	constexpr int CityCount = 20;
+	constexpr int OrdinanceCount = 500;
+
+	int availableCount = 0;
+
+	for (int i = 0; i < CityCount; i++)
+	{
+		const City city = CreateRandomCity(random);
+		ScopedCity scopedCity(city);
+
+		const OrdinanceProgram::MetricValues metrics = city.GetMetricValues();
+
+		for (int j = 0; j < OrdinanceCount; j++)
+		{
+			const std::unique_ptr<TestOrdinance> ordinance = CreateRandomOrdinance(random, true);
+
+			const bool available = ordinance->program.CheckConditions(metrics);
+
+			CHECK(available == ordinance->CheckConditionsReference());
+			CHECK(ordinance->program.GetConditionCount() == ordinance->conditions.size());
+			CHECK(ordinance->program.CalculateMonthlyIncome(ordinance->monthlyConstantIncome, metrics)
+				== ordinance->CalculateMonthlyIncomeReference());
+
+			if (available)
+			{
+				availableCount++;
+			}
+		}
+	}
+
+	// Both outcomes of the conditions are tested.
+	CHECK(availableCount > 0);
+	CHECK(availableCount < CityCount * OrdinanceCount);
+	std::printf("OrdinanceProgram_MatchesTheVirtualEvaluation: %d of %d ordinances available.\n", availableCount, CityCount * OrdinanceCount);
+}
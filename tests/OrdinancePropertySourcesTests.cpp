@@ -0,0 +1,215 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CompiledOrdinancePackWriter.h"
+#include "ExemplarBuilder.h"
+#include "OrdiancePropertyIDs.h"
+#include "OrdinancePropertySources.h"
+#include "PropertyHolderTestData.h"
+#include "TestFramework.h"
+#include "TestUtil.h"
+#include <vector>
+
+using namespace OrdinancePropertySources;
+
+namespace
+{
+	constexpr uint32_t ExemplarTypeID = 0x6534284A;
+	constexpr uint32_t GroupID = 0x4A5E8EF6;
+	constexpr uint32_t ExemplarTypePropertyID = 0x10;
+	constexpr uint32_t OrdinanceExemplarType = 14;
+
+	// An ordinance that uses every value type that the definition reads.
+	ExemplarBuilder CreateOrdinanceExemplar()
+	{
+		ExemplarBuilder builder;
+		builder
+			.AddUint32(ExemplarTypePropertyID, OrdinanceExemplarType)
+			.AddUint32Array(kOrdinanceNameKey, { 0x2026960B, 0x6A231EA4, 0x12345678 })
+			.AddString(kOrdinanceName, "Ordinance")
+			.AddString(kOrdinanceDescription, "An ordinance with every value type.")
+			.AddSint64(kOrdinanceEnactmentIncome, -500)
+			.AddSint64(kOrdinanceRetracmentIncome, 250)
+			.AddSint64(kOrdinancemMonthlyConstantIncome, -12345678901LL)
+			.AddBool(kOrdinanceIsIncome, true)
+			.AddUint32(kOrdinanceAvailabilityGameYear, 2010)
+			.AddUint32(kOrdinanceAvailabilityMinSchoolBuildingCount, 3)
+			.AddUint32(kOrdinanceAvailabilityMinPopulationCsHighWealth, 1500)
+			.AddString(kOrdinanceMonthlyIncomeFactorLuaFunction, "")
+			.AddFloat32(kOrdinanceMonthlyIncomeFactorResTotalPopulation, 0.125f)
+			.AddFloat32(kOrdinanceMonthlyIncomeFactorIHTPopulation, -2.5f)
+			.AddFloat32(kOrdinanceMonthlyIncomeFactorHospitalCount, 100.75f);
+
+		return builder;
+	}
+
+	// Reads every property with the value type that the ordinance definition
+	// uses for it, which is the value kind in the compiled pack schema.
+	template <typename TPropertySource>
+	uint64_t HashProperties(const TPropertySource& source, const cGZPersistResourceKey& key)
+	{
+		using ValueKind = CompiledOrdinancePackFormat::ValueKind;
+
+		const ContentHashingSource<TPropertySource> hashingSource(source, key);
+
+		for (const CompiledOrdinancePackFormat::PropertySchemaItem& item : CompiledOrdinancePackFormat::PropertySchema)
+		{
+			switch (item.kind)
+			{
+			case ValueKind::Int64:
+			{
+				int64_t value = 0;
+				hashingSource.GetPropertyValue(item.id, value);
+				break;
+			}
+			case ValueKind::Uint32:
+			{
+				uint32_t value = 0;
+				hashingSource.GetPropertyValue(item.id, value);
+				break;
+			}
+			case ValueKind::Float32:
+			{
+				float value = 0.0f;
+				hashingSource.GetPropertyValue(item.id, value);
+				break;
+			}
+			case ValueKind::Bool:
+			{
+				bool value = false;
+				hashingSource.GetPropertyValue(item.id, value);
+				break;
+			}
+			case ValueKind::String:
+			{
+				cRZBaseString value;
+				hashingSource.GetPropertyValue(item.id, value);
+				break;
+			}
+			case ValueKind::StringResourceKey:
+			{
+				StringResourceKey value;
+				hashingSource.GetPropertyValue(item.id, value);
+				break;
+			}
+			}
+		}
+
+		return hashingSource.GetHash();
+	}
+
+	struct SourceHashes
+	{
+		uint64_t propertyHolder;
+		uint64_t propertyTable;
+		uint64_t compiledPack;
+	};
+
+	// Hashes the exemplar through each of the property sources.
+	bool HashExemplar(
+		const TestUtil::TemporaryDirectory& directory,
+		const cGZPersistResourceKey& key,
+		const std::vector<uint8_t>& exemplar,
+		SourceHashes& hashes)
+	{
+		ExemplarPropertyTable table;
+
+		if (!table.Parse(exemplar))
+		{
+			return false;
+		}
+
+		const std::filesystem::path packPath = directory.GetPath() / "ordinances.pack";
+
+		CompiledOrdinancePackWriter writer;
+		CompiledOrdinancePack pack;
+
+		if (!writer.Add(key.type, key.group, key.instance, table)
+			|| !writer.Save(packPath)
+			|| !pack.Open(packPath))
+		{
+			return false;
+		}
+
+		hashes.propertyHolder = HashProperties(PropertyHolderSource(PropertyHolderTestData::AsPropertyHolder(table)), key);
+		hashes.propertyTable = HashProperties(PropertyTableSource(table), key);
+		hashes.compiledPack = HashProperties(CompiledPackSource(pack, 0), key);
+
+		return true;
+	}
+}
+
+TEST_CASE(OrdinancePropertySources_ContentHashDoesNotDependOnTheSource)
+{
+	TestUtil::TemporaryDirectory directory;
+	const cGZPersistResourceKey key(ExemplarTypeID, GroupID, 0x1000);
+
+	SourceHashes hashes{};
+	REQUIRE(HashExemplar(directory, key, CreateOrdinanceExemplar().Build(), hashes));
+
+	CHECK(hashes.propertyHolder == hashes.propertyTable);
+	CHECK(hashes.propertyTable == hashes.compiledPack);
+	CHECK(hashes.propertyHolder != 0);
+}
+
+TEST_CASE(OrdinancePropertySources_ContentHashOfMissingProperties)
+{
+	TestUtil::TemporaryDirectory directory;
+	const cGZPersistResourceKey key(ExemplarTypeID, GroupID, 0x1000);
+
+	// Only the exemplar type, all of the ordinance properties use their defaults.
+	SourceHashes hashes{};
+	REQUIRE(HashExemplar(
+		directory,
+		key,
+		ExemplarBuilder().AddUint32(ExemplarTypePropertyID, OrdinanceExemplarType).Build(),
+		hashes));
+
+	CHECK(hashes.propertyHolder == hashes.propertyTable);
+	CHECK(hashes.propertyTable == hashes.compiledPack);
+}
+
+TEST_CASE(OrdinancePropertySources_ContentHashChangesWithTheValues)
+{
+	TestUtil::TemporaryDirectory directory;
+	const cGZPersistResourceKey key(ExemplarTypeID, GroupID, 0x1000);
+
+	SourceHashes original{};
+	REQUIRE(HashExemplar(directory, key, CreateOrdinanceExemplar().Build(), original));
+
+	SourceHashes changedValue{};
+	REQUIRE(HashExemplar(
+		directory,
+		key,
+		CreateOrdinanceExemplar().AddSint64(kOrdinanceEnactmentIncome, -501).Build(),
+		changedValue));
+
+	SourceHashes changedKey{};
+	REQUIRE(HashExemplar(
+		directory,
+		cGZPersistResourceKey(ExemplarTypeID, GroupID, 0x1001),
+		CreateOrdinanceExemplar().Build(),
+		changedKey));
+
+	CHECK(changedValue.propertyHolder == changedValue.compiledPack);
+	CHECK(changedValue.propertyHolder != original.propertyHolder);
+	CHECK(changedKey.propertyHolder != original.propertyHolder);
+}
@@ -0,0 +1,121 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PersistResourceKeyFilterPipeline.h"
+#include "cGZPersistResourceKey.h"
+#include "TestFramework.h"
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t ExemplarTypeID = 0x6534284A;
+	constexpr uint32_t LTextTypeID = 0x2026960B;
+	constexpr uint32_t MaxisOrdinanceGroupID = 0xAA5C3144;
+	constexpr uint32_t OtherGroupID = 0x4A5E8EF6;
+
+	// The stages that the director uses, followed by a configured group exclusion.
+	void AddDirectorStages(PersistResourceKeyFilterPipeline& filter)
+	{
+		filter.RequireType("Exemplar type", ExemplarTypeID);
+		filter.ExcludeInstances("Maxis ordinance override", { 0x300, 0x100, 0x200 }, MaxisOrdinanceGroupID);
+		filter.ExcludeGroupRange("Configured group exclusion", 0x10000000, 0x1FFFFFFF);
+	}
+
+	bool IsIncluded(PersistResourceKeyFilterPipeline& filter, uint32_t type, uint32_t group, uint32_t instance)
+	{
+		return filter.IsKeyIncluded(cGZPersistResourceKey(type, group, instance));
+	}
+}
+
+TEST_CASE(PersistResourceKeyFilterPipeline_IncludesTheKeysThatPassEveryStage)
+{
+	PersistResourceKeyFilterPipeline filter;
+
+	// An empty pipeline includes every key.
+	CHECK(IsIncluded(filter, LTextTypeID, OtherGroupID, 1));
+
+	AddDirectorStages(filter);
+
+	CHECK(IsIncluded(filter, ExemplarTypeID, OtherGroupID, 1));
+	CHECK(!IsIncluded(filter, LTextTypeID, OtherGroupID, 1));
+
+	// The instance exclusion only applies to its group, the instances are
+	// sorted when the stage is added.
+	CHECK(!IsIncluded(filter, ExemplarTypeID, MaxisOrdinanceGroupID, 0x100));
+	CHECK(!IsIncluded(filter, ExemplarTypeID, MaxisOrdinanceGroupID, 0x300));
+	CHECK(IsIncluded(filter, ExemplarTypeID, MaxisOrdinanceGroupID, 0x150));
+	CHECK(IsIncluded(filter, ExemplarTypeID, OtherGroupID, 0x100));
+
+	// The group range is inclusive.
+	CHECK(IsIncluded(filter, ExemplarTypeID, 0x0FFFFFFF, 1));
+	CHECK(!IsIncluded(filter, ExemplarTypeID, 0x10000000, 1));
+	CHECK(!IsIncluded(filter, ExemplarTypeID, 0x1FFFFFFF, 1));
+	CHECK(IsIncluded(filter, ExemplarTypeID, 0x20000000, 1));
+}
+
+TEST_CASE(PersistResourceKeyFilterPipeline_InstanceExclusionForAnyGroup)
+{
+	PersistResourceKeyFilterPipeline filter;
+	filter.ExcludeInstances("Configured instance exclusion", { 7, 3, 5 });
+
+	CHECK(!IsIncluded(filter, ExemplarTypeID, OtherGroupID, 3));
+	CHECK(!IsIncluded(filter, ExemplarTypeID, MaxisOrdinanceGroupID, 7));
+	CHECK(IsIncluded(filter, ExemplarTypeID, OtherGroupID, 4));
+}
+
+TEST_CASE(PersistResourceKeyFilterPipeline_ConfigurationHashCoversTheStages)
+{
+	PersistResourceKeyFilterPipeline filter;
+	AddDirectorStages(filter);
+
+	// The hash does not depend on the stage names or the instance order.
+	PersistResourceKeyFilterPipeline renamed;
+	renamed.RequireType("Type", ExemplarTypeID);
+	renamed.ExcludeInstances("Instances", { 0x100, 0x200, 0x300 }, MaxisOrdinanceGroupID);
+	renamed.ExcludeGroupRange("Groups", 0x10000000, 0x1FFFFFFF);
+
+	CHECK(filter.GetConfigurationHash() == renamed.GetConfigurationHash());
+
+	// Filtering keys does not change the hash.
+	const uint64_t hash = filter.GetConfigurationHash();
+	IsIncluded(filter, LTextTypeID, OtherGroupID, 1);
+	CHECK(filter.GetConfigurationHash() == hash);
+
+	PersistResourceKeyFilterPipeline differentRange;
+	differentRange.RequireType("Exemplar type", ExemplarTypeID);
+	differentRange.ExcludeInstances("Maxis ordinance override", { 0x100, 0x200, 0x300 }, MaxisOrdinanceGroupID);
+	differentRange.ExcludeGroupRange("Configured group exclusion", 0x10000000, 0x1FFFFFFE);
+
+	PersistResourceKeyFilterPipeline differentInstances;
+	differentInstances.RequireType("Exemplar type", ExemplarTypeID);
+	differentInstances.ExcludeInstances("Maxis ordinance override", { 0x100, 0x200 }, MaxisOrdinanceGroupID);
+	differentInstances.ExcludeGroupRange("Configured group exclusion", 0x10000000, 0x1FFFFFFF);
+
+	PersistResourceKeyFilterPipeline differentOrder;
+	differentOrder.ExcludeInstances("Maxis ordinance override", { 0x100, 0x200, 0x300 }, MaxisOrdinanceGroupID);
+	differentOrder.RequireType("Exemplar type", ExemplarTypeID);
+	differentOrder.ExcludeGroupRange("Configured group exclusion", 0x10000000, 0x1FFFFFFF);
+
+	CHECK(differentRange.GetConfigurationHash() != hash);
+	CHECK(differentInstances.GetConfigurationHash() != hash);
+	CHECK(differentOrder.GetConfigurationHash() != hash);
+	CHECK(PersistResourceKeyFilterPipeline().GetConfigurationHash() != hash);
+}
@@ -0,0 +1,239 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PluginFileEnumerator.h"
+#include "TestFramework.h"
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// An in-memory file system.
+	// The directory contents are returned in the order that they were added,
+	// which is not sorted, so the tests can check that the enumerator sorts them.
+	class FakeFileSystem final : public IFileSystem
+	{
+	public:
+		void AddFile(const std::filesystem::path& path, uint64_t size = 100)
+		{
+			AddDirectory(path.parent_path());
+			directories[path.parent_path()].files.push_back(FileInfo{ path, size, 0 });
+		}
+
+		void AddDirectory(const std::filesystem::path& path)
+		{
+			if (!directories.contains(path))
+			{
+				directories.emplace(path, Directory());
+
+				if (path.has_relative_path())
+				{
+					AddDirectory(path.parent_path());
+					directories[path.parent_path()].subdirectories.push_back(path);
+				}
+			}
+		}
+
+		// The directory can not be read, its files and sub-directories are not returned.
+		void SetUnreadable(const std::filesystem::path& path)
+		{
+			unreadableDirectories.insert(path);
+		}
+
+		bool DirectoryExists(const std::filesystem::path& path) const override
+		{
+			return directories.contains(path);
+		}
+
+		bool GetDirectoryContents(
+			const std::filesystem::path& directory,
+			std::vector<std::filesystem::path>& subdirectories,
+			std::vector<FileInfo>& files) const override
+		{
+			const auto it = directories.find(directory);
+
+			if (it == directories.end() || unreadableDirectories.contains(directory))
+			{
+				return false;
+			}
+
+			subdirectories = it->second.subdirectories;
+			files = it->second.files;
+
+			return true;
+		}
+
+	private:
+		struct Directory
+		{
+			std::vector<std::filesystem::path> subdirectories;
+			std::vector<FileInfo> files;
+		};
+
+		std::map<std::filesystem::path, Directory> directories;
+		std::set<std::filesystem::path> unreadableDirectories;
+	};
+
+	std::vector<std::filesystem::path> GetPaths(const std::vector<FileInfo>& files)
+	{
+		std::vector<std::filesystem::path> paths;
+		paths.reserve(files.size());
+
+		for (const FileInfo& file : files)
+		{
+			paths.push_back(file.path);
+		}
+
+		return paths;
+	}
+
+	// Two plugin roots that both contain an override of the same file.
+	void AddOverlappingRoots(FakeFileSystem& fileSystem)
+	{
+		fileSystem.AddFile("/user/Plugins/z.dat");
+		fileSystem.AddFile("/user/Plugins/b/override.dat");
+		fileSystem.AddFile("/user/Plugins/a/2.dat");
+		fileSystem.AddFile("/user/Plugins/a/1.dat");
+		fileSystem.AddFile("/game/Plugins/override.dat");
+		fileSystem.AddFile("/game/Plugins/b/override.dat");
+		fileSystem.AddFile("/game/Plugins/a.dat");
+	}
+}
+
+TEST_CASE(PluginFileEnumerator_OrdersTheFilesByRootThenPath)
+{
+	FakeFileSystem fileSystem;
+	AddOverlappingRoots(fileSystem);
+
+	const std::vector<std::filesystem::path> expected =
+	{
+		"/user/Plugins/a/1.dat",
+		"/user/Plugins/a/2.dat",
+		"/user/Plugins/b/override.dat",
+		"/user/Plugins/z.dat",
+		"/game/Plugins/a.dat",
+		"/game/Plugins/b/override.dat",
+		"/game/Plugins/override.dat",
+	};
+
+	// The order does not depend on the number of threads.
+	for (uint32_t threadCount : { 1U, 2U, 4U, 16U })
+	{
+		const PluginFileEnumerator enumerator(fileSystem, PluginFileEnumerator::GetDefaultFileExtensions(), threadCount);
+
+		for (int iteration = 0; iteration < 20; iteration++)
+		{
+			std::vector<FileInfo> files;
+			REQUIRE(enumerator.Enumerate({ "/user/Plugins", "/game/Plugins" }, files));
+			CHECK(GetPaths(files) == expected);
+		}
+	}
+}
+
+TEST_CASE(PluginFileEnumerator_EarlierRootsTakePrecedence)
+{
+	FakeFileSystem fileSystem;
+	AddOverlappingRoots(fileSystem);
+
+	const PluginFileEnumerator enumerator(fileSystem, PluginFileEnumerator::GetDefaultFileExtensions(), 4);
+
+	// A caller that keeps the first file with a given relative path keeps the
+	// file from the earliest root.
+	auto getOverrideWinner = [&](const std::vector<std::filesystem::path>& roots)
+	{
+		std::vector<FileInfo> files;
+		enumerator.Enumerate(roots, files);
+
+		for (const FileInfo& file : files)
+		{
+			if (file.path.filename() == "override.dat" && file.path.parent_path().filename() == "b")
+			{
+				return file.path;
+			}
+		}
+
+		return std::filesystem::path();
+	};
+
+	CHECK(getOverrideWinner({ "/user/Plugins", "/game/Plugins" }) == "/user/Plugins/b/override.dat");
+	CHECK(getOverrideWinner({ "/game/Plugins", "/user/Plugins" }) == "/game/Plugins/b/override.dat");
+}
+
+TEST_CASE(PluginFileEnumerator_FiltersByExtension)
+{
+	FakeFileSystem fileSystem;
+	fileSystem.AddFile("/Plugins/lower.dat");
+	fileSystem.AddFile("/Plugins/UPPER.DAT");
+	fileSystem.AddFile("/Plugins/mixed.Sc4Lot");
+	fileSystem.AddFile("/Plugins/model.sc4model");
+	fileSystem.AddFile("/Plugins/desc.sc4desc");
+	fileSystem.AddFile("/Plugins/readme.txt");
+	fileSystem.AddFile("/Plugins/backup.dat.bak");
+	fileSystem.AddFile("/Plugins/dat");
+	fileSystem.AddFile("/Plugins/sub.dir/nested.dat");
+
+	std::vector<FileInfo> files;
+	REQUIRE(PluginFileEnumerator(fileSystem, PluginFileEnumerator::GetDefaultFileExtensions(), 2).Enumerate({ "/Plugins" }, files));
+
+	const std::vector<std::filesystem::path> expected =
+	{
+		"/Plugins/UPPER.DAT",
+		"/Plugins/desc.sc4desc",
+		"/Plugins/lower.dat",
+		"/Plugins/mixed.Sc4Lot",
+		"/Plugins/model.sc4model",
+		"/Plugins/sub.dir/nested.dat",
+	};
+
+	CHECK(GetPaths(files) == expected);
+
+	// A configured extension list replaces the default extensions.
+	REQUIRE(PluginFileEnumerator(fileSystem, { ".TXT" }, 2).Enumerate({ "/Plugins" }, files));
+	CHECK(GetPaths(files) == std::vector<std::filesystem::path>{ "/Plugins/readme.txt" });
+}
+
+TEST_CASE(PluginFileEnumerator_SkipsMissingRootsAndReportsReadErrors)
+{
+	FakeFileSystem fileSystem;
+	fileSystem.AddFile("/Plugins/a.dat");
+	fileSystem.AddFile("/Plugins/locked/b.dat");
+	fileSystem.AddFile("/Plugins/open/c.dat");
+
+	const PluginFileEnumerator enumerator(fileSystem, PluginFileEnumerator::GetDefaultFileExtensions(), 2);
+
+	std::vector<FileInfo> files;
+	CHECK(enumerator.Enumerate({ "/Missing", "/Plugins" }, files));
+	CHECK(files.size() == 3);
+
+	// The directories that can be read are still enumerated.
+	fileSystem.SetUnreadable("/Plugins/locked");
+	CHECK(!enumerator.Enumerate({ "/Plugins" }, files));
+
+	const std::vector<std::filesystem::path> expected =
+	{
+		"/Plugins/a.dat",
+		"/Plugins/open/c.dat",
+	};
+
+	CHECK(GetPaths(files) == expected);
+}
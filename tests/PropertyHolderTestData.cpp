@@ -0,0 +1,87 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PropertyHolderTestData.h"
+#include "cRZBaseString.h"
+#include "SCPropertyUtil.h"
+#include <array>
+#include <string_view>
+
+namespace
+{
+	const ExemplarPropertyTable& GetTable(const cISCPropertyHolder* pPropertyHolder)
+	{
+		return *reinterpret_cast<const ExemplarPropertyTable*>(pPropertyHolder);
+	}
+}
+
+const cISCPropertyHolder* PropertyHolderTestData::AsPropertyHolder(const ExemplarPropertyTable& table)
+{
+	return reinterpret_cast<const cISCPropertyHolder*>(&table);
+}
+
+bool SCPropertyUtil::GetPropertyValue(const cISCPropertyHolder* pPropertyHolder, uint32_t id, uint32_t& value)
+{
+	return GetTable(pPropertyHolder).GetPropertyValue(id, value);
+}
+
+bool SCPropertyUtil::GetPropertyValue(const cISCPropertyHolder* pPropertyHolder, uint32_t id, int64_t& value)
+{
+	return GetTable(pPropertyHolder).GetPropertyValue(id, value);
+}
+
+bool SCPropertyUtil::GetPropertyValue(const cISCPropertyHolder* pPropertyHolder, uint32_t id, float& value)
+{
+	return GetTable(pPropertyHolder).GetPropertyValue(id, value);
+}
+
+bool SCPropertyUtil::GetPropertyValue(const cISCPropertyHolder* pPropertyHolder, uint32_t id, bool& value)
+{
+	return GetTable(pPropertyHolder).GetPropertyValue(id, value);
+}
+
+bool SCPropertyUtil::GetPropertyValue(const cISCPropertyHolder* pPropertyHolder, uint32_t id, cIGZString& value)
+{
+	std::string_view text;
+
+	if (GetTable(pPropertyHolder).GetPropertyValue(id, text))
+	{
+		value.Copy(cRZBaseString(text.data(), static_cast<uint32_t>(text.size())));
+		return true;
+	}
+
+	return false;
+}
+
+bool SCPropertyUtil::GetPropertyValue(const cISCPropertyHolder* pPropertyHolder, uint32_t id, StringResourceKey& value)
+{
+	// The game reads the string resource key from a TGI array, the type is not used.
+	std::array<uint32_t, 3> tgi{};
+
+	if (GetTable(pPropertyHolder).GetPropertyValues(id, tgi))
+	{
+		value.groupID = tgi[1];
+		value.instanceID = tgi[2];
+		return true;
+	}
+
+	return false;
+}
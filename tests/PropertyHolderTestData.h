@@ -0,0 +1,35 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "cISCPropertyHolder.h"
+#include "ExemplarPropertyTable.h"
+
+// Stand-ins for the SCPropertyUtil functions, which read the properties of the
+// game's property holders.
+// The game's property holders are not available in the tests, the stand-ins
+// read the properties from the table that AsPropertyHolder was called with.
+namespace PropertyHolderTestData
+{
+	// Gets a property holder pointer for the SCPropertyUtil stand-ins.
+	// The pointer is only used to find the table, it must not be dereferenced.
+	const cISCPropertyHolder* AsPropertyHolder(const ExemplarPropertyTable& table);
+}
@@ -0,0 +1,112 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include "DBPFFile.h"
+#include "QFSCompression.h"
+#include "QFSTestData.h"
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	void MeasureDecoders(const char* name, const std::vector<std::vector<uint8_t>>& records)
+	{
+		uint64_t uncompressedSize = 0;
+
+		for (const std::vector<uint8_t>& record : records)
+		{
+			uint32_t size = 0;
+
+			if (QFSCompression::GetUncompressedSize(record, size))
+			{
+				uncompressedSize += size;
+			}
+		}
+
+		std::vector<uint8_t> output;
+
+		const std::string referenceLabel = std::string(name) + ", reference decoder";
+		const std::string optimizedLabel = std::string(name) + ", QFSCompression";
+
+		const double referenceTime = Benchmark::Measure(referenceLabel.c_str(), [&]()
+		{
+			for (const std::vector<uint8_t>& record : records)
+			{
+				QFSTestData::DecompressReference(record, output);
+			}
+
+			Benchmark::Consume(output.size());
+		});
+
+		const double optimizedTime = Benchmark::Measure(optimizedLabel.c_str(), [&]()
+		{
+			for (const std::vector<uint8_t>& record : records)
+			{
+				QFSCompression::Decompress(record, output);
+			}
+
+			Benchmark::Consume(output.size());
+		});
+
+		Benchmark::PrintThroughput(referenceLabel.c_str(), uncompressedSize, referenceTime);
+		Benchmark::PrintThroughput(optimizedLabel.c_str(), uncompressedSize, optimizedTime);
+	}
+}
+
+BENCHMARK(QFSCompression_Throughput)
+{
+	std::mt19937 random(1);
+
+	MeasureDecoders("8 MB synthetic stream", { QFSTestData::CreateRandomStream(random, 8 * 1024 * 1024) });
+
+	std::vector<std::vector<uint8_t>> exampleRecords;
+
+	for (const auto& dirEntry : std::filesystem::directory_iterator(EXAMPLES_DIRECTORY))
+	{
+		DBPFFile file;
+
+		if (dirEntry.path().extension() == ".dat" && file.Open(dirEntry.path()))
+		{
+			for (uint32_t i = 0; i < file.GetIndexEntryCount(); i++)
+			{
+				const DBPFFile::IndexEntry entry = file.GetIndexEntry(i);
+
+				if (file.IsRecordCompressed(entry))
+				{
+					const std::span<const uint8_t> recordData = file.GetRecordData(entry);
+					exampleRecords.emplace_back(recordData.begin(), recordData.end());
+				}
+			}
+		}
+	}
+
+	if (!exampleRecords.empty())
+	{
+		MeasureDecoders("examples/*.dat compressed records", exampleRecords);
+	}
+	else
+	{
+		std::printf("  The example files do not have any compressed records.\n");
+	}
+}
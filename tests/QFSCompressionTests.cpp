@@ -0,0 +1,168 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DBPFFile.h"
+#include "QFSCompression.h"
+#include "QFSTestData.h"
+#include "TestFramework.h"
+#include "TestUtil.h"
+#include <cstdio>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+	// Creates a stream that stores the literals and then copies them.
+	std::vector<uint8_t> CreateCopyStream(std::span<const uint8_t> controlBytes, uint32_t uncompressedSize)
+	{
+		std::vector<uint8_t> stream = { 0, 0, 0, 0, 0x10, 0xFB };
+		stream.push_back(static_cast<uint8_t>(uncompressedSize >> 16));
+		stream.push_back(static_cast<uint8_t>(uncompressedSize >> 8));
+		stream.push_back(static_cast<uint8_t>(uncompressedSize));
+		stream.insert(stream.end(), controlBytes.begin(), controlBytes.end());
+		stream.push_back(0xFC);
+
+		stream[0] = static_cast<uint8_t>(stream.size());
+		return stream;
+	}
+}
+
+TEST_CASE(QFSCompression_MatchesTheReferenceDecoder)
+{
+	std::mt19937 random(1);
+
+	for (uint32_t i = 0; i < 2000; i++)
+	{
+		const std::vector<uint8_t> stream = QFSTestData::CreateRandomStream(random, (random() % 20000) + 1);
+
+		std::vector<uint8_t> expected;
+		REQUIRE(QFSTestData::DecompressReference(stream, expected));
+
+		std::vector<uint8_t> actual;
+		CHECK(QFSCompression::Decompress(stream, actual));
+		CHECK(actual == expected);
+	}
+}
+
+TEST_CASE(QFSCompression_RejectsTruncatedStreams)
+{
+	std::mt19937 random(2);
+
+	for (uint32_t i = 0; i < 20; i++)
+	{
+		const std::vector<uint8_t> stream = QFSTestData::CreateRandomStream(random, 500);
+
+		std::vector<uint8_t> expected;
+		REQUIRE(QFSTestData::DecompressReference(stream, expected));
+
+		for (size_t size = 0; size < stream.size(); size++)
+		{
+			std::vector<uint8_t> output;
+			const bool result = QFSCompression::Decompress(std::span<const uint8_t>(stream.data(), size), output);
+
+			// The stream is still complete when only the stop command is removed.
+			CHECK(!result || output == expected);
+		}
+	}
+}
+
+TEST_CASE(QFSCompression_CopiesOverlappingBackReferences)
+{
+	// 4 literals followed by 2 byte commands that copy 10 bytes with the
+	// offsets 3, 1, 4 and 2.
+	const std::vector<uint8_t> controlBytes =
+	{
+		0xE0, 'a', 'b', 'c', 'd',
+		0x1C, 0x02,
+		0x1C, 0x00,
+		0x1C, 0x03,
+		0x1C, 0x01,
+	};
+
+	const std::vector<uint8_t> stream = CreateCopyStream(controlBytes, 44);
+
+	std::vector<uint8_t> expected;
+	REQUIRE(QFSTestData::DecompressReference(stream, expected));
+
+	std::vector<uint8_t> actual;
+	CHECK(QFSCompression::Decompress(stream, actual));
+	CHECK(actual == expected);
+	CHECK(std::string_view(reinterpret_cast<const char*>(actual.data()), 14) == "abcdbcdbcdbcdb");
+}
+
+TEST_CASE(QFSCompression_RejectsInvalidStreams)
+{
+	std::vector<uint8_t> output;
+
+	// A back-reference before the start of the output.
+	const std::vector<uint8_t> beforeStart = { 0xE0, 'a', 'b', 'c', 'd', 0x1C, 0x04 };
+	CHECK(!QFSCompression::Decompress(CreateCopyStream(beforeStart, 14), output));
+
+	// More output than the uncompressed size.
+	const std::vector<uint8_t> tooLong = { 0xE0, 'a', 'b', 'c', 'd', 0x1C, 0x00 };
+	CHECK(!QFSCompression::Decompress(CreateCopyStream(tooLong, 13), output));
+
+	// Less output than the uncompressed size.
+	CHECK(!QFSCompression::Decompress(CreateCopyStream(tooLong, 15), output));
+
+	// Not a QFS header.
+	std::vector<uint8_t> wrongSignature = CreateCopyStream(tooLong, 14);
+	wrongSignature[5] = 0xFA;
+	CHECK(!QFSCompression::IsCompressed(wrongSignature));
+	CHECK(!QFSCompression::Decompress(wrongSignature, output));
+}
+
+TEST_CASE(QFSCompression_DecompressesTheExampleFiles)
+{
+	uint32_t compressedRecordCount = 0;
+
+	for (const auto& dirEntry : std::filesystem::directory_iterator(EXAMPLES_DIRECTORY))
+	{
+		DBPFFile file;
+
+		if (dirEntry.path().extension() != ".dat" || !file.Open(dirEntry.path()))
+		{
+			continue;
+		}
+
+		for (uint32_t i = 0; i < file.GetIndexEntryCount(); i++)
+		{
+			const DBPFFile::IndexEntry entry = file.GetIndexEntry(i);
+
+			if (file.IsRecordCompressed(entry))
+			{
+				const std::span<const uint8_t> recordData = file.GetRecordData(entry);
+
+				std::vector<uint8_t> expected;
+				std::vector<uint8_t> actual;
+
+				CHECK(QFSTestData::DecompressReference(recordData, expected));
+				CHECK(QFSCompression::Decompress(recordData, actual));
+				CHECK(actual == expected);
+				compressedRecordCount++;
+			}
+		}
+	}
+
+	// Print the count, the example files are not required to use compression.
+	std::printf("QFSCompression_DecompressesTheExampleFiles: %u compressed records.\n", compressedRecordCount);
+}
@@ -0,0 +1,236 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "QFSTestData.h"
+#include <algorithm>
+
+namespace
+{
+	// The DBPF compressed size, the QFS signature and the 24-bit uncompressed size.
+	constexpr size_t HeaderSize = 9;
+}
+
+bool QFSTestData::DecompressReference(std::span<const uint8_t> recordData, std::vector<uint8_t>& output)
+{
+	if (recordData.size() < HeaderSize || recordData[4] != 0x10 || recordData[5] != 0xFB)
+	{
+		return false;
+	}
+
+	const size_t uncompressedSize = (static_cast<size_t>(recordData[6]) << 16)
+		| (static_cast<size_t>(recordData[7]) << 8)
+		| recordData[8];
+
+	output.clear();
+	output.reserve(uncompressedSize);
+
+	size_t offset = HeaderSize;
+
+	while (offset < recordData.size())
+	{
+		const uint8_t b0 = recordData[offset];
+		size_t literalLength = 0;
+		size_t copyLength = 0;
+		size_t copyOffset = 0;
+		size_t controlLength = 1;
+		bool endOfData = false;
+
+		if (b0 < 0x80)
+		{
+			controlLength = 2;
+		}
+		else if (b0 < 0xC0)
+		{
+			controlLength = 3;
+		}
+		else if (b0 < 0xE0)
+		{
+			controlLength = 4;
+		}
+
+		if (recordData.size() - offset < controlLength)
+		{
+			return false;
+		}
+
+		const uint8_t* control = recordData.data() + offset;
+
+		if (b0 < 0x80)
+		{
+			literalLength = b0 & 0x03;
+			copyLength = ((b0 & 0x1C) >> 2) + 3;
+			copyOffset = ((b0 & 0x60) << 3) + control[1] + 1;
+		}
+		else if (b0 < 0xC0)
+		{
+			literalLength = (control[1] >> 6) & 0x03;
+			copyLength = (b0 & 0x3F) + 4;
+			copyOffset = ((control[1] & 0x3F) << 8) + control[2] + 1;
+		}
+		else if (b0 < 0xE0)
+		{
+			literalLength = b0 & 0x03;
+			copyLength = ((b0 & 0x0C) << 6) + control[3] + 5;
+			copyOffset = ((b0 & 0x10) << 12) + (control[1] << 8) + control[2] + 1;
+		}
+		else if (b0 < 0xFC)
+		{
+			literalLength = ((b0 & 0x1F) << 2) + 4;
+		}
+		else
+		{
+			literalLength = b0 & 0x03;
+			endOfData = true;
+		}
+
+		offset += controlLength;
+
+		for (size_t i = 0; i < literalLength; i++)
+		{
+			if (offset >= recordData.size())
+			{
+				return false;
+			}
+
+			output.push_back(recordData[offset++]);
+		}
+
+		if (endOfData)
+		{
+			break;
+		}
+
+		if (copyOffset > output.size())
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < copyLength; i++)
+		{
+			output.push_back(output[output.size() - copyOffset]);
+		}
+	}
+
+	return output.size() == uncompressedSize;
+}
+
+std::vector<uint8_t> QFSTestData::CreateRandomStream(std::mt19937& random, size_t minimumLength)
+{
+	std::vector<uint8_t> stream(HeaderSize);
+	size_t outputLength = 0;
+
+	auto addLiterals = [&](size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			stream.push_back(static_cast<uint8_t>(random()));
+		}
+	};
+
+	// The back-reference offset must be within the output that has been written,
+	// including the literals of the same command.
+	auto getCopyOffset = [&](size_t literalLength, size_t maxOffset)
+	{
+		const size_t available = std::min(outputLength + literalLength, maxOffset);
+
+		// Short offsets create overlapping copies of repeating patterns.
+		if ((random() % 4) == 0)
+		{
+			return std::min<size_t>((random() % 8) + 1, available);
+		}
+
+		return (random() % available) + 1;
+	};
+
+	while (outputLength < minimumLength)
+	{
+		const uint32_t command = outputLength == 0 ? 3 : random() % 4;
+
+		if (command == 0)
+		{
+			// 2 byte command: 0-3 literals, a 3-10 byte copy with an offset of up to 1024.
+			const size_t literalLength = random() % 4;
+			const size_t copyLength = (random() % 8) + 3;
+			const size_t offset = getCopyOffset(literalLength, 1024) - 1;
+
+			stream.push_back(static_cast<uint8_t>(literalLength | ((copyLength - 3) << 2) | ((offset >> 8) << 5)));
+			stream.push_back(static_cast<uint8_t>(offset));
+			addLiterals(literalLength);
+			outputLength += literalLength + copyLength;
+		}
+		else if (command == 1)
+		{
+			// 3 byte command: 0-3 literals, a 4-67 byte copy with an offset of up to 16384.
+			const size_t literalLength = random() % 4;
+			const size_t copyLength = (random() % 64) + 4;
+			const size_t offset = getCopyOffset(literalLength, 16384) - 1;
+
+			stream.push_back(static_cast<uint8_t>(0x80 | (copyLength - 4)));
+			stream.push_back(static_cast<uint8_t>((literalLength << 6) | (offset >> 8)));
+			stream.push_back(static_cast<uint8_t>(offset));
+			addLiterals(literalLength);
+			outputLength += literalLength + copyLength;
+		}
+		else if (command == 2)
+		{
+			// 4 byte command: 0-3 literals, a 5-1028 byte copy with an offset of up to 131072.
+			const size_t literalLength = random() % 4;
+			const size_t copyLength = (random() % 1024) + 5;
+			const size_t offset = getCopyOffset(literalLength, 131072) - 1;
+
+			stream.push_back(static_cast<uint8_t>(0xC0 | literalLength | (((copyLength - 5) >> 8) << 2) | ((offset >> 16) << 4)));
+			stream.push_back(static_cast<uint8_t>(offset >> 8));
+			stream.push_back(static_cast<uint8_t>(offset));
+			stream.push_back(static_cast<uint8_t>(copyLength - 5));
+			addLiterals(literalLength);
+			outputLength += literalLength + copyLength;
+		}
+		else
+		{
+			// A literal run of 4-112 bytes.
+			const size_t literalLength = ((random() % 28) * 4) + 4;
+
+			stream.push_back(static_cast<uint8_t>(0xE0 | ((literalLength - 4) >> 2)));
+			addLiterals(literalLength);
+			outputLength += literalLength;
+		}
+	}
+
+	const uint32_t stopLiteralLength = random() % 4;
+	stream.push_back(static_cast<uint8_t>(0xFC | stopLiteralLength));
+	addLiterals(stopLiteralLength);
+	outputLength += stopLiteralLength;
+
+	const uint32_t compressedSize = static_cast<uint32_t>(stream.size());
+
+	for (size_t i = 0; i < 4; i++)
+	{
+		stream[i] = static_cast<uint8_t>(compressedSize >> (i * 8));
+	}
+
+	stream[4] = 0x10;
+	stream[5] = 0xFB;
+	stream[6] = static_cast<uint8_t>(outputLength >> 16);
+	stream[7] = static_cast<uint8_t>(outputLength >> 8);
+	stream[8] = static_cast<uint8_t>(outputLength);
+
+	return stream;
+}
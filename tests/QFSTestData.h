@@ -0,0 +1,40 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+// The QFS test data and the reference decoder that QFSCompression is compared with.
+namespace QFSTestData
+{
+	// Decompresses the DBPF record data one byte at a time, this is the
+	// straightforward RefPack loop that the optimized decoder replaces.
+	// Only the 3 byte size header that SC4 writes is supported.
+	bool DecompressReference(std::span<const uint8_t> recordData, std::vector<uint8_t>& output);
+
+	// Creates a valid QFS stream with a random mix of all of the command types,
+	// including back-references that overlap their output.
+	// The stream decompresses to at least the specified number of bytes.
+	std::vector<uint8_t> CreateRandomStream(std::mt19937& random, size_t minimumLength);
+}
@@ -0,0 +1,89 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestFramework.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	struct RegisteredTest
+	{
+		const char* name;
+		TestFramework::TestFunction function;
+	};
+
+	// The tests are registered by static initializers in the other translation
+	// units, a function-local static avoids depending on their order.
+	std::vector<RegisteredTest>& GetTests()
+	{
+		static std::vector<RegisteredTest> tests;
+
+		return tests;
+	}
+
+	uint32_t failureCount = 0;
+}
+
+bool TestFramework::RegisterTest(const char* name, TestFunction function)
+{
+	GetTests().push_back(RegisteredTest{ name, function });
+	return true;
+}
+
+void TestFramework::ReportFailure(const char* file, int line, const char* expression)
+{
+	std::printf("%s(%d): check failed: %s\n", file, line, expression);
+	failureCount++;
+}
+
+// Runs all of the tests, or the tests whose name contains the first argument.
+int main(int argc, char** argv)
+{
+	const char* filter = argc > 1 ? argv[1] : nullptr;
+
+	uint32_t testCount = 0;
+	uint32_t failedTestCount = 0;
+
+	for (const RegisteredTest& test : GetTests())
+	{
+		if (filter && !std::strstr(test.name, filter))
+		{
+			continue;
+		}
+
+		const uint32_t previousFailureCount = failureCount;
+
+		test.function();
+		testCount++;
+
+		if (failureCount != previousFailureCount)
+		{
+			std::printf("FAILED: %s\n", test.name);
+			failedTestCount++;
+		}
+	}
+
+	std::printf("%u of %u tests passed.\n", testCount - failedTestCount, testCount);
+
+	return failedTestCount == 0 ? 0 : 1;
+}
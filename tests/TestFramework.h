@@ -0,0 +1,59 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstdint>
+
+// A minimal test harness, the tests are registered by the TEST_CASE macro and
+// run in registration order by TestFramework.cpp.
+// A failed CHECK reports the expression and continues the test, a failed
+// REQUIRE also ends the test.
+namespace TestFramework
+{
+	using TestFunction = void(*)();
+
+	bool RegisterTest(const char* name, TestFunction function);
+	void ReportFailure(const char* file, int line, const char* expression);
+}
+
+#define TEST_CASE(name) \
+	static void name(); \
+	static const bool name##Registered = TestFramework::RegisterTest(#name, name); \
+	static void name()
+
+#define CHECK(expression) \
+	do \
+	{ \
+		if (!(expression)) \
+		{ \
+			TestFramework::ReportFailure(__FILE__, __LINE__, #expression); \
+		} \
+	} while (false)
+
+#define REQUIRE(expression) \
+	do \
+	{ \
+		if (!(expression)) \
+		{ \
+			TestFramework::ReportFailure(__FILE__, __LINE__, #expression); \
+			return; \
+		} \
+	} while (false)
@@ -0,0 +1,122 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestUtil.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <string>
+
+namespace
+{
+	std::atomic<uint32_t> directoryCount = 0;
+}
+
+TestUtil::TemporaryDirectory::TemporaryDirectory()
+{
+	// The time stamp keeps the name unique between test runs, the counter
+	// keeps it unique within a run.
+	const auto timeStamp = std::chrono::steady_clock::now().time_since_epoch().count();
+
+	path = std::filesystem::temp_directory_path()
+		/ ("ordinance-host-test-" + std::to_string(timeStamp) + "-" + std::to_string(directoryCount++));
+
+	std::filesystem::create_directories(path);
+}
+
+TestUtil::TemporaryDirectory::~TemporaryDirectory()
+{
+	std::error_code ec;
+	std::filesystem::remove_all(path, ec);
+}
+
+const std::filesystem::path& TestUtil::TemporaryDirectory::GetPath() const
+{
+	return path;
+}
+
+std::vector<uint8_t> TestUtil::ToBytes(std::string_view text)
+{
+	return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+bool TestUtil::ReadFile(const std::filesystem::path& path, std::vector<uint8_t>& data)
+{
+	std::ifstream stream(path, std::ios::binary);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	data.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	return !stream.bad();
+}
+
+bool TestUtil::WriteFile(const std::filesystem::path& path, std::span<const uint8_t> data)
+{
+	std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	stream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+	return static_cast<bool>(stream);
+}
+
+std::vector<uint8_t> TestUtil::CompressWithLiterals(std::span<const uint8_t> data)
+{
+	// The DBPF compressed size, the QFS signature and the 24-bit uncompressed size.
+	std::vector<uint8_t> output(9);
+	output[4] = 0x10;
+	output[5] = 0xFB;
+	output[6] = static_cast<uint8_t>(data.size() >> 16);
+	output[7] = static_cast<uint8_t>(data.size() >> 8);
+	output[8] = static_cast<uint8_t>(data.size());
+
+	size_t offset = 0;
+
+	// A literal run command copies a multiple of 4 bytes, up to 112 bytes.
+	while ((data.size() - offset) >= 4)
+	{
+		const size_t length = std::min<size_t>((data.size() - offset) & ~static_cast<size_t>(3), 112);
+
+		output.push_back(static_cast<uint8_t>(0xE0 | ((length - 4) >> 2)));
+		output.insert(output.end(), data.begin() + offset, data.begin() + offset + length);
+		offset += length;
+	}
+
+	// The stop command copies the remaining 0 to 3 bytes.
+	output.push_back(static_cast<uint8_t>(0xFC | (data.size() - offset)));
+	output.insert(output.end(), data.begin() + offset, data.end());
+
+	const uint32_t compressedSize = static_cast<uint32_t>(output.size());
+
+	for (size_t i = 0; i < 4; i++)
+	{
+		output[i] = static_cast<uint8_t>(compressedSize >> (i * 8));
+	}
+
+	return output;
+}
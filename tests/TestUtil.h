@@ -0,0 +1,56 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace TestUtil
+{
+	// A uniquely named directory in the system temporary directory, the directory
+	// and its contents are deleted when the object is destroyed.
+	class TemporaryDirectory
+	{
+	public:
+		TemporaryDirectory();
+		~TemporaryDirectory();
+
+		TemporaryDirectory(const TemporaryDirectory& other) = delete;
+		TemporaryDirectory& operator=(const TemporaryDirectory& other) = delete;
+
+		const std::filesystem::path& GetPath() const;
+
+	private:
+		std::filesystem::path path;
+	};
+
+	std::vector<uint8_t> ToBytes(std::string_view text);
+
+	bool ReadFile(const std::filesystem::path& path, std::vector<uint8_t>& data);
+	bool WriteFile(const std::filesystem::path& path, std::span<const uint8_t> data);
+
+	// Creates QFS compressed DBPF record data that stores the data as literal runs,
+	// without any back-references.
+	std::vector<uint8_t> CompressWithLiterals(std::span<const uint8_t> data);
+}
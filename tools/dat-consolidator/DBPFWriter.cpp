@@ -0,0 +1,299 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DBPFWriter.h"
+#include "HashUtil.h"
+#include "QFSCompression.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <tuple>
+#include <unordered_map>
+
+namespace
+{
+	constexpr uint32_t DBPFSignature = 0x46504244; // DBPF
+	constexpr uint32_t CompressedRecordDirectoryType = 0xE86B1EEF;
+	constexpr uint32_t CompressedRecordDirectoryGroup = 0xE86B1EEF;
+	constexpr uint32_t CompressedRecordDirectoryInstance = 0x286B1F03;
+
+	constexpr size_t HeaderSize = 96;
+	constexpr size_t IndexEntrySize = 20;
+	constexpr size_t CompressedRecordDirectoryEntrySize = 16;
+
+	struct IndexEntry
+	{
+		uint32_t type;
+		uint32_t group;
+		uint32_t instance;
+		uint32_t offset;
+		uint32_t size;
+	};
+
+	void WriteUint32(uint8_t* data, uint32_t value)
+	{
+		data[0] = static_cast<uint8_t>(value);
+		data[1] = static_cast<uint8_t>(value >> 8);
+		data[2] = static_cast<uint8_t>(value >> 16);
+		data[3] = static_cast<uint8_t>(value >> 24);
+	}
+
+	void AppendUint32(std::vector<uint8_t>& buffer, uint32_t value)
+	{
+		const size_t offset = buffer.size();
+		buffer.resize(offset + sizeof(value));
+		WriteUint32(buffer.data() + offset, value);
+	}
+
+	bool KeyLessThan(uint32_t lhsType, uint32_t lhsGroup, uint32_t lhsInstance, uint32_t rhsType, uint32_t rhsGroup, uint32_t rhsInstance)
+	{
+		return std::tie(lhsType, lhsGroup, lhsInstance) < std::tie(rhsType, rhsGroup, rhsInstance);
+	}
+}
+
+DBPFWriter::DBPFWriter() : records()
+{
+}
+
+bool DBPFWriter::Add(
+	uint32_t type,
+	uint32_t group,
+	uint32_t instance,
+	std::span<const uint8_t> data,
+	bool compressed)
+{
+	uint32_t uncompressedSize = static_cast<uint32_t>(data.size());
+
+	if (compressed && !QFSCompression::GetUncompressedSize(data, uncompressedSize))
+	{
+		return false;
+	}
+
+	records.push_back(Record{ type, group, instance, data, compressed, uncompressedSize });
+	return true;
+}
+
+bool DBPFWriter::Save(const std::filesystem::path& path, Statistics& statistics) const
+{
+	statistics = Statistics{};
+
+	// The records are sorted by key, the sort is stable so the last record that
+	// was added for each key is the last record in each run of equal keys.
+
+	std::vector<const Record*> sortedRecords;
+	sortedRecords.reserve(records.size());
+
+	for (const Record& record : records)
+	{
+		sortedRecords.push_back(&record);
+	}
+
+	std::stable_sort(
+		sortedRecords.begin(),
+		sortedRecords.end(),
+		[](const Record* lhs, const Record* rhs)
+		{
+			return KeyLessThan(lhs->type, lhs->group, lhs->instance, rhs->type, rhs->group, rhs->instance);
+		});
+
+	std::vector<const Record*> outputRecords;
+	outputRecords.reserve(sortedRecords.size());
+
+	for (size_t i = 0; i < sortedRecords.size(); i++)
+	{
+		const Record* record = sortedRecords[i];
+
+		if ((i + 1) < sortedRecords.size()
+			&& record->type == sortedRecords[i + 1]->type
+			&& record->group == sortedRecords[i + 1]->group
+			&& record->instance == sortedRecords[i + 1]->instance)
+		{
+			statistics.overriddenRecordCount++;
+			continue;
+		}
+
+		outputRecords.push_back(record);
+	}
+
+	// Lay out the record data, identical records share a single copy of the data.
+	// The records are matched by a hash of their data, and then compared to rule
+	// out hash collisions.
+
+	std::vector<IndexEntry> index;
+	index.reserve(outputRecords.size() + 1);
+
+	std::vector<std::span<const uint8_t>> dataBlocks;
+	std::unordered_map<uint64_t, std::vector<size_t>> dataBlocksByHash;
+	dataBlocksByHash.reserve(outputRecords.size());
+
+	uint64_t offset = HeaderSize;
+
+	for (const Record* record : outputRecords)
+	{
+		const uint64_t hash = HashUtil::Fnv1a64(record->data.data(), record->data.size());
+		std::vector<size_t>& candidates = dataBlocksByHash[hash];
+
+		const auto existing = std::find_if(
+			candidates.begin(),
+			candidates.end(),
+			[&](size_t entryIndex)
+			{
+				const std::span<const uint8_t> other = dataBlocks[entryIndex];
+
+				return other.size() == record->data.size()
+					&& std::equal(other.begin(), other.end(), record->data.begin());
+			});
+
+		if (existing != candidates.end())
+		{
+			const IndexEntry& other = index[*existing];
+
+			index.push_back(IndexEntry{ record->type, record->group, record->instance, other.offset, other.size });
+			dataBlocks.push_back(std::span<const uint8_t>());
+			statistics.sharedRecordCount++;
+		}
+		else
+		{
+			candidates.push_back(index.size());
+			index.push_back(IndexEntry{
+				record->type,
+				record->group,
+				record->instance,
+				static_cast<uint32_t>(offset),
+				static_cast<uint32_t>(record->data.size()) });
+			dataBlocks.push_back(record->data);
+			offset += record->data.size();
+		}
+	}
+
+	std::vector<uint8_t> compressedRecordDirectory;
+
+	for (const Record* record : outputRecords)
+	{
+		if (record->compressed)
+		{
+			AppendUint32(compressedRecordDirectory, record->type);
+			AppendUint32(compressedRecordDirectory, record->group);
+			AppendUint32(compressedRecordDirectory, record->instance);
+			AppendUint32(compressedRecordDirectory, record->uncompressedSize);
+		}
+	}
+
+	if (!compressedRecordDirectory.empty())
+	{
+		IndexEntry directoryEntry{
+			CompressedRecordDirectoryType,
+			CompressedRecordDirectoryGroup,
+			CompressedRecordDirectoryInstance,
+			static_cast<uint32_t>(offset),
+			static_cast<uint32_t>(compressedRecordDirectory.size()) };
+
+		index.insert(
+			std::upper_bound(
+				index.begin(),
+				index.end(),
+				directoryEntry,
+				[](const IndexEntry& lhs, const IndexEntry& rhs)
+				{
+					return KeyLessThan(lhs.type, lhs.group, lhs.instance, rhs.type, rhs.group, rhs.instance);
+				}),
+			directoryEntry);
+		dataBlocks.push_back(compressedRecordDirectory);
+
+		offset += compressedRecordDirectory.size();
+	}
+
+	const uint64_t indexOffset = offset;
+	const uint64_t indexSize = static_cast<uint64_t>(index.size()) * IndexEntrySize;
+
+	// The DBPF offsets are 32-bit values.
+	if (indexOffset + indexSize > std::numeric_limits<uint32_t>::max())
+	{
+		return false;
+	}
+
+	std::array<uint8_t, HeaderSize> header{};
+	WriteUint32(header.data(), DBPFSignature);
+	WriteUint32(header.data() + 4, 1); // Major version
+	WriteUint32(header.data() + 8, 0); // Minor version
+	WriteUint32(header.data() + 32, 7); // Index major version
+	WriteUint32(header.data() + 36, static_cast<uint32_t>(index.size()));
+	WriteUint32(header.data() + 40, static_cast<uint32_t>(indexOffset));
+	WriteUint32(header.data() + 44, static_cast<uint32_t>(indexSize));
+
+	std::vector<uint8_t> indexTable(static_cast<size_t>(indexSize));
+
+	for (size_t i = 0; i < index.size(); i++)
+	{
+		uint8_t* entry = indexTable.data() + (i * IndexEntrySize);
+
+		WriteUint32(entry, index[i].type);
+		WriteUint32(entry + 4, index[i].group);
+		WriteUint32(entry + 8, index[i].instance);
+		WriteUint32(entry + 12, index[i].offset);
+		WriteUint32(entry + 16, index[i].size);
+	}
+
+	// The file is written to a temporary file that replaces the existing file,
+	// this prevents a partially written file from being left in the plugins folder.
+
+	std::filesystem::path tempFilePath = path;
+	tempFilePath += ".tmp";
+
+	{
+		std::ofstream stream(tempFilePath, std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+
+		if (!stream)
+		{
+			return false;
+		}
+
+		stream.write(reinterpret_cast<const char*>(header.data()), header.size());
+
+		for (const std::span<const uint8_t>& block : dataBlocks)
+		{
+			stream.write(reinterpret_cast<const char*>(block.data()), block.size());
+		}
+
+		stream.write(reinterpret_cast<const char*>(indexTable.data()), indexTable.size());
+		stream.flush();
+
+		if (!stream)
+		{
+			return false;
+		}
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(tempFilePath, path, ec);
+
+	if (ec)
+	{
+		return false;
+	}
+
+	statistics.recordCount = static_cast<uint32_t>(outputRecords.size());
+	statistics.fileSize = indexOffset + indexSize;
+
+	return true;
+}
@@ -0,0 +1,68 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+// Writes a DBPF 1.0 file with a version 7.0 index, the format that SC4 uses.
+// The index is sorted by type, group and instance id, and the compressed
+// record directory is generated from the records that are marked as compressed.
+class DBPFWriter
+{
+public:
+	struct Statistics
+	{
+		uint32_t recordCount;
+		// The number of records that were replaced by a later record with the
+		// same type, group and instance id.
+		uint32_t overriddenRecordCount;
+		// The number of records that share the data of an identical record.
+		uint32_t sharedRecordCount;
+		uint64_t fileSize;
+	};
+
+	DBPFWriter();
+
+	// Adds a record, a record with the same type, group and instance id that was
+	// added earlier is replaced when the file is saved.
+	// The data is not copied, it must remain valid until Save returns.
+	// Returns false if the record is compressed and the data does not start
+	// with a QFS header.
+	bool Add(uint32_t type, uint32_t group, uint32_t instance, std::span<const uint8_t> data, bool compressed);
+
+	bool Save(const std::filesystem::path& path, Statistics& statistics) const;
+
+private:
+	struct Record
+	{
+		uint32_t type;
+		uint32_t group;
+		uint32_t instance;
+		std::span<const uint8_t> data;
+		bool compressed;
+		uint32_t uncompressedSize;
+	};
+
+	std::vector<Record> records;
+};
@@ -0,0 +1,229 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// A command line tool that merges the DAT files in the custom ordinance folder
+// into a single DAT file.
+// The game opens and indexes every file in the ordinance folder when it starts,
+// a single file with a sorted index is faster to load than many small files.
+
+#include "DBPFFile.h"
+#include "DBPFWriter.h"
+#include "OrdinanceDiscoveryPipeline.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t CompressedRecordDirectoryType = 0xE86B1EEF;
+
+	struct Options
+	{
+		std::vector<std::filesystem::path> inputs;
+		std::filesystem::path outputPath;
+	};
+
+	std::string ToDisplayString(const std::filesystem::path& path)
+	{
+		const std::u8string utf8 = path.u8string();
+
+		return std::string(utf8.begin(), utf8.end());
+	}
+
+	void PrintUsage()
+	{
+		std::puts(
+			"Usage: dat-consolidator -o <output file> <file or directory>...\n"
+			"\n"
+			"Merges the DAT files into a single DAT file, directories are searched recursively.\n"
+			"The files are merged in path order, when more than one file has a resource with the\n"
+			"same type, group and instance id the resource in the last file is used.");
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const std::string_view arg(argv[i]);
+
+			if ((arg == "-o" || arg == "--output") && (i + 1) < argc)
+			{
+				options.outputPath = argv[++i];
+			}
+			else if (arg.starts_with("-"))
+			{
+				return false;
+			}
+			else
+			{
+				options.inputs.emplace_back(argv[i]);
+			}
+		}
+
+		return !options.inputs.empty() && !options.outputPath.empty();
+	}
+
+	bool GetInputFiles(const Options& options, std::vector<std::filesystem::path>& files)
+	{
+		for (const std::filesystem::path& input : options.inputs)
+		{
+			std::error_code ec;
+
+			if (std::filesystem::is_directory(input, ec))
+			{
+				const std::vector<std::filesystem::path> directoryFiles = OrdinanceDiscoveryPipeline::GetFilesInDirectory(input);
+
+				files.insert(files.end(), directoryFiles.begin(), directoryFiles.end());
+			}
+			else if (std::filesystem::is_regular_file(input, ec))
+			{
+				files.push_back(input);
+			}
+			else
+			{
+				std::fprintf(stderr, "%s: No such file or directory.\n", ToDisplayString(input).c_str());
+				return false;
+			}
+		}
+
+		// The output file is skipped when it is in one of the input directories.
+		std::erase_if(
+			files,
+			[&](const std::filesystem::path& file)
+			{
+				std::error_code ec;
+				return std::filesystem::equivalent(file, options.outputPath, ec);
+			});
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	std::vector<std::filesystem::path> paths;
+
+	if (!GetInputFiles(options, paths))
+	{
+		return EXIT_FAILURE;
+	}
+
+	// The files must stay open until the output file has been written.
+	std::vector<std::unique_ptr<DBPFFile>> files;
+	files.reserve(paths.size());
+
+	DBPFWriter writer;
+	uint64_t inputSize = 0;
+	uint32_t inputRecordCount = 0;
+	uint32_t skippedFileCount = 0;
+
+	for (const std::filesystem::path& path : paths)
+	{
+		std::unique_ptr<DBPFFile> file = std::make_unique<DBPFFile>();
+
+		if (!file->Open(path))
+		{
+			std::printf("%s: warning: The file is not a DBPF 1.0 file, it was skipped.\n", ToDisplayString(path).c_str());
+			skippedFileCount++;
+			continue;
+		}
+
+		const uint32_t entryCount = file->GetIndexEntryCount();
+
+		for (uint32_t i = 0; i < entryCount; i++)
+		{
+			const DBPFFile::IndexEntry entry = file->GetIndexEntry(i);
+
+			if (entry.type == CompressedRecordDirectoryType)
+			{
+				// The compressed record directory is generated by the writer.
+				continue;
+			}
+
+			const std::span<const uint8_t> data = file->GetRecordData(entry);
+
+			if (data.size() != entry.size
+				|| !writer.Add(entry.type, entry.group, entry.instance, data, file->IsRecordCompressed(entry)))
+			{
+				std::printf(
+					"%s: warning: 0x%08x, 0x%08x, 0x%08x: The resource is invalid, it was skipped.\n",
+					ToDisplayString(path).c_str(),
+					entry.type,
+					entry.group,
+					entry.instance);
+				continue;
+			}
+
+			inputRecordCount++;
+		}
+
+		std::error_code ec;
+		const uintmax_t size = std::filesystem::file_size(path, ec);
+
+		if (!ec)
+		{
+			inputSize += size;
+		}
+
+		files.push_back(std::move(file));
+	}
+
+	DBPFWriter::Statistics statistics{};
+
+	if (!writer.Save(options.outputPath, statistics))
+	{
+		std::fprintf(stderr, "%s: Failed to write the output file.\n", ToDisplayString(options.outputPath).c_str());
+		return EXIT_FAILURE;
+	}
+
+	std::printf(
+		"Consolidated %zu files (%llu bytes) into %s (%llu bytes).\n",
+		files.size(),
+		static_cast<unsigned long long>(inputSize),
+		ToDisplayString(options.outputPath).c_str(),
+		static_cast<unsigned long long>(statistics.fileSize));
+	std::printf(
+		"%u resources read, %u written, %u overridden by a later file, %u identical resources share their data.\n",
+		inputRecordCount,
+		statistics.recordCount,
+		statistics.overriddenRecordCount,
+		statistics.sharedRecordCount);
+
+	if (skippedFileCount > 0)
+	{
+		std::printf("%u files were skipped.\n", skippedFileCount);
+	}
+
+	return EXIT_SUCCESS;
+}
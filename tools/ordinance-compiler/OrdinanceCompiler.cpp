@@ -0,0 +1,451 @@
+/*
+ * This file is part of SC4CustomOrdinanceHost, a DLL Plugin for SimCity 4
+ * that allows new ordinances to be defined in exemplars.
+ *
+ * Copyright (C) 2025 Nicholas Hayes
+ *
+ * SC4CustomOrdinanceHost is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * SC4CustomOrdinanceHost is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SC4CustomOrdinanceHost.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// A command line tool that checks the ordinance exemplars in DAT files without
+// starting the game, and optionally writes a compiled ordinance pack.
+// The tool uses the same exemplar decoding code as the plugin, see the README.
+
+#include "CompiledOrdinancePackFormat.h"
+#include "CompiledOrdinancePackWriter.h"
+#include "ExemplarPropertyTable.h"
+#include "MaxisOrdinanceIDs.h"
+#include "OrdiancePropertyIDs.h"
+#include "OrdinanceDiscoveryPipeline.h"
+#include <array>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using ExemplarStatus = OrdinanceDiscoveryPipeline::ExemplarStatus;
+using DiscoveredExemplar = OrdinanceDiscoveryPipeline::DiscoveredExemplar;
+
+namespace
+{
+	constexpr uint32_t kSC4StartYear = 2000;
+	// The game displays the year with 4 digits.
+	constexpr uint32_t kMaxGameYear = 9999;
+
+	struct Options
+	{
+		std::vector<std::filesystem::path> inputs;
+		std::filesystem::path packPath;
+		uint32_t threadCount = 0;
+	};
+
+	class Report
+	{
+	public:
+		explicit Report(const std::vector<std::filesystem::path>& files)
+			: files(files), errorCount(0), warningCount(0)
+		{
+		}
+
+		void Error(const DiscoveredExemplar& item, const char* format, ...)
+		{
+			va_list args;
+			va_start(args, format);
+			Write("error", item, format, args);
+			va_end(args);
+
+			errorCount++;
+		}
+
+		void Warning(const DiscoveredExemplar& item, const char* format, ...)
+		{
+			va_list args;
+			va_start(args, format);
+			Write("warning", item, format, args);
+			va_end(args);
+
+			warningCount++;
+		}
+
+		uint32_t GetErrorCount() const
+		{
+			return errorCount;
+		}
+
+		uint32_t GetWarningCount() const
+		{
+			return warningCount;
+		}
+
+	private:
+		void Write(const char* level, const DiscoveredExemplar& item, const char* format, va_list args)
+		{
+			const std::u8string path = files[item.fileIndex].u8string();
+
+			std::printf(
+				"%s: %s: 0x%08x, 0x%08x, 0x%08x: ",
+				reinterpret_cast<const char*>(path.c_str()),
+				level,
+				item.key.type,
+				item.key.group,
+				item.key.instance);
+			std::vprintf(format, args);
+			std::putchar('\n');
+		}
+
+		const std::vector<std::filesystem::path>& files;
+		uint32_t errorCount;
+		uint32_t warningCount;
+	};
+
+	void PrintUsage()
+	{
+		std::puts(
+			"Usage: ordinance-compiler [options] <file or directory>...\n"
+			"\n"
+			"Checks the ordinance exemplars in the DAT files, directories are searched recursively.\n"
+			"\n"
+			"Options:\n"
+			"  --pack <path>    Writes a compiled ordinance pack if there are no errors.\n"
+			"  --threads <n>    The number of worker threads, the default is the number of hardware threads.");
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const std::string_view arg(argv[i]);
+
+			if (arg == "--pack" && (i + 1) < argc)
+			{
+				options.packPath = argv[++i];
+			}
+			else if (arg == "--threads" && (i + 1) < argc)
+			{
+				options.threadCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+			}
+			else if (arg.starts_with("--"))
+			{
+				return false;
+			}
+			else
+			{
+				options.inputs.emplace_back(argv[i]);
+			}
+		}
+
+		return !options.inputs.empty();
+	}
+
+	bool GetInputFiles(const Options& options, std::vector<std::filesystem::path>& files, uint64_t& totalSize)
+	{
+		totalSize = 0;
+
+		for (const std::filesystem::path& input : options.inputs)
+		{
+			std::error_code ec;
+
+			if (std::filesystem::is_directory(input, ec))
+			{
+				const std::vector<std::filesystem::path> directoryFiles = OrdinanceDiscoveryPipeline::GetFilesInDirectory(input);
+
+				files.insert(files.end(), directoryFiles.begin(), directoryFiles.end());
+			}
+			else if (std::filesystem::is_regular_file(input, ec))
+			{
+				files.push_back(input);
+			}
+			else
+			{
+				const std::u8string path = input.u8string();
+
+				std::fprintf(stderr, "%s: No such file or directory.\n", reinterpret_cast<const char*>(path.c_str()));
+				return false;
+			}
+		}
+
+		for (const std::filesystem::path& file : files)
+		{
+			std::error_code ec;
+			const uintmax_t size = std::filesystem::file_size(file, ec);
+
+			if (!ec)
+			{
+				totalSize += size;
+			}
+		}
+
+		return true;
+	}
+
+	bool HasValueOfKind(
+		const ExemplarPropertyTable& properties,
+		uint32_t id,
+		CompiledOrdinancePackFormat::ValueKind kind)
+	{
+		using ValueKind = CompiledOrdinancePackFormat::ValueKind;
+
+		switch (kind)
+		{
+		case ValueKind::Int64:
+		{
+			int64_t value = 0;
+			return properties.GetPropertyValue(id, value);
+		}
+		case ValueKind::Uint32:
+		{
+			uint32_t value = 0;
+			return properties.GetPropertyValue(id, value);
+		}
+		case ValueKind::Float32:
+		{
+			float value = 0;
+			return properties.GetPropertyValue(id, value);
+		}
+		case ValueKind::Bool:
+		{
+			bool value = false;
+			return properties.GetPropertyValue(id, value);
+		}
+		case ValueKind::String:
+		{
+			std::string_view value;
+			return properties.GetPropertyValue(id, value);
+		}
+		case ValueKind::StringResourceKey:
+		{
+			std::array<uint32_t, 3> value{};
+			return properties.GetPropertyValues(id, value);
+		}
+		default:
+			return false;
+		}
+	}
+
+	void CheckOrdinanceProperties(const DiscoveredExemplar& item, Report& report)
+	{
+		const ExemplarPropertyTable& properties = item.properties;
+
+		if (properties.HasParentCohort())
+		{
+			report.Warning(item, "The exemplar has a parent cohort, the inherited properties are not checked.");
+		}
+
+		// The plugin ignores the properties that do not have the expected type.
+		for (const CompiledOrdinancePackFormat::PropertySchemaItem& schemaItem : CompiledOrdinancePackFormat::PropertySchema)
+		{
+			if (properties.Find(schemaItem.id) && !HasValueOfKind(properties, schemaItem.id, schemaItem.kind))
+			{
+				report.Error(item, "Property 0x%08x has the wrong type or number of values.", schemaItem.id);
+			}
+		}
+
+		std::array<uint32_t, 3> nameKey{};
+		std::string_view name;
+
+		if (!properties.GetPropertyValues(kOrdinanceNameKey, nameKey)
+			&& (!properties.GetPropertyValue(kOrdinanceName, name) || name.empty())
+			&& !properties.HasParentCohort())
+		{
+			report.Warning(item, "The ordinance does not have a name.");
+		}
+
+		uint32_t year = 0;
+
+		if (properties.GetPropertyValue(kOrdinanceAvailabilityGameYear, year) && year != 0)
+		{
+			if (year <= kSC4StartYear)
+			{
+				report.Warning(
+					item,
+					"The year available (%u) must be greater than %u, the property is ignored.",
+					year,
+					kSC4StartYear);
+			}
+			else if (year > kMaxGameYear)
+			{
+				report.Error(
+					item,
+					"The year available (%u) is out of range, the maximum is %u.",
+					year,
+					kMaxGameYear);
+			}
+		}
+
+		for (const uint32_t id : { kOrdinanceAvailabilityLuaFunction, kOrdinanceMonthlyIncomeFactorLuaFunction })
+		{
+			std::string_view functionName;
+
+			if (properties.GetPropertyValue(id, functionName) && functionName.empty())
+			{
+				report.Warning(item, "The Lua function name in property 0x%08x is empty, the property is ignored.", id);
+			}
+		}
+	}
+
+	// Checks the exemplars with the same rules that the plugin uses when it
+	// loads the ordinances, and adds the ordinances that the plugin would use
+	// to the pack writer.
+	// The pack writer is optional, returns the number of ordinances.
+	size_t CheckExemplars(
+		const std::vector<std::filesystem::path>& files,
+		const std::vector<DiscoveredExemplar>& exemplars,
+		CompiledOrdinancePackWriter* pPackWriter,
+		Report& report)
+	{
+		// The first exemplar that uses an instance id is kept.
+		std::unordered_map<uint32_t, const DiscoveredExemplar*> ordinances;
+		ordinances.reserve(exemplars.size());
+
+		for (const DiscoveredExemplar& item : exemplars)
+		{
+			switch (item.status)
+			{
+			case ExemplarStatus::Ordinance:
+				break;
+			case ExemplarStatus::NotOrdinance:
+				report.Error(item, "The exemplar does not have an ExemplarType of Ordinance.");
+				continue;
+			case ExemplarStatus::MissingExemplarType:
+				report.Error(item, "The exemplar does not have an ExemplarType property.");
+				continue;
+			case ExemplarStatus::UnsupportedFormat:
+				report.Warning(item, "Text exemplars are not checked.");
+				continue;
+			case ExemplarStatus::InheritedExemplarType:
+				report.Warning(item, "The exemplar inherits its ExemplarType from its parent cohort, it is not checked.");
+				continue;
+			case ExemplarStatus::InvalidData:
+			default:
+				report.Error(item, "The exemplar could not be decoded.");
+				continue;
+			}
+
+			if (MaxisOrdinanceCLSIDs.contains(item.key.instance))
+			{
+				if (item.key.group == kMaxisOrdinanceGroupID)
+				{
+					report.Warning(item, "The exemplar overrides a Maxis ordinance, it is ignored by the plugin.");
+				}
+				else
+				{
+					report.Error(item, "The instance id is the same as a Maxis ordinance id.");
+				}
+				continue;
+			}
+
+			const auto [it, inserted] = ordinances.try_emplace(item.key.instance, &item);
+
+			if (!inserted)
+			{
+				const DiscoveredExemplar& first = *it->second;
+				const std::u8string firstPath = files[first.fileIndex].u8string();
+
+				report.Error(
+					item,
+					"The instance id is already used by 0x%08x, 0x%08x, 0x%08x in %s, the exemplar is ignored.",
+					first.key.type,
+					first.key.group,
+					first.key.instance,
+					reinterpret_cast<const char*>(firstPath.c_str()));
+				continue;
+			}
+
+			CheckOrdinanceProperties(item, report);
+
+			if (pPackWriter && !pPackWriter->Add(item.key.type, item.key.group, item.key.instance, item.properties))
+			{
+				report.Error(item, "The exemplar can't be added to a compiled pack because it has a parent cohort.");
+			}
+		}
+
+		return ordinances.size();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	std::vector<std::filesystem::path> files;
+	uint64_t totalSize = 0;
+
+	if (!GetInputFiles(options, files, totalSize))
+	{
+		return EXIT_FAILURE;
+	}
+
+	const auto startTime = std::chrono::steady_clock::now();
+
+	const OrdinanceDiscoveryPipeline pipeline(options.threadCount);
+	std::vector<DiscoveredExemplar> exemplars;
+
+	pipeline.Run(files, exemplars);
+
+	Report report(files);
+	CompiledOrdinancePackWriter packWriter;
+
+	const size_t ordinanceCount = CheckExemplars(
+		files,
+		exemplars,
+		options.packPath.empty() ? nullptr : &packWriter,
+		report);
+
+	const auto endTime = std::chrono::steady_clock::now();
+
+	const double seconds = std::chrono::duration<double>(endTime - startTime).count();
+	const double megabytes = static_cast<double>(totalSize) / (1024.0 * 1024.0);
+
+	std::printf(
+		"Checked %zu exemplars in %zu files (%.1f MiB) in %.3f seconds, %.0f exemplars/s, %.1f MiB/s.\n",
+		exemplars.size(),
+		files.size(),
+		megabytes,
+		seconds,
+		seconds > 0 ? static_cast<double>(exemplars.size()) / seconds : 0.0,
+		seconds > 0 ? megabytes / seconds : 0.0);
+	std::printf(
+		"%zu ordinances, %u errors, %u warnings.\n",
+		ordinanceCount,
+		report.GetErrorCount(),
+		report.GetWarningCount());
+
+	if (!options.packPath.empty())
+	{
+		if (report.GetErrorCount() > 0)
+		{
+			std::puts("The compiled pack was not written because of the errors.");
+		}
+		else if (!packWriter.Save(options.packPath))
+		{
+			std::fputs("Failed to write the compiled pack.\n", stderr);
+			return EXIT_FAILURE;
+		}
+	}
+
+	return report.GetErrorCount() > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}